@@ -0,0 +1,100 @@
+#!/usr/local/bin/perl
+#	\file make_kernels.pl
+#	\brief CUDA kernel image file generator.
+#	Compiles kernel source file to cubin for every given architecture and to
+#	PTX for the highest one, and embeds results to C++ source file as
+#	table of #CZKernelImage.
+#	Usage: make_kernels.pl <output.cpp> <input.cu> <nvcc> [<nvcc option> ...] <arch> [<arch> ...]
+#	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+#	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+#	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+
+use File::Basename;
+use File::Path;
+
+if(@ARGV < 4) {
+	die 'Usage: make_kernels.pl <output.cpp> <input.cu> <nvcc> [<nvcc option> ...] <arch> [<arch> ...]'."\n";
+}
+
+$outfile = shift @ARGV;
+$infile = shift @ARGV;
+$nvcc = shift @ARGV;
+
+@options = ();
+@archs = ();
+foreach $arg (@ARGV) {
+	if($arg =~ /^\d+$/) {
+		push @archs, $arg;
+	} else {
+		push @options, $arg;
+	}
+}
+@archs = sort { $a <=> $b } @archs;
+
+if(@archs < 1) {
+	die 'No target architecture is specified!'."\n";
+}
+
+$tmpfile = $outfile.'.tmp';
+mkpath(dirname($outfile));
+
+sub compile {
+	my ($target, $name) = @_;
+	my $cmd = join(' ', $nvcc, @options, $target, '-o', $tmpfile, $infile);
+	print $cmd."\n";
+	system($cmd) == 0 or die 'Can\'t compile '.$infile.' for '.$name.'!'."\n";
+
+	open(IMG, '<', $tmpfile) or die 'Unable to open image file '.$tmpfile.'!'."\n";
+	binmode(IMG);
+	local $/;
+	my $data = <IMG>;
+	close(IMG);
+	unlink($tmpfile);
+	return $data;
+}
+
+sub dump_image {
+	my ($name, $data) = @_;
+	my @bytes = unpack('C*', $data);
+	print OUT 'static const unsigned char s_'.$name.'[] = {';
+	for(my $i = 0; $i < @bytes; $i++) {
+		print OUT "\n\t" if(($i % 16) == 0);
+		printf OUT '0x%02x,', $bytes[$i];
+	}
+	print OUT "\n".'};'."\n\n";
+}
+
+open(OUT, '>'.$outfile) or die 'Unable to open output file '.$outfile.'!';
+
+print OUT '/*!'."\t".'\\file '.$outfile.''."\n";
+print OUT "\t".'\\brief CUDA kernel images.'."\n";
+print OUT "\t".'\\warning This file is automatically generated by script make_kernels.pl.'."\n";
+print OUT "\t".'\\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/'."\n";
+print OUT "\t".'\\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/'."\n";
+print OUT "\t".'\\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html'."\n";
+print OUT '*/'."\n";
+print OUT "\n";
+print OUT '#include "czkernels.h"'."\n";
+print OUT "\n";
+
+@table = ();
+
+foreach $arch (@archs) {
+	$data = compile('-cubin -gencode arch=compute_'.$arch.',code=sm_'.$arch, 'sm_'.$arch);
+	dump_image('sm_'.$arch, $data);
+	push @table, "\t".'{'.$arch.', 0, s_sm_'.$arch.', sizeof(s_sm_'.$arch.')},'."\n";
+}
+
+$arch = $archs[-1];
+$data = compile('-ptx -arch=compute_'.$arch, 'compute_'.$arch);
+$data .= "\0";
+dump_image('compute_'.$arch, $data);
+push @table, "\t".'{'.$arch.', 1, s_compute_'.$arch.', sizeof(s_compute_'.$arch.')},'."\n";
+
+print OUT 'const struct CZKernelImage CZKernelImageTab[] = {'."\n";
+print OUT @table;
+print OUT '};'."\n";
+print OUT "\n";
+print OUT 'const int CZKernelImageNum = sizeof(CZKernelImageTab) / sizeof(CZKernelImageTab[0]);'."\n";
+
+close(OUT);
@@ -0,0 +1,58 @@
+#!/bin/sh
+#	\file startup-time.sh
+#	\brief Startup time and shared library dependencies of CUDA-Z binaries.
+#	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+#	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+#	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+
+#	\paragraph commandline Command line arguments
+#	startup-time.sh \a [runs] \a binary...
+#	\arg runs Number of runs of every binary, 20 by default
+#	\arg binary Binary to measure, e.g. bin/cuda-z bin/cuda-z-cli
+#
+#	Every binary lists devices of simulated backend, so neither GPU nor
+#	display is needed. Median wall time of runs is printed together with
+#	the number of shared libraries the binary loads.
+
+#set -x
+
+czRuns=20
+
+case "$1" in
+[0-9]*)
+	czRuns="$1"
+	shift
+	;;
+esac
+
+if [ $# -eq 0 ]; then
+	echo "Usage: $0 [runs] binary..." >&2
+	exit 1
+fi
+
+czNow() {
+	date +%s%N
+}
+
+for czBin in "$@"; do
+	if [ ! -x "$czBin" ]; then
+		echo "$czBin: not found" >&2
+		continue
+	fi
+
+	czTimes=
+	i=0
+	while [ $i -lt $czRuns ]; do
+		czStart=`czNow`
+		"$czBin" -cli -backend sim -nocache -list >/dev/null 2>&1
+		czEnd=`czNow`
+		czTimes="$czTimes `expr \( $czEnd - $czStart \) / 1000`"
+		i=`expr $i + 1`
+	done
+
+	czMedian=`echo $czTimes | tr ' ' '\n' | sort -n | awk '{ t[NR] = $1 } END { print t[int((NR + 1) / 2)] }'`
+	czLibs=`ldd "$czBin" 2>/dev/null | grep -c '=>'`
+
+	echo "$czBin: median startup $czMedian us of $czRuns runs, $czLibs shared libraries"
+	ldd "$czBin" 2>/dev/null | grep -i 'qt\|cuda' | sed 's/^[ \t]*/\t/'
+done
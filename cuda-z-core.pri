@@ -0,0 +1,52 @@
+#	\file cuda-z-core.pri
+#	\brief CUDA-Z core library for applications.
+#	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+#	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+#	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+
+#
+# Applications include this file after setting CZ_BUILD_DIR to link the core
+# library of cuda-z-core.pro instead of compiling its sources again. The
+# library is built in core folder of the application build, with the same
+# sm_, debug and static configuration, before the application is linked.
+#
+
+CZ_CORE_DIR = $$CZ_BUILD_DIR/core
+win32:CZ_CORE_LIB = $$CZ_CORE_DIR/lib/cuda-z-core.lib
+else:CZ_CORE_LIB = $$CZ_CORE_DIR/lib/libcuda-z-core.a
+
+CZ_CORE_CONFIG = $$find(CONFIG, sm_.*)
+CONFIG(debug, debug|release):CZ_CORE_CONFIG += debug
+else:CZ_CORE_CONFIG += release
+static:CZ_CORE_CONFIG += static
+
+INCLUDEPATH += $$PWD/src
+
+LIBS += $$CZ_CORE_LIB
+unix:LIBS += -lcudart_static
+linux:!static:LIBS += -ldl -lm -lrt
+win32:LIBS += \
+	$$quote($$(CUDA_LIB_PATH)\\cuda.lib) \
+	$$quote($$(CUDA_LIB_PATH)\\cudart_static.lib) \
+	Version.lib \
+	Kernel32.lib \
+	Psapi.lib
+unix:QMAKE_LIBDIR += /usr/local/cuda/lib
+unix:QMAKE_LIBDIR += /usr/local/cuda/lib64
+
+make_core_dir.target = $$CZ_CORE_DIR
+win32:make_core_dir.commands = $(MKDIR) $$replace(CZ_CORE_DIR, /, \\)
+else:make_core_dir.commands = $(MKDIR) $$CZ_CORE_DIR
+QMAKE_EXTRA_TARGETS += make_core_dir
+
+# Sub-make decides itself whether the library is up to date.
+core_lib.target = $$CZ_CORE_LIB
+win32:core_lib.commands = cd $$replace(CZ_CORE_DIR, /, \\) && $(QMAKE) $$replace(PWD, /, \\)\\cuda-z-core.pro -after $$join(CZ_CORE_CONFIG, " CONFIG+=", "CONFIG+=") && $(MAKE)
+else:core_lib.commands = cd $$CZ_CORE_DIR && $(QMAKE) $$PWD/cuda-z-core.pro -after $$join(CZ_CORE_CONFIG, " CONFIG+=", "CONFIG+=") && $(MAKE)
+core_lib.depends = make_core_dir FORCE
+QMAKE_EXTRA_TARGETS += core_lib
+PRE_TARGETDEPS += $$CZ_CORE_LIB
+
+core_clean.target = core_clean
+core_clean.commands = -cd $$CZ_CORE_DIR && $(MAKE) clean
+QMAKE_EXTRA_TARGETS += core_clean
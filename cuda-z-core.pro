@@ -0,0 +1,118 @@
+#	\file cuda-z-core.pro
+#	\brief CUDA-Z core library project file.
+#	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+#	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+#	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+
+#
+# Device queries, tests, statistics, sessions, history, tracing, reports
+# and merge of reports. These modules are plain C and do not use Qt. Both
+# cuda-z and cuda-z-cli link this library (see cuda-z-core.pri), which
+# builds it in their core folder. Exception is Mac OS X, where kext
+# version is read with QSettings.
+#
+
+TEMPLATE = lib
+TARGET = cuda-z-core
+CONFIG -= qt
+CONFIG += staticlib warn_on
+CONFIG += release
+#CONFIG += debug
+#CONFIG += sm_all
+
+# Kext version is read with QSettings on Mac OS X.
+mac: {
+	CONFIG += qt
+	QT = core
+}
+
+CZ_SOURCE_DIR = $$PWD
+CZ_BUILD_DIR = $$OUT_PWD
+CZ_BUILD_SRC_DIR = $$CZ_BUILD_DIR/src
+
+# Compiling...
+
+HEADERS += src/log.h \
+	src/cudainfo.h \
+	src/cudaarch.h \
+	src/cztimer.h \
+	src/czsoak.h \
+	src/czplugin.h \
+	src/czstat.h \
+	src/czbackend.h \
+	src/czsim.h \
+	src/czsession.h \
+	src/czasync.h \
+	src/czcache.h \
+	src/czbaseline.h \
+	src/czhistory.h \
+	src/czfleet.h \
+	src/cztrace.h \
+	src/czhealth.h \
+	src/czreport.h \
+	src/czmerge.h \
+	src/czkernels.h
+mac:HEADERS += src/plist.h
+linux:HEADERS += src/ldso.h
+SOURCES += src/log.cpp \
+	src/cudaarch.cpp \
+	src/cztimer.cpp \
+	src/czsoak.cpp \
+	src/czplugin.cpp \
+	src/czstat.cpp \
+	src/czbackend.cpp \
+	src/czsim.cpp \
+	src/czsession.cpp \
+	src/czasync.cpp \
+	src/czcache.cpp \
+	src/czbaseline.cpp \
+	src/czhistory.cpp \
+	src/czfleet.cpp \
+	src/cztrace.cpp \
+	src/czhealth.cpp \
+	src/czreport.cpp \
+	src/czmerge.cpp
+mac:SOURCES += src/plist.cpp
+linux:SOURCES += src/ldso.cpp
+CUSOURCES += src/cudainfo.cu
+CUKERNELS += src/czkernels.cu
+
+SM_CONFIG = $$find(CONFIG, sm_.*)
+isEmpty(SM_CONFIG): CONFIG += sm_all
+
+# Kernels are compiled to cubin for every architecture below and to PTX for
+# the highest one. Only the image matching the device is loaded at run time.
+sm_all:CONFIG += sm_30 sm_32 sm_35 sm_37 sm_50 sm_52 sm_53 sm_60 sm_61 sm_62
+
+sm_10:CUKERNEL_ARCHS += 10
+sm_11:CUKERNEL_ARCHS += 11
+sm_13:CUKERNEL_ARCHS += 13
+sm_20:CUKERNEL_ARCHS += 20
+sm_30:CUKERNEL_ARCHS += 30
+sm_32:CUKERNEL_ARCHS += 32
+sm_35:CUKERNEL_ARCHS += 35
+sm_37:CUKERNEL_ARCHS += 37
+sm_50:CUKERNEL_ARCHS += 50
+sm_52:CUKERNEL_ARCHS += 52
+sm_53:CUKERNEL_ARCHS += 53
+sm_60:CUKERNEL_ARCHS += 60
+sm_61:CUKERNEL_ARCHS += 61
+sm_62:CUKERNEL_ARCHS += 62
+sm_70:CUKERNEL_ARCHS += 70
+sm_72:CUKERNEL_ARCHS += 72
+
+INCLUDEPATH += $$CZ_BUILD_SRC_DIR
+INCLUDEPATH += $$CZ_SOURCE_DIR/src
+
+make_src_dir.target = $$CZ_BUILD_SRC_DIR
+win32:make_src_dir.commands = $(MKDIR) $$replace(CZ_BUILD_SRC_DIR, /, \\)
+else:make_src_dir.commands = $(MKDIR) $$CZ_BUILD_SRC_DIR
+QMAKE_EXTRA_TARGETS += make_src_dir
+PRE_TARGETDEPS += $$CZ_BUILD_SRC_DIR
+
+# Outputs...
+
+DESTDIR = $$CZ_BUILD_DIR/lib
+OBJECTS_DIR = $$CZ_BUILD_DIR/bld/o
+
+include(cuda.pri)
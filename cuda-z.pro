@@ -12,8 +12,18 @@ CONFIG += release
 CONFIG += console
 #CONFIG += static
 #CONFIG += sm_all
+#CONFIG += cli
+
+# CLI build makes lean cuda-z-cli binary without GUI, it does not link
+# QtGui and widgets, so it can run on headless nodes.
+cli: {
+	QT = core network
+	TARGET = cuda-z-cli
+	DEFINES += CZ_CLI_ONLY
+	mac:CONFIG -= app_bundle
+}
 
-isEqual(QT_MAJOR_VERSION, 5) {
+!cli:isEqual(QT_MAJOR_VERSION, 5) {
 	QT += widgets
 }
 
@@ -25,88 +35,40 @@ CZ_BUILD_SRC_DIR = $$CZ_BUILD_DIR/src
 
 # Compiling...
 
-FORMS = ui/czdialog.ui
-HEADERS = src/version.h \
-	src/czdialog.h \
+include(cuda-z-core.pri)
+
+HEADERS += src/version.h \
 	src/czdeviceinfo.h \
 	src/czdeviceinfodecoder.h \
 	src/czcommandline.h \
-	src/log.h \
 	src/platform.h \
-	src/cudainfo.h
-mac:HEADERS += src/plist.h
-SOURCES = src/czdialog.cpp \
-	src/czdeviceinfo.cpp \
+	src/czparallel.h \
+	src/czdaemon.h
+SOURCES += src/czdeviceinfo.cpp \
 	src/czdeviceinfodecoder.cpp \
 	src/czcommandline.cpp \
-	src/log.cpp \
 	src/platform.cpp \
+	src/czparallel.cpp \
+	src/czdaemon.cpp \
 	src/main.cpp
-mac:SOURCES += src/plist.cpp
-CUSOURCES = src/cudainfo.cu
-RESOURCES = res/cuda-z.qrc
+!cli: {
+	FORMS = ui/czdialog.ui
+	HEADERS += src/czdialog.h \
+		src/czchart.h
+	SOURCES += src/czdialog.cpp \
+		src/czchart.cpp
+}
+!cli:RESOURCES = res/cuda-z.qrc
 win32:RC_FILE += res/cuda-z.rc
-mac: {
+mac:!cli: {
 	ICON = res/img/icon.icns
 	TARGET = CUDA-Z
 	QMAKE_INFO_PLIST = res/Info.plist
 }
 
-SM_CONFIG = $$find(CONFIG, sm_.*)
-isEmpty(SM_CONFIG): CONFIG += sm_all
-
-sm_all:CONFIG += sm_30 sm_32 sm_35 sm_37 sm_50 sm_52 sm_53 sm_60 sm_61 sm_62
-
-sm_10:CUFLAGS += -gencode=arch=compute_10,code=sm_10 \
-	-gencode=arch=compute_10,code=compute_10
-
-sm_11:CUFLAGS += -gencode=arch=compute_11,code=sm_11 \
-	-gencode=arch=compute_11,code=compute_11
-
-sm_13:CUFLAGS += -gencode=arch=compute_13,code=sm_13 \
-	-gencode=arch=compute_13,code=compute_13
-
-sm_20:CUFLAGS += -gencode=arch=compute_20,code=sm_20 \
-	-gencode=arch=compute_20,code=compute_20
-
-sm_30:CUFLAGS += -gencode=arch=compute_30,code=sm_30 \
-	-gencode=arch=compute_30,code=compute_30
-
-sm_32:CUFLAGS += -gencode arch=compute_32,code=sm_32 \
-	-gencode arch=compute_32,code=compute_32
-
-sm_35:CUFLAGS += -gencode=arch=compute_35,code=sm_35 \
-	-gencode=arch=compute_35,code=compute_35
-
-sm_37:CUFLAGS += -gencode=arch=compute_37,code=sm_37 \
-	-gencode=arch=compute_37,code=compute_37
-
-sm_50:CUFLAGS += -gencode arch=compute_50,code=sm_50 \
-	-gencode arch=compute_50,code=compute_50
-
-sm_52:CUFLAGS += -gencode arch=compute_52,code=sm_52 \
-	-gencode arch=compute_52,code=compute_52
-
-sm_53:CUFLAGS += -gencode arch=compute_53,code=sm_53 \
-	-gencode arch=compute_53,code=compute_53
-
-sm_60:CUFLAGS += -gencode arch=compute_60,code=sm_60 \
-	-gencode arch=compute_60,code=compute_60
-
-sm_61:CUFLAGS += -gencode arch=compute_61,code=sm_61 \
-	-gencode arch=compute_61,code=compute_61
-
-sm_62:CUFLAGS += -gencode arch=compute_62,code=sm_62 \
-	-gencode arch=compute_62,code=compute_62
-
-sm_70:CUFLAGS += -gencode arch=compute_70,code=sm_70 \
-	-gencode arch=compute_70,code=compute_70
-
-sm_72:CUFLAGS += -gencode arch=compute_72,code=sm_72 \
-	-gencode arch=compute_72,code=compute_72
-
 win32:INCLUDEPATH += $$quote($$replace(CZ_BUILD_SRC_DIR, /, \\))
 else:INCLUDEPATH += $$CZ_BUILD_SRC_DIR
+INCLUDEPATH += $$CZ_SOURCE_DIR/src
 
 win32:RC_INCLUDEPATH += $$quote($$replace(CZ_SOURCE_DIR, /, \\))
 win32:RC_INCLUDEPATH += $$quote($$replace(CZ_SOURCE_DIR, /, \\)\\src)
@@ -116,15 +78,6 @@ win32:isEqual(QT_MAJOR_VERSION, 4) {
 	QMAKE_RC = rc $$join(RC_INCLUDEPATH, " -I ", "-I ")
 }
 
-unix:LIBS += -lcudart_static
-linux:!static:LIBS += -ldl -lm -lrt
-win32:LIBS += \
-	$$quote($$(CUDA_LIB_PATH)\\cuda.lib) \
-	$$quote($$(CUDA_LIB_PATH)\\cudart_static.lib) \
-	Version.lib \
-	Kernel32.lib \
-	Psapi.lib
-
 make_src_dir.target = $$CZ_BUILD_SRC_DIR
 win32:make_src_dir.commands = $(MKDIR) $$replace(CZ_BUILD_SRC_DIR, /, \\)
 else:make_src_dir.commands = $(MKDIR) $$CZ_BUILD_SRC_DIR
@@ -170,18 +123,21 @@ win32:QCLEANFILES += \
 	vc1?0.pdb \
 	bin\\cuda-z.exe \
 	bin\\cuda-z.pdb \
+	bin\\cuda-z-cli.exe \
+	bin\\cuda-z-cli.pdb \
 	cuda-z.ncb \
 	cudainfo.linkinfo \
 	version.nsi \
 	build.nsi
 unix:!mac:QCLEANFILES += \
-	bin/cuda-z
+	bin/cuda-z \
+	bin/cuda-z-cli
 
 QMAKE_EXTRA_VARIABLES += QCLEANFILES
 
 qclean.target = qclean
 qclean.commands = -$(DEL_FILE) $(EXPORT_QCLEANFILES) #$(EXPORT_BUILD_H)
-qclean.depends = clean
+qclean.depends = clean core_clean
 QMAKE_EXTRA_TARGETS += qclean
 
 mac: {
@@ -226,5 +182,3 @@ OBJECTS_DIR = $$CZ_BUILD_DIR/bld/o
 MOC_DIR = $$CZ_BUILD_DIR/bld/moc
 UI_DIR = $$CZ_BUILD_DIR/bld/ui
 RCC_DIR = $$CZ_BUILD_DIR/bld/rcc
-
-include(cuda.pri)
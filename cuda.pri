@@ -58,6 +58,20 @@
 	silent:cu.commands = @echo nvcc ${QMAKE_FILE_IN} && $$cu.commands
 	QMAKE_EXTRA_COMPILERS += cu
 
+	cukern.name = Cuda kernels ${QMAKE_FILE_IN}
+	cukern.input = CUKERNELS
+	cukern.output = $$CZ_BUILD_SRC_DIR/${QMAKE_FILE_BASE}_img.cpp
+	cukern.variable_out = SOURCES
+	cukern.depends = $$CZ_SOURCE_DIR/src/czkernels.h
+	CUKERNEL_FLAGS += -I$$CZ_SOURCE_DIR/src
+	unix:contains(QMAKE_CUFLAGS, -m64):CUKERNEL_FLAGS += -m64
+	unix:contains(QMAKE_CUFLAGS, -m32):CUKERNEL_FLAGS += -m32
+	win32:contains(QMAKE_TARGET.arch, x86):CUKERNEL_FLAGS += -m32
+	win32:contains(QMAKE_TARGET.arch, x86_64):CUKERNEL_FLAGS += -m64
+	cukern.commands = perl $$CZ_SOURCE_DIR/bld/bin/make_kernels.pl ${QMAKE_FILE_OUT} ${QMAKE_FILE_NAME} $$QMAKE_CUC $$CUKERNEL_FLAGS $$CUKERNEL_ARCHS$$escape_expand(\\n\\t)
+	silent:cukern.commands = @echo nvcc ${QMAKE_FILE_IN} && $$cukern.commands
+	QMAKE_EXTRA_COMPILERS += cukern
+
 	build_pass|isEmpty(BUILDS):cuclean.depends = compiler_cu_clean
 	else:cuclean.CONFIG += recursive
 	QMAKE_EXTRA_TARGETS += cuclean
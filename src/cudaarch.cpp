@@ -0,0 +1,296 @@
+/*!	\file cudaarch.cpp
+	\brief CUDA architecture database and theoretical peak calculations.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "cudaarch.h"
+
+#define CZ_KB			1024			/*!< Kibibyte. */
+
+/*!	\brief Architecture database.
+	\link https://docs.nvidia.com/cuda/cuda-c-programming-guide/index.html#arithmetic-instructions
+	\link https://en.wikipedia.org/wiki/CUDA
+	Entries of one major revision must be sorted by minor revision.
+*/
+static const struct CZArchInfo s_archTab[] = {
+	/* major, minor, arch, chip, fp16, fp32, fp64, int32, sfu, memory, rate, pcie, lanes, L1, shared */
+	{1, 0, "Tesla", "G80", 0, 8, 0, 2, 2, "GDDR3", 2, 1, 16, 0, 16 * CZ_KB},
+	{1, 1, "Tesla", "G8x, G9x", 0, 8, 0, 2, 2, "GDDR3", 2, 2, 16, 0, 16 * CZ_KB},
+	{1, 2, "Tesla", "GT21x", 0, 8, 0, 2, 2, "GDDR3", 2, 2, 16, 0, 16 * CZ_KB},
+	{1, 3, "Tesla", "GT200", 0, 8, 1, 2, 2, "GDDR3", 2, 2, 16, 0, 16 * CZ_KB},
+	{2, 0, "Fermi", "GF100, GF110", 0, 32, 16, 16, 4, "GDDR5", 2, 2, 16, 16 * CZ_KB, 48 * CZ_KB},
+	{2, 1, "Fermi", "GF10x, GF11x", 0, 48, 4, 16, 8, "GDDR5", 2, 2, 16, 16 * CZ_KB, 48 * CZ_KB},
+	{3, 0, "Kepler", "GK10x", 0, 192, 8, 32, 32, "GDDR5", 2, 3, 16, 16 * CZ_KB, 48 * CZ_KB},
+	{3, 2, "Kepler", "GK20A", 0, 192, 8, 32, 32, "LPDDR3", 2, 0, 0, 16 * CZ_KB, 48 * CZ_KB},
+	{3, 5, "Kepler", "GK11x, GK208", 0, 192, 64, 32, 32, "GDDR5", 2, 3, 16, 16 * CZ_KB, 48 * CZ_KB},
+	{3, 7, "Kepler", "GK210", 0, 192, 64, 32, 32, "GDDR5", 2, 3, 16, 16 * CZ_KB, 112 * CZ_KB},
+	/* Maxwell and Pascal have no native 32-bit IMAD, it is emulated with several XMAD instructions. */
+	{5, 0, "Maxwell", "GM10x", 0, 128, 4, 32, 32, "GDDR5", 2, 3, 16, 24 * CZ_KB, 64 * CZ_KB},
+	{5, 2, "Maxwell", "GM20x", 0, 128, 4, 32, 32, "GDDR5", 2, 3, 16, 48 * CZ_KB, 96 * CZ_KB},
+	{5, 3, "Maxwell", "GM20B", 256, 128, 4, 32, 32, "LPDDR4", 2, 0, 0, 24 * CZ_KB, 64 * CZ_KB},
+	{6, 0, "Pascal", "GP100", 128, 64, 32, 16, 16, "HBM2", 2, 3, 16, 24 * CZ_KB, 64 * CZ_KB},
+	{6, 1, "Pascal", "GP10x", 2, 128, 4, 32, 32, "GDDR5X", 2, 3, 16, 48 * CZ_KB, 96 * CZ_KB},
+	{6, 2, "Pascal", "GP10B", 256, 128, 4, 32, 32, "LPDDR4", 2, 0, 0, 24 * CZ_KB, 64 * CZ_KB},
+	{7, 0, "Volta", "GV100", 128, 64, 32, 64, 16, "HBM2", 2, 3, 16, 128 * CZ_KB, 96 * CZ_KB},
+	{7, 2, "Volta", "GV10B", 128, 64, 2, 64, 16, "LPDDR4X", 2, 0, 0, 128 * CZ_KB, 96 * CZ_KB},
+	{7, 5, "Turing", "TU10x", 128, 64, 2, 64, 16, "GDDR6", 2, 3, 16, 96 * CZ_KB, 64 * CZ_KB},
+	{8, 0, "Ampere", "GA100", 256, 64, 32, 64, 16, "HBM2e", 2, 4, 16, 192 * CZ_KB, 164 * CZ_KB},
+	{8, 6, "Ampere", "GA10x", 256, 128, 2, 64, 16, "GDDR6X", 2, 4, 16, 128 * CZ_KB, 100 * CZ_KB},
+	{8, 7, "Ampere", "GA10B", 256, 128, 2, 64, 16, "LPDDR5", 2, 0, 0, 192 * CZ_KB, 164 * CZ_KB},
+	{8, 9, "Ada", "AD10x", 256, 128, 2, 64, 16, "GDDR6X", 2, 4, 16, 128 * CZ_KB, 100 * CZ_KB},
+	{9, 0, "Hopper", "GH100", 256, 128, 64, 64, 16, "HBM3", 2, 5, 16, 256 * CZ_KB, 228 * CZ_KB},
+};
+
+/*!	\def CZ_ARCH_TAB_SIZE
+	\brief Number of entries in architecture database.
+*/
+#define CZ_ARCH_TAB_SIZE	(sizeof(s_archTab) / sizeof(s_archTab[0]))
+
+/*!	\brief Find architecture information by compute capability.
+	Unknown minor revision falls back to the closest known older minor
+	revision of the same major revision.
+	\returns \a NULL if architecture is unknown, or a pointer to architecture information.
+*/
+const struct CZArchInfo *CZArchFind(
+	int major,			/*!<[in] GPU Architecture major version. */
+	int minor			/*!<[in] GPU Architecture minor version. */
+) {
+	const struct CZArchInfo *found = NULL;
+	unsigned int i;
+
+	for(i = 0; i < CZ_ARCH_TAB_SIZE; i++) {
+		if(s_archTab[i].major != major)
+			continue;
+		if(s_archTab[i].minor == minor)
+			return &s_archTab[i];
+		if(s_archTab[i].minor < minor)
+			found = &s_archTab[i];
+	}
+
+	return found;
+}
+
+/*!	\brief Get a name of GPU Architecture.
+	\returns "" if GPU Architecture is unknown, or a name of the architecture.
+*/
+const char *CZArchName(
+	int major,			/*!<[in] GPU Architecture major version. */
+	int minor			/*!<[in] GPU Architecture minor version. */
+) {
+	const struct CZArchInfo *arch = CZArchFind(major, minor);
+	return (arch == NULL)? "": arch->archName;
+}
+
+/*!	\brief Get number of CUDA cores per multiprocessor.
+	\returns 0 if GPU Architecture is unknown, or number of CUDA cores per multiprocessor.
+*/
+int CZArchCoresPerMP(
+	int major,			/*!<[in] GPU Architecture major version. */
+	int minor			/*!<[in] GPU Architecture minor version. */
+) {
+	const struct CZArchInfo *arch = CZArchFind(major, minor);
+	return (arch == NULL)? 0: arch->thrFloat32;
+}
+
+/*!	\brief Short names of metrics used in command line and exported files.
+*/
+static const char *s_metricNames[CZMetricMax] = {
+	"hd-pin",	/* CZMetricCopyHDPin */
+	"hd-page",	/* CZMetricCopyHDPage */
+	"dh-pin",	/* CZMetricCopyDHPin */
+	"dh-page",	/* CZMetricCopyDHPage */
+	"dd",		/* CZMetricCopyDD */
+	"float",	/* CZMetricCalcFloat */
+	"double",	/* CZMetricCalcDouble */
+	"int64",	/* CZMetricCalcInteger64 */
+	"int32",	/* CZMetricCalcInteger32 */
+	"int24",	/* CZMetricCalcInteger24 */
+};
+
+/*!	\brief Get short name of a metric.
+	\returns "" if metric is unknown, or a name of the metric.
+*/
+const char *CZMetricName(
+	int metric			/*!<[in] Metric, see enum #CZMetric. */
+) {
+	if((metric < 0) || (metric >= CZMetricMax))
+		return "";
+
+	return s_metricNames[metric];
+}
+
+/*!	\brief Find a metric by its short name.
+	\returns \a -1 if metric is unknown, or a metric (see enum #CZMetric).
+*/
+int CZMetricFind(
+	const char *name		/*!<[in] Short name of metric. */
+) {
+	int i;
+
+	if(name == NULL)
+		return -1;
+
+	for(i = 0; i < CZMetricMax; i++) {
+		if(strcmp(s_metricNames[i], name) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+/*!	\brief Get measured value of a metric.
+	\returns Value in KiB/s for copy metrics and in KOPS for calculation metrics, \a 0 if unknown.
+*/
+float CZMetricValue(
+	const struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	int metric			/*!<[in] Metric, see enum #CZMetric. */
+) {
+	if(info == NULL)
+		return 0;
+
+	switch(metric) {
+	case CZMetricCopyHDPin:		return info->band.copyHDPin;
+	case CZMetricCopyHDPage:	return info->band.copyHDPage;
+	case CZMetricCopyDHPin:		return info->band.copyDHPin;
+	case CZMetricCopyDHPage:	return info->band.copyDHPage;
+	case CZMetricCopyDD:		return info->band.copyDD;
+	case CZMetricCalcFloat:		return info->perf.calcFloat;
+	case CZMetricCalcDouble:	return info->perf.calcDouble;
+	case CZMetricCalcInteger64:	return info->perf.calcInteger64;
+	case CZMetricCalcInteger32:	return info->perf.calcInteger32;
+	case CZMetricCalcInteger24:	return info->perf.calcInteger24;
+	default:			return 0;
+	}
+}
+
+/*!	\brief Set measured value of a metric.
+*/
+void CZMetricSetValue(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int metric,			/*!<[in] Metric, see enum #CZMetric. */
+	float value			/*!<[in] Value in KiB/s for copy metrics and in KOPS for calculation metrics. */
+) {
+	if(info == NULL)
+		return;
+
+	switch(metric) {
+	case CZMetricCopyHDPin:		info->band.copyHDPin = value; break;
+	case CZMetricCopyHDPage:	info->band.copyHDPage = value; break;
+	case CZMetricCopyDHPin:		info->band.copyDHPin = value; break;
+	case CZMetricCopyDHPage:	info->band.copyDHPage = value; break;
+	case CZMetricCopyDD:		info->band.copyDD = value; break;
+	case CZMetricCalcFloat:		info->perf.calcFloat = value; break;
+	case CZMetricCalcDouble:	info->perf.calcDouble = value; break;
+	case CZMetricCalcInteger64:	info->perf.calcInteger64 = value; break;
+	case CZMetricCalcInteger32:	info->perf.calcInteger32 = value; break;
+	case CZMetricCalcInteger24:	info->perf.calcInteger24 = value; break;
+	}
+}
+
+/*!	\brief Get one direction bandwidth of one PCI Express lane.
+	\returns Bandwidth in bytes per second, \a 0 if generation is unknown.
+*/
+static double CZArchHostLinkLaneRate(
+	int gen				/*!<[in] PCI Express generation. */
+) {
+	switch(gen) {
+	case 1: return 250.0e6;			/* 2.5 GT/s, 8b/10b */
+	case 2: return 500.0e6;			/* 5 GT/s, 8b/10b */
+	case 3: return 8.0e9 * 128 / 130 / 8;	/* 8 GT/s, 128b/130b */
+	case 4: return 16.0e9 * 128 / 130 / 8;	/* 16 GT/s, 128b/130b */
+	case 5: return 32.0e9 * 128 / 130 / 8;	/* 32 GT/s, 128b/130b */
+	default: return 0;
+	}
+}
+
+/*!	\brief Calculate theoretical peak of a metric.
+	Memory bandwidth is derived from memory clock and bus width reported by
+	device, host transfers are limited by the typical host link of architecture.
+	Calculation peaks count a multiply-add as two operations the same way as
+	performance tests do. 64-bit integer multiply-add is emulated by several
+	32-bit instructions, so its peak is an estimation.
+	\returns Value in KiB/s for copy metrics and in KOPS for calculation metrics, \a 0 if unknown.
+*/
+double CZArchCalcPeak(
+	const struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	int metric			/*!<[in] Metric, see enum #CZMetric. */
+) {
+	const struct CZArchInfo *arch;
+	double opsPerClock;
+	double memBand;
+	double linkBand;
+
+	if(info == NULL)
+		return 0;
+
+	arch = CZArchFind(info->major, info->minor);
+	if(arch == NULL)
+		return 0;
+
+	/* Memory bandwidth in bytes per second. */
+	memBand = (double)info->mem.memoryClockRate * 1000 *
+		(double)arch->memDataRate * (double)info->mem.memoryBusWidth / 8;
+
+	/* Host link bandwidth in bytes per second, shared memory for integrated GPU. */
+	if(info->core.integratedGpu || (arch->hostLinkGen == 0))
+		linkBand = memBand / 2;
+	else
+		linkBand = CZArchHostLinkLaneRate(arch->hostLinkGen) * arch->hostLinkWidth;
+
+	switch(metric) {
+	case CZMetricCopyHDPin:
+	case CZMetricCopyHDPage:
+	case CZMetricCopyDHPin:
+	case CZMetricCopyDHPage:
+		return linkBand / CZ_KB;
+
+	case CZMetricCopyDD: /* every byte is read and written */
+		return memBand / 2 / CZ_KB;
+
+	case CZMetricCalcFloat:
+		opsPerClock = arch->thrFloat32;
+		break;
+
+	case CZMetricCalcDouble:
+		opsPerClock = arch->thrFloat64;
+		break;
+
+	case CZMetricCalcInteger32:
+		opsPerClock = arch->thrInteger32;
+		break;
+
+	case CZMetricCalcInteger24: /* native 24-bit multiply exists on Tesla only */
+		opsPerClock = (arch->major == 1)? arch->thrFloat32: arch->thrInteger32;
+		break;
+
+	case CZMetricCalcInteger64:
+		opsPerClock = (double)arch->thrInteger32 / 4;
+		break;
+
+	default:
+		return 0;
+	}
+
+	/* clockRate is in kHz, so result is in KOPS. */
+	return 2 * opsPerClock * (double)info->core.muliProcCount * (double)info->core.clockRate;
+}
+
+/*!	\brief Calculate efficiency of a metric, i.e. measured value to theoretical peak ratio.
+	\returns Efficiency in percents, \a 0 if unknown.
+*/
+double CZArchCalcEfficiency(
+	const struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	int metric			/*!<[in] Metric, see enum #CZMetric. */
+) {
+	double peak = CZArchCalcPeak(info, metric);
+
+	if(peak <= 0)
+		return 0;
+
+	return 100 * (double)CZMetricValue(info, metric) / peak;
+}
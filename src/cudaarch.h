@@ -0,0 +1,53 @@
+/*!	\file cudaarch.h
+	\brief CUDA architecture database definitions.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_CUDAARCH_H
+#define CZ_CUDAARCH_H
+
+#include "cudainfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!	\brief Characteristics of one GPU architecture (compute capability).
+	All throughput values are results per clock per multiprocessor.
+*/
+struct CZArchInfo {
+	int		major;			/*!< Major revision number of compute capability. */
+	int		minor;			/*!< Minor revision number of compute capability. */
+	const char	*archName;		/*!< Architecture name. E.g. "Kepler". */
+	const char	*chipName;		/*!< GPU chip family. E.g. "GK10x". */
+	int		thrFloat16;		/*!< Half-precision FMA throughput (0 if not supported natively). */
+	int		thrFloat32;		/*!< Single-precision FMA throughput (i.e. CUDA cores per multiprocessor). */
+	int		thrFloat64;		/*!< Double-precision FMA throughput (0 if not supported). */
+	int		thrInteger32;		/*!< 32-bit integer multiply-add throughput. Emulated cases are effective rates. */
+	int		thrSFU;			/*!< Special function unit throughput (rsqrt, sin, cos, ...). */
+	const char	*memType;		/*!< Typical memory type. E.g. "GDDR5". */
+	int		memDataRate;		/*!< Data transfers per memory clock reported by driver. */
+	int		hostLinkGen;		/*!< Typical PCI Express generation (0 for integrated GPUs). */
+	int		hostLinkWidth;		/*!< Typical PCI Express link width in lanes. */
+	int		l1CacheSize;		/*!< Default L1 cache size per multiprocessor in bytes. */
+	int		sharedPerMP;		/*!< Maximum shared memory per multiprocessor in bytes. */
+};
+
+const struct CZArchInfo *CZArchFind(int major, int minor);
+const char *CZArchName(int major, int minor);
+int CZArchCoresPerMP(int major, int minor);
+
+const char *CZMetricName(int metric);
+int CZMetricFind(const char *name);
+float CZMetricValue(const struct CZDeviceInfo *info, int metric);
+void CZMetricSetValue(struct CZDeviceInfo *info, int metric, float value);
+double CZArchCalcPeak(const struct CZDeviceInfo *info, int metric);
+double CZArchCalcEfficiency(const struct CZDeviceInfo *info, int metric);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_CUDAARCH_H
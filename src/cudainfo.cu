@@ -9,6 +9,8 @@
 #include <cuda_runtime.h>
 #include <host_defines.h>
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #if CUDA_VERSION < 5050
 #error CUDA 1.x - 5.0 are not supported any more! Please use CUDA Toolkit 5.5+ instead.
@@ -16,6 +18,12 @@
 
 #include "log.h"
 #include "cudainfo.h"
+#include "cudaarch.h"
+#include "czkernels.h"
+#include "cztimer.h"
+#include "czstat.h"
+#include "cztrace.h"
+#include "czbackend.h"
 
 #if (defined(WIN64) || defined(_WIN64) || defined(__WIN64__)) || (defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
 #define Q_OS_WIN
@@ -28,13 +36,12 @@
 #endif
 
 #define CZ_COPY_BUF_SIZE	(16 * (1 << 20))	/*!< Transfer buffer size. */
-#define CZ_COPY_LOOPS_NUM	8			/*!< Number of loops to run transfer test to. */
+#define CZ_COPY_QUICK_SIZE	(1 << 20)		/*!< Transfer buffer size in quick mode. */
+#define CZ_COPY_LOOPS_NUM	8			/*!< Number of measured loops to run transfer test to. */
+
+#define CZ_CALC_LOOPS_NUM	8			/*!< Number of measured loops to run performance test to. */
+#define CZ_CALC_SAFE_MS		500			/*!< Safe duration of one kernel launch on device with watchdog. */
 
-#define CZ_CALC_BLOCK_LOOPS	32			/*!< Number of loops to run calculation loop. */
-#define CZ_CALC_BLOCK_SIZE	256			/*!< Size of instruction block. */
-#define CZ_CALC_BLOCK_NUM	8			/*!< Number of instruction blocks in loop. */
-#define CZ_CALC_OPS_NUM		2			/*!< Number of operations per one loop. */
-#define CZ_CALC_LOOPS_NUM	8			/*!< Number of loops to run performance test to. */
 
 #define CZ_DEF_WARP_SIZE	32			/*!< Default warp size value. */
 #define CZ_DEF_THREADS_MAX	512			/*!< Default max threads value value. */
@@ -52,24 +59,92 @@
 		} \
 	}
 
+/*!	\brief Error handling of CUDA driver API calls.
+*/
+#define CZ_CUDA_DRV_CALL(funcCall, errProc) \
+	{ \
+		CUresult errCode; \
+		if((errCode = (funcCall)) != CUDA_SUCCESS) { \
+			CZLog(CZLogLevelError, "CUDA Driver Error: %08x", errCode); \
+			errProc; \
+		} \
+	}
+
 /*!	\brief Prototype of function \a cuDeviceGetAttribute().
 */
 typedef CUresult (CUDAAPI *cuDeviceGetAttribute_t)(int *pi, CUdevice_attribute attrib, CUdevice dev);
 
+/*!	\brief Prototype of function \a cuDeviceGet().
+*/
+typedef CUresult (CUDAAPI *cuDeviceGet_t)(CUdevice *device, int ordinal);
+
+/*!	\brief Prototype of function \a cuDeviceGetName().
+*/
+typedef CUresult (CUDAAPI *cuDeviceGetName_t)(char *name, int len, CUdevice dev);
+
 /*!	\brief Prototype of function \a cuInit().
 */
 typedef CUresult (CUDAAPI *cuInit_t)(unsigned int Flags);
 
+/*!	\brief Prototype of function \a cuModuleLoadDataEx().
+*/
+typedef CUresult (CUDAAPI *cuModuleLoadDataEx_t)(CUmodule *module, const void *image, unsigned int numOptions, CUjit_option *options, void **optionValues);
+
+/*!	\brief Prototype of function \a cuModuleGetFunction().
+*/
+typedef CUresult (CUDAAPI *cuModuleGetFunction_t)(CUfunction *hfunc, CUmodule hmod, const char *name);
+
+/*!	\brief Prototype of function \a cuModuleUnload().
+*/
+typedef CUresult (CUDAAPI *cuModuleUnload_t)(CUmodule hmod);
+
+/*!	\brief Prototype of function \a cuLaunchKernel().
+*/
+typedef CUresult (CUDAAPI *cuLaunchKernel_t)(CUfunction f,
+	unsigned int gridDimX, unsigned int gridDimY, unsigned int gridDimZ,
+	unsigned int blockDimX, unsigned int blockDimY, unsigned int blockDimZ,
+	unsigned int sharedMemBytes, CUstream hStream, void **kernelParams, void **extra);
+
 /*!	\brief Pointer to function \a cuDeviceGetAttribute().
 	This parameter is initializaed by CZCudaIsInit().
 */
 static cuDeviceGetAttribute_t p_cuDeviceGetAttribute = NULL;
 
+/*!	\brief Pointer to function \a cuDeviceGet().
+	This parameter is initializaed by CZCudaIsInit().
+*/
+static cuDeviceGet_t p_cuDeviceGet = NULL;
+
+/*!	\brief Pointer to function \a cuDeviceGetName().
+	This parameter is initializaed by CZCudaIsInit().
+*/
+static cuDeviceGetName_t p_cuDeviceGetName = NULL;
+
 /*!	\brief Pointer to function \a cuInit().
 	This parameter is initializaed by CZCudaIsInit().
 */
 static cuInit_t p_cuInit = NULL;
 
+/*!	\brief Pointer to function \a cuModuleLoadDataEx().
+	This parameter is initializaed by CZCudaIsInit().
+*/
+static cuModuleLoadDataEx_t p_cuModuleLoadDataEx = NULL;
+
+/*!	\brief Pointer to function \a cuModuleGetFunction().
+	This parameter is initializaed by CZCudaIsInit().
+*/
+static cuModuleGetFunction_t p_cuModuleGetFunction = NULL;
+
+/*!	\brief Pointer to function \a cuModuleUnload().
+	This parameter is initializaed by CZCudaIsInit().
+*/
+static cuModuleUnload_t p_cuModuleUnload = NULL;
+
+/*!	\brief Pointer to function \a cuLaunchKernel().
+	This parameter is initializaed by CZCudaIsInit().
+*/
+static cuLaunchKernel_t p_cuLaunchKernel = NULL;
+
 /*!	\brief Driver version string.
 */
 static char drvVersion[CZ_VER_STR_LEN] = "";
@@ -237,6 +312,17 @@ static bool CZCudaIsInit(void) {
 			return false;
 		}
 
+		p_cuModuleLoadDataEx = (cuModuleLoadDataEx_t)GetProcAddress(hDll, "cuModuleLoadDataEx");
+		p_cuModuleGetFunction = (cuModuleGetFunction_t)GetProcAddress(hDll, "cuModuleGetFunction");
+		p_cuModuleUnload = (cuModuleUnload_t)GetProcAddress(hDll, "cuModuleUnload");
+		p_cuLaunchKernel = (cuLaunchKernel_t)GetProcAddress(hDll, "cuLaunchKernel");
+		p_cuDeviceGet = (cuDeviceGet_t)GetProcAddress(hDll, "cuDeviceGet");
+		p_cuDeviceGetName = (cuDeviceGetName_t)GetProcAddress(hDll, "cuDeviceGetName");
+		if((p_cuModuleLoadDataEx == NULL) || (p_cuModuleGetFunction == NULL) ||
+			(p_cuModuleUnload == NULL) || (p_cuLaunchKernel == NULL)) {
+			return false;
+		}
+
 		CZGetDllVersion(CZ_DLL_FNAME, drvDllVerStr);
 
 		if(CZGetDllDescription(CZ_DLL_FNAME, description) != NULL) {
@@ -282,78 +368,39 @@ static bool CZCudaIsInit(void) {
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include "ldso.h"
 #define CZ_FILE_STR_LEN		256			/*!< Version file string length. */
 #define CZ_VER_FILE_NAME	"/proc/driver/nvidia/version"	/*!< Driver version file name. */
-#define CZ_PROC_MAP_NAME	"/proc/self/maps"	/*!< Process memory map file. */
 #define CZ_DLL_FNAME		"libcuda.so"		/*!< CUDA dll file name. */
+#define CZ_DLL_SONAME		"libcuda.so.1"		/*!< CUDA dll soname. */
 #define CZ_DLL_FNAME_RT		"libcudart.so"		/*!< CUDA RT dll file name. */
-#define CZ_LD_SO_CONF		"/etc/ld.so.conf"	/*!< ld.so configuration file. */
-#define CZ_LD_SO_DIR		"/etc/ld.so.conf.d/"	/*!< ld.so configuration directory. */
-#define CZ_LD_SO_LINE_MAX	100			/*!< ld.so configuration line length. */
 
-/*!	\brief Get version of shared library.
+/*!	\brief Get version of shared library loaded by this process.
 */
 static char *CZGetSoVersion(
-	char *name,			/*!<[in] Name of so file. E.g. "libcuda.so". */
+	const char *name,		/*!<[in] Name of so file. E.g. "libcuda.so". */
 	char *version			/*!<[out] Library version buffer. */
 ) {
-	FILE *fp = NULL;
-	char str[CZ_FILE_STR_LEN];
-	int found = 0;
+	CZLdSoPath path;
+	char *p;
 
-	fp = fopen(CZ_PROC_MAP_NAME, "r");
-	if(fp == NULL) {
+	if(CZLdSoLoaded(name, path, sizeof(path)) != 0)
 		return NULL;
-	}
-
-	while(fgets(str, CZ_FILE_STR_LEN - 1, fp) != NULL) {
-		if(strstr(str, name) != NULL) {
-			char *p = NULL;
-			char fname[CZ_FILE_STR_LEN];
 
-			p = str + strlen(str) - 1;
-			while((p >= str) && ((*p == ' ') || (*p == '\n') || (*p == '\r') || (*p == '\t') || (*p == 0))) {
-				*p = 0;
-				p--;
-			}
-
-			while((p >= str) && ((*p != ' ') && (*p != '\n') && (*p != '\r') && (*p != '\t') && (*p != 0))) {
-				p--;
-			}
-
-			strncpy(fname, p, CZ_FILE_STR_LEN - 1);
-			p = basename(fname);
-			if(p == NULL)
-				continue;
-
-			if(strstr(p, name) != p) {
-				continue;
-			}
-
-			p = p + strlen(name);
-			if(*p != '.')
-				continue;
-
-			strncpy(version, p + 1, CZ_VER_STR_LEN - 1);
-
-			found++;
-			break;
-		}
-	}
+	p = basename(path);
+	if((strstr(p, name) != p) || (p[strlen(name)] != '.'))
+		return NULL;
 
-	fclose(fp);
+	strncpy(version, p + strlen(name) + 1, CZ_VER_STR_LEN - 1);
 
-	if(found) {
-		CZLog(CZLogLevelLow, "Version of %s is %s.", name, version);
-		return version;
-	} else {
-		return NULL;
-	}
+	CZLog(CZLogLevelLow, "Version of %s is %s.", name, version);
+	return version;
 }
 
 /*!	\brief Check if CUDA fully initialized.
 	This function loads libcuda.so and finds functions \a cuInit()
-	and \a cuDeviceGetAttribute().
+	and \a cuDeviceGetAttribute(). Library is searched by CZLdSoFind(),
+	the dynamic linker is asked directly only if it is not found there.
 	\returns \a true in case of success, \a false in case of error.
 */
 static bool CZCudaIsInit(void) {
@@ -361,63 +408,21 @@ static bool CZCudaIsInit(void) {
 	void *hDll = NULL;
 
 	if((p_cuInit == NULL) || (p_cuDeviceGetAttribute == NULL)) {
+		CZLdSoPath paths[CZ_LD_SO_FIND_MAX];
+		int num;
 
-		if(hDll == NULL) {
-			hDll = dlopen(CZ_DLL_FNAME, RTLD_LAZY);
-		}
-
-		if(hDll == NULL) {
-			hDll = dlopen("/usr/lib/" CZ_DLL_FNAME, RTLD_LAZY);
-		}
-
-		if(hDll == NULL) {
-			hDll = dlopen("/usr/lib/nvidia-current/" CZ_DLL_FNAME, RTLD_LAZY);
-		}
-
-		if(hDll == NULL) {
-			hDll = dlopen("/usr/lib32/" CZ_DLL_FNAME, RTLD_LAZY);
-		}
-
-		if(hDll == NULL) {
-			hDll = dlopen("/usr/lib32/nvidia-current/" CZ_DLL_FNAME, RTLD_LAZY);
-		}
+		num = CZLdSoFind(CZ_DLL_SONAME, paths, CZ_LD_SO_FIND_MAX);
+		num += CZLdSoFind(CZ_DLL_FNAME, paths + num, CZ_LD_SO_FIND_MAX - num);
 
-		if(hDll == NULL) {
-			hDll = dlopen("/usr/lib64/" CZ_DLL_FNAME, RTLD_LAZY);
-		}
-
-		if(hDll == NULL) {
-			hDll = dlopen("/usr/lib64/nvidia-current/" CZ_DLL_FNAME, RTLD_LAZY);
-		}
-
-		if(hDll == NULL) {
-			hDll = dlopen("/usr/lib128/" CZ_DLL_FNAME, RTLD_LAZY);
-		}
-
-		if(hDll == NULL) {
-			hDll = dlopen("/usr/lib128/nvidia-current/" CZ_DLL_FNAME, RTLD_LAZY);
+		for(int i = 0; (i < num) && (hDll == NULL); i++) {
+			hDll = dlopen(paths[i], RTLD_LAZY);
+			if(hDll == NULL)
+				CZLog(CZLogLevelLow, "Can't load %s: %s", paths[i], dlerror());
 		}
 
-		// Try to check ld.so.conf & Co
-		if(hDll == NULL) {
-			char buf[CZ_LD_SO_LINE_MAX + sizeof(CZ_DLL_FNAME) + 1];
-			char *p;
-			FILE *f;
-
-			f = popen("cat " CZ_LD_SO_CONF " " CZ_LD_SO_DIR "/*", "r");
-			if(f != NULL) {
-				while(fgets(buf, CZ_LD_SO_LINE_MAX, f) != NULL) {
-					if((p = strchr(buf, '\n')) != NULL) *p = 0;
-					if((p = strchr(buf, '#')) != NULL) *p = 0;
-					if(strlen(buf) > 0) {
-						strcat(buf, "/" CZ_DLL_FNAME);
-						if(hDll == NULL) {
-							hDll = dlopen(buf, RTLD_LAZY);
-						}
-					}
-				}
-				pclose(f);
-			}
+		/* Linker may know more, e.g. run path of executable, but not in fixture root. */
+		if((hDll == NULL) && (CZLdSoRoot()[0] == 0)) {
+			hDll = dlopen(CZ_DLL_SONAME, RTLD_LAZY);
 		}
 
 		if(hDll == NULL) {
@@ -435,6 +440,17 @@ static bool CZCudaIsInit(void) {
 			return false;
 		}
 
+		p_cuModuleLoadDataEx = (cuModuleLoadDataEx_t)dlsym(hDll, "cuModuleLoadDataEx");
+		p_cuModuleGetFunction = (cuModuleGetFunction_t)dlsym(hDll, "cuModuleGetFunction");
+		p_cuModuleUnload = (cuModuleUnload_t)dlsym(hDll, "cuModuleUnload");
+		p_cuLaunchKernel = (cuLaunchKernel_t)dlsym(hDll, "cuLaunchKernel");
+		p_cuDeviceGet = (cuDeviceGet_t)dlsym(hDll, "cuDeviceGet");
+		p_cuDeviceGetName = (cuDeviceGetName_t)dlsym(hDll, "cuDeviceGetName");
+		if((p_cuModuleLoadDataEx == NULL) || (p_cuModuleGetFunction == NULL) ||
+			(p_cuModuleUnload == NULL) || (p_cuLaunchKernel == NULL)) {
+			return false;
+		}
+
 		CZGetSoVersion(CZ_DLL_FNAME, drvDllVerStr);
 		CZGetSoVersion(CZ_DLL_FNAME_RT, rtDllVerStr);
 
@@ -620,6 +636,17 @@ static bool CZCudaIsInit(void) {
 			return false;
 		}
 
+		p_cuModuleLoadDataEx = (cuModuleLoadDataEx_t)dlsym(hDll, "cuModuleLoadDataEx");
+		p_cuModuleGetFunction = (cuModuleGetFunction_t)dlsym(hDll, "cuModuleGetFunction");
+		p_cuModuleUnload = (cuModuleUnload_t)dlsym(hDll, "cuModuleUnload");
+		p_cuLaunchKernel = (cuLaunchKernel_t)dlsym(hDll, "cuLaunchKernel");
+		p_cuDeviceGet = (cuDeviceGet_t)dlsym(hDll, "cuDeviceGet");
+		p_cuDeviceGetName = (cuDeviceGetName_t)dlsym(hDll, "cuDeviceGetName");
+		if((p_cuModuleLoadDataEx == NULL) || (p_cuModuleGetFunction == NULL) ||
+			(p_cuModuleUnload == NULL) || (p_cuLaunchKernel == NULL)) {
+			return false;
+		}
+
 		if(CZCheckKextLoaded(CZ_KEXT_ID_GEFORCE))
 			CZGetKextVersion(CZ_KEXT_NAME_GEFORCE, drvVersion);
 
@@ -635,7 +662,7 @@ static bool CZCudaIsInit(void) {
 
 /*!	\brief Check if CUDA is present here.
 */
-bool CZCudaCheck(void) {
+static bool CZCudaRtCheck(void) {
 
 	if(!CZCudaIsInit())
 		return false;
@@ -660,7 +687,7 @@ bool CZCudaCheck(void) {
 /*!	\brief Check how many CUDA-devices are present.
 	\returns number of CUDA-devices in case of success, \a 0 if no CUDA-devies were found.
 */
-int CZCudaDeviceFound(void) {
+static int CZCudaRtDeviceFound(void) {
 
 	int count;
 
@@ -670,71 +697,30 @@ int CZCudaDeviceFound(void) {
 	return count;
 }
 
-/*!	\def ConvertSMVer2Cores(major, minor)
-	\brief Get number of CUDA cores per multiprocessor.
-	\link https://en.wikipedia.org/wiki/CUDA
-	\arg[in] major GPU Architecture major version.
-	\arg[in] minor GPU Architecture minor version.
-	\returns 0 if GPU Architecture is unknown, or number of CUDA cores per multiprocessor.
-*/
-#define ConvertSMVer2Cores(major, minor) \
-	(((major) == 1)? ( /* Tesla */ \
-		((minor) == 0)? 8: /* G80*/ \
-		((minor) == 1)? 8: /* G8x, G9x */ \
-		((minor) == 2)? 8: /* GT21x */ \
-		((minor) == 3)? 8: /* GT200 */ \
-		0): \
-	((major) == 2)? ( /* Fermi */ \
-		((minor) == 0)? 32: /* GF100, GF110 */ \
-		((minor) == 1)? 48: /* GF10x, FG11x */ \
-		0): \
-	((major) == 3)? ( /* Kepler */ \
-		((minor) == 0)? 192: /* GK10x */ \
-		((minor) == 2)? 192: /* GK20A */ \
-		((minor) == 5)? 192: /* GK11x, GK208 */ \
-		((minor) == 7)? 192: /* GK210 */ \
-		0): \
-	((major) == 5)? ( /* Maxwell */ \
-		((minor) == 0)? 128: /* GM10x */ \
-		((minor) == 2)? 128: /* GM20x */ \
-		((minor) == 3)? 128: /* GM20B */ \
-		0): \
-	((major) == 6)? ( /* Pascal */ \
-		((minor) == 0)? 64:  /* GP100 */ \
-		((minor) == 1)? 128: /* GP10x */ \
-		((minor) == 2)? 128: /* GP10B */ \
-		0): \
-	((major) == 7)? ( /* Volta */ \
-		((minor) == 0)? 64:  /* GV100 */ \
-		0): \
-	0)
-
-/*!	\def ConvertSMVer2ArchName(major, minor)
-	\brief Get a name of GPU Architecture.
-	\link https://en.wikipedia.org/wiki/CUDA
-	\arg[in] major GPU Architecture major version.
-	\arg[in] minor GPU Architecture minor version.
-	\returns "" if GPU Architecture is unknown, or a name of the architecture.
-*/
-#define ConvertSMVer2ArchName(major, minor) \
-	(((major) == 1)? "Tesla": \
-	((major) == 2)? "Fermi": \
-	((major) == 3)? "Kepler": \
-	((major) == 5)? "Maxwell": \
-	((major) == 6)? "Pascal": \
-	((major) == 7)? "Volta": \
-	"")
-
 /*!	\def COMPILE_ASSERT(cond)
 	\arg[in] cond Static condition.
 	\brief Compile time assert() for constant conditions.
 */
 #define COMPILE_ASSERT(cond)	{typedef char compile_assert_error[(cond)? 1: -1];}
 
+/*!	\brief Convert CUDA compute mode to #CZComputeMode.
+	Driver and runtime API use the same values of compute modes.
+	\returns compute mode, see enum #CZComputeMode.
+*/
+static int CZCudaComputeMode(
+	int mode			/*!<[in] CUDA compute mode. */
+) {
+	return
+		(mode == cudaComputeModeDefault)? CZComputeModeDefault:
+		(mode == cudaComputeModeExclusive)? CZComputeModeExclusive:
+		(mode == cudaComputeModeProhibited)? CZComputeModeProhibited:
+		CZComputeModeUnknown;
+}
+
 /*!	\brief Read information about a CUDA-device.
 	\returns \a 0 in case of success, \a -1 in case of error.
 */
-int CZCudaReadDeviceInfo(
+static int CZCudaRtReadDeviceInfo(
 	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
 	int num				/*!<[in] Number (index) of CUDA-device. */
 ) {
@@ -747,7 +733,7 @@ int CZCudaReadDeviceInfo(
 	if(!CZCudaIsInit())
 		return -1;
 
-	if(num >= CZCudaDeviceFound())
+	if(num >= CZCudaRtDeviceFound())
 		return -1;
 
 	CZ_CUDA_CALL(cudaGetDeviceProperties(&prop, num),
@@ -757,7 +743,7 @@ int CZCudaReadDeviceInfo(
 	strncpy(info->deviceName, prop.name, sizeof(info->deviceName));
 	info->major = prop.major;
 	info->minor = prop.minor;
-	strncpy(info->archName, ConvertSMVer2ArchName(prop.major, prop.minor), sizeof(info->archName));
+	strncpy(info->archName, CZArchName(prop.major, prop.minor), sizeof(info->archName));
 	info->drvVersion = drvVersion;
 	info->drvDllVer = drvDllVer;
 	info->drvDllVerStr = drvDllVerStr;
@@ -779,16 +765,12 @@ int CZCudaReadDeviceInfo(
 	info->core.watchdogEnabled = prop.kernelExecTimeoutEnabled;
 	info->core.integratedGpu = prop.integrated;
 	info->core.concurrentKernels = prop.concurrentKernels;
-	info->core.computeMode =
-		(prop.computeMode == cudaComputeModeDefault)? CZComputeModeDefault:
-		(prop.computeMode == cudaComputeModeExclusive)? CZComputeModeExclusive:
-		(prop.computeMode == cudaComputeModeProhibited)? CZComputeModeProhibited:
-		CZComputeModeUnknown;
+	info->core.computeMode = CZCudaComputeMode(prop.computeMode);
 	info->core.pciBusID = prop.pciBusID;
 	info->core.pciDeviceID = prop.pciDeviceID;
 	info->core.pciDomainID = prop.pciDomainID;
 	info->core.maxThreadsPerMultiProcessor = prop.maxThreadsPerMultiProcessor;
-	info->core.cudaCores = ConvertSMVer2Cores(prop.major, prop.minor) * prop.multiProcessorCount;
+	info->core.cudaCores = CZArchCoresPerMP(prop.major, prop.minor) * prop.multiProcessorCount;
 	info->core.streamPrioritiesSupported = prop.streamPrioritiesSupported;
 
 	info->mem.totalGlobal = prop.totalGlobalMem;
@@ -818,6 +800,55 @@ int CZCudaReadDeviceInfo(
 	return 0;
 }
 
+/*!	\brief Read versions, PCI location and name of a CUDA-device.
+	Attributes that can be changed without driver update (compute mode,
+	ECC, TCC driver, watchdog) are read here too, so they are never taken
+	from cache. Only driver API queries are used, so device is not initialized.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZCudaRtReadDeviceKey(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int num				/*!<[in] Number (index) of CUDA-device. */
+) {
+	CUdevice dev;
+	int computeMode;
+
+	if(info == NULL)
+		return -1;
+
+	if(!CZCudaIsInit() || (p_cuDeviceGet == NULL) || (p_cuDeviceGetName == NULL))
+		return -1;
+
+	CZ_CUDA_DRV_CALL(p_cuDeviceGet(&dev, num),
+		return -1);
+	CZ_CUDA_DRV_CALL(p_cuDeviceGetName(info->deviceName, sizeof(info->deviceName), dev),
+		return -1);
+	CZ_CUDA_DRV_CALL(p_cuDeviceGetAttribute(&info->core.pciBusID, CU_DEVICE_ATTRIBUTE_PCI_BUS_ID, dev),
+		return -1);
+	CZ_CUDA_DRV_CALL(p_cuDeviceGetAttribute(&info->core.pciDeviceID, CU_DEVICE_ATTRIBUTE_PCI_DEVICE_ID, dev),
+		return -1);
+	CZ_CUDA_DRV_CALL(p_cuDeviceGetAttribute(&info->core.pciDomainID, CU_DEVICE_ATTRIBUTE_PCI_DOMAIN_ID, dev),
+		return -1);
+	CZ_CUDA_DRV_CALL(p_cuDeviceGetAttribute(&info->core.watchdogEnabled, CU_DEVICE_ATTRIBUTE_KERNEL_EXEC_TIMEOUT, dev),
+		return -1);
+	CZ_CUDA_DRV_CALL(p_cuDeviceGetAttribute(&computeMode, CU_DEVICE_ATTRIBUTE_COMPUTE_MODE, dev),
+		return -1);
+	CZ_CUDA_DRV_CALL(p_cuDeviceGetAttribute(&info->mem.errorCorrection, CU_DEVICE_ATTRIBUTE_ECC_ENABLED, dev),
+		return -1);
+	CZ_CUDA_DRV_CALL(p_cuDeviceGetAttribute(&info->tccDriver, CU_DEVICE_ATTRIBUTE_TCC_DRIVER, dev),
+		return -1);
+	info->core.computeMode = CZCudaComputeMode(computeMode);
+
+	info->num = num;
+	info->drvVersion = drvVersion;
+	info->drvDllVer = drvDllVer;
+	info->drvDllVerStr = drvDllVerStr;
+	info->rtDllVer = rtDllVer;
+	info->rtDllVerStr = rtDllVerStr;
+
+	return 0;
+}
+
 /*!	\brief Local service data structure for bandwith calulations.
 */
 struct CZDeviceInfoBandLocalData {
@@ -825,11 +856,14 @@ struct CZDeviceInfoBandLocalData {
 	void		*memHostPin;	/*!< Pinned host memory. */
 	void		*memDevice1;	/*!< Device memory buffer 1. */
 	void		*memDevice2;	/*!< Device memory buffer 2. */
+	size_t		bufSize;	/*!< Size of every memory buffer. */
+	CUmodule	module;		/*!< Module of performance test kernels. Loaded on first use. */
+	CUfunction	kernel[CZ_CALC_MODE_NUM];	/*!< Performance test kernels. */
 };
 
 /*!	\brief Set device for current thread.
 */
-int CZCudaCalcDeviceSelect(
+static int CZCudaRtCalcDeviceSelect(
 	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
 ) {
 
@@ -841,69 +875,126 @@ int CZCudaCalcDeviceSelect(
 	return 0;
 }
 
-/*!	\brief Allocate buffers for bandwidth calculations.
+/*!	\brief Free copy buffers of bandwidth calculations.
+*/
+static void CZCudaCalcDeviceBandwidthFreeBuffers(
+	struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	CZDeviceInfoBandLocalData *lData	/*!<[in,out] Local service data. */
+) {
+	CZLog(CZLogLevelLow, "Free host pageable for %s.", info->deviceName);
+
+	if(lData->memHostPage != NULL)
+		free(lData->memHostPage);
+
+	CZLog(CZLogLevelLow, "Free host pinned for %s.", info->deviceName);
+
+	if(lData->memHostPin != NULL)
+		cudaFreeHost(lData->memHostPin);
+
+	CZLog(CZLogLevelLow, "Free device buffer 1 for %s.", info->deviceName);
+
+	if(lData->memDevice1 != NULL)
+		cudaFree(lData->memDevice1);
+
+	CZLog(CZLogLevelLow, "Free device buffer 2 for %s.", info->deviceName);
+
+	if(lData->memDevice2 != NULL)
+		cudaFree(lData->memDevice2);
+
+	lData->memHostPage = NULL;
+	lData->memHostPin = NULL;
+	lData->memDevice1 = NULL;
+	lData->memDevice2 = NULL;
+	lData->bufSize = 0;
+}
+
+/*!	\brief Allocate copy buffers of bandwidth calculations.
 	\returns \a 0 in case of success, \a -1 in case of error.
 */
-static int CZCudaCalcDeviceBandwidthAlloc(
-	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+static int CZCudaCalcDeviceBandwidthAllocBuffers(
+	struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	CZDeviceInfoBandLocalData *lData,	/*!<[in,out] Local service data. */
+	size_t bufSize			/*!<[in] Size of every memory buffer. */
 ) {
-	CZDeviceInfoBandLocalData *lData;
+	CZLog(CZLogLevelLow, "Alloc host pageable for %s.", info->deviceName);
 
-	if(info == NULL)
+	lData->memHostPage = (void*)malloc(bufSize);
+	if(lData->memHostPage == NULL)
 		return -1;
 
-	if(info->band.localData == NULL) {
+	CZLog(CZLogLevelLow, "Host pageable is at 0x%08X.", lData->memHostPage);
 
-		CZLog(CZLogLevelLow, "Alloc local buffers for %s.", info->deviceName);
+	CZLog(CZLogLevelLow, "Alloc host pinned for %s.", info->deviceName);
 
-		lData = (CZDeviceInfoBandLocalData*)malloc(sizeof(*lData));
-		if(lData == NULL) {
-			return -1;
-		}
+	CZ_CUDA_CALL(cudaMallocHost((void**)&lData->memHostPin, bufSize),
+		CZCudaCalcDeviceBandwidthFreeBuffers(info, lData);
+		return -1);
 
-		CZLog(CZLogLevelLow, "Alloc host pageable for %s.", info->deviceName);
+	CZLog(CZLogLevelLow, "Host pinned is at 0x%08X.", lData->memHostPin);
 
-		lData->memHostPage = (void*)malloc(CZ_COPY_BUF_SIZE);
-		if(lData->memHostPage == NULL) {
-			free(lData);
-			return -1;
-		}
+	CZLog(CZLogLevelLow, "Alloc device buffer 1 for %s.", info->deviceName);
 
-		CZLog(CZLogLevelLow, "Host pageable is at 0x%08X.", lData->memHostPage);
+	CZ_CUDA_CALL(cudaMalloc((void**)&lData->memDevice1, bufSize),
+		CZCudaCalcDeviceBandwidthFreeBuffers(info, lData);
+		return -1);
 
-		CZLog(CZLogLevelLow, "Alloc host pinned for %s.", info->deviceName);
+	CZLog(CZLogLevelLow, "Device buffer 1 is at 0x%08X.", lData->memDevice1);
 
-		CZ_CUDA_CALL(cudaMallocHost((void**)&lData->memHostPin, CZ_COPY_BUF_SIZE),
-			free(lData->memHostPage);
-			free(lData);
-			return -1);
+	CZLog(CZLogLevelLow, "Alloc device buffer 2 for %s.", info->deviceName);
 
-		CZLog(CZLogLevelLow, "Host pinned is at 0x%08X.", lData->memHostPin);
+	CZ_CUDA_CALL(cudaMalloc((void**)&lData->memDevice2, bufSize),
+		CZCudaCalcDeviceBandwidthFreeBuffers(info, lData);
+		return -1);
 
-		CZLog(CZLogLevelLow, "Alloc device buffer 1 for %s.", info->deviceName);
+	CZLog(CZLogLevelLow, "Device buffer 2 is at 0x%08X.", lData->memDevice2);
 
-		CZ_CUDA_CALL(cudaMalloc((void**)&lData->memDevice1, CZ_COPY_BUF_SIZE),
-			cudaFreeHost(lData->memHostPin);
-			free(lData->memHostPage);
-			free(lData);
-			return -1);
+	lData->bufSize = bufSize;
+
+	return 0;
+}
 
-		CZLog(CZLogLevelLow, "Device buffer 1 is at 0x%08X.", lData->memDevice1);
+/*!	\brief Allocate buffers for bandwidth calculations.
+	Buffers allocated in quick mode are too small for full tests, so they
+	are allocated again when device is used in full mode later. Loaded
+	kernel module is kept.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZCudaCalcDeviceBandwidthAlloc(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	CZDeviceInfoBandLocalData *lData;
+	size_t bufSize;
+
+	if(info == NULL)
+		return -1;
 
-		CZLog(CZLogLevelLow, "Alloc device buffer 2 for %s.", info->deviceName);
+	bufSize = info->quickMode? CZ_COPY_QUICK_SIZE: CZ_COPY_BUF_SIZE;
 
-		CZ_CUDA_CALL(cudaMalloc((void**)&lData->memDevice2, CZ_COPY_BUF_SIZE),
-			cudaFree(lData->memDevice1);
-			cudaFreeHost(lData->memHostPin);
-			free(lData->memHostPage);
-			free(lData);
-			return -1);
+	lData = (CZDeviceInfoBandLocalData*)info->band.localData;
+	if((lData != NULL) && (lData->bufSize >= bufSize))
+		return 0;
 
-		CZLog(CZLogLevelLow, "Device buffer 2 is at 0x%08X.", lData->memDevice2);
+	double traceMs = CZTraceStart();
+
+	if(lData == NULL) {
+		CZLog(CZLogLevelLow, "Alloc local buffers for %s.", info->deviceName);
 
+		lData = (CZDeviceInfoBandLocalData*)malloc(sizeof(*lData));
+		if(lData == NULL) {
+			return -1;
+		}
+		memset(lData, 0, sizeof(*lData));
 		info->band.localData = (void*)lData;
+	} else if(lData->bufSize != 0) {
+		CZLog(CZLogLevelLow, "Buffers of %s are too small for full mode, alloc them again.", info->deviceName);
+		CZCudaCalcDeviceBandwidthFreeBuffers(info, lData);
 	}
 
+	if(CZCudaCalcDeviceBandwidthAllocBuffers(info, lData, bufSize) != 0)
+		return -1;
+
+	CZTraceSpan(CZTracePhaseAlloc, info->num, -1, traceMs);
+
 	return 0;
 }
 
@@ -920,30 +1011,19 @@ static int CZCudaCalcDeviceBandwidthFree(
 
 	lData = (CZDeviceInfoBandLocalData*)info->band.localData;
 	if(lData != NULL) {
+		double traceMs = CZTraceStart();
 
-		CZLog(CZLogLevelLow, "Free host pageable for %s.", info->deviceName);
-
-		if(lData->memHostPage != NULL)
-			free(lData->memHostPage);
-
-		CZLog(CZLogLevelLow, "Free host pinned for %s.", info->deviceName);
+		CZCudaCalcDeviceBandwidthFreeBuffers(info, lData);
 
-		if(lData->memHostPin != NULL)
-			cudaFreeHost(lData->memHostPin);
-
-		CZLog(CZLogLevelLow, "Free device buffer 1 for %s.", info->deviceName);
-
-		if(lData->memDevice1 != NULL)
-			cudaFree(lData->memDevice1);
-
-		CZLog(CZLogLevelLow, "Free device buffer 2 for %s.", info->deviceName);
-
-		if(lData->memDevice2 != NULL)
-			cudaFree(lData->memDevice2);
+		if(lData->module != NULL) {
+			CZLog(CZLogLevelLow, "Unload kernel module for %s.", info->deviceName);
+			p_cuModuleUnload(lData->module);
+		}
 
 		CZLog(CZLogLevelLow, "Free local buffers for %s.", info->deviceName);
 
 		free(lData);
+		CZTraceSpan(CZTracePhaseFree, info->num, -1, traceMs);
 	}
 	info->band.localData = NULL;
 
@@ -965,6 +1045,7 @@ static int CZCudaCalcDeviceBandwidthReset(
 	info->band.copyDHPage = 0;
 	info->band.copyDHPin = 0;
 	info->band.copyDD = 0;
+	memset(&info->stat[CZMetricCopyHDPin], 0, (CZMetricCopyDD - CZMetricCopyHDPin + 1) * sizeof(info->stat[0]));
 
 	return 0;
 }
@@ -974,26 +1055,40 @@ static int CZCudaCalcDeviceBandwidthReset(
 #define CZ_COPY_MODE_D2D	2	/*!< Device to device data copy mode. */
 
 /*!	\brief Run data transfer bandwidth tests.
-	\returns \a 0 in case of success, \a other is value in KiB/s.
+	Every loop is measured separately, first \a info->warmupNum loops are
+	discarded and statistics of the rest is stored to \a stat. Number of
+	measured loops is chosen by CZStatLoopsDone().
+	\returns \a 0 in case of success, \a other is mean value in KiB/s.
 */
 static float CZCudaCalcDeviceBandwidthTestCommon (
 	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
 	int mode,			/*!<[in] Run bandwidth test in one of modes. */
-	int pinned			/*!<[in] Use pinned \a (=1) memory buffer instead of pagable \a (=0). */
+	int pinned,			/*!<[in] Use pinned \a (=1) memory buffer instead of pagable \a (=0). */
+	struct CZDeviceInfoStat *stat	/*!<[out] Statistics of test. */
 ) {
+	int metric =
+		(mode == CZ_COPY_MODE_H2D)? (pinned? CZMetricCopyHDPin: CZMetricCopyHDPage):
+		(mode == CZ_COPY_MODE_D2H)? (pinned? CZMetricCopyDHPin: CZMetricCopyDHPage):
+		CZMetricCopyDD;
 	CZDeviceInfoBandLocalData *lData;
 	float timeMs = 0.0;
-	float bandwidthKiBs = 0.0;
+	float loopKiBs[CZ_STAT_SAMPLES_MAX];
+	double startMs;
 	cudaEvent_t start;
 	cudaEvent_t stop;
 	void *memHost;
 	void *memDevice1;
 	void *memDevice2;
+	size_t copySize;
+	int warmupNum;
 	int i;
 
-	if(info == NULL)
+	if((info == NULL) || (stat == NULL))
 		return 0;
 
+	memset(stat, 0, sizeof(*stat));
+	warmupNum = CZStatWarmupNum(info);
+
 	CZ_CUDA_CALL(cudaEventCreate(&start),
 		return 0);
 
@@ -1007,6 +1102,16 @@ static float CZCudaCalcDeviceBandwidthTestCommon (
 	memDevice1 = lData->memDevice1;
 	memDevice2 = lData->memDevice2;
 
+	/* Buffers are allocated again by CZCudaCalcDeviceBandwidthAlloc() when quick mode is off. */
+	copySize = info->quickMode? CZ_COPY_QUICK_SIZE: CZ_COPY_BUF_SIZE;
+	if(copySize > lData->bufSize) {
+		CZLog(CZLogLevelError, "Buffers of %s are smaller than %d bytes, device is not prepared for full mode!",
+			info->deviceName, (int)copySize);
+		cudaEventDestroy(start);
+		cudaEventDestroy(stop);
+		return 0;
+	}
+
 	CZLog(CZLogLevelLow, "Starting %s test (%s) on %s.",
 		(mode == CZ_COPY_MODE_H2D)? "host to device":
 		(mode == CZ_COPY_MODE_D2H)? "device to host":
@@ -1014,32 +1119,37 @@ static float CZCudaCalcDeviceBandwidthTestCommon (
 		pinned? "pinned": "pageable",
 		info->deviceName);
 
-	for(i = 0; i < CZ_COPY_LOOPS_NUM; i++) {
+	startMs = CZTimerNow();
+
+	for(i = -warmupNum; ((i <= 0) && !CZStatStopped(info)) || !CZStatLoopsDone(info, loopKiBs, i, CZ_COPY_LOOPS_NUM, CZTimerNow() - startMs); i++) {
 
 		float loopMs = 0.0;
+		double loopTraceMs = CZTraceStart();
+		double traceMs;
 
 		CZ_CUDA_CALL(cudaEventRecord(start, 0),
 			cudaEventDestroy(start);
 			cudaEventDestroy(stop);
 			return 0);
 
+		traceMs = CZTraceStart();
 		switch(mode) {
 		case CZ_COPY_MODE_H2D:
-			CZ_CUDA_CALL(cudaMemcpy(memDevice1, memHost, CZ_COPY_BUF_SIZE, cudaMemcpyHostToDevice),
+			CZ_CUDA_CALL(cudaMemcpy(memDevice1, memHost, copySize, cudaMemcpyHostToDevice),
 				cudaEventDestroy(start);
 				cudaEventDestroy(stop);
 				return 0);
 			break;
 
 		case CZ_COPY_MODE_D2H:
-			CZ_CUDA_CALL(cudaMemcpy(memHost, memDevice2, CZ_COPY_BUF_SIZE, cudaMemcpyDeviceToHost),
+			CZ_CUDA_CALL(cudaMemcpy(memHost, memDevice2, copySize, cudaMemcpyDeviceToHost),
 				cudaEventDestroy(start);
 				cudaEventDestroy(stop);
 				return 0);
 			break;
 
 		case CZ_COPY_MODE_D2D:
-			CZ_CUDA_CALL(cudaMemcpy(memDevice2, memDevice1, CZ_COPY_BUF_SIZE, cudaMemcpyDeviceToDevice),
+			CZ_CUDA_CALL(cudaMemcpy(memDevice2, memDevice1, copySize, cudaMemcpyDeviceToDevice),
 				cudaEventDestroy(start);
 				cudaEventDestroy(stop);
 				return 0);
@@ -1050,40 +1160,50 @@ static float CZCudaCalcDeviceBandwidthTestCommon (
 			cudaEventDestroy(stop);
 			return 0;
 		}
+		CZTraceSpan(CZTracePhaseCopy, info->num, metric, traceMs);
 
 		CZ_CUDA_CALL(cudaEventRecord(stop, 0),
 			cudaEventDestroy(start);
 			cudaEventDestroy(stop);
 			return 0);
 
+		traceMs = CZTraceStart();
 		CZ_CUDA_CALL(cudaEventSynchronize(stop),
 			cudaEventDestroy(start);
 			cudaEventDestroy(stop);
 			return 0);
+		CZTraceSpan(CZTracePhaseSync, info->num, metric, traceMs);
 
 		CZ_CUDA_CALL(cudaEventElapsedTime(&loopMs, start, stop),
 			cudaEventDestroy(start);
 			cudaEventDestroy(stop);
 			return 0);
+		CZTraceSpan(CZTracePhaseLoop, info->num, metric, loopTraceMs);
+
+		if(i < 0) /* warm-up loop */
+			continue;
 
 		timeMs += loopMs;
+		loopKiBs[i] = (
+			1000 *
+			(float)copySize
+		) / (
+			loopMs *
+			(float)(1 << 10)
+		);
 	}
 
 	CZLog(CZLogLevelLow, "Test complete in %f ms.", timeMs);
-
-	bandwidthKiBs = (
-		1000 *
-		(float)CZ_COPY_BUF_SIZE *
-		(float)CZ_COPY_LOOPS_NUM
-	) / (
-		timeMs *
-		(float)(1 << 10)
-	);
+	CZTraceSpan(CZTracePhaseTest, info->num, metric, startMs);
 
 	cudaEventDestroy(start);
 	cudaEventDestroy(stop);
 
-	return bandwidthKiBs;
+	if(CZStatSubmit(info, metric, loopKiBs, i, stat) != 0)
+		return 0;
+	CZStatLog(stat, "KiB/s");
+
+	return stat->mean;
 }
 
 /*!	\brief Run several bandwidth tests.
@@ -1093,11 +1213,11 @@ static int CZCudaCalcDeviceBandwidthTest(
 	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
 ) {
 
-	info->band.copyHDPage = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_H2D, 0);
-	info->band.copyHDPin = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_H2D, 1);
-	info->band.copyDHPage = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_D2H, 0);
-	info->band.copyDHPin = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_D2H, 1);
-	info->band.copyDD = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_D2D, 0);
+	info->band.copyHDPage = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_H2D, 0, &info->stat[CZMetricCopyHDPage]);
+	info->band.copyHDPin = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_H2D, 1, &info->stat[CZMetricCopyHDPin]);
+	info->band.copyDHPage = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_D2H, 0, &info->stat[CZMetricCopyDHPage]);
+	info->band.copyDHPin = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_D2H, 1, &info->stat[CZMetricCopyDHPin]);
+	info->band.copyDD = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_D2D, 0, &info->stat[CZMetricCopyDD]);
 
 	return 0;
 }
@@ -1105,9 +1225,10 @@ static int CZCudaCalcDeviceBandwidthTest(
 /*!	\brief Prepare buffers bandwidth tests.
 	\returns \a 0 in case of success, \a -1 in case of error.
 */
-int CZCudaPrepareDevice(
+static int CZCudaRtPrepareDevice(
 	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
 ) {
+	double startMs;
 
 	if(info == NULL)
 		return -1;
@@ -1115,16 +1236,20 @@ int CZCudaPrepareDevice(
 	if(!CZCudaIsInit())
 		return -1;
 
+	startMs = CZTimerNow();
+
 	if(CZCudaCalcDeviceBandwidthAlloc(info) != 0)
 		return -1;
 
+	CZLog(CZLogLevelModerate, "Device %s prepared in %.1f ms.", info->deviceName, CZTimerNow() - startMs);
+
 	return 0;
 }
 
 /*!	\brief Calculate bandwidth information about CUDA-device.
 	\returns \a 0 in case of success, \a -1 in case of error.
 */
-int CZCudaCalcDeviceBandwidth(
+static int CZCudaRtCalcDeviceBandwidth(
 	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
 ) {
 
@@ -1149,7 +1274,7 @@ int CZCudaCalcDeviceBandwidth(
 /*!	\brief Cleanup after test and bandwidth calculations.
 	\returns \a 0 in case of success, \a -1 in case of error.
 */
-int CZCudaCleanDevice(
+static int CZCudaRtCleanDevice(
 	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
 ) {
 
@@ -1177,268 +1302,213 @@ static int CZCudaCalcDevicePerformanceReset(
 	info->perf.calcInteger32 = 0;
 	info->perf.calcInteger24 = 0;
 	info->perf.calcInteger64 = 0;
+	memset(&info->stat[CZMetricCalcFloat], 0, (CZMetricCalcInteger24 - CZMetricCalcFloat + 1) * sizeof(info->stat[0]));
 
 	return 0;
 }
 
-/*!	\brief 16 MAD instructions for float point test.
-*/
-#define CZ_CALC_FMAD_16(a, b) \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-
-/*!	\brief 256 MAD instructions for float point test.
-*/
-#define CZ_CALC_FMAD_256(a, b) \
-	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
-	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
-	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
-	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
-	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
-	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
-	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
-	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
-
-/*!	\brief 16 DMAD instructions for double-precision test.
-*/
-#define CZ_CALC_DFMAD_16(a, b) \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-
-/*	a = fma(a, a, a); b = fma(b, b, b); a = fma(a, a, a); b = fma(b, b, b); \
-	a = fma(a, a, a); b = fma(b, b, b); a = fma(a, a, a); b = fma(b, b, b); \
-	a = fma(a, a, a); b = fma(b, b, b); a = fma(a, a, a); b = fma(b, b, b); \
-	a = fma(a, a, a); b = fma(b, b, b); a = fma(a, a, a); b = fma(b, b, b); \*/
-
-/*!	\brief 256 MAD instructions for float point test.
-*/
-#define CZ_CALC_DFMAD_256(a, b) \
-	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
-	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
-	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
-	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
-	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
-	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
-	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
-	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
-
-/*!	\brief 16 MAD instructions for 32-bit integer test.
-*/
-#define CZ_CALC_IMAD32_16(a, b) \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-
-/*!	\brief 256 MAD instructions for 32-bit integer test.
-*/
-#define CZ_CALC_IMAD32_256(a, b) \
-	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
-	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
-	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
-	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
-	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
-	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
-	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
-	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
-
-/*!	\brief 16 MAD instructions for 64-bit integer test.
-*/
-#define CZ_CALC_IMAD64_16(a, b) \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
-
-/*!	\brief 256 MAD instructions for 64-bit integer test.
-*/
-#define CZ_CALC_IMAD64_256(a, b) \
-	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
-	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
-	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
-	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
-	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
-	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
-	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
-	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
-
-/*!	\brief 16 MAD instructions for 24-bit integer test.
-*/
-#define CZ_CALC_IMAD24_16(a, b) \
-	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
-	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
-	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
-	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
-	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
-	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
-	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
-	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
-
-/*!	\brief 256 MAD instructions for 24-bit integer test.
-*/
-#define CZ_CALC_IMAD24_256(a, b) \
-	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
-	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
-	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
-	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
-	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
-	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
-	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
-	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
-
-#define CZ_CALC_MODE_FLOAT	0	/*!< Single-precision float point test mode. */
-#define CZ_CALC_MODE_DOUBLE	1	/*!< Double-precision float point test mode. */
-#define CZ_CALC_MODE_INTEGER32	2	/*!< 32-bit integer test mode. */
-#define CZ_CALC_MODE_INTEGER24	3	/*!< 24-bit integer test mode. */
-#define CZ_CALC_MODE_INTEGER64	4	/*!< 64-bit integer test mode. */
-
-/*!	\brief GPU code for float point test.
-*/
-__global__ void CZCudaCalcKernelFloat(
-	void *buf			/*!<[in] Data buffer. */
+/*!	\brief Find kernel image suitable for CUDA-device.
+	Cubin of the same major revision and the highest minor revision not
+	above device's one is preferred. PTX of the highest architecture not
+	above device's one is used as fallback and compiled by driver.
+	\returns pointer to image, \a NULL if no suitable image was found.
+*/
+static const struct CZKernelImage *CZCudaFindKernelImage(
+	struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
 ) {
-	int index = blockIdx.x * blockDim.x + threadIdx.x;
-	float *arr = (float*)buf;
-	float val1 = index;
-	float val2 = arr[index];
+	const struct CZKernelImage *cubin = NULL;
+	const struct CZKernelImage *ptx = NULL;
+	int arch = info->major * 10 + info->minor;
 	int i;
 
-	for(i = 0; i < CZ_CALC_BLOCK_LOOPS; i++) {
-		CZ_CALC_FMAD_256(val1, val2);
-		CZ_CALC_FMAD_256(val1, val2);
-		CZ_CALC_FMAD_256(val1, val2);
-		CZ_CALC_FMAD_256(val1, val2);
-		CZ_CALC_FMAD_256(val1, val2);
-		CZ_CALC_FMAD_256(val1, val2);
-		CZ_CALC_FMAD_256(val1, val2);
-		CZ_CALC_FMAD_256(val1, val2);
+	for(i = 0; i < CZKernelImageNum; i++) {
+		const struct CZKernelImage *image = &CZKernelImageTab[i];
+
+		if(image->arch > arch)
+			continue;
+
+		if(image->isPtx) {
+			if((ptx == NULL) || (image->arch > ptx->arch))
+				ptx = image;
+		} else if((image->arch / 10) == info->major) {
+			if((cubin == NULL) || (image->arch > cubin->arch))
+				cubin = image;
+		}
 	}
 
-	arr[index] = val1 + val2;
+	return (cubin != NULL)? cubin: ptx;
 }
 
-/*!	\brief GPU code for double-precision test.
+/*!	\brief Load module of performance test kernels.
+	Only the image matching CUDA-device is loaded and only on first use.
+	\returns \a 0 in case of success, \a -1 in case of error.
 */
-__global__ void CZCudaCalcKernelDouble(
-	void *buf			/*!<[in] Data buffer. */
+static int CZCudaCalcDeviceKernelLoad(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
 ) {
-	int index = blockIdx.x * blockDim.x + threadIdx.x;
-	double *arr = (double*)buf;
-	double val1 = index;
-	double val2 = arr[index];
+	static const char *kernelNames[CZ_CALC_MODE_NUM] = CZ_CALC_KERNEL_NAMES;
+	CZDeviceInfoBandLocalData *lData;
+	const struct CZKernelImage *image;
+	CUmodule module;
+	double startMs;
 	int i;
 
-	for(i = 0; i < CZ_CALC_BLOCK_LOOPS; i++) {
-		CZ_CALC_DFMAD_256(val1, val2);
-		CZ_CALC_DFMAD_256(val1, val2);
-		CZ_CALC_DFMAD_256(val1, val2);
-		CZ_CALC_DFMAD_256(val1, val2);
-		CZ_CALC_DFMAD_256(val1, val2);
-		CZ_CALC_DFMAD_256(val1, val2);
-		CZ_CALC_DFMAD_256(val1, val2);
-		CZ_CALC_DFMAD_256(val1, val2);
+	lData = (CZDeviceInfoBandLocalData*)info->band.localData;
+	if(lData == NULL)
+		return -1;
+
+	if(lData->module != NULL)
+		return 0;
+
+	image = CZCudaFindKernelImage(info);
+	if(image == NULL) {
+		CZLog(CZLogLevelError, "No kernel image for compute capability %d.%d of %s.",
+			info->major, info->minor, info->deviceName);
+		return -1;
 	}
 
-	arr[index] = val1 + val2;
-}
+	startMs = CZTimerNow();
 
-/*!	\brief GPU code for 32-bit integer test.
-*/
-__global__ void CZCudaCalcKernelInteger32(
-	void *buf			/*!<[in] Data buffer. */
-) {
-	int index = blockIdx.x * blockDim.x + threadIdx.x;
-	int *arr = (int*)buf;
-	int val1 = index;
-	int val2 = arr[index];
-	int i;
+	CZ_CUDA_DRV_CALL(p_cuModuleLoadDataEx(&module, image->data, 0, NULL, NULL),
+		return -1);
 
-	for(i = 0; i < CZ_CALC_BLOCK_LOOPS; i++) {
-		CZ_CALC_IMAD32_256(val1, val2);
-		CZ_CALC_IMAD32_256(val1, val2);
-		CZ_CALC_IMAD32_256(val1, val2);
-		CZ_CALC_IMAD32_256(val1, val2);
-		CZ_CALC_IMAD32_256(val1, val2);
-		CZ_CALC_IMAD32_256(val1, val2);
-		CZ_CALC_IMAD32_256(val1, val2);
-		CZ_CALC_IMAD32_256(val1, val2);
+	for(i = 0; i < CZ_CALC_MODE_NUM; i++) {
+		CZ_CUDA_DRV_CALL(p_cuModuleGetFunction(&lData->kernel[i], module, kernelNames[i]),
+			p_cuModuleUnload(module);
+			return -1);
 	}
 
-	arr[index] = val1 + val2;
+	lData->module = module;
+
+	CZLog(CZLogLevelModerate, "Kernel image %s_%d (%u bytes) loaded for %s in %.1f ms.",
+		image->isPtx? "compute": "sm", image->arch, image->size, info->deviceName, CZTimerNow() - startMs);
+
+	return 0;
 }
 
-/*!	\brief GPU code for 24-bit integer test.
+/*!	\brief Launch GPU calculation kernel.
+	Calculation loops of every thread are split into launches of at most
+	\a chunkLoops loops. Kernels without loop parameter (\a loopsNum is \a 0)
+	are launched once.
+	\returns \a 0 in case of success, \a -1 in case of error.
 */
-__global__ void CZCudaCalcKernelInteger24(
-	void *buf			/*!<[in] Data buffer. */
+static int CZCudaCalcDeviceKernelLaunch(
+	CUfunction kernel,		/*!<[in] Kernel to run. */
+	int blocksNum,			/*!<[in] Number of blocks. */
+	int threadsNum,			/*!<[in] Number of threads in block. */
+	void **kernelParams,		/*!<[in] Kernel parameters, the second one points to \a *launchLoops. */
+	int *launchLoops,		/*!<[out] Number of loops of current launch. */
+	int loopsNum,			/*!<[in] Total number of loops. */
+	int chunkLoops			/*!<[in] Maximal number of loops of one launch. */
 ) {
-	int index = blockIdx.x * blockDim.x + threadIdx.x;
-	int *arr = (int*)buf;
-	int val1 = index;
-	int val2 = arr[index];
-	int i;
+	int loopsDone = 0;
 
-	for(i = 0; i < CZ_CALC_BLOCK_LOOPS; i++) {
-		CZ_CALC_IMAD24_256(val1, val2);
-		CZ_CALC_IMAD24_256(val1, val2);
-		CZ_CALC_IMAD24_256(val1, val2);
-		CZ_CALC_IMAD24_256(val1, val2);
-		CZ_CALC_IMAD24_256(val1, val2);
-		CZ_CALC_IMAD24_256(val1, val2);
-		CZ_CALC_IMAD24_256(val1, val2);
-		CZ_CALC_IMAD24_256(val1, val2);
-	}
+	do {
+		*launchLoops = ((loopsNum - loopsDone) < chunkLoops)? (loopsNum - loopsDone): chunkLoops;
 
-	arr[index] = val1 + val2;
+		CZ_CUDA_DRV_CALL(p_cuLaunchKernel(kernel,
+			blocksNum, 1, 1, threadsNum, 1, 1, 0, NULL, kernelParams, NULL),
+			return -1);
+
+		CZ_CUDA_CALL(cudaGetLastError(),
+			return -1);
+
+		loopsDone += *launchLoops;
+	} while(loopsDone < loopsNum);
+
+	return 0;
 }
 
-/*!	\brief GPU code for 64-bit integer test.
+/*!	\brief Choose number of calculation loops of one kernel launch.
+	On devices with kernel run time limit the duration of one loop is
+	estimated with calibration launch, and work is split into launches
+	shorter than #CZ_CALC_SAFE_MS. Otherwise all loops run in one launch.
+	\returns number of loops of one launch.
 */
-__global__ void CZCudaCalcKernelInteger64(
-	void *buf			/*!<[in] Data buffer. */
+static int CZCudaCalcDeviceKernelChunk(
+	struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	CUfunction kernel,		/*!<[in] Kernel to run. */
+	const char *testName,		/*!<[in] Name of test for logging. */
+	int blocksNum,			/*!<[in] Number of blocks. */
+	int threadsNum,			/*!<[in] Number of threads in block. */
+	void **kernelParams,		/*!<[in] Kernel parameters. */
+	int *launchLoops,		/*!<[out] Number of loops of current launch. */
+	int loopsNum			/*!<[in] Total number of loops. */
 ) {
-	int index = blockIdx.x * blockDim.x + threadIdx.x;
-	long long *arr = (long long*)buf;
-	long long val1 = index;
-	long long val2 = arr[index];
-	int i;
-
-	for(i = 0; i < CZ_CALC_BLOCK_LOOPS; i++) {
-		CZ_CALC_IMAD64_256(val1, val2);
-		CZ_CALC_IMAD64_256(val1, val2);
-		CZ_CALC_IMAD64_256(val1, val2);
-		CZ_CALC_IMAD64_256(val1, val2);
-		CZ_CALC_IMAD64_256(val1, val2);
-		CZ_CALC_IMAD64_256(val1, val2);
-		CZ_CALC_IMAD64_256(val1, val2);
-		CZ_CALC_IMAD64_256(val1, val2);
+	double calibMs;
+	double traceMs;
+	int chunkLoops;
+
+	if(!info->core.watchdogEnabled)
+		return loopsNum;
+
+	calibMs = CZTimerNow();
+	traceMs = CZTraceStart();
+	if(CZCudaCalcDeviceKernelLaunch(kernel, blocksNum, threadsNum, kernelParams, launchLoops, (loopsNum > 0)? 1: 0, 1) != 0)
+		return loopsNum;
+	CZTraceSpan(CZTracePhaseLaunch, info->num, -1, traceMs);
+
+	traceMs = CZTraceStart();
+	if(cudaDeviceSynchronize() != cudaSuccess)
+		return loopsNum;
+	CZTraceSpan(CZTracePhaseSync, info->num, -1, traceMs);
+	calibMs = CZTimerNow() - calibMs;
+
+	if(loopsNum == 0) {
+		if(calibMs > CZ_CALC_SAFE_MS)
+			CZLog(CZLogLevelWarning, "Kernel %s runs %.0f ms on %s with watchdog and can't be split.",
+				testName, calibMs, info->deviceName);
+		return 0;
 	}
 
-	arr[index] = val1 + val2;
+	chunkLoops = (calibMs > 0)? (int)(CZ_CALC_SAFE_MS / calibMs): loopsNum;
+	if(chunkLoops < 1)
+		chunkLoops = 1;
+	if(chunkLoops > loopsNum)
+		chunkLoops = loopsNum;
+
+	CZLog(CZLogLevelModerate, "Watchdog is enabled on %s, %s test loop takes %.2f ms, %d loop(s) per launch.",
+		info->deviceName, testName, calibMs, chunkLoops);
+
+	return chunkLoops;
 }
 
-/*!	\brief Run GPU calculation performace tests.
-	\returns \a 0 in case of success, \a -1 in case of error.
+/*!	\brief Run GPU calculation kernel and measure its performance.
+	Kernel takes a pointer to device buffer as the only parameter.
+	Every loop is measured separately, first \a info->warmupNum loops are
+	discarded and statistics of the rest is stored to \a stat. Number of
+	measured loops is chosen by CZStatLoopsDone(). On devices with watchdog
+	every loop may consist of several shorter launches, see CZCudaCalcDeviceKernelChunk().
+	\returns \a 0 in case of error, \a other is mean value in KOPS.
 */
-static float CZCudaCalcDevicePerformanceTest(
+static float CZCudaCalcDeviceKernelTest(
 	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
-	int mode			/*!<[in] Run performance test in one of modes. */
+	CUfunction kernel,		/*!<[in] Kernel to run. */
+	const char *testName,		/*!<[in] Name of test for logging. */
+	double opsPerThread,		/*!<[in] Number of operations done by one thread. */
+	int loopsNum,			/*!<[in] Number of calculation loops passed to kernel, \a 0 if kernel takes no loop parameter. */
+	int metric,			/*!<[in] Measured metric, \a -1 for user-supplied kernel. */
+	struct CZDeviceInfoStat *stat	/*!<[out] Statistics of test. */
 ) {
 	CZDeviceInfoBandLocalData *lData;
 	float timeMs = 0.0;
-	float performanceKOPs = 0.0;
+	float loopKOPs[CZ_STAT_SAMPLES_MAX];
+	double startMs;
 	cudaEvent_t start;
 	cudaEvent_t stop;
-	int blocksNum = info->heavyMode? info->core.muliProcCount: 1;
+	int blocksNum;
+	int warmupNum;
+	int chunkLoops;
+	int launchLoops;
 	int i;
 
-	if(info == NULL)
+	if((info == NULL) || (stat == NULL))
 		return 0;
 
+	memset(stat, 0, sizeof(*stat));
+	blocksNum = info->heavyMode? info->core.muliProcCount: 1;
+	warmupNum = CZStatWarmupNum(info);
+
 	CZ_CUDA_CALL(cudaEventCreate(&start),
 		return 0);
 
@@ -1447,6 +1517,7 @@ static float CZCudaCalcDevicePerformanceTest(
 		return 0);
 
 	lData = (CZDeviceInfoBandLocalData*)info->band.localData;
+	void *kernelParams[] = {&lData->memDevice1, &launchLoops};
 
 	int threadsNum = info->core.maxThreadsPerBlock;
 	if(threadsNum == 0) {
@@ -1459,96 +1530,124 @@ static float CZCudaCalcDevicePerformanceTest(
 	}
 
 	CZLog(CZLogLevelLow, "Starting %s test on %s on %d block(s) %d thread(s) each.",
-		(mode == CZ_CALC_MODE_FLOAT)? "single-precision float":
-		(mode == CZ_CALC_MODE_DOUBLE)? "double-precision float":
-		(mode == CZ_CALC_MODE_INTEGER32)? "32-bit integer":
-		(mode == CZ_CALC_MODE_INTEGER24)? "24-bit integer":
-		(mode == CZ_CALC_MODE_INTEGER64)? "64-bit integer": "unknown",
+		testName,
 		info->deviceName,
 		blocksNum,
 		threadsNum);
 
-	for(i = 0; i < CZ_CALC_LOOPS_NUM; i++) {
+	chunkLoops = CZCudaCalcDeviceKernelChunk(info, kernel, testName, blocksNum, threadsNum, kernelParams, &launchLoops, loopsNum);
+
+	startMs = CZTimerNow();
+
+	for(i = -warmupNum; ((i <= 0) && !CZStatStopped(info)) || !CZStatLoopsDone(info, loopKOPs, i, CZ_CALC_LOOPS_NUM, CZTimerNow() - startMs); i++) {
 
 		float loopMs = 0.0;
+		double loopTraceMs = CZTraceStart();
+		double traceMs;
 
 		CZ_CUDA_CALL(cudaEventRecord(start, 0),
 			cudaEventDestroy(start);
 			cudaEventDestroy(stop);
 			return 0);
 
-		switch(mode) {
-		case CZ_CALC_MODE_FLOAT:
-			CZCudaCalcKernelFloat<<<blocksNum, threadsNum>>>(lData->memDevice1);
-			break;
-
-		case CZ_CALC_MODE_DOUBLE:
-			CZCudaCalcKernelDouble<<<blocksNum, threadsNum>>>(lData->memDevice1);
-			break;
-
-		case CZ_CALC_MODE_INTEGER32:
-			CZCudaCalcKernelInteger32<<<blocksNum, threadsNum>>>(lData->memDevice1);
-			break;
-
-		case CZ_CALC_MODE_INTEGER24:
-			CZCudaCalcKernelInteger24<<<blocksNum, threadsNum>>>(lData->memDevice1);
-			break;
-
-		case CZ_CALC_MODE_INTEGER64:
-			CZCudaCalcKernelInteger64<<<blocksNum, threadsNum>>>(lData->memDevice1);
-			break;
-
-		default: // WTF!
+		traceMs = CZTraceStart();
+		if(CZCudaCalcDeviceKernelLaunch(kernel, blocksNum, threadsNum, kernelParams, &launchLoops, loopsNum, chunkLoops) != 0) {
 			cudaEventDestroy(start);
 			cudaEventDestroy(stop);
 			return 0;
 		}
-
-		CZ_CUDA_CALL(cudaGetLastError(),
-			cudaEventDestroy(start);
-			cudaEventDestroy(stop);
-			return 0);
+		CZTraceSpan(CZTracePhaseLaunch, info->num, metric, traceMs);
 
 		CZ_CUDA_CALL(cudaEventRecord(stop, 0),
 			cudaEventDestroy(start);
 			cudaEventDestroy(stop);
 			return 0);
 
+		traceMs = CZTraceStart();
 		CZ_CUDA_CALL(cudaEventSynchronize(stop),
 			cudaEventDestroy(start);
 			cudaEventDestroy(stop);
 			return 0);
+		CZTraceSpan(CZTracePhaseSync, info->num, metric, traceMs);
 
 		CZ_CUDA_CALL(cudaEventElapsedTime(&loopMs, start, stop),
 			cudaEventDestroy(start);
 			cudaEventDestroy(stop);
 			return 0);
+		CZTraceSpan(CZTracePhaseLoop, info->num, metric, loopTraceMs);
+
+		if(i < 0) /* warm-up loop */
+			continue;
 
 		timeMs += loopMs;
+		loopKOPs[i] = (
+			(float)info->core.muliProcCount *
+			(float)threadsNum *
+			(float)opsPerThread
+		) / (float)loopMs;
 	}
 
 	CZLog(CZLogLevelLow, "Test complete in %f ms.", timeMs);
-
-	performanceKOPs = (
-		(float)info->core.muliProcCount *
-		(float)CZ_CALC_LOOPS_NUM *
-		(float)threadsNum *
-		(float)CZ_CALC_BLOCK_LOOPS *
-		(float)CZ_CALC_OPS_NUM *
-		(float)CZ_CALC_BLOCK_SIZE *
-		(float)CZ_CALC_BLOCK_NUM
-	) / (float)timeMs;
+	CZTraceSpan(CZTracePhaseTest, info->num, metric, startMs);
 
 	cudaEventDestroy(start);
 	cudaEventDestroy(stop);
 
-	return performanceKOPs;
+	if(CZStatSubmit(info, metric, loopKOPs, i, stat) != 0)
+		return 0;
+	CZStatLog(stat, "KOPS");
+
+	return stat->mean;
+}
+
+/*!	\brief Run GPU calculation performace tests.
+	\returns \a 0 in case of error, \a other is value in KOPS.
+*/
+static float CZCudaCalcDevicePerformanceTest(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int mode,			/*!<[in] Run performance test in one of modes. */
+	struct CZDeviceInfoStat *stat	/*!<[out] Statistics of test. */
+) {
+	static const char *testNames[CZ_CALC_MODE_NUM] = {
+		"single-precision float",
+		"double-precision float",
+		"32-bit integer",
+		"24-bit integer",
+		"64-bit integer",
+	};
+	static const int testMetrics[CZ_CALC_MODE_NUM] = {
+		CZMetricCalcFloat,
+		CZMetricCalcDouble,
+		CZMetricCalcInteger32,
+		CZMetricCalcInteger24,
+		CZMetricCalcInteger64,
+	};
+	CZDeviceInfoBandLocalData *lData;
+	int loopsNum;
+
+	if(info == NULL)
+		return 0;
+
+	if((mode < 0) || (mode >= CZ_CALC_MODE_NUM) || (CZCudaCalcDeviceKernelLoad(info) != 0))
+		return 0;
+
+	lData = (CZDeviceInfoBandLocalData*)info->band.localData;
+	loopsNum = info->quickMode? CZ_CALC_QUICK_LOOPS: CZ_CALC_BLOCK_LOOPS;
+
+	return CZCudaCalcDeviceKernelTest(info, lData->kernel[mode], testNames[mode],
+		(double)loopsNum *
+		(double)CZ_CALC_OPS_NUM *
+		(double)CZ_CALC_BLOCK_SIZE *
+		(double)CZ_CALC_BLOCK_NUM,
+		loopsNum,
+		testMetrics[mode],
+		stat);
 }
 
 /*!	\brief Calculate performance information about CUDA-device.
 	\returns \a 0 in case of success, \a -1 in case of error.
 */
-int CZCudaCalcDevicePerformance(
+static int CZCudaRtCalcDevicePerformance(
 	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
 ) {
 
@@ -1561,13 +1660,353 @@ int CZCudaCalcDevicePerformance(
 	if(!CZCudaIsInit())
 		return -1;
 
-	info->perf.calcFloat = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_FLOAT);
+	info->perf.calcFloat = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_FLOAT, &info->stat[CZMetricCalcFloat]);
 	if(((info->major > 1)) ||
 		((info->major == 1) && (info->minor >= 3)))
-		info->perf.calcDouble = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_DOUBLE);
-	info->perf.calcInteger32 = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_INTEGER32);
-	info->perf.calcInteger24 = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_INTEGER24);
-	info->perf.calcInteger64 = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_INTEGER64);
+		info->perf.calcDouble = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_DOUBLE, &info->stat[CZMetricCalcDouble]);
+	info->perf.calcInteger32 = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_INTEGER32, &info->stat[CZMetricCalcInteger32]);
+	info->perf.calcInteger24 = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_INTEGER24, &info->stat[CZMetricCalcInteger24]);
+	info->perf.calcInteger64 = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_INTEGER64, &info->stat[CZMetricCalcInteger64]);
+
+	return 0;
+}
+
+/*!	\brief Run one bandwidth or performance test.
+	The result is stored in the corresponding field of \a info.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZCudaRtCalcDeviceTest(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int metric			/*!<[in] Test to run. See enum #CZMetric. */
+) {
+	float value = 0;
+
+	if(info == NULL)
+		return -1;
+
+	if(!CZCudaIsInit())
+		return -1;
+
+	if(CZCudaCalcDeviceBandwidthAlloc(info) != 0)
+		return -1;
+
+	switch(metric) {
+	case CZMetricCopyHDPin:
+		value = info->band.copyHDPin = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_H2D, 1, &info->stat[CZMetricCopyHDPin]);
+		break;
+	case CZMetricCopyHDPage:
+		value = info->band.copyHDPage = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_H2D, 0, &info->stat[CZMetricCopyHDPage]);
+		break;
+	case CZMetricCopyDHPin:
+		value = info->band.copyDHPin = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_D2H, 1, &info->stat[CZMetricCopyDHPin]);
+		break;
+	case CZMetricCopyDHPage:
+		value = info->band.copyDHPage = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_D2H, 0, &info->stat[CZMetricCopyDHPage]);
+		break;
+	case CZMetricCopyDD:
+		value = info->band.copyDD = CZCudaCalcDeviceBandwidthTestCommon(info, CZ_COPY_MODE_D2D, 0, &info->stat[CZMetricCopyDD]);
+		break;
+	case CZMetricCalcFloat:
+		value = info->perf.calcFloat = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_FLOAT, &info->stat[CZMetricCalcFloat]);
+		break;
+	case CZMetricCalcDouble:
+		if(((info->major > 1)) ||
+			((info->major == 1) && (info->minor >= 3)))
+			value = info->perf.calcDouble = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_DOUBLE, &info->stat[CZMetricCalcDouble]);
+		break;
+	case CZMetricCalcInteger64:
+		value = info->perf.calcInteger64 = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_INTEGER64, &info->stat[CZMetricCalcInteger64]);
+		break;
+	case CZMetricCalcInteger32:
+		value = info->perf.calcInteger32 = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_INTEGER32, &info->stat[CZMetricCalcInteger32]);
+		break;
+	case CZMetricCalcInteger24:
+		value = info->perf.calcInteger24 = CZCudaCalcDevicePerformanceTest(info, CZ_CALC_MODE_INTEGER24, &info->stat[CZMetricCalcInteger24]);
+		break;
+	default: // WTF!
+		return -1;
+	}
+
+	if(value == 0)
+		return -1;
 
 	return 0;
 }
+
+/*!	\brief Handle of NVRTC program.
+*/
+typedef struct _nvrtcProgram *CZNvrtcProgram;
+
+/*!	\brief Prototype of function \a nvrtcCreateProgram().
+*/
+typedef int (*nvrtcCreateProgram_t)(CZNvrtcProgram *prog, const char *src, const char *name, int numHeaders, const char * const *headers, const char * const *includeNames);
+
+/*!	\brief Prototype of function \a nvrtcCompileProgram().
+*/
+typedef int (*nvrtcCompileProgram_t)(CZNvrtcProgram prog, int numOptions, const char * const *options);
+
+/*!	\brief Prototype of functions \a nvrtcGetProgramLogSize() and \a nvrtcGetPTXSize().
+*/
+typedef int (*nvrtcGetSize_t)(CZNvrtcProgram prog, size_t *sizeRet);
+
+/*!	\brief Prototype of functions \a nvrtcGetProgramLog() and \a nvrtcGetPTX().
+*/
+typedef int (*nvrtcGetString_t)(CZNvrtcProgram prog, char *str);
+
+/*!	\brief Prototype of function \a nvrtcDestroyProgram().
+*/
+typedef int (*nvrtcDestroyProgram_t)(CZNvrtcProgram *prog);
+
+static nvrtcCreateProgram_t p_nvrtcCreateProgram = NULL;	/*!< Pointer to function \a nvrtcCreateProgram(). */
+static nvrtcCompileProgram_t p_nvrtcCompileProgram = NULL;	/*!< Pointer to function \a nvrtcCompileProgram(). */
+static nvrtcGetSize_t p_nvrtcGetProgramLogSize = NULL;		/*!< Pointer to function \a nvrtcGetProgramLogSize(). */
+static nvrtcGetString_t p_nvrtcGetProgramLog = NULL;		/*!< Pointer to function \a nvrtcGetProgramLog(). */
+static nvrtcGetSize_t p_nvrtcGetPTXSize = NULL;		/*!< Pointer to function \a nvrtcGetPTXSize(). */
+static nvrtcGetString_t p_nvrtcGetPTX = NULL;			/*!< Pointer to function \a nvrtcGetPTX(). */
+static nvrtcDestroyProgram_t p_nvrtcDestroyProgram = NULL;	/*!< Pointer to function \a nvrtcDestroyProgram(). */
+
+/*!	\brief List of NVRTC library names to try, newest first.
+*/
+static const char *nvrtcDllNames[] = {
+#if defined(Q_OS_WIN)
+	"nvrtc64_120_0.dll",
+	"nvrtc64_112_0.dll",
+	"nvrtc64_111_0.dll",
+	"nvrtc64_110_0.dll",
+	"nvrtc64_102_0.dll",
+	"nvrtc64_101_0.dll",
+	"nvrtc64_100_0.dll",
+	"nvrtc64_92.dll",
+	"nvrtc64_91.dll",
+	"nvrtc64_90.dll",
+	"nvrtc64_80.dll",
+	"nvrtc64_75.dll",
+	"nvrtc64_70.dll",
+#elif defined(Q_OS_LINUX)
+	"libnvrtc.so",
+	"libnvrtc.so.12",
+	"libnvrtc.so.11.2",
+	"libnvrtc.so.11.1",
+	"libnvrtc.so.11.0",
+	"libnvrtc.so.10.2",
+	"libnvrtc.so.10.1",
+	"libnvrtc.so.10.0",
+	"libnvrtc.so.9.2",
+	"libnvrtc.so.9.1",
+	"libnvrtc.so.9.0",
+	"libnvrtc.so.8.0",
+#elif defined(Q_OS_MAC)
+	"libnvrtc.dylib",
+	"@rpath/libnvrtc.dylib",
+	"@executable_path/libnvrtc.dylib",
+	"/usr/local/cuda/lib/libnvrtc.dylib",
+#endif
+	NULL
+};
+
+#if defined(Q_OS_WIN)
+#define CZ_NVRTC_OPEN(name)	((void*)LoadLibraryA(name))
+#define CZ_NVRTC_SYM(h, name)	((void*)GetProcAddress((HMODULE)(h), name))
+#else
+#define CZ_NVRTC_OPEN(name)	dlopen(name, RTLD_LAZY)
+#define CZ_NVRTC_SYM(h, name)	dlsym(h, name)
+#endif
+
+/*!	\brief Check if NVRTC is loaded.
+	This function loads NVRTC library on first call and finds functions
+	needed for compilation of plugin kernels. On Linux library is searched
+	by CZLdSoFind(), the dynamic linker is asked directly only if it is
+	not found there.
+	\returns \a true in case of success, \a false in case of error.
+*/
+static bool CZNvrtcIsInit(void) {
+
+	void *hDll = NULL;
+	bool linker = true;
+	int i;
+
+	if(p_nvrtcCreateProgram != NULL)
+		return true;
+
+#if defined(Q_OS_LINUX)
+	for(i = 0; (hDll == NULL) && (nvrtcDllNames[i] != NULL); i++) {
+		CZLdSoPath paths[CZ_LD_SO_FIND_MAX];
+		int num = CZLdSoFind(nvrtcDllNames[i], paths, CZ_LD_SO_FIND_MAX);
+
+		for(int j = 0; (j < num) && (hDll == NULL); j++) {
+			hDll = CZ_NVRTC_OPEN(paths[j]);
+			if(hDll == NULL)
+				CZLog(CZLogLevelLow, "Can't load %s: %s", paths[j], dlerror());
+			else
+				CZLog(CZLogLevelLow, "NVRTC loaded from %s.", paths[j]);
+		}
+	}
+
+	/* Linker may know more, e.g. run path of executable, but not in fixture root. */
+	linker = (CZLdSoRoot()[0] == 0);
+#endif
+
+	for(i = 0; linker && (hDll == NULL) && (nvrtcDllNames[i] != NULL); i++) {
+		hDll = CZ_NVRTC_OPEN(nvrtcDllNames[i]);
+		if(hDll != NULL)
+			CZLog(CZLogLevelLow, "NVRTC loaded from %s.", nvrtcDllNames[i]);
+	}
+
+	if(hDll == NULL) {
+		CZLog(CZLogLevelError, "Can't load NVRTC library.");
+		return false;
+	}
+
+	p_nvrtcCreateProgram = (nvrtcCreateProgram_t)CZ_NVRTC_SYM(hDll, "nvrtcCreateProgram");
+	p_nvrtcCompileProgram = (nvrtcCompileProgram_t)CZ_NVRTC_SYM(hDll, "nvrtcCompileProgram");
+	p_nvrtcGetProgramLogSize = (nvrtcGetSize_t)CZ_NVRTC_SYM(hDll, "nvrtcGetProgramLogSize");
+	p_nvrtcGetProgramLog = (nvrtcGetString_t)CZ_NVRTC_SYM(hDll, "nvrtcGetProgramLog");
+	p_nvrtcGetPTXSize = (nvrtcGetSize_t)CZ_NVRTC_SYM(hDll, "nvrtcGetPTXSize");
+	p_nvrtcGetPTX = (nvrtcGetString_t)CZ_NVRTC_SYM(hDll, "nvrtcGetPTX");
+	p_nvrtcDestroyProgram = (nvrtcDestroyProgram_t)CZ_NVRTC_SYM(hDll, "nvrtcDestroyProgram");
+	if((p_nvrtcCreateProgram == NULL) || (p_nvrtcCompileProgram == NULL) ||
+		(p_nvrtcGetProgramLogSize == NULL) || (p_nvrtcGetProgramLog == NULL) ||
+		(p_nvrtcGetPTXSize == NULL) || (p_nvrtcGetPTX == NULL) ||
+		(p_nvrtcDestroyProgram == NULL)) {
+		CZLog(CZLogLevelError, "Can't find NVRTC functions.");
+		p_nvrtcCreateProgram = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+/*!	\brief Compile CUDA C source to PTX with NVRTC.
+	\returns PTX code allocated with malloc(), \a NULL in case of error.
+*/
+static char *CZNvrtcCompile(
+	struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	const char *source		/*!<[in] CUDA C source code. */
+) {
+	CZNvrtcProgram prog;
+	char arch[CZ_VER_STR_LEN];
+	const char *options[] = {arch};
+	size_t logSize = 0;
+	size_t ptxSize = 0;
+	char *ptx;
+	int r;
+
+	sprintf(arch, "--gpu-architecture=compute_%d%d", info->major, info->minor);
+
+	if(p_nvrtcCreateProgram(&prog, source, "plugin.cu", 0, NULL, NULL) != 0) {
+		CZLog(CZLogLevelError, "Can't create NVRTC program.");
+		return NULL;
+	}
+
+	r = p_nvrtcCompileProgram(prog, 1, options);
+
+	if((p_nvrtcGetProgramLogSize(prog, &logSize) == 0) && (logSize > 1)) {
+		char *log = (char*)malloc(logSize);
+		if(log != NULL) {
+			if(p_nvrtcGetProgramLog(prog, log) == 0)
+				CZLog((r == 0)? CZLogLevelLow: CZLogLevelError, "NVRTC log:\n%s", log);
+			free(log);
+		}
+	}
+
+	if(r != 0) {
+		CZLog(CZLogLevelError, "Can't compile plugin for %s (error %d).", arch, r);
+		p_nvrtcDestroyProgram(&prog);
+		return NULL;
+	}
+
+	if((p_nvrtcGetPTXSize(prog, &ptxSize) != 0) ||
+		((ptx = (char*)malloc(ptxSize)) == NULL)) {
+		p_nvrtcDestroyProgram(&prog);
+		return NULL;
+	}
+
+	if(p_nvrtcGetPTX(prog, ptx) != 0) {
+		free(ptx);
+		p_nvrtcDestroyProgram(&prog);
+		return NULL;
+	}
+
+	p_nvrtcDestroyProgram(&prog);
+
+	return ptx;
+}
+
+/*!	\brief Compile and run user-supplied calculation kernel.
+	Kernel must be declared as \a extern \a "C" \a __global__ \a void \a name(void \a *buf).
+	It is run in the same way as built-in performance tests, and result
+	is stored in \a info->perf.calcPlugin.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZCudaRtCalcDevicePlugin(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	const char *source,		/*!<[in] CUDA C source code. */
+	const char *kernelName,		/*!<[in] Name of kernel function. */
+	double opsPerThread		/*!<[in] Number of operations done by one thread. */
+) {
+	CUmodule module;
+	CUfunction kernel;
+	char *ptx;
+	double startMs;
+
+	if((info == NULL) || (source == NULL) || (kernelName == NULL) || (opsPerThread <= 0))
+		return -1;
+
+	info->perf.calcPlugin = 0;
+	memset(&info->perf.calcPluginStat, 0, sizeof(info->perf.calcPluginStat));
+	strncpy(info->perf.pluginName, kernelName, CZ_PLUGIN_NAME_LEN - 1);
+	info->perf.pluginName[CZ_PLUGIN_NAME_LEN - 1] = 0;
+
+	if(!CZCudaIsInit())
+		return -1;
+
+	if(!CZNvrtcIsInit())
+		return -1;
+
+	if(CZCudaCalcDeviceBandwidthAlloc(info) != 0)
+		return -1;
+
+	startMs = CZTimerNow();
+
+	ptx = CZNvrtcCompile(info, source);
+	if(ptx == NULL)
+		return -1;
+
+	CZ_CUDA_DRV_CALL(p_cuModuleLoadDataEx(&module, ptx, 0, NULL, NULL),
+		free(ptx);
+		return -1);
+	free(ptx);
+
+	CZ_CUDA_DRV_CALL(p_cuModuleGetFunction(&kernel, module, kernelName),
+		CZLog(CZLogLevelError, "Can't find kernel %s in plugin.", kernelName);
+		p_cuModuleUnload(module);
+		return -1);
+
+	CZLog(CZLogLevelModerate, "Plugin %s compiled in %.1f ms.", kernelName, CZTimerNow() - startMs);
+
+	info->perf.calcPlugin = CZCudaCalcDeviceKernelTest(info, kernel, kernelName, opsPerThread, 0, -1, &info->perf.calcPluginStat);
+
+	p_cuModuleUnload(module);
+
+	if(info->perf.calcPlugin == 0)
+		return -1;
+
+	return 0;
+}
+
+/*!	\brief CUDA runtime and driver API backend.
+*/
+const struct CZBackend CZBackendCuda = {
+	"cuda",
+	CZCudaRtCheck,
+	CZCudaRtDeviceFound,
+	CZCudaRtReadDeviceInfo,
+	CZCudaRtReadDeviceKey,
+	CZCudaRtCalcDeviceSelect,
+	CZCudaRtPrepareDevice,
+	CZCudaRtCalcDeviceBandwidth,
+	CZCudaRtCalcDevicePerformance,
+	CZCudaRtCalcDeviceTest,
+	CZCudaRtCalcDevicePlugin,
+	CZCudaRtCleanDevice,
+};
@@ -12,6 +12,9 @@
 extern "C" {
 #endif
 
+#define CZ_PLUGIN_NAME_LEN	64			/*!< Maximal length of plugin kernel name. */
+#define CZ_WARMUP_DEF_NUM	1			/*!< Default number of warm-up iterations of each test. */
+
 /*!	\brief Device compute mode.
 */
 enum CZComputeMode {
@@ -21,6 +24,22 @@ enum CZComputeMode {
 	CZComputeModeProhibited,		/*!< Compute-prohibited mode. */
 };
 
+/*!	\brief Measured metrics of CUDA-device.
+*/
+enum CZMetric {
+	CZMetricCopyHDPin = 0,			/*!< Copy rate from host pinned to device memory. */
+	CZMetricCopyHDPage,			/*!< Copy rate from host pageable to device memory. */
+	CZMetricCopyDHPin,			/*!< Copy rate from device to host pinned memory. */
+	CZMetricCopyDHPage,			/*!< Copy rate from device to host pageable memory. */
+	CZMetricCopyDD,				/*!< Copy rate from device to device memory. */
+	CZMetricCalcFloat,			/*!< Single-precision float point calculations performance. */
+	CZMetricCalcDouble,			/*!< Double-precision float point calculations performance. */
+	CZMetricCalcInteger64,			/*!< 64-bit integer calculations performance. */
+	CZMetricCalcInteger32,			/*!< 32-bit integer calculations performance. */
+	CZMetricCalcInteger24,			/*!< 24-bit integer calculations performance. */
+	CZMetricMax,				/*!< Number of metrics. */
+};
+
 /*!	\brief Information about CUDA-device core.
 */
 struct CZDeviceInfoCore {
@@ -64,6 +83,21 @@ struct CZDeviceInfoMem {
 	int		l2CacheSize;		/*!< L2 cache size in bytes. */
 };
 
+/*!	\brief Statistics of one measured metric over test iterations.
+	Values are in the same units as the metric itself.
+*/
+struct CZDeviceInfoStat {
+	int		samplesNum;		/*!< Number of measured iterations (warm-up ones are not counted). */
+	float		min;			/*!< Minimal value. */
+	float		max;			/*!< Maximal value. */
+	float		median;			/*!< Median value. */
+	float		mean;			/*!< Arithmetic mean value. */
+	float		p95;			/*!< 95th percentile. */
+	float		stddev;			/*!< Sample standard deviation. */
+	float		cv;			/*!< Coefficient of variation in percents. */
+	float		ci95;			/*!< Half-width of 95% confidence interval of mean relative to mean in percents. */
+};
+
 /*!	\brief Information about CUDA-device bandwidth.
 */
 struct CZDeviceInfoBand {
@@ -84,6 +118,9 @@ struct CZDeviceInfoPerf {
 	float		calcInteger32;		/*!< 32-bit integer calculations performance in KOPS. */
 	float		calcInteger24;		/*!< 24-bit integer calculations performance in KOPS. */
 	float		calcInteger64;		/*!< 64-bit integer calculations performance in KOPS. */
+	float		calcPlugin;		/*!< User-supplied kernel performance in KOPS. */
+	char		pluginName[CZ_PLUGIN_NAME_LEN];	/*!< Name of user-supplied kernel, empty if not tested. */
+	struct CZDeviceInfoStat	calcPluginStat;	/*!< Statistics of user-supplied kernel performance. */
 };
 
 /*!	\brief Information about CUDA-device.
@@ -91,6 +128,12 @@ struct CZDeviceInfoPerf {
 struct CZDeviceInfo {
 	int		num;			/*!< Device index. */
 	int		heavyMode;		/*!< Heavy test mode flag. */
+	int		quickMode;		/*!< Quick test mode flag, tests use short transfers and kernel launches. */
+	int		warmupNum;		/*!< Number of warm-up iterations discarded before each test. */
+	float		precision;		/*!< Target #CZDeviceInfoStat::ci95 of adaptive test mode in percents, \a 0 for fixed number of iterations. */
+	float		budgetMs;		/*!< Time budget of one test in adaptive mode in milliseconds, \a 0 for default. */
+	volatile int	*cancel;		/*!< Flag stopping running test after current iteration, may be \a NULL. */
+	double		deadlineMs;		/*!< Time by CZTimerNow() stopping running test after current iteration, \a 0 for no limit. */
 	char		deviceName[256];	/*!< ASCII string identifying the device name. */
 	int		major;			/*!< Major revision numbers defining the device's compute capability. */
 	int		minor;			/*!< Minor revision numbers defining the device's compute capability. */
@@ -105,6 +148,7 @@ struct CZDeviceInfo {
 	struct CZDeviceInfoMem	mem;
 	struct CZDeviceInfoBand	band;
 	struct CZDeviceInfoPerf	perf;
+	struct CZDeviceInfoStat	stat[CZMetricMax];	/*!< Statistics of measured metrics. See enum #CZMetric. */
 };
 
 bool CZCudaCheck(void);
@@ -114,6 +158,8 @@ int CZCudaCalcDeviceSelect(struct CZDeviceInfo *info);
 int CZCudaPrepareDevice(struct CZDeviceInfo *info);
 int CZCudaCalcDeviceBandwidth(struct CZDeviceInfo *info);
 int CZCudaCalcDevicePerformance(struct CZDeviceInfo *info);
+int CZCudaCalcDeviceTest(struct CZDeviceInfo *info, int metric);
+int CZCudaCalcDevicePlugin(struct CZDeviceInfo *info, const char *source, const char *kernelName, double opsPerThread);
 int CZCudaCleanDevice(struct CZDeviceInfo *info);
 
 #ifdef __cplusplus
@@ -0,0 +1,481 @@
+/*!	\file czasync.cpp
+	\brief Asynchronous benchmark API source file.
+	Every benchmark job runs in its own native thread, so the API does not
+	depend on Qt and can be driven from any event loop. A job can be polled,
+	waited for with timeout, or reported through completion callback.
+	Cancellation token of caller and deadline of job are watched by a
+	separate thread which raises stop flag of running test, so both
+	adaptive and fixed tests stop after their current iteration.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "cztimer.h"
+#include "cudaarch.h"
+#include "czstat.h"
+#include "czasync.h"
+
+#if (defined(WIN64) || defined(_WIN64) || defined(__WIN64__)) || (defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
+#define CZ_ASYNC_WIN
+#include <windows.h>
+#else
+#include <time.h>
+#include <pthread.h>
+#endif
+
+#define CZ_ASYNC_WATCH_MS	5			/*!< Period of checking cancellation token of caller. */
+
+/*!	\brief Asynchronous benchmark job.
+*/
+struct CZAsyncJob {
+	struct CZAsyncRequest	request;	/*!< Copy of request. */
+	struct CZDeviceInfo	info;		/*!< Results of benchmark. */
+	volatile int	cancelFlag;		/*!< Own cancel flag if request has no token. */
+	volatile int	*cancel;		/*!< Cancel flag of caller. */
+	volatile int	stop;			/*!< Stop flag checked by tests, raised on cancel or deadline. */
+	volatile int	timedOut;		/*!< Stop flag was raised by deadline. */
+	double		deadline;		/*!< Absolute deadline by CZTimerNow(), \a 0 for no limit. */
+	int		status;			/*!< Benchmark status. See enum #CZAsyncStatus. */
+	int		watched;		/*!< Watcher thread is started. */
+	int		released;		/*!< Job was released from its own callback and is freed by its thread. */
+#ifdef CZ_ASYNC_WIN
+	HANDLE		thread;			/*!< Benchmark thread. */
+	DWORD		threadId;		/*!< Id of benchmark thread, set by the thread itself. */
+	HANDLE		watcher;		/*!< Thread watching cancellation token and deadline. */
+	CRITICAL_SECTION	mutex;		/*!< Status lock. */
+	CONDITION_VARIABLE	finished;	/*!< Status change signal. */
+#else
+	pthread_t	thread;			/*!< Benchmark thread. */
+	pthread_t	threadSelf;		/*!< Benchmark thread, set by the thread itself. */
+	int		threadStarted;		/*!< Field \a threadSelf is set. */
+	pthread_t	watcher;		/*!< Thread watching cancellation token and deadline. */
+	pthread_mutex_t	mutex;			/*!< Status lock. */
+	pthread_cond_t	finished;		/*!< Status change signal. */
+#endif
+};
+
+/*!	\brief Fill request with default values.
+*/
+void CZAsyncRequestDefault(
+	struct CZAsyncRequest *request	/*!<[out] Benchmark request. */
+) {
+	if(request == NULL)
+		return;
+
+	memset(request, 0, sizeof(*request));
+	request->warmupNum = CZ_WARMUP_DEF_NUM;
+}
+
+/*!	\brief Report progress of job.
+*/
+static void CZAsyncReport(
+	struct CZAsyncJob *job,		/*!<[in] Benchmark job. */
+	int phase,			/*!<[in] Current phase. */
+	int metric,			/*!<[in] Current test. */
+	int testsDone,			/*!<[in] Number of finished tests. */
+	int testsNum			/*!<[in] Number of requested tests. */
+) {
+	if(job->request.progress != NULL)
+		job->request.progress(job->request.context, phase, metric, testsDone, testsNum);
+}
+
+/*!	\brief Raise stop flag of job if it is cancelled or its deadline is reached.
+	\returns \a CZAsyncStatusRunning to continue, or final status.
+*/
+static int CZAsyncCheckStop(
+	struct CZAsyncJob *job		/*!<[in,out] Benchmark job. */
+) {
+	if(*job->cancel)
+		job->stop = 1;
+
+	if(!job->stop && (job->deadline != 0) && (CZTimerNow() >= job->deadline)) {
+		job->timedOut = 1;
+		job->stop = 1;
+	}
+
+	if(!job->stop)
+		return CZAsyncStatusRunning;
+
+	return job->timedOut? CZAsyncStatusTimeout: CZAsyncStatusCancelled;
+}
+
+/*!	\brief Run benchmark of job.
+	\returns final status of job.
+*/
+static int CZAsyncRunJob(
+	struct CZAsyncJob *job		/*!<[in,out] Benchmark job. */
+) {
+	struct CZDeviceInfo *info = &job->info;
+	int testsNum = 0;
+	int testsDone = 0;
+	int status;
+	int metric;
+
+	for(metric = 0; metric < CZMetricMax; metric++) {
+		if((job->request.metrics == 0) || (job->request.metrics & (1 << metric)))
+			testsNum++;
+	}
+
+	CZAsyncReport(job, CZAsyncPhasePrepare, -1, 0, testsNum);
+
+	if((CZCudaReadDeviceInfo(info, job->request.device) != 0) ||
+		(CZCudaCalcDeviceSelect(info) != 0) ||
+		(CZCudaPrepareDevice(info) != 0)) {
+		CZLog(CZLogLevelError, "Can't prepare device %d for asynchronous benchmark.", job->request.device);
+		return CZAsyncStatusFailed;
+	}
+
+	status = CZAsyncStatusDone;
+	for(metric = 0; metric < CZMetricMax; metric++) {
+		if((job->request.metrics != 0) && !(job->request.metrics & (1 << metric)))
+			continue;
+
+		status = CZAsyncCheckStop(job);
+		if(status != CZAsyncStatusRunning)
+			break;
+		status = CZAsyncStatusDone;
+
+		/* Adaptive test must not run past deadline of job. */
+		if((job->deadline != 0) && (info->precision > 0)) {
+			float budgetMs = (job->request.budgetMs > 0)? job->request.budgetMs: CZ_ADAPT_DEF_BUDGET_MS;
+			float remainMs = job->deadline - CZTimerNow();
+			info->budgetMs = (remainMs < budgetMs)? remainMs: budgetMs;
+		}
+
+		CZAsyncReport(job, (metric <= CZMetricCopyDD)? CZAsyncPhaseBandwidth: CZAsyncPhasePerformance,
+			metric, testsDone, testsNum);
+
+		if(CZCudaCalcDeviceTest(info, metric) != 0)
+			CZLog(CZLogLevelModerate, "Test %s failed on device %d.", CZMetricName(metric), info->num);
+		testsDone++;
+	}
+
+	/* Test interrupted by stop flag is incomplete. */
+	if(status == CZAsyncStatusDone) {
+		status = CZAsyncCheckStop(job);
+		if(status == CZAsyncStatusRunning)
+			status = CZAsyncStatusDone;
+	}
+
+	CZCudaCleanDevice(info);
+
+	return status;
+}
+
+/*!	\brief Wait for threads of job and free it.
+	Benchmark thread releasing its own job is detached instead.
+*/
+static void CZAsyncRelease(
+	struct CZAsyncJob *job,		/*!<[in,out] Benchmark job. */
+	int self			/*!<[in] Job is released by its benchmark thread. */
+) {
+#ifdef CZ_ASYNC_WIN
+	if(!self)
+		WaitForSingleObject(job->thread, INFINITE);
+	CloseHandle(job->thread);
+	if(job->watched) {
+		WaitForSingleObject(job->watcher, INFINITE);
+		CloseHandle(job->watcher);
+	}
+	DeleteCriticalSection(&job->mutex);
+#else
+	if(self)
+		pthread_detach(job->thread);
+	else
+		pthread_join(job->thread, NULL);
+	if(job->watched)
+		pthread_join(job->watcher, NULL);
+	pthread_cond_destroy(&job->finished);
+	pthread_mutex_destroy(&job->mutex);
+#endif
+
+	free(job);
+}
+
+/*!	\brief Set final status of job and wake up waiting threads.
+*/
+static void CZAsyncFinish(
+	struct CZAsyncJob *job,		/*!<[in,out] Benchmark job. */
+	int status			/*!<[in] Final status. */
+) {
+#ifdef CZ_ASYNC_WIN
+	EnterCriticalSection(&job->mutex);
+	job->status = status;
+	WakeAllConditionVariable(&job->finished);
+	LeaveCriticalSection(&job->mutex);
+#else
+	pthread_mutex_lock(&job->mutex);
+	job->status = status;
+	pthread_cond_broadcast(&job->finished);
+	pthread_mutex_unlock(&job->mutex);
+#endif
+}
+
+/*!	\brief Thread function of job.
+*/
+#ifdef CZ_ASYNC_WIN
+static DWORD WINAPI CZAsyncThread(
+	LPVOID arg			/*!<[in,out] Benchmark job. */
+) {
+#else
+static void *CZAsyncThread(
+	void *arg			/*!<[in,out] Benchmark job. */
+) {
+#endif
+	struct CZAsyncJob *job = (struct CZAsyncJob*)arg;
+	int testsDone;
+	int status;
+
+#ifdef CZ_ASYNC_WIN
+	EnterCriticalSection(&job->mutex);
+	job->threadId = GetCurrentThreadId();
+	LeaveCriticalSection(&job->mutex);
+#else
+	pthread_mutex_lock(&job->mutex);
+	job->threadSelf = pthread_self();
+	job->threadStarted = 1;
+	pthread_mutex_unlock(&job->mutex);
+#endif
+
+	status = CZAsyncRunJob(job);
+	testsDone = 0;
+	for(int i = 0; i < CZMetricMax; i++) {
+		if(job->info.stat[i].samplesNum != 0)
+			testsDone++;
+	}
+
+	CZAsyncFinish(job, status);
+	CZAsyncReport(job, CZAsyncPhaseDone, -1, testsDone, testsDone);
+
+	if(job->request.complete != NULL)
+		job->request.complete(job->request.context, status, &job->info);
+
+	if(job->released)
+		CZAsyncRelease(job, 1);
+
+	return 0;
+}
+
+/*!	\brief Thread function of watcher of job.
+	Checks cancellation token of caller and deadline until job is over.
+*/
+#ifdef CZ_ASYNC_WIN
+static DWORD WINAPI CZAsyncWatcher(
+	LPVOID arg			/*!<[in,out] Benchmark job. */
+) {
+#else
+static void *CZAsyncWatcher(
+	void *arg			/*!<[in,out] Benchmark job. */
+) {
+#endif
+	struct CZAsyncJob *job = (struct CZAsyncJob*)arg;
+
+#ifdef CZ_ASYNC_WIN
+	EnterCriticalSection(&job->mutex);
+	while((job->status == CZAsyncStatusRunning) && (CZAsyncCheckStop(job) == CZAsyncStatusRunning))
+		SleepConditionVariableCS(&job->finished, &job->mutex, CZ_ASYNC_WATCH_MS);
+	LeaveCriticalSection(&job->mutex);
+#else
+	pthread_mutex_lock(&job->mutex);
+	while((job->status == CZAsyncStatusRunning) && (CZAsyncCheckStop(job) == CZAsyncStatusRunning)) {
+		struct timespec ts;
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_nsec += CZ_ASYNC_WATCH_MS * 1000000L;
+		if(ts.tv_nsec >= 1000000000) {
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000;
+		}
+		pthread_cond_timedwait(&job->finished, &job->mutex, &ts);
+	}
+	pthread_mutex_unlock(&job->mutex);
+#endif
+
+	return 0;
+}
+
+/*!	\brief Start benchmark of device in background.
+	\returns job handle, \a NULL in case of error.
+*/
+struct CZAsyncJob *CZAsyncStart(
+	const struct CZAsyncRequest *request	/*!<[in] Benchmark request. */
+) {
+	struct CZAsyncJob *job;
+
+	if(request == NULL)
+		return NULL;
+
+	job = (struct CZAsyncJob*)malloc(sizeof(*job));
+	if(job == NULL)
+		return NULL;
+
+	memset(job, 0, sizeof(*job));
+	job->request = *request;
+	job->cancel = (request->cancel != NULL)? request->cancel: &job->cancelFlag;
+	job->deadline = (request->deadlineMs > 0)? (CZTimerNow() + request->deadlineMs): 0;
+	job->status = CZAsyncStatusRunning;
+
+	job->info.num = request->device;
+	job->info.warmupNum = request->warmupNum;
+	job->info.precision = request->precision;
+	job->info.budgetMs = request->budgetMs;
+	job->info.cancel = &job->stop;
+
+	/* Benchmark thread waits for handles below, it may release the job itself. */
+#ifdef CZ_ASYNC_WIN
+	InitializeCriticalSection(&job->mutex);
+	InitializeConditionVariable(&job->finished);
+	EnterCriticalSection(&job->mutex);
+	job->thread = CreateThread(NULL, 0, CZAsyncThread, job, 0, NULL);
+	if(job->thread == NULL) {
+		LeaveCriticalSection(&job->mutex);
+		DeleteCriticalSection(&job->mutex);
+		free(job);
+		return NULL;
+	}
+	if((request->cancel != NULL) || (job->deadline != 0)) {
+		job->watcher = CreateThread(NULL, 0, CZAsyncWatcher, job, 0, NULL);
+		job->watched = (job->watcher != NULL);
+	}
+	LeaveCriticalSection(&job->mutex);
+#else
+	pthread_mutex_init(&job->mutex, NULL);
+	pthread_cond_init(&job->finished, NULL);
+	pthread_mutex_lock(&job->mutex);
+	if(pthread_create(&job->thread, NULL, CZAsyncThread, job) != 0) {
+		pthread_mutex_unlock(&job->mutex);
+		pthread_cond_destroy(&job->finished);
+		pthread_mutex_destroy(&job->mutex);
+		free(job);
+		return NULL;
+	}
+	if((request->cancel != NULL) || (job->deadline != 0))
+		job->watched = (pthread_create(&job->watcher, NULL, CZAsyncWatcher, job) == 0);
+	pthread_mutex_unlock(&job->mutex);
+#endif
+
+	if(((request->cancel != NULL) || (job->deadline != 0)) && !job->watched)
+		CZLog(CZLogLevelWarning, "Can't watch asynchronous benchmark of device %d, deadline is checked between tests only.", request->device);
+
+	CZLog(CZLogLevelLow, "Asynchronous benchmark of device %d started.", request->device);
+
+	return job;
+}
+
+/*!	\brief Get current status of job without waiting.
+	\returns status of job. See enum #CZAsyncStatus.
+*/
+int CZAsyncPoll(
+	struct CZAsyncJob *job		/*!<[in] Benchmark job. */
+) {
+	return CZAsyncWait(job, 0);
+}
+
+/*!	\brief Wait until job is over or timeout expires.
+	\returns status of job. See enum #CZAsyncStatus.
+*/
+int CZAsyncWait(
+	struct CZAsyncJob *job,		/*!<[in] Benchmark job. */
+	double timeoutMs		/*!<[in] Timeout in milliseconds, negative to wait forever. */
+) {
+	double endMs = CZTimerNow() + timeoutMs;
+	int status;
+
+	if(job == NULL)
+		return CZAsyncStatusFailed;
+
+#ifdef CZ_ASYNC_WIN
+	EnterCriticalSection(&job->mutex);
+	while(job->status == CZAsyncStatusRunning) {
+		double leftMs = endMs - CZTimerNow();
+		if((timeoutMs >= 0) && (leftMs <= 0))
+			break;
+		SleepConditionVariableCS(&job->finished, &job->mutex, (timeoutMs < 0)? INFINITE: (DWORD)leftMs + 1);
+	}
+	status = job->status;
+	LeaveCriticalSection(&job->mutex);
+#else
+	pthread_mutex_lock(&job->mutex);
+	while(job->status == CZAsyncStatusRunning) {
+		if(timeoutMs < 0) {
+			pthread_cond_wait(&job->finished, &job->mutex);
+		} else {
+			double leftMs = endMs - CZTimerNow();
+			struct timespec ts;
+			if(leftMs <= 0)
+				break;
+			clock_gettime(CLOCK_REALTIME, &ts);
+			ts.tv_sec += (time_t)(leftMs / 1000);
+			ts.tv_nsec += (long)((leftMs - (time_t)(leftMs / 1000) * 1000.0) * 1.0e6);
+			if(ts.tv_nsec >= 1000000000) {
+				ts.tv_sec++;
+				ts.tv_nsec -= 1000000000;
+			}
+			pthread_cond_timedwait(&job->finished, &job->mutex, &ts);
+		}
+	}
+	status = job->status;
+	pthread_mutex_unlock(&job->mutex);
+#endif
+
+	return status;
+}
+
+/*!	\brief Cancel job. Running test stops after its current iteration.
+	Cancellation token of request is not changed, it may be shared by
+	other jobs.
+*/
+void CZAsyncCancel(
+	struct CZAsyncJob *job		/*!<[in,out] Benchmark job. */
+) {
+	if(job == NULL)
+		return;
+
+	job->stop = 1;
+}
+
+/*!	\brief Get results of job.
+	Results are complete only when CZAsyncPoll() reports final status.
+	\returns device information with results of tests.
+*/
+const struct CZDeviceInfo *CZAsyncResult(
+	const struct CZAsyncJob *job	/*!<[in] Benchmark job. */
+) {
+	return (job == NULL)? NULL: &job->info;
+}
+
+/*!	\brief Release job. Running job is cancelled and waited for.
+	Job may be released from its own callbacks too, then it is cancelled
+	and freed by its thread when completion callback returns.
+*/
+void CZAsyncFree(
+	struct CZAsyncJob *job		/*!<[in,out] Benchmark job. */
+) {
+	int self;
+
+	if(job == NULL)
+		return;
+
+	if(CZAsyncPoll(job) == CZAsyncStatusRunning)
+		CZAsyncCancel(job);
+
+#ifdef CZ_ASYNC_WIN
+	EnterCriticalSection(&job->mutex);
+	self = (GetCurrentThreadId() == job->threadId);
+	LeaveCriticalSection(&job->mutex);
+#else
+	pthread_mutex_lock(&job->mutex);
+	self = job->threadStarted && pthread_equal(pthread_self(), job->threadSelf);
+	pthread_mutex_unlock(&job->mutex);
+#endif
+	if(self) {
+		job->released = 1;
+		return;
+	}
+
+	CZAsyncRelease(job, 0);
+}
@@ -0,0 +1,76 @@
+/*!	\file czasync.h
+	\brief Asynchronous benchmark API definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_ASYNC_H
+#define CZ_ASYNC_H
+
+#include "cudainfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!	\brief Phase of asynchronous benchmark.
+*/
+enum CZAsyncPhase {
+	CZAsyncPhasePrepare = 0,		/*!< Reading information and preparing device. */
+	CZAsyncPhaseBandwidth,			/*!< Bandwidth tests. */
+	CZAsyncPhasePerformance,		/*!< Performance tests. */
+	CZAsyncPhaseDone,			/*!< Benchmark is over. */
+};
+
+/*!	\brief Status of asynchronous benchmark.
+*/
+enum CZAsyncStatus {
+	CZAsyncStatusRunning = 0,		/*!< Benchmark is running. */
+	CZAsyncStatusDone,			/*!< All requested tests are done. */
+	CZAsyncStatusFailed,			/*!< Device can't be prepared. */
+	CZAsyncStatusCancelled,			/*!< Benchmark was cancelled. */
+	CZAsyncStatusTimeout,			/*!< Deadline was reached before all tests were done. */
+};
+
+/*!	\brief Progress callback. Called from benchmark thread before every test
+	with \a metric of the test, and once with #CZAsyncPhaseDone and \a -1.
+*/
+typedef void (*CZAsyncProgress)(void *context, int phase, int metric, int testsDone, int testsNum);
+
+/*!	\brief Completion callback. Called from benchmark thread when the
+	benchmark is over. \a info is valid until CZAsyncFree(), which may be
+	called from the callback itself.
+*/
+typedef void (*CZAsyncComplete)(void *context, int status, const struct CZDeviceInfo *info);
+
+/*!	\brief Asynchronous benchmark request.
+*/
+struct CZAsyncRequest {
+	int		device;			/*!< Device index. */
+	int		metrics;		/*!< Mask of tests to run (bit \a 1<<metric), \a 0 for all. See enum #CZMetric. */
+	int		warmupNum;		/*!< Number of warm-up iterations discarded before each test. */
+	float		precision;		/*!< Target precision of adaptive test mode in percents, \a 0 for fixed number of iterations. */
+	float		budgetMs;		/*!< Time budget of one test in adaptive mode in milliseconds, \a 0 for default. */
+	double		deadlineMs;		/*!< Time limit of whole benchmark in milliseconds, running test stops after its current iteration when it is reached, \a 0 for no limit. */
+	volatile int	*cancel;		/*!< Cancellation token shared with caller, set to non-zero to cancel, may be \a NULL. */
+	CZAsyncProgress	progress;		/*!< Progress callback, may be \a NULL. */
+	CZAsyncComplete	complete;		/*!< Completion callback, may be \a NULL. */
+	void		*context;		/*!< Context of callbacks. */
+};
+
+struct CZAsyncJob;
+
+void CZAsyncRequestDefault(struct CZAsyncRequest *request);
+struct CZAsyncJob *CZAsyncStart(const struct CZAsyncRequest *request);
+int CZAsyncPoll(struct CZAsyncJob *job);
+int CZAsyncWait(struct CZAsyncJob *job, double timeoutMs);
+void CZAsyncCancel(struct CZAsyncJob *job);
+const struct CZDeviceInfo *CZAsyncResult(const struct CZAsyncJob *job);
+void CZAsyncFree(struct CZAsyncJob *job);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_ASYNC_H
@@ -0,0 +1,183 @@
+/*!	\file czbackend.cpp
+	\brief Benchmark backend dispatcher source file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "cudainfo.h"
+#include "czbackend.h"
+#include "czsession.h"
+#include "czcache.h"
+
+#define CZ_BACKEND_ENV		"CZ_BACKEND"		/*!< Environment variable selecting backend. */
+
+/*!	\brief List of available backends. The first one is default.
+*/
+static const struct CZBackend *s_backendTab[] = {
+	&CZBackendCuda,
+	&CZBackendSim,
+	&CZBackendReplay,
+};
+
+/*!	\brief Current backend.
+*/
+static const struct CZBackend *s_backend = NULL;
+
+/*!	\brief Select backend by name.
+	\returns \a 0 in case of success, \a -1 if there is no such backend.
+*/
+int CZBackendSelect(
+	const char *name		/*!<[in] Name of backend. */
+) {
+	if(name == NULL)
+		return -1;
+
+	for(unsigned int i = 0; i < sizeof(s_backendTab) / sizeof(s_backendTab[0]); i++) {
+		if(strcmp(s_backendTab[i]->name, name) == 0) {
+			s_backend = s_backendTab[i];
+			CZLog(CZLogLevelLow, "Using %s backend.", s_backend->name);
+			return 0;
+		}
+	}
+
+	CZLog(CZLogLevelError, "Unknown backend %s.", name);
+	return -1;
+}
+
+/*!	\brief Get current backend.
+	If no backend is selected yet, it is taken from environment variable
+	\a CZ_BACKEND, or the first one from the list is used.
+	\returns current backend.
+*/
+const struct CZBackend *CZBackendGet(void) {
+
+	if(s_backend == NULL) {
+		const char *name = getenv(CZ_BACKEND_ENV);
+		if((name == NULL) || (CZBackendSelect(name) != 0))
+			s_backend = s_backendTab[0];
+	}
+
+	return s_backend;
+}
+
+/*!	\brief Check if CUDA is present here.
+*/
+bool CZCudaCheck(void) {
+	bool present = CZBackendGet()->check();
+	CZSessionRecordCheckResult(present);
+	return present;
+}
+
+/*!	\brief Check how many CUDA-devices are present.
+	\returns number of CUDA-devices in case of success, \a 0 if no CUDA-devies were found.
+*/
+int CZCudaDeviceFound(void) {
+	int num = CZBackendGet()->deviceFound();
+	CZSessionRecordDevicesNum(num);
+	return num;
+}
+
+/*!	\brief Read information about a CUDA-device.
+	If cache of device information is used and backend can identify
+	device cheaply, static information is taken from cache when possible.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCudaReadDeviceInfo(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int num				/*!<[in] Number (index) of CUDA-device. */
+) {
+	const struct CZBackend *backend = CZBackendGet();
+	bool cached = CZCacheIsOpen() && (backend->readDeviceKey != NULL);
+	int res;
+
+	if(cached && (backend->readDeviceKey(info, num) == 0) && (CZCacheLookup(info) == 0)) {
+		res = 0;
+	} else {
+		res = backend->readDeviceInfo(info, num);
+		if((res == 0) && cached)
+			CZCacheStore(info);
+	}
+
+	if(res == 0)
+		CZSessionRecordDeviceInfo(info);
+	return res;
+}
+
+/*!	\brief Set device for current thread.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCudaCalcDeviceSelect(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	return CZBackendGet()->calcDeviceSelect(info);
+}
+
+/*!	\brief Prepare buffers bandwidth tests.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCudaPrepareDevice(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	return CZBackendGet()->prepareDevice(info);
+}
+
+/*!	\brief Calculate bandwidth information about CUDA-device.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCudaCalcDeviceBandwidth(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	return CZBackendGet()->calcDeviceBandwidth(info);
+}
+
+/*!	\brief Calculate performance information about CUDA-device.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCudaCalcDevicePerformance(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	return CZBackendGet()->calcDevicePerformance(info);
+}
+
+/*!	\brief Run one bandwidth or performance test.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCudaCalcDeviceTest(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int metric			/*!<[in] Test to run. See enum #CZMetric. */
+) {
+	return CZBackendGet()->calcDeviceTest(info, metric);
+}
+
+/*!	\brief Compile and run user-supplied calculation kernel.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCudaCalcDevicePlugin(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	const char *source,		/*!<[in] CUDA C source code. */
+	const char *kernelName,		/*!<[in] Name of kernel function. */
+	double opsPerThread		/*!<[in] Number of operations done by one thread. */
+) {
+	const struct CZBackend *backend = CZBackendGet();
+
+	if(backend->calcDevicePlugin == NULL) {
+		CZLog(CZLogLevelError, "Plugin kernels are not supported by %s backend.", backend->name);
+		return -1;
+	}
+
+	return backend->calcDevicePlugin(info, source, kernelName, opsPerThread);
+}
+
+/*!	\brief Cleanup after test and bandwidth calculations.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCudaCleanDevice(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	return CZBackendGet()->cleanDevice(info);
+}
@@ -0,0 +1,47 @@
+/*!	\file czbackend.h
+	\brief Benchmark backend interface definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_BACKEND_H
+#define CZ_BACKEND_H
+
+#include "cudainfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!	\brief Benchmark backend.
+	Every CZCuda*() function of cudainfo.h is dispatched to the function
+	of current backend with the same meaning. Optional functions may be \a NULL.
+*/
+struct CZBackend {
+	const char	*name;			/*!< Backend name used to select it. */
+	bool		(*check)(void);		/*!< See CZCudaCheck(). */
+	int		(*deviceFound)(void);	/*!< See CZCudaDeviceFound(). */
+	int		(*readDeviceInfo)(struct CZDeviceInfo *info, int num);	/*!< See CZCudaReadDeviceInfo(). */
+	int		(*readDeviceKey)(struct CZDeviceInfo *info, int num);	/*!< Read versions, PCI location, name and mutable attributes of device without initializing it, optional. Enables cache of device information. */
+	int		(*calcDeviceSelect)(struct CZDeviceInfo *info);	/*!< See CZCudaCalcDeviceSelect(). */
+	int		(*prepareDevice)(struct CZDeviceInfo *info);	/*!< See CZCudaPrepareDevice(). */
+	int		(*calcDeviceBandwidth)(struct CZDeviceInfo *info);	/*!< See CZCudaCalcDeviceBandwidth(). */
+	int		(*calcDevicePerformance)(struct CZDeviceInfo *info);	/*!< See CZCudaCalcDevicePerformance(). */
+	int		(*calcDeviceTest)(struct CZDeviceInfo *info, int metric);	/*!< See CZCudaCalcDeviceTest(). */
+	int		(*calcDevicePlugin)(struct CZDeviceInfo *info, const char *source, const char *kernelName, double opsPerThread);	/*!< See CZCudaCalcDevicePlugin(), optional. */
+	int		(*cleanDevice)(struct CZDeviceInfo *info);	/*!< See CZCudaCleanDevice(). */
+};
+
+extern const struct CZBackend CZBackendCuda;
+extern const struct CZBackend CZBackendSim;
+extern const struct CZBackend CZBackendReplay;
+
+const struct CZBackend *CZBackendGet(void);
+int CZBackendSelect(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_BACKEND_H
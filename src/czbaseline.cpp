@@ -0,0 +1,186 @@
+/*!	\file czbaseline.cpp
+	\brief Comparison of test results with baseline source file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <string.h>
+#include <math.h>
+
+#include "log.h"
+#include "cudaarch.h"
+#include "czbaseline.h"
+
+#define CZ_BASELINE_DEF_THRESHOLD	5		/*!< Default regression threshold in percents. */
+#define CZ_BASELINE_DEF_ALPHA	0.05			/*!< Default significance level. */
+
+#define CZ_BETA_ITER_MAX	200			/*!< Maximal number of continued fraction iterations. */
+#define CZ_BETA_EPS		1e-12			/*!< Relative precision of continued fraction. */
+#define CZ_BETA_TINY		1e-300			/*!< Guard against division by zero. */
+
+/*!	\brief Fill regression gate configuration with default values.
+*/
+void CZBaselineConfigDefault(
+	struct CZBaselineConfig *config	/*!<[out] Regression gate configuration. */
+) {
+	if(config == NULL)
+		return;
+
+	config->thresholdPct = CZ_BASELINE_DEF_THRESHOLD;
+	config->alpha = CZ_BASELINE_DEF_ALPHA;
+}
+
+/*!	\brief Evaluate continued fraction of incomplete beta function
+	by modified Lentz's method.
+	\returns value of continued fraction.
+*/
+static double CZBaselineBetaFrac(
+	double a,			/*!<[in] First shape parameter. */
+	double b,			/*!<[in] Second shape parameter. */
+	double x			/*!<[in] Argument. */
+) {
+	double c = 1;
+	double d = 1 - (a + b) * x / (a + 1);
+	double h;
+	int m;
+
+	if(fabs(d) < CZ_BETA_TINY)
+		d = CZ_BETA_TINY;
+	d = 1 / d;
+	h = d;
+
+	for(m = 1; m <= CZ_BETA_ITER_MAX; m++) {
+		double m2 = 2 * m;
+		double aa = m * (b - m) * x / ((a + m2 - 1) * (a + m2));
+		double delta;
+
+		d = 1 + aa * d;
+		if(fabs(d) < CZ_BETA_TINY)
+			d = CZ_BETA_TINY;
+		c = 1 + aa / c;
+		if(fabs(c) < CZ_BETA_TINY)
+			c = CZ_BETA_TINY;
+		d = 1 / d;
+		h *= d * c;
+
+		aa = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1));
+		d = 1 + aa * d;
+		if(fabs(d) < CZ_BETA_TINY)
+			d = CZ_BETA_TINY;
+		c = 1 + aa / c;
+		if(fabs(c) < CZ_BETA_TINY)
+			c = CZ_BETA_TINY;
+		d = 1 / d;
+		delta = d * c;
+		h *= delta;
+
+		if(fabs(delta - 1) < CZ_BETA_EPS)
+			break;
+	}
+
+	return h;
+}
+
+/*!	\brief Calculate regularized incomplete beta function I_x(a, b).
+	\returns value of function.
+*/
+static double CZBaselineBeta(
+	double a,			/*!<[in] First shape parameter. */
+	double b,			/*!<[in] Second shape parameter. */
+	double x			/*!<[in] Argument in range [0, 1]. */
+) {
+	double front;
+
+	if(x <= 0)
+		return 0;
+	if(x >= 1)
+		return 1;
+
+	front = exp(lgamma(a + b) - lgamma(a) - lgamma(b) + a * log(x) + b * log(1 - x));
+
+	if(x < (a + 1) / (a + b + 2))
+		return front * CZBaselineBetaFrac(a, b, x) / a;
+	return 1 - front * CZBaselineBetaFrac(b, a, 1 - x) / b;
+}
+
+/*!	\brief Calculate two-sided p-value of Welch's t-test.
+	\returns p-value, or \a -1 if test can't be done.
+*/
+static double CZBaselineWelch(
+	const struct CZDeviceInfoStat *a,	/*!<[in] Statistics of first sample. */
+	const struct CZDeviceInfoStat *b	/*!<[in] Statistics of second sample. */
+) {
+	double va, vb, se2, t, df;
+
+	if((a == NULL) || (b == NULL) || (a->samplesNum < 2) || (b->samplesNum < 2))
+		return -1;
+
+	va = (double)a->stddev * a->stddev / a->samplesNum;
+	vb = (double)b->stddev * b->stddev / b->samplesNum;
+	se2 = va + vb;
+
+	if(se2 <= 0)
+		return (a->mean == b->mean)? 1: 0;
+
+	t = (a->mean - b->mean) / sqrt(se2);
+	df = se2 * se2 / (va * va / (a->samplesNum - 1) + vb * vb / (b->samplesNum - 1));
+
+	return CZBaselineBeta(df / 2, 0.5, df / (df + t * t));
+}
+
+/*!	\brief Compare one metric with baseline.
+	Means are compared when statistics of iterations are available,
+	single values otherwise. Metric regresses (or improves) when its
+	mean changes by more than \a thresholdPct percents and, if both
+	sides have at least two iterations, the change is significant by
+	Welch's t-test at \a alpha level. All metrics are throughputs,
+	so lower is worse.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZBaselineCompare(
+	const struct CZBaselineConfig *config,	/*!<[in] Regression gate configuration. */
+	int metric,			/*!<[in] Compared metric. See enum #CZMetric. */
+	double baseValue,		/*!<[in] Baseline value of metric. */
+	const struct CZDeviceInfoStat *baseStat,	/*!<[in] Baseline statistics, may be \a NULL. */
+	double curValue,		/*!<[in] Current value of metric. */
+	const struct CZDeviceInfoStat *curStat,	/*!<[in] Current statistics, may be \a NULL. */
+	struct CZBaselineResult *result	/*!<[out] Comparison result. */
+) {
+	if((config == NULL) || (result == NULL))
+		return -1;
+
+	memset(result, 0, sizeof(*result));
+	result->metric = metric;
+	result->pValue = -1;
+
+	result->base = ((baseStat != NULL) && (baseStat->samplesNum > 0))? baseStat->mean: baseValue;
+	result->current = ((curStat != NULL) && (curStat->samplesNum > 0))? curStat->mean: curValue;
+
+	if(result->base <= 0) {
+		result->verdict = CZBaselineNoData;
+		return 0;
+	}
+
+	/* Device that can't run test any more must not pass the gate. */
+	if(result->current <= 0) {
+		result->verdict = CZBaselineFailed;
+		CZLog(CZLogLevelLow, "Baseline %s: %.6g -> no result", CZMetricName(metric), result->base);
+		return 0;
+	}
+
+	result->deltaPct = 100 * (result->current - result->base) / result->base;
+	result->pValue = CZBaselineWelch(curStat, baseStat);
+
+	if(fabs(result->deltaPct) <= config->thresholdPct)
+		result->verdict = CZBaselineSame;
+	else if((result->pValue >= 0) && (result->pValue >= config->alpha))
+		result->verdict = CZBaselineSame;
+	else
+		result->verdict = (result->deltaPct < 0)? CZBaselineRegressed: CZBaselineImproved;
+
+	CZLog(CZLogLevelLow, "Baseline %s: %.6g -> %.6g (%+.2f%%, p=%.4g)", CZMetricName(metric),
+		result->base, result->current, result->deltaPct, result->pValue);
+
+	return 0;
+}
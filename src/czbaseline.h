@@ -0,0 +1,52 @@
+/*!	\file czbaseline.h
+	\brief Comparison of test results with baseline definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_BASELINE_H
+#define CZ_BASELINE_H
+
+#include "cudainfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!	\brief Verdict of comparison of one metric with baseline.
+*/
+enum CZBaselineVerdict {
+	CZBaselineNoData = 0,			/*!< Metric is missing in baseline or was not measured. */
+	CZBaselineSame,				/*!< Change is within threshold or not significant. */
+	CZBaselineImproved,			/*!< Metric is significantly better than baseline. */
+	CZBaselineRegressed,			/*!< Metric is significantly worse than baseline. */
+	CZBaselineFailed,			/*!< Metric is in baseline, but current test failed or gave no result. Gates as regression. */
+};
+
+/*!	\brief Regression gate configuration.
+*/
+struct CZBaselineConfig {
+	float		thresholdPct;		/*!< Smallest change of mean treated as regression in percents. */
+	float		alpha;			/*!< Significance level of Welch's t-test. */
+};
+
+/*!	\brief Comparison of one metric with baseline.
+*/
+struct CZBaselineResult {
+	int		metric;			/*!< Compared metric. See enum #CZMetric. */
+	int		verdict;		/*!< Verdict. See enum #CZBaselineVerdict. */
+	double		base;			/*!< Mean of baseline. */
+	double		current;		/*!< Mean of current results. */
+	double		deltaPct;		/*!< Change of mean relative to baseline in percents. */
+	double		pValue;			/*!< Two-sided p-value of Welch's t-test, \a -1 if statistics are not available. */
+};
+
+void CZBaselineConfigDefault(struct CZBaselineConfig *config);
+int CZBaselineCompare(const struct CZBaselineConfig *config, int metric, double baseValue, const struct CZDeviceInfoStat *baseStat, double curValue, const struct CZDeviceInfoStat *curStat, struct CZBaselineResult *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_BASELINE_H
@@ -0,0 +1,366 @@
+/*!	\file czcache.cpp
+	\brief Persistent cache of static device information source file.
+	Static properties of CUDA-devices are stored in a file keyed by driver
+	and runtime versions, PCI location and device name, so they can be
+	reported without querying and initializing devices again.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "cudainfo.h"
+#include "czcache.h"
+
+#if (defined(WIN64) || defined(_WIN64) || defined(__WIN64__)) || (defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
+#define CZ_CACHE_WIN
+#include <windows.h>
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <pthread.h>
+#endif
+
+#define CZ_CACHE_BYTE_ORDER	0x01020304		/*!< Byte order mark. */
+#define CZ_CACHE_STR_LEN	256			/*!< Maximal length of stored string. */
+#define CZ_CACHE_PATH_LEN	1024			/*!< Maximal length of cache file name. */
+
+/*!	\brief Cache file header.
+*/
+struct CZCacheHeader {
+	char		magic[8];		/*!< File signature #CZ_CACHE_MAGIC. */
+	int		version;		/*!< File format version #CZ_CACHE_VERSION. */
+	int		byteOrder;		/*!< Byte order mark #CZ_CACHE_BYTE_ORDER. */
+	int		entrySize;		/*!< Size of struct #CZCacheEntry. */
+	int		num;			/*!< Number of entries. */
+};
+
+/*!	\brief Cached device. The first part is the key, the rest is static
+	device information.
+*/
+struct CZCacheEntry {
+	char		drvVersion[CZ_CACHE_STR_LEN];	/*!< Driver version string. */
+	int		drvDllVer;		/*!< Driver Dll version. */
+	int		rtDllVer;		/*!< Runtime Dll version. */
+	int		pciDomainID;		/*!< PCI domain identifier of the device. */
+	int		pciBusID;		/*!< PCI bus identifier of the device. */
+	int		pciDeviceID;		/*!< PCI device identifier of the device. */
+	char		deviceName[256];	/*!< ASCII string identifying the device name. */
+	int		major;			/*!< Major revision number of compute capability. */
+	int		minor;			/*!< Minor revision number of compute capability. */
+	char		archName[256];		/*!< ASCII string identifying the device architecture name. */
+	int		tccDriver;		/*!< 1 if the device is using a TCC driver or 0 if not. */
+	struct CZDeviceInfoCore	core;
+	struct CZDeviceInfoMem	mem;
+};
+
+static bool s_cacheOpen = false;			/*!< Cache is used. */
+static char s_cacheFileName[CZ_CACHE_PATH_LEN];		/*!< Name of cache file. */
+static struct CZCacheEntry s_cacheEntries[CZ_CACHE_DEVICES_MAX];	/*!< Cached devices. */
+static int s_cacheEntriesNum = 0;			/*!< Number of cached devices. */
+
+#ifdef CZ_CACHE_WIN
+static SRWLOCK s_cacheMutex = SRWLOCK_INIT;		/*!< Lock of cached devices, initialized statically, so it works before CZCacheOpen() too. */
+#else
+static pthread_mutex_t s_cacheMutex = PTHREAD_MUTEX_INITIALIZER;	/*!< Lock of cached devices. */
+#endif
+
+/*!	\brief Lock cached devices. Devices may be read by several threads.
+*/
+static void CZCacheLock(void) {
+#ifdef CZ_CACHE_WIN
+	AcquireSRWLockExclusive(&s_cacheMutex);
+#else
+	pthread_mutex_lock(&s_cacheMutex);
+#endif
+}
+
+/*!	\brief Unlock cached devices.
+*/
+static void CZCacheUnlock(void) {
+#ifdef CZ_CACHE_WIN
+	ReleaseSRWLockExclusive(&s_cacheMutex);
+#else
+	pthread_mutex_unlock(&s_cacheMutex);
+#endif
+}
+
+/*!	\brief Create directory if it does not exist.
+*/
+static void CZCacheMakeDir(
+	const char *dirName		/*!<[in] Name of directory. */
+) {
+#ifdef CZ_CACHE_WIN
+	_mkdir(dirName);
+#else
+	mkdir(dirName, 0755);
+#endif
+}
+
+/*!	\brief Build name of cache file in default location of user cache:
+	\a %LOCALAPPDATA%\\cuda-z on Windows, \a ~/Library/Caches/cuda-z on Mac OS X
+	and \a $XDG_CACHE_HOME/cuda-z or \a ~/.cache/cuda-z on other systems.
+	Missing directories are created.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZCacheDefaultFileName(
+	char *fileName,			/*!<[out] Name of cache file. */
+	int size			/*!<[in] Size of \a fileName buffer. */
+) {
+	char dirName[CZ_CACHE_PATH_LEN];
+	const char *base;
+
+#ifdef CZ_CACHE_WIN
+	base = getenv("LOCALAPPDATA");
+	if(base == NULL)
+		return -1;
+	snprintf(dirName, sizeof(dirName), "%s\\cuda-z", base);
+	CZCacheMakeDir(dirName);
+	if(snprintf(fileName, size, "%s\\" CZ_CACHE_FILE_NAME, dirName) >= size)
+		return -1;
+#else
+	base = getenv("HOME");
+#ifdef __APPLE__
+	if(base == NULL)
+		return -1;
+	snprintf(dirName, sizeof(dirName), "%s/Library/Caches/cuda-z", base);
+#else
+	if((getenv("XDG_CACHE_HOME") != NULL) && (getenv("XDG_CACHE_HOME")[0] == '/')) {
+		snprintf(dirName, sizeof(dirName), "%s/cuda-z", getenv("XDG_CACHE_HOME"));
+	} else {
+		if(base == NULL)
+			return -1;
+		snprintf(dirName, sizeof(dirName), "%s/.cache", base);
+		CZCacheMakeDir(dirName);
+		snprintf(dirName, sizeof(dirName), "%s/.cache/cuda-z", base);
+	}
+#endif
+	CZCacheMakeDir(dirName);
+	if(snprintf(fileName, size, "%s/" CZ_CACHE_FILE_NAME, dirName) >= size)
+		return -1;
+#endif
+
+	return 0;
+}
+
+/*!	\brief Write all cached devices to cache file.
+	Called with cached devices locked.
+*/
+static void CZCacheWrite(void) {
+	struct CZCacheHeader header;
+	FILE *fp;
+
+	memset(&header, 0, sizeof(header));
+	strncpy(header.magic, CZ_CACHE_MAGIC, sizeof(header.magic));
+	header.version = CZ_CACHE_VERSION;
+	header.byteOrder = CZ_CACHE_BYTE_ORDER;
+	header.entrySize = sizeof(struct CZCacheEntry);
+	header.num = s_cacheEntriesNum;
+
+	fp = fopen(s_cacheFileName, "wb");
+	if(fp == NULL) {
+		CZLog(CZLogLevelWarning, "Can't write cache file %s.", s_cacheFileName);
+		return;
+	}
+
+	if((fwrite(&header, sizeof(header), 1, fp) != 1) ||
+		(fwrite(s_cacheEntries, sizeof(s_cacheEntries[0]), s_cacheEntriesNum, fp) != (size_t)s_cacheEntriesNum))
+		CZLog(CZLogLevelWarning, "Can't write cache file %s.", s_cacheFileName);
+
+	fclose(fp);
+}
+
+/*!	\brief Fill key part of cache entry from device information.
+*/
+static void CZCacheMakeKey(
+	struct CZCacheEntry *entry,	/*!<[out] Cache entry. */
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	memset(entry, 0, sizeof(*entry));
+	if(info->drvVersion != NULL)
+		strncpy(entry->drvVersion, info->drvVersion, sizeof(entry->drvVersion) - 1);
+	entry->drvDllVer = info->drvDllVer;
+	entry->rtDllVer = info->rtDllVer;
+	entry->pciDomainID = info->core.pciDomainID;
+	entry->pciBusID = info->core.pciBusID;
+	entry->pciDeviceID = info->core.pciDeviceID;
+	memcpy(entry->deviceName, info->deviceName, sizeof(entry->deviceName) - 1);
+}
+
+/*!	\brief Check if cache entry is the same PCI device.
+*/
+static bool CZCacheSameLocation(
+	const struct CZCacheEntry *a,	/*!<[in] First cache entry. */
+	const struct CZCacheEntry *b	/*!<[in] Second cache entry. */
+) {
+	return (a->pciDomainID == b->pciDomainID) &&
+		(a->pciBusID == b->pciBusID) &&
+		(a->pciDeviceID == b->pciDeviceID);
+}
+
+/*!	\brief Check if cache entry has the same key.
+*/
+static bool CZCacheSameKey(
+	const struct CZCacheEntry *a,	/*!<[in] First cache entry. */
+	const struct CZCacheEntry *b	/*!<[in] Second cache entry. */
+) {
+	return CZCacheSameLocation(a, b) &&
+		(a->drvDllVer == b->drvDllVer) &&
+		(a->rtDllVer == b->rtDllVer) &&
+		(strcmp(a->drvVersion, b->drvVersion) == 0) &&
+		(strcmp(a->deviceName, b->deviceName) == 0);
+}
+
+/*!	\brief Start using cache of static device information.
+	Devices are loaded from \a fileName, missing or incompatible file
+	gives empty cache.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCacheOpen(
+	const char *fileName		/*!<[in] Name of cache file, \a NULL for default location. */
+) {
+	struct CZCacheHeader header;
+	FILE *fp;
+
+	CZCacheClose();
+
+	if(fileName != NULL) {
+		strncpy(s_cacheFileName, fileName, sizeof(s_cacheFileName) - 1);
+		s_cacheFileName[sizeof(s_cacheFileName) - 1] = 0;
+	} else if(CZCacheDefaultFileName(s_cacheFileName, sizeof(s_cacheFileName)) != 0) {
+		CZLog(CZLogLevelWarning, "Can't find location of cache file.");
+		return -1;
+	}
+
+	s_cacheOpen = true;
+
+	fp = fopen(s_cacheFileName, "rb");
+	if(fp == NULL) {
+		CZLog(CZLogLevelLow, "Cache file %s is empty.", s_cacheFileName);
+		return 0;
+	}
+
+	if((fread(&header, sizeof(header), 1, fp) != 1) ||
+		(strncmp(header.magic, CZ_CACHE_MAGIC, sizeof(header.magic)) != 0) ||
+		(header.version != CZ_CACHE_VERSION) ||
+		(header.byteOrder != CZ_CACHE_BYTE_ORDER) ||
+		(header.entrySize != sizeof(struct CZCacheEntry)) ||
+		(header.num < 0) || (header.num > CZ_CACHE_DEVICES_MAX) ||
+		(fread(s_cacheEntries, sizeof(s_cacheEntries[0]), header.num, fp) != (size_t)header.num)) {
+		CZLog(CZLogLevelLow, "Cache file %s is not compatible, ignored.", s_cacheFileName);
+		fclose(fp);
+		return 0;
+	}
+
+	s_cacheEntriesNum = header.num;
+	fclose(fp);
+
+	CZLog(CZLogLevelLow, "Cache file %s: %d device(s).", s_cacheFileName, s_cacheEntriesNum);
+
+	return 0;
+}
+
+/*!	\brief Stop using cache of static device information.
+*/
+void CZCacheClose(void) {
+
+	if(!s_cacheOpen)
+		return;
+
+	s_cacheOpen = false;
+	s_cacheEntriesNum = 0;
+}
+
+/*!	\brief Check if cache of static device information is used.
+*/
+bool CZCacheIsOpen(void) {
+	return s_cacheOpen;
+}
+
+/*!	\brief Find static information about device in cache.
+	Driver and runtime versions, PCI location and device name of \a info
+	must be already set, as well as attributes that may change between
+	runs: compute mode, watchdog, ECC and TCC driver. The rest of static
+	information is filled from cache, test configuration and results are
+	not changed.
+	\returns \a 0 if device is found, \a -1 otherwise.
+*/
+int CZCacheLookup(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	struct CZCacheEntry key;
+	int res = -1;
+
+	if(!s_cacheOpen || (info == NULL))
+		return -1;
+
+	CZCacheMakeKey(&key, info);
+
+	CZCacheLock();
+	for(int i = 0; i < s_cacheEntriesNum; i++) {
+		const struct CZCacheEntry *entry = &s_cacheEntries[i];
+		if(CZCacheSameKey(entry, &key)) {
+			int watchdogEnabled = info->core.watchdogEnabled;
+			int computeMode = info->core.computeMode;
+			int errorCorrection = info->mem.errorCorrection;
+
+			info->major = entry->major;
+			info->minor = entry->minor;
+			memcpy(info->archName, entry->archName, sizeof(info->archName));
+			info->core = entry->core;
+			info->mem = entry->mem;
+			info->core.watchdogEnabled = watchdogEnabled;
+			info->core.computeMode = computeMode;
+			info->mem.errorCorrection = errorCorrection;
+			res = 0;
+			break;
+		}
+	}
+	CZCacheUnlock();
+
+	if(res == 0)
+		CZLog(CZLogLevelLow, "Information about device %d is taken from cache.", info->num);
+
+	return res;
+}
+
+/*!	\brief Store static information about device in cache.
+	Cached device with the same PCI location is replaced, so entries of
+	replaced devices and old drivers do not pile up.
+*/
+void CZCacheStore(
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	struct CZCacheEntry entry;
+	int i;
+
+	if(!s_cacheOpen || (info == NULL))
+		return;
+
+	CZCacheMakeKey(&entry, info);
+	entry.major = info->major;
+	entry.minor = info->minor;
+	memcpy(entry.archName, info->archName, sizeof(entry.archName));
+	entry.tccDriver = info->tccDriver;
+	entry.core = info->core;
+	entry.mem = info->mem;
+
+	CZCacheLock();
+	for(i = 0; i < s_cacheEntriesNum; i++) {
+		if(CZCacheSameLocation(&s_cacheEntries[i], &entry))
+			break;
+	}
+
+	if(i < CZ_CACHE_DEVICES_MAX) {
+		s_cacheEntries[i] = entry;
+		if(i == s_cacheEntriesNum)
+			s_cacheEntriesNum++;
+		CZCacheWrite();
+	}
+	CZCacheUnlock();
+}
@@ -0,0 +1,32 @@
+/*!	\file czcache.h
+	\brief Persistent cache of static device information definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_CACHE_H
+#define CZ_CACHE_H
+
+#include "cudainfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_CACHE_MAGIC		"CZCACHE"		/*!< Cache file signature. */
+#define CZ_CACHE_VERSION	1			/*!< Cache file format version. */
+#define CZ_CACHE_DEVICES_MAX	64			/*!< Maximal number of devices in cache. */
+#define CZ_CACHE_FILE_NAME	"devices.cache"		/*!< Name of cache file in default location. */
+
+int CZCacheOpen(const char *fileName);
+void CZCacheClose(void);
+bool CZCacheIsOpen(void);
+int CZCacheLookup(struct CZDeviceInfo *info);
+void CZCacheStore(const struct CZDeviceInfo *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_CACHE_H
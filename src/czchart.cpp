@@ -0,0 +1,204 @@
+/*!	\file czchart.cpp
+	\brief Time series chart widget source file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <QPainter>
+#include <QPolygonF>
+#include <QDateTime>
+
+#include "czchart.h"
+#include "czdeviceinfodecoder.h"
+
+#define CZ_CHART_MARGIN		4			/*!< Margin around plot area in pixels. */
+#define CZ_CHART_PAD		0.05			/*!< Padding of value range relative to range. */
+#define CZ_CHART_DOTS_MAX	50			/*!< Maximal number of points drawn with dots. */
+
+/*!	\class CZChart
+	\brief This class draws time series of one metric as a line with
+	optional min/max band around it and vertical markers. Values are
+	labeled in units of the metric.
+*/
+
+/*!	\brief Creates chart widget.
+*/
+CZChart::CZChart(
+	QWidget *parent			/*!<[in,out] Parent of widget. */
+)	: QWidget(parent) {
+	m_metric = 0;
+	m_axis = axisDate;
+	setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+/*!	\brief Destroys chart widget.
+*/
+CZChart::~CZChart() {
+}
+
+/*!	\brief Set metric used to label values. See enum #CZMetric.
+*/
+void CZChart::setMetric(
+	int metric			/*!<[in] Metric. */
+) {
+	m_metric = metric;
+	update();
+}
+
+/*!	\brief Set kind of time axis.
+*/
+void CZChart::setAxis(
+	int axis			/*!<[in] Kind of time axis. */
+) {
+	m_axis = axis;
+	update();
+}
+
+/*!	\brief Set points of chart, sorted by time.
+*/
+void CZChart::setPoints(
+	const QList<struct CZChartPoint> &points	/*!<[in] Points of chart. */
+) {
+	m_points = points;
+	update();
+}
+
+/*!	\brief Set vertical markers of chart.
+*/
+void CZChart::setMarkers(
+	const QList<struct CZChartMarker> &markers	/*!<[in] Markers of chart. */
+) {
+	m_markers = markers;
+	update();
+}
+
+/*!	\brief Remove all points and markers.
+*/
+void CZChart::clear() {
+	m_points.clear();
+	m_markers.clear();
+	update();
+}
+
+/*!	\brief Minimal size of chart.
+*/
+QSize CZChart::minimumSizeHint() const {
+	return QSize(160, 80);
+}
+
+/*!	\brief Preferred size of chart.
+*/
+QSize CZChart::sizeHint() const {
+	return QSize(300, 160);
+}
+
+/*!	\brief Label of time axis.
+*/
+const QString CZChart::axisLabel() const {
+	double first = m_points.first().x;
+	double last = m_points.last().x;
+
+	if(m_axis == axisSeconds)
+		return tr("last %1 s").arg((int)(last - first));
+
+	return QDateTime::fromTime_t((uint)first).toString("yyyy-MM-dd hh:mm") + " - " +
+		QDateTime::fromTime_t((uint)last).toString("yyyy-MM-dd hh:mm");
+}
+
+/*!	\brief Draw chart.
+*/
+void CZChart::paintEvent(
+	QPaintEvent *event		/*!<[in] Paint event. */
+) {
+	(void)event;
+
+	QPainter painter(this);
+	painter.fillRect(rect(), palette().base());
+
+	QFontMetrics metrics = fontMetrics();
+	QRectF plot = QRectF(rect()).adjusted(CZ_CHART_MARGIN, CZ_CHART_MARGIN + metrics.height(),
+		-CZ_CHART_MARGIN, -CZ_CHART_MARGIN - metrics.height());
+
+	painter.setPen(palette().color(QPalette::Mid));
+	painter.drawRect(plot);
+
+	if(m_points.isEmpty()) {
+		painter.setPen(palette().color(QPalette::Text));
+		painter.drawText(plot, Qt::AlignCenter, tr("No data"));
+		return;
+	}
+
+	double xMin = m_points.first().x;
+	double xMax = m_points.last().x;
+	double yMin = m_points.first().min;
+	double yMax = m_points.first().max;
+	for(int i = 0; i < m_points.size(); i++) {
+		yMin = qMin(yMin, qMin(m_points[i].min, m_points[i].value));
+		yMax = qMax(yMax, qMax(m_points[i].max, m_points[i].value));
+	}
+
+	double pad = (yMax - yMin) * CZ_CHART_PAD;
+	if(pad <= 0)
+		pad = (yMax != 0)? qAbs(yMax) * CZ_CHART_PAD: 1;
+	yMin -= pad;
+	yMax += pad;
+	if(xMax <= xMin)
+		xMax = xMin + 1;
+
+	QPolygonF line;
+	QPolygonF band;
+	for(int i = 0; i < m_points.size(); i++) {
+		double px = plot.left() + (m_points[i].x - xMin) / (xMax - xMin) * plot.width();
+		line.append(QPointF(px, plot.bottom() - (m_points[i].value - yMin) / (yMax - yMin) * plot.height()));
+		band.append(QPointF(px, plot.bottom() - (m_points[i].max - yMin) / (yMax - yMin) * plot.height()));
+	}
+	for(int i = m_points.size() - 1; i >= 0; i--) {
+		double px = plot.left() + (m_points[i].x - xMin) / (xMax - xMin) * plot.width();
+		band.append(QPointF(px, plot.bottom() - (m_points[i].min - yMin) / (yMax - yMin) * plot.height()));
+	}
+
+	if(m_points.size() == 1) {
+		line[0].setX(plot.center().x());
+	}
+
+	painter.setRenderHint(QPainter::Antialiasing);
+
+	for(int i = 0; i < m_markers.size(); i++) {
+		if((m_markers[i].x < xMin) || (m_markers[i].x > xMax))
+			continue;
+		double px = plot.left() + (m_markers[i].x - xMin) / (xMax - xMin) * plot.width();
+		painter.setPen(QPen(palette().color(QPalette::Mid), 1, Qt::DashLine));
+		painter.drawLine(QPointF(px, plot.top()), QPointF(px, plot.bottom()));
+		painter.setPen(palette().color(QPalette::Text));
+		painter.drawText(QRectF(px + 2, plot.top(), plot.right() - px - 2, metrics.height()),
+			Qt::AlignLeft | Qt::AlignTop, m_markers[i].label);
+	}
+
+	QColor color = palette().color(QPalette::Highlight);
+	if(m_points.size() > 1) {
+		QColor bandColor = color;
+		bandColor.setAlpha(64);
+		painter.setPen(Qt::NoPen);
+		painter.setBrush(bandColor);
+		painter.drawPolygon(band);
+	}
+
+	painter.setPen(QPen(color, 2));
+	painter.setBrush(Qt::NoBrush);
+	painter.drawPolyline(line);
+	if(line.size() <= CZ_CHART_DOTS_MAX) {
+		painter.setBrush(color);
+		for(int i = 0; i < line.size(); i++)
+			painter.drawEllipse(line[i], 2.5, 2.5);
+	}
+
+	painter.setRenderHint(QPainter::Antialiasing, false);
+	painter.setPen(palette().color(QPalette::Text));
+	painter.drawText(QRectF(plot.left(), rect().top(), plot.width(), plot.top() - rect().top()),
+		Qt::AlignLeft | Qt::AlignVCenter, CZCudaDeviceInfoDecoder::getMetricValue(m_metric, yMax - pad));
+	painter.drawText(QRectF(plot.left(), plot.bottom(), plot.width() / 2, rect().bottom() - plot.bottom()),
+		Qt::AlignLeft | Qt::AlignVCenter, CZCudaDeviceInfoDecoder::getMetricValue(m_metric, yMin + pad));
+	painter.drawText(QRectF(plot.center().x(), plot.bottom(), plot.width() / 2, rect().bottom() - plot.bottom()),
+		Qt::AlignRight | Qt::AlignVCenter, axisLabel());
+}
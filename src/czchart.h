@@ -0,0 +1,64 @@
+/*!	\file czchart.h
+	\brief Time series chart widget header file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_CHART_H
+#define CZ_CHART_H
+
+#include <QWidget>
+#include <QList>
+#include <QString>
+
+/*!	\brief Point of chart.
+*/
+struct CZChartPoint {
+	double		x;			/*!< Time of point. */
+	double		value;			/*!< Value of metric. */
+	double		min;			/*!< Lower edge of band, equal to \a value if there is no band. */
+	double		max;			/*!< Upper edge of band, equal to \a value if there is no band. */
+};
+
+/*!	\brief Vertical marker of chart.
+*/
+struct CZChartMarker {
+	double		x;			/*!< Time of marker. */
+	QString		label;			/*!< Label of marker. */
+};
+
+class CZChart: public QWidget {
+	Q_OBJECT
+
+public:
+	enum {
+		axisDate = 0,		/*!< Time is in seconds since epoch, labels are dates. */
+		axisSeconds,		/*!< Time is in seconds, label is length of time window. */
+	};
+
+	CZChart(QWidget *parent = 0);
+	~CZChart();
+
+	void setMetric(int metric);
+	void setAxis(int axis);
+	void setPoints(const QList<struct CZChartPoint> &points);
+	void setMarkers(const QList<struct CZChartMarker> &markers);
+	void clear();
+
+	QSize minimumSizeHint() const;
+	QSize sizeHint() const;
+
+protected:
+	void paintEvent(QPaintEvent *event);
+
+private:
+	int m_metric;
+	int m_axis;
+	QList<struct CZChartPoint> m_points;
+	QList<struct CZChartMarker> m_markers;
+
+	const QString axisLabel() const;
+};
+
+#endif//CZ_CHART_H
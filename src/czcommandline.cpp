@@ -5,13 +5,29 @@
 	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
 */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <QObject>
 #include <QString>
 #include <QFile>
 #include <QTextStream>
+#include <QCoreApplication>
+#include <QStringList>
 
 #include "log.h"
 #include "cudainfo.h"
+#include "cudaarch.h"
+#include "czsoak.h"
+#include "czbaseline.h"
+#include "czhistory.h"
+#include "czfleet.h"
+#include "czhealth.h"
+#include "czmerge.h"
+#include "czreport.h"
+#include "czplugin.h"
+#include "czparallel.h"
+#include "cztimer.h"
 #include "czdeviceinfodecoder.h"
 #include "platform.h"
 #include "version.h"
@@ -36,10 +52,32 @@ CZCommandLine::CZCommandLine(
 	m_needVersion = false;
 	m_printVerbose = false;
 	m_listDevices = false;
+	m_skipTests = false;
 	m_devIndex = 0;
+	m_devAll = false;
+	m_warmupNum = CZ_WARMUP_DEF_NUM;
+	m_precision = 0;
+	m_budgetSec = 0;
 	m_printToConsole = false;
 	m_exportHTML = false;
 	m_exportTXT = false;
+	m_exportJSON = false;
+	m_exportCSV = false;
+	m_soakTest = false;
+	m_parallelTest = false;
+	m_daemon = false;
+	memset(&m_daemonConfig, 0, sizeof(m_daemonConfig));
+	m_daemonConfig.port = CZ_DAEMON_DEF_PORT;
+	m_daemonConfig.intervalSec = CZ_DAEMON_DEF_INTERVAL;
+	m_daemonConfig.jitterPct = CZ_DAEMON_DEF_JITTER;
+	foreach(QString test, QString(CZ_DAEMON_DEF_TESTS).split(','))
+		m_daemonConfig.metrics |= 1 << CZMetricFind(test.toLatin1().constData());
+	CZSoakConfigDefault(&m_soakConfig);
+	CZBaselineConfigDefault(&m_baselineConfig);
+	CZHealthConfigDefault(&m_healthConfig);
+	CZFleetConfigDefault(&m_fleetConfig);
+	m_pluginKernelName = CZ_PLUGIN_KERNEL_NAME;
+	m_pluginOps = 0;
 }
 
 /*!	\brief Terminates the command line interface.
@@ -67,16 +105,137 @@ bool CZCommandLine::parse() {
 		} else if(QString(m_argv[i]) == "-list") {
 			m_listDevices = true;
 		} else if(QString(m_argv[i]) == "-dev") {
+			if(++i < m_argc) {
+				m_devList.clear();
+				m_devAll = (QString(m_argv[i]) == "all");
+				if(!m_devAll) {
+					foreach(QString dev, QString(m_argv[i]).split(',', QString::SkipEmptyParts)) {
+						bool intOk;
+						int devIndex = dev.trimmed().toInt(&intOk);
+						if(!intOk || (devIndex < 0)) {
+							CZLog(CZLogLevelError, tr("Wrong usage of option '-dev <list>'!"));
+							return false;
+						}
+						m_devList.append(devIndex);
+					}
+					if(m_devList.isEmpty()) {
+						CZLog(CZLogLevelError, tr("Wrong usage of option '-dev <list>'!"));
+						return false;
+					}
+					m_devIndex = m_devList.first();
+				}
+				CZLog(CZLogLevelLow, tr("Device index: %1").arg(m_argv[i]));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-dev <list>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-merge") {
+			if(++i < m_argc) {
+				m_mergeDirName = m_argv[i];
+				CZLog(CZLogLevelLow, tr("Merged reports directory: %1").arg(m_mergeDirName));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-merge <dir>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-outlierz") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_fleetConfig.outlierZ = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_fleetConfig.outlierZ < 0)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-outlierz <z>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Outlier robust z-score: %1").arg(m_fleetConfig.outlierZ));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-outlierz <z>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-outlier") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_fleetConfig.outlierPct = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_fleetConfig.outlierPct < 0)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-outlier <pct>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Outlier threshold: %1%").arg(m_fleetConfig.outlierPct));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-outlier <pct>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-notest") {
+			m_skipTests = true;
+		} else if((QString(m_argv[i]) == "-nocache") || (QString(m_argv[i]) == "-nohistory")) {
+			/* applied in main() before CUDA initialization */
+		} else if(QString(m_argv[i]) == "-parallel") {
+			m_parallelTest = true;
+		} else if(QString(m_argv[i]) == "-daemon") {
+			m_daemon = true;
+		} else if(QString(m_argv[i]) == "-port") {
 			if(++i < m_argc) {
 				bool intOk;
-				m_devIndex = QString(m_argv[i]).toInt(&intOk);
-				if(!intOk) {
-					CZLog(CZLogLevelError, tr("Wrong usage of option '-dev <n>'!"));
+				m_daemonConfig.port = QString(m_argv[i]).toInt(&intOk);
+				if(!intOk || (m_daemonConfig.port < 0) || (m_daemonConfig.port > 65535)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-port <n>'!"));
 					return false;
 				}
-				CZLog(CZLogLevelLow, tr("Device index: %1").arg(m_devIndex));
+				CZLog(CZLogLevelLow, tr("Daemon port: %1").arg(m_daemonConfig.port));
 			} else {
-				CZLog(CZLogLevelError, tr("Wrong usage of option '-dev <n>'!"));
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-port <n>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-socket") {
+			if(++i < m_argc) {
+				m_daemonSocket = m_argv[i];
+				CZLog(CZLogLevelLow, tr("Daemon socket: %1").arg(m_daemonSocket));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-socket <name>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-interval") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_daemonConfig.intervalSec = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_daemonConfig.intervalSec <= 0)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-interval <sec>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Daemon interval: %1 s").arg(m_daemonConfig.intervalSec));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-interval <sec>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-jitter") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_daemonConfig.jitterPct = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_daemonConfig.jitterPct < 0) || (m_daemonConfig.jitterPct >= 100)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-jitter <pct>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Daemon interval jitter: %1%").arg(m_daemonConfig.jitterPct));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-jitter <pct>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-daemontests") {
+			if(++i < m_argc) {
+				m_daemonConfig.metrics = 0;
+				foreach(QString test, QString(m_argv[i]).split(',', QString::SkipEmptyParts)) {
+					int metric = CZMetricFind(test.trimmed().toLatin1().constData());
+					if(metric == -1) {
+						CZLog(CZLogLevelError, tr("Wrong usage of option '-daemontests <list>'!"));
+						return false;
+					}
+					m_daemonConfig.metrics |= 1 << metric;
+				}
+				if(m_daemonConfig.metrics == 0) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-daemontests <list>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Daemon tests: %1").arg(m_argv[i]));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-daemontests <list>'!"));
 				return false;
 			}
 		} else if(QString(m_argv[i]) == "-print") {
@@ -99,12 +258,218 @@ bool CZCommandLine::parse() {
 				CZLog(CZLogLevelError, tr("Wrong usage of option '-txt <file>'!"));
 				return false;
 			}
+		} else if(QString(m_argv[i]) == "-json") {
+			if(++i < m_argc) {
+				m_exportJSON = true;
+				m_fileNameJSON = m_argv[i];
+				CZLog(CZLogLevelLow, tr("JSON file name: %1").arg(m_fileNameJSON));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-json <file>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-csv") {
+			if(++i < m_argc) {
+				m_exportCSV = true;
+				m_fileNameCSV = m_argv[i];
+				CZLog(CZLogLevelLow, tr("CSV file name: %1").arg(m_fileNameCSV));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-csv <file>'!"));
+				return false;
+			}
+		} else if((QString(m_argv[i]) == "-backend") || (QString(m_argv[i]) == "-simconfig") ||
+			(QString(m_argv[i]) == "-record") || (QString(m_argv[i]) == "-replay") ||
+			(QString(m_argv[i]) == "-cache") || (QString(m_argv[i]) == "-history") ||
+			(QString(m_argv[i]) == "-trace")) {
+			if(++i >= m_argc) { /* applied in main() before CUDA initialization */
+				CZLog(CZLogLevelError, tr("Wrong usage of option '%1'!").arg(m_argv[i - 1]));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-warmup") {
+			if(++i < m_argc) {
+				bool intOk;
+				m_warmupNum = QString(m_argv[i]).toInt(&intOk);
+				if(!intOk || (m_warmupNum < 0)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-warmup <n>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Warm-up iterations: %1").arg(m_warmupNum));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-warmup <n>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-precision") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_precision = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_precision <= 0)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-precision <pct>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Target precision: %1%").arg(m_precision));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-precision <pct>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-budget") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_budgetSec = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_budgetSec <= 0)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-budget <sec>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Time budget of test: %1 s").arg(m_budgetSec));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-budget <sec>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-baseline") {
+			if(++i < m_argc) {
+				m_baselineFileName = m_argv[i];
+				CZLog(CZLogLevelLow, tr("Baseline file name: %1").arg(m_baselineFileName));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-baseline <file>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-threshold") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_baselineConfig.thresholdPct = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_baselineConfig.thresholdPct < 0)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-threshold <pct>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Regression threshold: %1%").arg(m_baselineConfig.thresholdPct));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-threshold <pct>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-alpha") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_baselineConfig.alpha = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_baselineConfig.alpha <= 0) || (m_baselineConfig.alpha >= 1)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-alpha <p>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Significance level: %1").arg(m_baselineConfig.alpha));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-alpha <p>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-healthcheck") {
+			if(++i < m_argc) {
+				m_healthFileName = m_argv[i];
+				CZLog(CZLogLevelLow, tr("Health check thresholds file name: %1").arg(m_healthFileName));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-healthcheck <file>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-healthbudget") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_healthConfig.budgetSec = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_healthConfig.budgetSec <= 0)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-healthbudget <sec>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Time budget of health check: %1 s").arg(m_healthConfig.budgetSec));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-healthbudget <sec>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-soak") {
+			if(++i < m_argc) {
+				bool floatOk;
+				float minutes = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (minutes <= 0)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-soak <min>'!"));
+					return false;
+				}
+				m_soakTest = true;
+				m_soakConfig.durationSec = minutes * 60;
+				CZLog(CZLogLevelLow, tr("Soak test duration: %1 min").arg(minutes));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-soak <min>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-soaktest") {
+			if(++i < m_argc) {
+				m_soakConfig.metric = CZMetricFind(m_argv[i]);
+				if(m_soakConfig.metric == -1) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-soaktest <test>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Soak test: %1").arg(m_argv[i]));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-soaktest <test>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-soakinterval") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_soakConfig.intervalSec = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_soakConfig.intervalSec <= 0)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-soakinterval <sec>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Soak test interval: %1 s").arg(m_soakConfig.intervalSec));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-soakinterval <sec>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-soakdrop") {
+			if(++i < m_argc) {
+				bool floatOk;
+				m_soakConfig.dropPct = QString(m_argv[i]).toFloat(&floatOk);
+				if(!floatOk || (m_soakConfig.dropPct <= 0) || (m_soakConfig.dropPct >= 100)) {
+					CZLog(CZLogLevelError, tr("Wrong usage of option '-soakdrop <pct>'!"));
+					return false;
+				}
+				CZLog(CZLogLevelLow, tr("Soak test throttling threshold: %1%").arg(m_soakConfig.dropPct));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-soakdrop <pct>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-plugin") {
+			if(++i < m_argc) {
+				m_pluginFileName = m_argv[i];
+				CZLog(CZLogLevelLow, tr("Plugin file name: %1").arg(m_pluginFileName));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-plugin <file>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-pluginname") {
+			if(++i < m_argc) {
+				m_pluginKernelName = m_argv[i];
+				CZLog(CZLogLevelLow, tr("Plugin kernel name: %1").arg(m_pluginKernelName));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-pluginname <kernel>'!"));
+				return false;
+			}
+		} else if(QString(m_argv[i]) == "-pluginops") {
+			if((++i < m_argc) && (CZPluginEvalOps(m_argv[i], &m_pluginOps) == 0)) {
+				CZLog(CZLogLevelLow, tr("Plugin operations per thread: %1").arg(m_pluginOps));
+			} else {
+				CZLog(CZLogLevelError, tr("Wrong usage of option '-pluginops <formula>'!"));
+				return false;
+			}
 		} else {
 			CZLog(CZLogLevelError, tr("Wrong option '%1'!").arg(m_argv[i]));
 			return false;
 		}
 	}
 
+	if(!m_pluginFileName.isEmpty() && (m_pluginOps == 0)) {
+		CZLog(CZLogLevelError, tr("Option '-plugin <file>' requires option '-pluginops <formula>'!"));
+		return false;
+	}
+
+	if(!m_healthFileName.isEmpty() && (m_soakTest || !m_baselineFileName.isEmpty())) {
+		CZLog(CZLogLevelError, tr("Option '-healthcheck <file>' can't be used with options '-soak <min>' and '-baseline <file>'!"));
+		return false;
+	}
+
 	return true;
 }
 
@@ -133,6 +498,22 @@ int CZCommandLine::exec() {
 		return 0;
 	}
 
+	if(!m_mergeDirName.isEmpty()) {
+		return execMerge();
+	}
+
+	if(m_parallelTest) {
+		return execParallel();
+	}
+
+	if(m_daemon) {
+		return execDaemon();
+	}
+
+	if(m_devAll || (m_devList.size() > 1)) {
+		return execFleet();
+	}
+
 	if(m_devIndex >= CZCudaDeviceFound()) {
 		CZLog(CZLogLevelError, tr("Wrong CUDA device index!"));
 		CZLog(CZLogLevelHigh, tr("Run '%1 -cli -list' for more information").arg(CZ_NAME_SHORT));
@@ -143,70 +524,538 @@ int CZCommandLine::exec() {
 	memset(&info, 0, sizeof(info));
 	info.num = m_devIndex;
 	info.heavyMode = 0;
+	info.warmupNum = m_warmupNum;
+	info.precision = m_precision;
+	info.budgetMs = m_budgetSec * 1000;
 
 	CZLog(CZLogLevelLow, tr("Getting information about %1 ...").arg(info.num));
 	if(CZCudaReadDeviceInfo(&info, info.num) != 0) {
 		CZLog(CZLogLevelError, tr("Can't get information about device %1!").arg(info.num));
 		return 1;
 	}
+	CZTimerPhase("device info");
+
+	if(m_skipTests)
+		return exportReport(info);
+
+	if(!m_healthFileName.isEmpty()) {
+		int r = execHealth(info);
+		CZCudaCleanDevice(&info);
+		return r;
+	}
 
 	CZLog(CZLogLevelLow, tr("Preparing device %1 ...").arg(info.num));
 	if(CZCudaPrepareDevice(&info) != 0) {
 		CZLog(CZLogLevelError, tr("Can't prepare device %1!").arg(info.num));
 		return 1;
 	}
+	CZTimerPhase("context");
 
-	for(int i = 0; i < 2; i++) { /* repeat tests twice for better precision */
-		int r = CZCudaCalcDeviceBandwidth(&info);
-		if(r != -1)
-			r = CZCudaCalcDevicePerformance(&info);
+	if(m_soakTest) {
+		int r = execSoak(info);
+		CZCudaCleanDevice(&info);
+		return r;
+	}
 
-		if(r != 0) {
-			CZLog(CZLogLevelError, tr("Can't perform tests on device %1!").arg(info.num));
+	if(!m_baselineFileName.isEmpty()) {
+		int r = execBaseline(info);
+		CZCudaCleanDevice(&info);
+		return r;
+	}
+
+	int r = CZCudaCalcDeviceBandwidth(&info);
+	if(r != -1)
+		r = CZCudaCalcDevicePerformance(&info);
+
+	if(r != 0) {
+		CZLog(CZLogLevelError, tr("Can't perform tests on device %1!").arg(info.num));
+	}
+
+	CZTimerPhase("first results");
+	CZTimerPhaseLog();
+
+	if(r == 0)
+		CZHistoryAppend(&info);
+
+	if(!m_pluginFileName.isEmpty()) {
+		if(execPlugin(info) != 0) {
+			CZCudaCleanDevice(&info);
+			return 1;
 		}
 	}
 
+	r = exportReport(info);
+	CZCudaCleanDevice(&info);
+
+	return r;
+}
+
+/*!	\brief This function prints and exports CUDA information report.
+	\returns \a 0 in case of success, \a other in case of failure
+*/
+int CZCommandLine::exportReport(
+	struct CZDeviceInfo &info	/*!<[in] CUDA-device information. */
+) {
 	CZCudaDeviceInfoDecoder decoder(info);
 
-	if(m_exportHTML) {
-		QString fileName = m_fileNameHTML;
-		QFile file(fileName);
-		if(!file.open(QFile::WriteOnly | QFile::Text)) {
-			CZLog(CZLogLevelError,
-				tr("Cannot write file %1:\n%2.").arg(fileName).arg(file.errorString()));
+	if(m_exportHTML && (writeReport(m_fileNameHTML, decoder.generateHTMLReport()) != 0))
+		return 1;
+
+	if(m_exportTXT && (writeReport(m_fileNameTXT, decoder.generateTextReport()) != 0))
+		return 1;
+
+	if(m_exportJSON && (writeReport(m_fileNameJSON, decoder.generateJSONReport()) != 0))
+		return 1;
+
+	if(m_exportCSV && (writeReport(m_fileNameCSV, decoder.generateCSVReport()) != 0))
+		return 1;
+
+	if(!m_exportHTML && !m_exportTXT && !m_exportJSON && !m_exportCSV) {
+		m_printToConsole = true;
+	}
+
+	if(m_printToConsole) {
+		QTextStream stream(stdout);
+		stream << decoder.generateTextReport();
+	}
+
+	return 0;
+}
+
+/*!	\brief This function prints and exports combined report of many devices.
+	\returns \a 0 in case of success, \a other in case of failure
+*/
+int CZCommandLine::exportFleetReport(
+	const struct CZDeviceInfo *infos,	/*!<[in] Information of devices. */
+	int num				/*!<[in] Number of devices. */
+) {
+	if(m_exportHTML && (writeReport(m_fileNameHTML,
+		CZCudaDeviceInfoDecoder::generateFleetHTMLReport(infos, num, m_fleetConfig)) != 0))
+		return 1;
+
+	if(m_exportTXT && (writeReport(m_fileNameTXT,
+		CZCudaDeviceInfoDecoder::generateFleetTextReport(infos, num, m_fleetConfig)) != 0))
+		return 1;
+
+	if(m_exportJSON && (writeReport(m_fileNameJSON,
+		CZCudaDeviceInfoDecoder::generateFleetJSONReport(infos, num, m_fleetConfig)) != 0))
+		return 1;
+
+	if(m_exportCSV && (writeReport(m_fileNameCSV,
+		CZCudaDeviceInfoDecoder::generateFleetCSVReport(infos, num, m_fleetConfig)) != 0))
+		return 1;
+
+	if(!m_exportHTML && !m_exportTXT && !m_exportJSON && !m_exportCSV) {
+		m_printToConsole = true;
+	}
+
+	if(m_printToConsole) {
+		QTextStream stream(stdout);
+		stream << CZCudaDeviceInfoDecoder::generateFleetTextReport(infos, num, m_fleetConfig);
+	}
+
+	return 0;
+}
+
+/*!	\brief This function writes report to a file.
+	\returns \a 0 in case of success, \a other in case of failure
+*/
+int CZCommandLine::writeReport(
+	const QString &fileName,	/*!<[in] Name of file. */
+	const QString &report		/*!<[in] Text of report. */
+) {
+	QFile file(fileName);
+	if(!file.open(QFile::WriteOnly | QFile::Text)) {
+		CZLog(CZLogLevelError,
+			tr("Cannot write file %1:\n%2.").arg(fileName).arg(file.errorString()));
+		return 1;
+	}
+
+	QTextStream stream(&file);
+	stream << report;
+
+	return 0;
+}
+
+/*!	\brief This function compiles and runs user-supplied kernel.
+	\returns \a 0 in case of success, \a other in case of failure
+*/
+int CZCommandLine::execPlugin(
+	struct CZDeviceInfo &info	/*!<[in,out] CUDA-device information. */
+) {
+	char *source = CZPluginReadSource(m_pluginFileName.toLocal8Bit().constData());
+	if(source == NULL) {
+		CZLog(CZLogLevelError, tr("Can't read plugin file %1!").arg(m_pluginFileName));
+		return 1;
+	}
+
+	int r = CZCudaCalcDevicePlugin(&info, source, m_pluginKernelName.toLocal8Bit().constData(), m_pluginOps);
+	free(source);
+
+	if(r != 0) {
+		CZLog(CZLogLevelError, tr("Can't run plugin kernel %1 on device %2!").arg(m_pluginKernelName).arg(info.num));
+		return 1;
+	}
+
+	return 0;
+}
+
+/*!	\brief Soak test progress callback. Prints every sample to a console.
+	\returns \a 0 to continue test
+*/
+static int CZCommandLineSoakProgress(
+	void *context,			/*!<[in] Soak test configuration. */
+	const struct CZSoakSample *sample	/*!<[in] New sample of time series. */
+) {
+	const struct CZSoakConfig *config = (const struct CZSoakConfig*)context;
+
+	QTextStream stream(stdout);
+	stream << QString("%1 s: %2").arg(sample->timeSec, 0, 'f', 1)
+		.arg(CZCudaDeviceInfoDecoder::getMetricValue(config->metric, sample->value)) << endl;
+
+	return 0;
+}
+
+/*!	\brief This function runs soak test and prints its results.
+	\returns \a 0 in case of success, \a 1 in case of failure,
+	\a 2 if throttling was detected
+*/
+int CZCommandLine::execSoak(
+	struct CZDeviceInfo &info	/*!<[in,out] CUDA-device information. */
+) {
+	struct CZSoakSample *samples;
+	struct CZSoakResult result;
+	int num;
+
+	samples = new struct CZSoakSample[CZ_SOAK_SAMPLES_MAX];
+
+	num = CZSoakRun(&info, &m_soakConfig, samples, CZ_SOAK_SAMPLES_MAX, CZCommandLineSoakProgress, &m_soakConfig);
+	if((num <= 0) || (CZSoakAnalyze(&m_soakConfig, samples, num, &result) != 0)) {
+		CZLog(CZLogLevelError, tr("Can't perform soak test on device %1!").arg(info.num));
+		delete[] samples;
+		return 1;
+	}
+
+	QTextStream stream(stdout);
+	stream << QString("%1: %2").arg(tr("Device")).arg(info.deviceName) << endl;
+	stream << CZCudaDeviceInfoDecoder::generateSoakReport(m_soakConfig, NULL, num, result);
+
+	delete[] samples;
+
+	return (result.eventsNum != 0)? 2: 0;
+}
+
+/*!	\brief This function re-runs tests of baseline report and compares results with it.
+	\returns \a 0 if nothing regressed, \a 2 in case of regression, \a 1 in case of failure
+*/
+int CZCommandLine::execBaseline(
+	struct CZDeviceInfo &info	/*!<[in,out] CUDA-device information. */
+) {
+	struct CZReport *reports;
+	int reportsNum;
+	if(CZReportRead(m_baselineFileName.toLocal8Bit().constData(), &reports, &reportsNum) != 0) {
+		CZLog(CZLogLevelError, tr("Can't read baseline from %1!").arg(m_baselineFileName));
+		return 1;
+	}
+
+	int res = execBaselineCompare(info, reports[0]);
+
+	CZReportFreeAll(reports, reportsNum);
+
+	return res;
+}
+
+/*!	\brief This function re-runs tests of parsed baseline report and compares results with it.
+	\returns \a 0 if nothing regressed, \a 2 in case of regression, \a 1 in case of failure
+*/
+int CZCommandLine::execBaselineCompare(
+	struct CZDeviceInfo &info,	/*!<[in,out] CUDA-device information. */
+	const struct CZReport &baseline	/*!<[in] Fields of baseline report. */
+) {
+	const char *baseName = CZReportValue(&baseline, "device.name");
+	if((baseName == NULL) || (strcmp(baseName, info.deviceName) != 0)) {
+		CZLog(CZLogLevelWarning, tr("Baseline was recorded on %1, device %2 is %3!")
+			.arg(QString::fromUtf8(baseName)).arg(info.num).arg(info.deviceName));
+	}
+
+	struct CZBaselineResult results[CZMetricMax];
+	int num = 0;
+	int regressedNum = 0;
+
+	for(int metric = 0; metric < CZMetricMax; metric++) {
+		double baseValue;
+		struct CZDeviceInfoStat baseStat;
+		if((CZReportMetric(&baseline, metric, &baseValue, &baseStat) != 0) || (baseValue <= 0))
+			continue;
+
+		CZLog(CZLogLevelLow, tr("Testing %1 ...").arg(CZMetricName(metric)));
+		bool failed = (CZCudaCalcDeviceTest(&info, metric) != 0);
+		if(failed) {
+			CZLog(CZLogLevelError, tr("Can't perform test %1 on device %2!").arg(CZMetricName(metric)).arg(info.num));
+		}
+
+		CZBaselineCompare(&m_baselineConfig, metric, baseValue, &baseStat,
+			CZMetricValue(&info, metric), &info.stat[metric], &results[num]);
+		if(failed)
+			results[num].verdict = CZBaselineFailed;
+		if((results[num].verdict == CZBaselineRegressed) || (results[num].verdict == CZBaselineFailed))
+			regressedNum++;
+		num++;
+	}
+
+	if(num == 0) {
+		CZLog(CZLogLevelError, tr("Baseline %1 has no test results!").arg(m_baselineFileName));
+		return 1;
+	}
+
+	CZHistoryAppend(&info);
+
+	QTextStream stream(stdout);
+	stream << CZCudaDeviceInfoDecoder::generateBaselineReport(baseline, info, m_baselineConfig, results, num);
+	stream.flush();
+
+	if(m_exportHTML || m_exportTXT || m_exportJSON || m_exportCSV) {
+		if(exportReport(info) != 0)
+			return 1;
+	}
+
+	return (regressedNum != 0)? 2: 0;
+}
+
+/*!	\brief This function runs quick health check of device against
+	thresholds of its model. Device is prepared by health check itself,
+	so preparation counts into its time budget.
+	\returns \a 0 if device is healthy, \a 2 if any check failed, \a 1 in case of failure
+*/
+int CZCommandLine::execHealth(
+	struct CZDeviceInfo &info	/*!<[in,out] CUDA-device information. */
+) {
+	if(CZHealthConfigure(&m_healthConfig, m_healthFileName.toLocal8Bit().constData()) != 0)
+		return 1;
+
+	struct CZHealthResult results[CZ_HEALTH_TESTS_NUM];
+	struct CZHealthSummary summary;
+	int num = CZHealthRun(&info, &m_healthConfig, results, &summary);
+	if(num <= 0) {
+		CZLog(CZLogLevelError, tr("Can't perform health check of device %1!").arg(info.num));
+		return 1;
+	}
+
+	CZTimerPhase("health check");
+
+	QTextStream stream(stdout);
+	stream << CZCudaDeviceInfoDecoder::generateHealthReport(info, m_healthConfig, results, num, summary);
+	stream.flush();
+
+	if(m_exportJSON && (writeReport(m_fileNameJSON,
+		CZCudaDeviceInfoDecoder::generateHealthJSONReport(info, m_healthConfig, results, num, summary)) != 0))
+		return 1;
+
+	return summary.passed? 0: 2;
+}
+
+/*!	\brief This function runs parallel benchmark of all devices and prints its results.
+	\returns \a 0 in case of success, \a 1 in case of failure
+*/
+int CZCommandLine::execParallel() {
+	struct CZDeviceInfo *infos;
+	int num = CZCudaDeviceFound();
+	int i;
+
+	if(num <= 0) {
+		CZLog(CZLogLevelError, tr("No CUDA devices found!"));
+		return 1;
+	}
+
+	infos = new struct CZDeviceInfo[num];
+	memset(infos, 0, num * sizeof(infos[0]));
+
+	for(i = 0; i < num; i++) {
+		infos[i].num = i;
+		infos[i].heavyMode = 0;
+		infos[i].warmupNum = m_warmupNum;
+		infos[i].precision = m_precision;
+		infos[i].budgetMs = m_budgetSec * 1000;
+
+		CZLog(CZLogLevelLow, tr("Getting information about %1 ...").arg(i));
+		if(CZCudaReadDeviceInfo(&infos[i], i) != 0) {
+			CZLog(CZLogLevelError, tr("Can't get information about device %1!").arg(i));
+			delete[] infos;
 			return 1;
 		}
+	}
+
+	CZParallelBench bench(infos, num);
+	if(bench.run() != 0) {
+		CZLog(CZLogLevelError, tr("Can't perform parallel tests!"));
+		delete[] infos;
+		return 1;
+	}
+
+	QTextStream stream(stdout);
+	stream << CZCudaDeviceInfoDecoder::generateParallelReport(infos, bench.results(), num);
+
+	delete[] infos;
+
+	return 0;
+}
+
+/*!	\brief This function tests selected devices one after another and
+	exports combined report of them.
+	\returns \a 0 in case of success, \a 1 in case of failure
+*/
+int CZCommandLine::execFleet() {
+	struct CZDeviceInfo *infos;
+	int found = CZCudaDeviceFound();
+	int num;
+	int res = 0;
+
+	if(m_soakTest || !m_baselineFileName.isEmpty() || !m_healthFileName.isEmpty()) {
+		CZLog(CZLogLevelError, tr("Soak test, baseline comparison and health check require a single device!"));
+		return 1;
+	}
 
-		QTextStream stream(&file);
-		stream << decoder.generateHTMLReport();
+	if(m_devAll) {
+		m_devList.clear();
+		for(int i = 0; i < found; i++)
+			m_devList.append(i);
 	}
 
-	if(m_exportTXT) {
-		QString fileName = m_fileNameTXT;
-		QFile file(fileName);
-		if(!file.open(QFile::WriteOnly | QFile::Text)) {
-			CZLog(CZLogLevelError,
-				tr("Cannot write file %1:\n%2.").arg(fileName).arg(file.errorString()));
+	num = m_devList.size();
+	if(num <= 0) {
+		CZLog(CZLogLevelError, tr("No CUDA devices found!"));
+		return 1;
+	}
+
+	infos = new struct CZDeviceInfo[num];
+	memset(infos, 0, num * sizeof(infos[0]));
+
+	for(int i = 0; i < num; i++) {
+		struct CZDeviceInfo &info = infos[i];
+
+		if(m_devList[i] >= found) {
+			CZLog(CZLogLevelError, tr("Wrong CUDA device index %1!").arg(m_devList[i]));
+			CZLog(CZLogLevelHigh, tr("Run '%1 -cli -list' for more information").arg(CZ_NAME_SHORT));
+			delete[] infos;
 			return 1;
 		}
 
-		QTextStream stream(&file);
-		stream << decoder.generateTextReport();
+		info.num = m_devList[i];
+		info.heavyMode = 0;
+		info.warmupNum = m_warmupNum;
+		info.precision = m_precision;
+		info.budgetMs = m_budgetSec * 1000;
+
+		CZLog(CZLogLevelLow, tr("Getting information about %1 ...").arg(info.num));
+		if(CZCudaReadDeviceInfo(&info, info.num) != 0) {
+			CZLog(CZLogLevelError, tr("Can't get information about device %1!").arg(info.num));
+			delete[] infos;
+			return 1;
+		}
+
+		if(m_skipTests)
+			continue;
+
+		CZLog(CZLogLevelLow, tr("Preparing device %1 ...").arg(info.num));
+		if(CZCudaPrepareDevice(&info) != 0) {
+			CZLog(CZLogLevelError, tr("Can't prepare device %1!").arg(info.num));
+			res = 1;
+			continue;
+		}
+
+		int r = CZCudaCalcDeviceBandwidth(&info);
+		if(r != -1)
+			r = CZCudaCalcDevicePerformance(&info);
+
+		if(r != 0) {
+			CZLog(CZLogLevelError, tr("Can't perform tests on device %1!").arg(info.num));
+			res = 1;
+		} else {
+			CZHistoryAppend(&info);
+		}
+
+		if(!m_pluginFileName.isEmpty() && (execPlugin(info) != 0))
+			res = 1;
+
+		CZCudaCleanDevice(&info);
+	}
+
+	CZTimerPhase("fleet results");
+	CZTimerPhaseLog();
+
+	if(exportFleetReport(infos, num) != 0)
+		res = 1;
+
+	delete[] infos;
+
+	return res;
+}
+
+/*!	\brief This function merges report files of many nodes and exports
+	comparison of nodes.
+	\returns \a 0 in case of success, \a 1 in case of failure
+*/
+int CZCommandLine::execMerge() {
+	struct CZMerge merge;
+	int res = 0;
+
+	CZMergeInit(&merge, &m_fleetConfig);
+
+	if(CZMergeAddDir(&merge, m_mergeDirName.toLocal8Bit().constData()) <= 0) {
+		CZLog(CZLogLevelError, tr("No reports found in %1!").arg(m_mergeDirName));
+		res = 1;
+	} else if(CZMergeAnalyze(&merge) != 0) {
+		res = 1;
+	}
+
+	if(m_exportJSON) {
+		CZLog(CZLogLevelWarning, tr("JSON export of merged reports is not supported, use CSV."));
 	}
 
-	if(!m_exportHTML && !m_exportTXT) {
+	if((res == 0) && m_exportHTML && (writeReport(m_fileNameHTML, CZCudaDeviceInfoDecoder::generateMergeHTMLReport(merge)) != 0))
+		res = 1;
+
+	if((res == 0) && m_exportTXT && (writeReport(m_fileNameTXT, CZCudaDeviceInfoDecoder::generateMergeTextReport(merge)) != 0))
+		res = 1;
+
+	if((res == 0) && m_exportCSV && (writeReport(m_fileNameCSV, CZCudaDeviceInfoDecoder::generateMergeCSVReport(merge)) != 0))
+		res = 1;
+
+	if(!m_exportHTML && !m_exportTXT && !m_exportCSV) {
 		m_printToConsole = true;
 	}
 
-	if(m_printToConsole) {
+	if((res == 0) && m_printToConsole) {
 		QTextStream stream(stdout);
-		stream << decoder.generateTextReport();
-		return 0;
+		stream << CZCudaDeviceInfoDecoder::generateMergeTextReport(merge);
 	}
 
-	CZCudaCleanDevice(&info);
+	CZMergeFree(&merge);
 
-	return 0;
+	return res;
+}
+
+/*!	\brief This function runs benchmark daemon until it is terminated.
+	\returns \a 0 in case of success, \a 1 in case of failure
+*/
+int CZCommandLine::execDaemon() {
+
+	if(CZCudaDeviceFound() <= 0) {
+		CZLog(CZLogLevelError, tr("No CUDA devices found!"));
+		return 1;
+	}
+
+	m_daemonConfig.warmupNum = m_warmupNum;
+	m_daemonConfig.precision = m_precision;
+	m_daemonConfig.budgetMs = m_budgetSec * 1000;
+
+	CZDaemon daemon(m_daemonConfig, m_daemonSocket);
+	if(!daemon.start()) {
+		CZLog(CZLogLevelError, tr("Can't start benchmark daemon!"));
+		return 1;
+	}
+
+	return QCoreApplication::exec();
 }
 
 /*!	\brief This function returns utility title information
@@ -260,10 +1109,47 @@ const QString CZCommandLine::getHelpString() {
 	help += QString("\t-cli          %1\n").arg(tr("Activate command line interface"));
 	help += QString("\t-verbose      %1\n").arg(tr("Print more status information"));
 	help += QString("\t-list         %1\n").arg(tr("Print list of available CUDA devices"));
-	help += QString("\t-dev <n>      %1\n").arg(tr("Print/export CUDA information about device <n>"));
+	help += QString("\t-dev <list>   %1\n").arg(tr("Print/export CUDA information about device <n>, comma-separated devices or all"));
+	help += QString("\t-outlier <pct>       %1\n").arg(tr("Deviation from median of devices treated as outlier, 0 to disable (default: %1)").arg(CZ_FLEET_DEF_OUTLIER_PCT));
+	help += QString("\t-outlierz <z>        %1\n").arg(tr("Robust z-score of outlier, 0 to disable (default: %1)").arg(CZ_FLEET_DEF_OUTLIER_Z));
+	help += QString("\t-merge <dir>  %1\n").arg(tr("Compare JSON/CSV reports of many nodes from <dir>, no CUDA needed"));
+	help += QString("\t-notest       %1\n").arg(tr("Print/export static information only, without tests"));
+	help += QString("\t-parallel     %1\n").arg(tr("Test all devices in isolation and concurrently"));
+	help += QString("\t-daemon       %1\n").arg(tr("Run tests periodically and serve results in Prometheus format"));
+	help += QString("\t-port <n>     %1\n").arg(tr("Daemon HTTP port on local host, 0 to disable (default: %1)").arg(CZ_DAEMON_DEF_PORT));
+	help += QString("\t-socket <name>       %1\n").arg(tr("Daemon local socket accepting 'run' and 'metrics' commands"));
+	help += QString("\t-interval <sec>      %1\n").arg(tr("Daemon interval between test runs (default: %1)").arg(CZ_DAEMON_DEF_INTERVAL));
+	help += QString("\t-jitter <pct>        %1\n").arg(tr("Daemon random deviation of interval (default: %1)").arg(CZ_DAEMON_DEF_JITTER));
+	help += QString("\t-daemontests <list>  %1\n").arg(tr("Daemon comma-separated tests (default: %1)").arg(CZ_DAEMON_DEF_TESTS));
 	help += QString("\t-print        %1\n").arg(tr("Print CUDA information to a console (default)"));
 	help += QString("\t-html <file>  %1\n").arg(tr("Export CUDA information to a <file> as HTML"));
 	help += QString("\t-txt <file>   %1\n").arg(tr("Export CUDA information to a <file> as TXT"));
+	help += QString("\t-json <file>  %1\n").arg(tr("Export CUDA information to a <file> as JSON"));
+	help += QString("\t-csv <file>   %1\n").arg(tr("Export CUDA information to a <file> as CSV"));
+	help += QString("\t-backend <name>      %1\n").arg(tr("Benchmark backend: cuda, sim or replay (default: cuda)"));
+	help += QString("\t-simconfig <file>    %1\n").arg(tr("Read simulated devices from <file>"));
+	help += QString("\t-record <file>       %1\n").arg(tr("Record device queries and test iterations to <file>"));
+	help += QString("\t-replay <file>       %1\n").arg(tr("Replay session recorded to <file> instead of running tests"));
+	help += QString("\t-cache <file>        %1\n").arg(tr("Keep static device information in <file> (default: user cache directory)"));
+	help += QString("\t-nocache      %1\n").arg(tr("Always query static device information from driver"));
+	help += QString("\t-history <file>      %1\n").arg(tr("Append results of real devices to history <file> (default: user data directory)"));
+	help += QString("\t-nohistory    %1\n").arg(tr("Do not keep history of results"));
+	help += QString("\t-trace <file>        %1\n").arg(tr("Write Chrome trace of test phases to <file>"));
+	help += QString("\t-warmup <n>   %1\n").arg(tr("Discard <n> warm-up iterations of each test (default: %1)").arg(CZ_WARMUP_DEF_NUM));
+	help += QString("\t-precision <pct>     %1\n").arg(tr("Repeat each test until 95% confidence interval is within <pct> percents of mean"));
+	help += QString("\t-budget <sec>        %1\n").arg(tr("Time budget of each test in adaptive mode (default: 2)"));
+	help += QString("\t-baseline <file>     %1\n").arg(tr("Re-run tests of JSON/CSV report <file> and exit with 2 on regression or failed test"));
+	help += QString("\t-threshold <pct>     %1\n").arg(tr("Smallest drop treated as regression (default: 5)"));
+	help += QString("\t-alpha <p>           %1\n").arg(tr("Significance level of regression (default: 0.05)"));
+	help += QString("\t-healthcheck <file>  %1\n").arg(tr("Run quick health check against thresholds <file> and exit with 2 on failure"));
+	help += QString("\t-healthbudget <sec>  %1\n").arg(tr("Time budget of whole health check (default: %1)").arg(CZ_HEALTH_DEF_BUDGET));
+	help += QString("\t-soak <min>   %1\n").arg(tr("Run soak test for <min> minutes and report throttling"));
+	help += QString("\t-soaktest <test>     %1\n").arg(tr("Soak test to run: %1 (default: %2)").arg("hd-pin, hd-page, dh-pin, dh-page, dd, float, double, int64, int32, int24").arg(CZMetricName(CZMetricCalcFloat)));
+	help += QString("\t-soakinterval <sec>  %1\n").arg(tr("Soak test sampling interval in seconds (default: 10)"));
+	help += QString("\t-soakdrop <pct>      %1\n").arg(tr("Soak test throttling threshold in percents (default: 10)"));
+	help += QString("\t-plugin <file>       %1\n").arg(tr("Compile and run kernel from CUDA C <file>"));
+	help += QString("\t-pluginname <kernel> %1\n").arg(tr("Name of plugin kernel (default: %1)").arg(CZ_PLUGIN_KERNEL_NAME));
+	help += QString("\t-pluginops <formula> %1\n").arg(tr("Operations per thread done by plugin kernel, e.g. \"32*8*256*2\""));
 
 	return help;
 }
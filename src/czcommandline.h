@@ -10,6 +10,14 @@
 
 #include <QObject>
 #include <QString>
+#include <QList>
+
+#include "czsoak.h"
+#include "czdaemon.h"
+#include "czbaseline.h"
+#include "czfleet.h"
+#include "czhealth.h"
+#include "czreport.h"
 
 class CZCommandLine: public QObject {
 	Q_OBJECT
@@ -37,12 +45,58 @@ private:
 	bool m_needVersion;
 	bool m_printVerbose;
 	bool m_listDevices;
+	bool m_skipTests;
 	int m_devIndex;
+	bool m_devAll;
+	QList<int> m_devList;
+	struct CZFleetConfig m_fleetConfig;
+	QString m_mergeDirName;
+	int m_warmupNum;
+	float m_precision;
+	float m_budgetSec;
 	bool m_printToConsole;
 	bool m_exportHTML;
 	QString m_fileNameHTML;
 	bool m_exportTXT;
 	QString m_fileNameTXT;
+	bool m_exportJSON;
+	QString m_fileNameJSON;
+	bool m_exportCSV;
+	QString m_fileNameCSV;
+	bool m_soakTest;
+	bool m_parallelTest;
+	bool m_daemon;
+	struct CZDaemonConfig m_daemonConfig;
+	QString m_daemonSocket;
+	struct CZSoakConfig m_soakConfig;
+	QString m_baselineFileName;
+	struct CZBaselineConfig m_baselineConfig;
+	QString m_healthFileName;
+	struct CZHealthConfig m_healthConfig;
+	QString m_pluginFileName;
+	QString m_pluginKernelName;
+	double m_pluginOps;
+
+	int exportReport(struct CZDeviceInfo &info);
+	int exportFleetReport(const struct CZDeviceInfo *infos, int num);
+	static int writeReport(const QString &fileName, const QString &report);
+
+	int execPlugin(struct CZDeviceInfo &info);
+
+	int execSoak(struct CZDeviceInfo &info);
+
+	int execBaseline(struct CZDeviceInfo &info);
+	int execBaselineCompare(struct CZDeviceInfo &info, const struct CZReport &baseline);
+
+	int execHealth(struct CZDeviceInfo &info);
+
+	int execParallel();
+
+	int execFleet();
+
+	int execMerge();
+
+	int execDaemon();
 };
 
 #endif//CZ_COMMANDLINE_H
@@ -0,0 +1,432 @@
+/*!	\file czdaemon.cpp
+	\brief Headless benchmark daemon source file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <QTcpSocket>
+#include <QDateTime>
+#include <QStringList>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "version.h"
+#include "cztimer.h"
+#include "cudaarch.h"
+#include "czhistory.h"
+#include "czdaemon.h"
+#include "czdeviceinfodecoder.h"
+
+/*!	\class CZDaemon
+	\brief This class keeps all devices prepared and re-runs a light
+	benchmark set on a schedule. Latest results are exposed in Prometheus
+	text format over HTTP on local host (\a GET \a /metrics), and over a
+	local socket which also accepts on-demand runs. Socket commands are
+	one per line:
+	- \a metrics - reply with latest results;
+	- \a run - run benchmark now and reply with its results.
+*/
+
+/*!	\brief Creates benchmark daemon and its devices.
+*/
+CZDaemon::CZDaemon(
+	const struct CZDaemonConfig &config,	/*!<[in] Daemon configuration. */
+	const QString &socketName,	/*!<[in] Name of local socket, empty to disable it. */
+	QObject *parent			/*!<[in,out] Parent of daemon. */
+) 	: QObject(parent) {
+
+	m_config = config;
+	m_socketName = socketName;
+	m_runsNum = 0;
+
+	int num = CZCudaDeviceFound();
+	for(int i = 0; i < num; i++) {
+		struct CZDaemonDevice device;
+		memset(&device, 0, sizeof(device));
+
+		device.info = new CZCudaDeviceInfo(i, this);
+		device.info->waitInfo();
+		if(device.info->info().major == 0) {
+			delete device.info;
+			continue;
+		}
+
+		device.info->info().warmupNum = m_config.warmupNum;
+		device.info->info().precision = m_config.precision;
+		device.info->info().budgetMs = m_config.budgetMs;
+		device.info->infoSnapshot(device.results);
+		connect(device.info, SIGNAL(taskFinished(int,int,int,bool)), SLOT(slotTaskFinished(int,int,int,bool)));
+		m_devices.append(device);
+	}
+
+	m_timer.setSingleShot(true);
+	connect(&m_timer, SIGNAL(timeout()), SLOT(slotTimer()));
+	connect(&m_httpServer, SIGNAL(newConnection()), SLOT(slotHttpConnection()));
+	connect(&m_socketServer, SIGNAL(newConnection()), SLOT(slotSocketConnection()));
+
+	qsrand((uint)QDateTime::currentDateTime().toTime_t());
+}
+
+/*!	\brief Destroys benchmark daemon.
+*/
+CZDaemon::~CZDaemon() {
+	m_timer.stop();
+	m_httpServer.close();
+	m_socketServer.close();
+}
+
+/*!	\brief Start listening and run benchmark for the first time.
+	\returns \a true in case of success
+*/
+bool CZDaemon::start() {
+
+	if(m_devices.isEmpty()) {
+		CZLog(CZLogLevelError, tr("No devices to test!"));
+		return false;
+	}
+
+	if(m_config.port != 0) {
+		if(!m_httpServer.listen(QHostAddress::LocalHost, m_config.port)) {
+			CZLog(CZLogLevelError, tr("Can't listen on port %1: %2").arg(m_config.port).arg(m_httpServer.errorString()));
+			return false;
+		}
+		CZLog(CZLogLevelHigh, tr("Metrics are available at http://127.0.0.1:%1/metrics").arg(m_config.port));
+	}
+
+	if(!m_socketName.isEmpty()) {
+		QLocalServer::removeServer(m_socketName);
+		if(!m_socketServer.listen(m_socketName)) {
+			CZLog(CZLogLevelError, tr("Can't listen on socket %1: %2").arg(m_socketName).arg(m_socketServer.errorString()));
+			return false;
+		}
+		CZLog(CZLogLevelHigh, tr("Commands are accepted at %1").arg(m_socketServer.fullServerName()));
+	}
+
+	runNow();
+	return true;
+}
+
+/*!	\brief Check if benchmark is running now.
+*/
+bool CZDaemon::isRunning() const {
+
+	for(int i = 0; i < m_devices.size(); i++) {
+		if(m_devices[i].pending != 0)
+			return true;
+	}
+	return false;
+}
+
+/*!	\brief Run benchmark on all devices now, unless it is running already.
+*/
+void CZDaemon::runNow() {
+
+	if(isRunning())
+		return;
+
+	m_timer.stop();
+	CZLog(CZLogLevelModerate, tr("Benchmark run %1 started").arg(m_runsNum + 1));
+
+	for(int i = 0; i < m_devices.size(); i++) {
+		struct CZDaemonDevice &device = m_devices[i];
+		device.startMs = CZTimerNow();
+
+		for(int metric = 0; metric < CZMetricMax; metric++) {
+			if((m_config.metrics & (1 << metric)) == 0)
+				continue;
+
+			struct CZTask task;
+			memset(&task, 0, sizeof(task));
+			task.type = CZTaskTest;
+			task.priority = CZTaskPriorityNormal;
+			task.index = i;
+			task.metric = metric;
+			device.info->pushTask(task);
+			device.pending++;
+		}
+	}
+
+	if(!isRunning())
+		scheduleRun();
+}
+
+/*!	\brief Schedule next benchmark run with random jitter.
+*/
+void CZDaemon::scheduleRun() {
+
+	double jitter = m_config.jitterPct / 100.0 * (2.0 * qrand() / RAND_MAX - 1.0);
+	double intervalMs = m_config.intervalSec * 1000.0 * (1.0 + jitter);
+
+	if(intervalMs < 1000)
+		intervalMs = 1000;
+
+	CZLog(CZLogLevelLow, tr("Next benchmark run in %1 s").arg(intervalMs / 1000, 0, 'f', 1));
+	m_timer.start((int)intervalMs);
+}
+
+/*!	\brief Scheduled benchmark run.
+*/
+void CZDaemon::slotTimer() {
+	runNow();
+}
+
+/*!	\brief Test of benchmark run is finished.
+	When all tests of all devices are finished waiting socket clients get
+	results and next run is scheduled.
+*/
+void CZDaemon::slotTaskFinished(
+	int id,				/*!<[in] Task id. */
+	int type,			/*!<[in] Task type. */
+	int index,			/*!<[in] Index of device in daemon. */
+	bool cancelled			/*!<[in] Task was cancelled. */
+) {
+	(void)id;
+	(void)cancelled;
+
+	if((type != CZTaskTest) || (index < 0) || (index >= m_devices.size()))
+		return;
+
+	struct CZDaemonDevice &device = m_devices[index];
+	if(device.pending == 0)
+		return;
+
+	if(--device.pending == 0) {
+		device.runsNum++;
+		device.lastRunSec = QDateTime::currentDateTime().toTime_t();
+		device.lastDurationSec = (CZTimerNow() - device.startMs) / 1000;
+		device.info->infoSnapshot(device.results);
+
+		/* History of runs every few minutes would soon hide older
+		results beyond CZ_HISTORY_READ_MAX records and grow without end. */
+		if(device.lastRunSec - device.lastHistorySec >= CZ_DAEMON_HISTORY_PERIOD) {
+			CZHistoryAppend(&device.results);
+			device.lastHistorySec = device.lastRunSec;
+		}
+	}
+
+	if(isRunning())
+		return;
+
+	m_runsNum++;
+	CZLog(CZLogLevelModerate, tr("Benchmark run %1 finished").arg(m_runsNum));
+
+	QString metrics = generateMetrics();
+	for(int i = 0; i < m_waitingSockets.size(); i++) {
+		m_waitingSockets[i]->write(metrics.toUtf8());
+		m_waitingSockets[i]->disconnectFromServer();
+	}
+	m_waitingSockets.clear();
+
+	emit runFinished();
+	scheduleRun();
+}
+
+/*!	\brief Escape label value of Prometheus text format.
+*/
+static const QString CZDaemonLabel(
+	const QString &value		/*!<[in] Label value. */
+) {
+	QString out = value;
+	out.replace("\\", "\\\\");
+	out.replace("\"", "\\\"");
+	out.replace("\n", "\\n");
+	return out;
+}
+
+/*!	\brief Append one metric family of all devices and tests to Prometheus text.
+*/
+static void CZDaemonFamily(
+	QString &out,			/*!<[in,out] Prometheus text. */
+	const QList<struct CZDaemonDevice> &devices,	/*!<[in] Daemon devices. */
+	int metrics,			/*!<[in] Mask of tested metrics. */
+	const char *name,		/*!<[in] Family name. */
+	const char *help,		/*!<[in] Family description. */
+	int field			/*!<[in] Field of statistics, see CZDaemon::generateMetrics(). */
+) {
+	out += QString("# HELP cuda_z_%1 %2\n").arg(name).arg(help);
+	out += QString("# TYPE cuda_z_%1 gauge\n").arg(name);
+
+	for(int i = 0; i < devices.size(); i++) {
+		const struct CZDeviceInfo &info = devices[i].results;
+
+		for(int metric = 0; metric < CZMetricMax; metric++) {
+			if((metrics & (1 << metric)) == 0)
+				continue;
+
+			const struct CZDeviceInfoStat &stat = info.stat[metric];
+			double scale = CZCudaDeviceInfoDecoder::getMetricBaseValue(metric, 1);
+			double value;
+
+			switch(field) {
+			case 0: value = CZMetricValue(&info, metric) * scale; break;
+			case 1: value = CZArchCalcPeak(&info, metric) * scale; break;
+			case 2: value = stat.min * scale; break;
+			case 3: value = stat.max * scale; break;
+			case 4: value = stat.median * scale; break;
+			case 5: value = stat.mean * scale; break;
+			case 6: value = stat.p95 * scale; break;
+			case 7: value = stat.stddev * scale; break;
+			case 8: value = stat.cv; break;
+			case 9: value = stat.ci95; break;
+			default: value = stat.samplesNum; break;
+			}
+
+			out += QString("cuda_z_%1{device=\"%2\",test=\"%3\",unit=\"%4\"} %5\n")
+				.arg(name).arg(info.num).arg(CZMetricName(metric))
+				.arg(CZCudaDeviceInfoDecoder::getMetricBaseUnit(metric))
+				.arg(QString::number(value, 'g', 15));
+		}
+	}
+}
+
+/*!	\brief Generate latest results in Prometheus text format.
+	Rates are in B/s or op/s as shown by \a unit label. Results are the
+	copies taken when runs finished, so a run in progress is not seen.
+*/
+const QString CZDaemon::generateMetrics() const {
+
+	QString out;
+
+	out += "# HELP cuda_z_device_info Information about CUDA-device.\n";
+	out += "# TYPE cuda_z_device_info gauge\n";
+	for(int i = 0; i < m_devices.size(); i++) {
+		const struct CZDeviceInfo &info = m_devices[i].results;
+		out += QString("cuda_z_device_info{device=\"%1\",name=\"%2\",arch=\"%3\",capability=\"%4.%5\",driver=\"%6\",pci=\"%7:%8:%9\"} 1\n")
+			.arg(info.num).arg(CZDaemonLabel(info.deviceName)).arg(CZDaemonLabel(info.archName))
+			.arg(info.major).arg(info.minor).arg(CZDaemonLabel((info.drvVersion == NULL)? "": info.drvVersion))
+			.arg(info.core.pciDomainID, 4, 16, QChar('0')).arg(info.core.pciBusID, 2, 16, QChar('0')).arg(info.core.pciDeviceID, 2, 16, QChar('0'));
+	}
+
+	CZDaemonFamily(out, m_devices, m_config.metrics, "value", "Latest measured value of test.", 0);
+	CZDaemonFamily(out, m_devices, m_config.metrics, "peak", "Theoretical peak of test.", 1);
+	CZDaemonFamily(out, m_devices, m_config.metrics, "stat_min", "Minimal value of measured iterations.", 2);
+	CZDaemonFamily(out, m_devices, m_config.metrics, "stat_max", "Maximal value of measured iterations.", 3);
+	CZDaemonFamily(out, m_devices, m_config.metrics, "stat_median", "Median value of measured iterations.", 4);
+	CZDaemonFamily(out, m_devices, m_config.metrics, "stat_mean", "Mean value of measured iterations.", 5);
+	CZDaemonFamily(out, m_devices, m_config.metrics, "stat_p95", "95th percentile of measured iterations.", 6);
+	CZDaemonFamily(out, m_devices, m_config.metrics, "stat_stddev", "Standard deviation of measured iterations.", 7);
+	CZDaemonFamily(out, m_devices, m_config.metrics, "stat_cv_percent", "Coefficient of variation of measured iterations in percents.", 8);
+	CZDaemonFamily(out, m_devices, m_config.metrics, "stat_ci95_percent", "Half-width of 95% confidence interval relative to mean in percents.", 9);
+	CZDaemonFamily(out, m_devices, m_config.metrics, "stat_samples", "Number of measured iterations.", 10);
+
+	out += "# HELP cuda_z_runs_total Number of finished benchmark runs.\n";
+	out += "# TYPE cuda_z_runs_total counter\n";
+	for(int i = 0; i < m_devices.size(); i++)
+		out += QString("cuda_z_runs_total{device=\"%1\"} %2\n").arg(m_devices[i].results.num).arg(m_devices[i].runsNum);
+
+	out += "# HELP cuda_z_last_run_timestamp_seconds Time of last finished benchmark run.\n";
+	out += "# TYPE cuda_z_last_run_timestamp_seconds gauge\n";
+	for(int i = 0; i < m_devices.size(); i++)
+		out += QString("cuda_z_last_run_timestamp_seconds{device=\"%1\"} %2\n").arg(m_devices[i].results.num).arg(QString::number(m_devices[i].lastRunSec, 'f', 0));
+
+	out += "# HELP cuda_z_last_run_duration_seconds Duration of last finished benchmark run.\n";
+	out += "# TYPE cuda_z_last_run_duration_seconds gauge\n";
+	for(int i = 0; i < m_devices.size(); i++)
+		out += QString("cuda_z_last_run_duration_seconds{device=\"%1\"} %2\n").arg(m_devices[i].results.num).arg(QString::number(m_devices[i].lastDurationSec, 'f', 3));
+
+	return out;
+}
+
+/*!	\brief New connection to HTTP endpoint.
+*/
+void CZDaemon::slotHttpConnection() {
+
+	while(m_httpServer.hasPendingConnections()) {
+		QTcpSocket *socket = m_httpServer.nextPendingConnection();
+		connect(socket, SIGNAL(readyRead()), SLOT(slotHttpRead()));
+		connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+	}
+}
+
+/*!	\brief Serve HTTP request. Only request line is used, headers are ignored.
+*/
+void CZDaemon::slotHttpRead() {
+
+	QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+	if((socket == NULL) || !socket->canReadLine())
+		return;
+
+	QStringList request = QString::fromLatin1(socket->readLine()).simplified().split(' ');
+	disconnect(socket, SIGNAL(readyRead()), this, SLOT(slotHttpRead()));
+
+	QString status;
+	QString type = "text/plain; charset=utf-8";
+	QByteArray body;
+
+	if((request.size() < 2) || ((request[0] != "GET") && (request[0] != "HEAD"))) {
+		status = "405 Method Not Allowed";
+		body = "Method not allowed\n";
+	} else if(request[1] == "/metrics") {
+		status = "200 OK";
+		type = "text/plain; version=0.0.4; charset=utf-8";
+		body = generateMetrics().toUtf8();
+	} else if(request[1] == "/") {
+		status = "200 OK";
+		body = CZ_NAME_SHORT " daemon: see /metrics\n";
+	} else {
+		status = "404 Not Found";
+		body = "Not found\n";
+	}
+
+	CZLog(CZLogLevelLow, tr("HTTP %1 %2: %3").arg(request.value(0)).arg(request.value(1)).arg(status));
+
+	QByteArray response;
+	response += "HTTP/1.0 " + status.toLatin1() + "\r\n";
+	response += "Content-Type: " + type.toLatin1() + "\r\n";
+	response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+	response += "Connection: close\r\n";
+	response += "\r\n";
+	if(request.value(0) != "HEAD")
+		response += body;
+
+	socket->write(response);
+	socket->disconnectFromHost();
+}
+
+/*!	\brief New connection to local socket.
+*/
+void CZDaemon::slotSocketConnection() {
+
+	while(m_socketServer.hasPendingConnections()) {
+		QLocalSocket *socket = m_socketServer.nextPendingConnection();
+		connect(socket, SIGNAL(readyRead()), SLOT(slotSocketRead()));
+		connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+	}
+}
+
+/*!	\brief Serve command of local socket.
+*/
+void CZDaemon::slotSocketRead() {
+
+	QLocalSocket *socket = qobject_cast<QLocalSocket*>(sender());
+	if((socket == NULL) || !socket->canReadLine())
+		return;
+
+	QString command = QString::fromLatin1(socket->readLine()).trimmed();
+	disconnect(socket, SIGNAL(readyRead()), this, SLOT(slotSocketRead()));
+
+	CZLog(CZLogLevelLow, tr("Socket command: %1").arg(command));
+
+	if(command == "run") {
+		m_waitingSockets.append(socket);
+		connect(socket, SIGNAL(destroyed(QObject*)), SLOT(slotSocketDestroyed(QObject*)));
+		runNow();
+	} else if(command == "metrics") {
+		socket->write(generateMetrics().toUtf8());
+		socket->disconnectFromServer();
+	} else {
+		socket->write(QString("error: unknown command '%1'\n").arg(command).toUtf8());
+		socket->disconnectFromServer();
+	}
+}
+
+/*!	\brief Forget local socket client closed before benchmark run is finished.
+*/
+void CZDaemon::slotSocketDestroyed(
+	QObject *socket			/*!<[in] Destroyed socket. */
+) {
+	m_waitingSockets.removeAll((QLocalSocket*)socket);
+}
@@ -0,0 +1,89 @@
+/*!	\file czdaemon.h
+	\brief Headless benchmark daemon header file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_DAEMON_H
+#define CZ_DAEMON_H
+
+#include <QObject>
+#include <QList>
+#include <QTimer>
+#include <QTcpServer>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include "czdeviceinfo.h"
+
+#define CZ_DAEMON_DEF_PORT	9464			/*!< Default TCP port of metrics endpoint. */
+#define CZ_DAEMON_DEF_INTERVAL	300			/*!< Default interval between benchmark runs in seconds. */
+#define CZ_DAEMON_DEF_JITTER	10			/*!< Default random deviation of interval in percents. */
+#define CZ_DAEMON_DEF_TESTS	"hd-pin,dh-pin,dd,float"	/*!< Default light benchmark set. */
+#define CZ_DAEMON_HISTORY_PERIOD	3600		/*!< Shortest period between history records of one device in seconds. */
+
+/*!	\brief Configuration of benchmark daemon.
+*/
+struct CZDaemonConfig {
+	int		port;			/*!< TCP port of HTTP endpoint on local host, \a 0 to disable it. */
+	float		intervalSec;		/*!< Interval between benchmark runs in seconds. */
+	float		jitterPct;		/*!< Random deviation of interval in percents. */
+	int		metrics;		/*!< Mask of tests to run (bit \a 1<<metric). See enum #CZMetric. */
+	int		warmupNum;		/*!< Number of warm-up iterations discarded before each test. */
+	float		precision;		/*!< Target precision of adaptive test mode in percents, \a 0 for fixed number of iterations. */
+	float		budgetMs;		/*!< Time budget of one test in adaptive mode in milliseconds. */
+};
+
+/*!	\brief State of device in benchmark daemon.
+*/
+struct CZDaemonDevice {
+	CZCudaDeviceInfo	*info;		/*!< Device with its task thread. */
+	struct CZDeviceInfo	results;	/*!< Copy of device information taken when last run finished, metrics are served from it. */
+	int		pending;		/*!< Number of tests of current run not finished yet. */
+	int		runsNum;		/*!< Number of finished runs. */
+	double		lastRunSec;		/*!< Time of last finished run in seconds since epoch. */
+	double		lastDurationSec;	/*!< Duration of last finished run in seconds. */
+	double		lastHistorySec;		/*!< Time of run last added to history in seconds since epoch. */
+	double		startMs;		/*!< Start time of current run. */
+};
+
+class CZDaemon: public QObject {
+	Q_OBJECT
+
+public:
+	CZDaemon(const struct CZDaemonConfig &config, const QString &socketName, QObject *parent = 0);
+	~CZDaemon();
+
+	bool start();
+	void runNow();
+	bool isRunning() const;
+
+	const QString generateMetrics() const;
+
+signals:
+	void runFinished();
+
+private slots:
+	void slotTimer();
+	void slotTaskFinished(int id, int type, int index, bool cancelled);
+	void slotHttpConnection();
+	void slotHttpRead();
+	void slotSocketConnection();
+	void slotSocketRead();
+	void slotSocketDestroyed(QObject *socket);
+
+private:
+	struct CZDaemonConfig m_config;
+	QString m_socketName;
+	QList<struct CZDaemonDevice> m_devices;
+	QTimer m_timer;
+	QTcpServer m_httpServer;
+	QLocalServer m_socketServer;
+	QList<QLocalSocket*> m_waitingSockets;
+	int m_runsNum;
+
+	void scheduleRun();
+};
+
+#endif//CZ_DAEMON_H
@@ -6,42 +6,51 @@
 */
 
 #include "log.h"
+#include "cztimer.h"
+#include "cztrace.h"
 #include "czdeviceinfo.h"
 
-/*!	\class CZUpdateThread
-	\brief This class implements performance data update procedure.
+/*!	\class CZTaskThread
+	\brief This class implements queue of benchmark tasks of one device.
+	Tasks run one by one in order of priority, tasks of the same priority
+	run in order of pushing. Queued tasks can be removed and running task
+	can be stopped after its current test iteration.
+	The thread reads device information as soon as it starts, so several
+	devices are enumerated in parallel. The device is prepared for tests
+	only before the first task, so devices which are never tested do not
+	get a context and test buffers.
 */
 
-/*!	\brief Creates the performance data update thread.
+/*!	\brief Creates the benchmark task thread.
 */
-CZUpdateThread::CZUpdateThread(
+CZTaskThread::CZTaskThread(
 	CZCudaDeviceInfo *info,		/*!<[in,out] CUDA device information class. */
 	QObject *parent			/*!<[in,out] Parent of the thread. */
 )	: QThread(parent) {
 
 	m_abort = false;
-	m_testRunning = false;
-	m_deviceReady = false;
 	m_info = info;
-	m_index = -1;
+	m_nextId = 1;
+	m_runningId = 0;
+	m_runningType = -1;
+	m_cancelRunning = 0;
+	m_infoReady = false;
+	memset(&m_snapshot, 0, sizeof(m_snapshot));
 
 	CZLog(CZLogLevelLow, "Thread created");
 }
 
-/*!	\brief Terminates the performance data update thread.
-	This function waits util performance test will be over.
+/*!	\brief Terminates the benchmark task thread.
+	Queued tasks are dropped and running task is cancelled.
 */
-CZUpdateThread::~CZUpdateThread() {
+CZTaskThread::~CZTaskThread() {
 
 	m_mutex.lock();
-	m_deviceReady = true;
-	m_readyForWork.wakeOne();
 	m_abort = true;
-	m_newLoop.wakeOne();
-	m_testRunning = true;
-	m_testStart.wakeAll();
-	m_testRunning = false;
-	m_testFinish.wakeAll();
+	m_queue.clear();
+	m_cancelRunning = 1;
+	m_queueChanged.wakeAll();
+	m_taskFinished.wakeAll();
 	m_mutex.unlock();
 
 	wait();
@@ -49,101 +58,259 @@ CZUpdateThread::~CZUpdateThread() {
 	CZLog(CZLogLevelLow, "Thread is done");
 }
 
-/*!	\brief Push performance test.
+/*!	\brief Push task to queue.
+	\returns id of task.
 */
-void CZUpdateThread::testPerformance(
-	int index			/*!<[in] Index of device in list. */
+int CZTaskThread::push(
+	const struct CZTask &task	/*!<[in] Task to push. Field \a id is ignored. */
 ) {
-	CZLog(CZLogLevelModerate, "Rising update action for device %d", index);
+	struct CZTask newTask = task;
+	int pos;
 
 	m_mutex.lock();
-	m_index = index;
-	if(!isRunning()) {
-		start();
-		CZLog(CZLogLevelLow, "Waiting for device is ready...");
+	newTask.id = m_nextId++;
+	for(pos = 0; pos < m_queue.size(); pos++) {
+		if(m_queue[pos].priority < newTask.priority)
+			break;
 	}
+	m_queue.insert(pos, newTask);
+	m_queueChanged.wakeAll();
+	m_mutex.unlock();
 
-	while(!m_deviceReady)
-		m_readyForWork.wait(&m_mutex);
+	CZLog(CZLogLevelModerate, "Task %d of type %d pushed with priority %d", newTask.id, newTask.type, newTask.priority);
 
-	m_newLoop.wakeOne();
+	return newTask.id;
+}
+
+/*!	\brief Push performance test of all metrics.
+	If such test is already waiting in queue no new task is pushed,
+	so periodic refreshes do not pile up behind a long task.
+	\returns id of task.
+*/
+int CZTaskThread::pushSweep(
+	int index,			/*!<[in] Index of device in list, \a -1 to keep index and mode of waiting task. */
+	int heavyMode			/*!<[in] Heavy test mode flag. */
+) {
+	struct CZTask task;
+
+	m_mutex.lock();
+	for(int i = 0; i < m_queue.size(); i++) {
+		if((m_queue[i].type == CZTaskSweep) && (m_queue[i].priority == CZTaskPriorityNormal)) {
+			if(index != -1) {
+				m_queue[i].index = index;
+				m_queue[i].heavyMode = heavyMode;
+			}
+			int id = m_queue[i].id;
+			m_mutex.unlock();
+			return id;
+		}
+	}
 	m_mutex.unlock();
+
+	memset(&task, 0, sizeof(task));
+	task.type = CZTaskSweep;
+	task.priority = CZTaskPriorityNormal;
+	task.index = index;
+	task.heavyMode = heavyMode;
+	return push(task);
 }
 
-/*!	\brief Wait for performance test results.
+/*!	\brief Cancel task. Queued task is removed from queue,
+	running task stops after its current test iteration.
+	Signals are emitted for removed task as if it was finished.
+	\returns \a true if task was queued or running.
+*/
+bool CZTaskThread::cancel(
+	int id				/*!<[in] Id of task. */
+) {
+	struct CZTask task;
+	bool removed = false;
+	bool found = false;
+
+	m_mutex.lock();
+	if(id == m_runningId) {
+		m_cancelRunning = 1;
+		found = true;
+	} else {
+		for(int i = 0; i < m_queue.size(); i++) {
+			if(m_queue[i].id == id) {
+				task = m_queue.takeAt(i);
+				m_taskFinished.wakeAll();
+				removed = found = true;
+				break;
+			}
+		}
+	}
+	m_mutex.unlock();
+
+	if(found)
+		CZLog(CZLogLevelModerate, "Task %d cancelled", id);
+
+	if(removed) {
+		emit taskFinished(task.id, task.type, task.index, true);
+		if(task.type == CZTaskSoak)
+			emit testedSoak(task.index);
+	}
+
+	return found;
+}
+
+/*!	\brief Wait until task is finished, cancelled or removed from queue.
+*/
+void CZTaskThread::waitTask(
+	int id				/*!<[in] Id of task. */
+) {
+	CZLog(CZLogLevelModerate, "Waiting for task %d...", id);
+
+	m_mutex.lock();
+	forever {
+		bool queued = false;
+		for(int i = 0; i < m_queue.size(); i++) {
+			if(m_queue[i].id == id) {
+				queued = true;
+				break;
+			}
+		}
+		if(m_abort || (!queued && (m_runningId != id)))
+			break;
+		m_taskFinished.wait(&m_mutex);
+	}
+	m_mutex.unlock();
+
+	CZLog(CZLogLevelModerate, "Task %d is over", id);
+}
+
+/*!	\brief Wait until device information is read by the thread.
 */
-void CZUpdateThread::waitPerformance() {
+void CZTaskThread::waitInfo() {
 
-	testPerformance(-1);
+	m_mutex.lock();
+	while(!m_infoReady && !m_abort)
+		m_taskFinished.wait(&m_mutex);
+	m_mutex.unlock();
+}
 
-	CZLog(CZLogLevelModerate, "Waiting for results...");
+/*!	\brief Get copy of device information made by the thread when
+	information was read or its last task finished. Unlike
+	CZCudaDeviceInfo::info() it is safe to call while a task is running.
+*/
+void CZTaskThread::snapshot(
+	struct CZDeviceInfo &info	/*!<[out] Copy of device information. */
+) {
+	m_mutex.lock();
+	info = m_snapshot;
+	m_mutex.unlock();
+}
+
+/*!	\brief Check if task of given type is queued or running.
+*/
+bool CZTaskThread::hasTask(
+	int type			/*!<[in] Type of task. See enum #CZTaskType. */
+) {
+	bool found;
 
 	m_mutex.lock();
-	CZLog(CZLogLevelLow, "Waiting for beginnig of test...");
-	while(!m_testRunning)
-		m_testStart.wait(&m_mutex);
-	CZLog(CZLogLevelLow, "Waiting for end of test...");
-	while(m_testRunning)
-		m_testFinish.wait(&m_mutex);
+	found = (m_runningId != 0) && (m_runningType == type);
+	for(int i = 0; !found && (i < m_queue.size()); i++) {
+		if(m_queue[i].type == type)
+			found = true;
+	}
 	m_mutex.unlock();
 
-	CZLog(CZLogLevelModerate, "Got results!");
+	return found;
 }
 
 /*!	\brief Main work function of the thread.
 */
-void CZUpdateThread::run() {
+void CZTaskThread::run() {
+	bool prepared = false;
+	double startMs;
+	int device = m_info->info().num;
 
 	CZLog(CZLogLevelLow, "Thread started");
+	CZTraceThreadName(QString("device %1").arg(device).toLocal8Bit().constData());
 
-	m_info->prepareDevice();
+	startMs = CZTimerNow();
+	m_info->readInfo();
+	CZTraceSpan(CZTracePhaseInfo, device, -1, startMs);
+	CZLog(CZLogLevelModerate, "Device %d information read in %.1f ms", device, CZTimerNow() - startMs);
 
 	m_mutex.lock();
-	m_deviceReady = true;
-	m_readyForWork.wakeAll();
+	m_infoReady = true;
+	m_snapshot = m_info->info();
+	m_taskFinished.wakeAll();
 
 	forever {
-		int index;
+		struct CZTask task;
+		bool cancelled;
+		double traceMs = CZTraceStart();
 
-		CZLog(CZLogLevelLow, "Waiting for new loop...");
-		m_newLoop.wait(&m_mutex);
-		index = m_index;
-		m_mutex.unlock();
-
-		CZLog(CZLogLevelLow, "Thread loop started");
+		while(!m_abort && m_queue.isEmpty()) {
+			CZLog(CZLogLevelLow, "Waiting for new task...");
+			m_queueChanged.wait(&m_mutex);
+		}
+		CZTraceSpan(CZTracePhaseWait, device, -1, traceMs);
 
-		if(m_abort) {
-			m_mutex.lock();
+		if(m_abort)
 			break;
-		}
 
-		m_mutex.lock();
-		m_testRunning = true;
-		m_testStart.wakeAll();
+		task = m_queue.takeFirst();
+		m_runningId = task.id;
+		m_runningType = task.type;
+		m_cancelRunning = 0;
 		m_mutex.unlock();
 
-		m_info->updateInfo();
+		if(!prepared) {
+			startMs = CZTimerNow();
+			m_info->prepareDevice();
+			prepared = true;
+			CZTraceSpan(CZTracePhasePrepare, device, -1, startMs);
+			CZLog(CZLogLevelModerate, "Device %d prepared in %.1f ms", device, CZTimerNow() - startMs);
+		}
+
+		CZLog(CZLogLevelLow, "Task %d started", task.id);
+		traceMs = CZTraceStart();
+
+		switch(task.type) {
+		case CZTaskTest:
+			m_info->updateTest(task.metric, task.heavyMode, &m_cancelRunning);
+			break;
+		case CZTaskSweep:
+			m_info->updateInfo(task.heavyMode, &m_cancelRunning);
+			break;
+		case CZTaskSoak:
+			m_info->soakTest(task.soakConfig, task.heavyMode, &m_cancelRunning);
+			break;
+		}
+		CZTraceSpan(CZTracePhaseTask, device, task.type, traceMs);
 
 		m_mutex.lock();
-		m_testRunning = false;
-		m_testFinish.wakeAll();
+		cancelled = (m_cancelRunning != 0);
+		m_snapshot = m_info->info();
+		m_runningId = 0;
+		m_runningType = -1;
+		m_cancelRunning = 0;
+		m_taskFinished.wakeAll();
 		m_mutex.unlock();
 
-		if(index != -1)
-			emit testedPerformance(index);
+		CZLog(CZLogLevelLow, "Task %d finished%s", task.id, cancelled? " (cancelled)": "");
 
-		if(m_abort) {
-			m_mutex.lock();
-			break;
-		}
+		emit taskFinished(task.id, task.type, task.index, cancelled);
+		if(task.type == CZTaskSoak)
+			emit testedSoak(task.index);
+		else if(!cancelled && (task.index != -1))
+			emit testedPerformance(task.index);
 
 		m_mutex.lock();
 	}
 
-	m_deviceReady = false;
 	m_mutex.unlock();
 
-	m_info->cleanDevice();
+	if(prepared) {
+		startMs = CZTimerNow();
+		m_info->cleanDevice();
+		CZTraceSpan(CZTracePhaseClean, device, -1, startMs);
+	}
 }
 
 /*!	\class CZCudaDeviceInfo
@@ -159,9 +326,17 @@ CZCudaDeviceInfo::CZCudaDeviceInfo(
 	memset(&m_info, 0, sizeof(m_info));
 	m_info.num = devNum;
 	m_info.heavyMode = 0;
-	readInfo();
-	m_thread = new CZUpdateThread(this, this);
+	m_info.warmupNum = CZ_WARMUP_DEF_NUM;
+	m_soakTaskId = 0;
+	CZSoakConfigDefault(&m_soakConfig);
+	memset(&m_soakResult, 0, sizeof(m_soakResult));
+	m_soakSamples = new struct CZSoakSample[CZ_SOAK_SAMPLES_MAX];
+	m_soakSamplesNum = 0;
+	m_tested = false;
+	m_thread = new CZTaskThread(this, this);
+	connect(m_thread, SIGNAL(taskFinished(int,int,int,bool)), this, SIGNAL(taskFinished(int,int,int,bool)));
 	connect(m_thread, SIGNAL(testedPerformance(int)), this, SIGNAL(testedPerformance(int)));
+	connect(m_thread, SIGNAL(testedSoak(int)), this, SIGNAL(testedSoak(int)));
 	m_thread->start();
 }
 
@@ -169,6 +344,7 @@ CZCudaDeviceInfo::CZCudaDeviceInfo(
 */
 CZCudaDeviceInfo::~CZCudaDeviceInfo() {
 	delete m_thread;
+	delete[] m_soakSamples;
 }
 
 /*!	\brief This function reads CUDA-device basic information.
@@ -183,24 +359,91 @@ int CZCudaDeviceInfo::readInfo() {
 */
 int CZCudaDeviceInfo::prepareDevice() {
 	if(CZCudaCalcDeviceSelect(&m_info) != 0)
-		return 1;
+		return -1;
 	return CZCudaPrepareDevice(&m_info);
 }
 
 /*!	\brief This function updates CUDA-device performance information.
+	Results of cancelled update are dropped.
 	\returns \a 0 in case of success, \a -1 in case of error.
 */
-int CZCudaDeviceInfo::updateInfo() {
+int CZCudaDeviceInfo::updateInfo(
+	int heavyMode,			/*!<[in] Heavy test mode flag. */
+	volatile int *cancel		/*!<[in] Cancel flag, may be \a NULL. */
+) {
 	struct CZDeviceInfo info = m_info;
+	info.heavyMode = heavyMode;
+	info.cancel = cancel;
 
 	int r = CZCudaCalcDeviceBandwidth(&info);
-	if(r != -1)
+	if((r != -1) && ((cancel == NULL) || !*cancel))
 		r = CZCudaCalcDevicePerformance(&info);
 
+	if((cancel != NULL) && *cancel)
+		return -1;
+
+	info.cancel = NULL;
 	m_info = info;
+	m_tested = true;
 	return r;
 }
 
+/*!	\brief This function updates one CUDA-device bandwidth or performance value.
+	Results of cancelled update are dropped.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCudaDeviceInfo::updateTest(
+	int metric,			/*!<[in] Test to run. See enum #CZMetric. */
+	int heavyMode,			/*!<[in] Heavy test mode flag. */
+	volatile int *cancel		/*!<[in] Cancel flag, may be \a NULL. */
+) {
+	struct CZDeviceInfo info = m_info;
+	info.heavyMode = heavyMode;
+	info.cancel = cancel;
+
+	int r = CZCudaCalcDeviceTest(&info, metric);
+
+	if((cancel != NULL) && *cancel)
+		return -1;
+
+	info.cancel = NULL;
+	m_info = info;
+	return r;
+}
+
+/*!	\brief Soak test progress callback. Passes a new sample to GUI.
+	\returns \a 0 to continue test.
+*/
+int CZCudaDeviceInfo::soakProgress(
+	void *context,			/*!<[in] CUDA device information class. */
+	const struct CZSoakSample *sample	/*!<[in] New sample of time series. */
+) {
+	CZCudaDeviceInfo *info = (CZCudaDeviceInfo*)context;
+
+	emit info->soakSampled(sample->timeSec, sample->value);
+
+	return 0;
+}
+
+/*!	\brief This function runs CUDA-device soak test.
+	Measured values of performance information are not changed.
+	Samples collected before cancellation are analysed.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZCudaDeviceInfo::soakTest(
+	const struct CZSoakConfig &config,	/*!<[in] Soak test configuration. */
+	int heavyMode,			/*!<[in] Heavy test mode flag. */
+	volatile int *cancel		/*!<[in] Cancel flag, may be \a NULL. */
+) {
+	struct CZDeviceInfo info = m_info;
+	info.heavyMode = heavyMode;
+	info.cancel = cancel;
+
+	m_soakConfig = config;
+	m_soakSamplesNum = CZSoakRun(&info, &m_soakConfig, m_soakSamples, CZ_SOAK_SAMPLES_MAX, soakProgress, this);
+	return CZSoakAnalyze(&m_soakConfig, m_soakSamples, m_soakSamplesNum, &m_soakResult);
+}
+
 /*!	\brief This function cleans buffers used for bandwidth tests.
 	\returns \a 0 in case of success, \a -1 in case of error.
 */
@@ -209,21 +452,121 @@ int CZCudaDeviceInfo::cleanDevice() {
 }
 
 /*!	\brief Returns pointer to inforation structure.
+	The structure is changed by the thread when its task finishes, so
+	other threads must use infoSnapshot() while tasks may run.
 */
 struct CZDeviceInfo &CZCudaDeviceInfo::info() {
 	return m_info;
 }
 
+/*!	\brief Get copy of device information as of the last finished task.
+	See CZTaskThread::snapshot().
+*/
+void CZCudaDeviceInfo::infoSnapshot(
+	struct CZDeviceInfo &info	/*!<[out] Copy of device information. */
+) {
+	m_thread->snapshot(info);
+}
+
+/*!	\brief Wait until device information is read.
+	Information is read in background right after construction.
+*/
+void CZCudaDeviceInfo::waitInfo() {
+	m_thread->waitInfo();
+}
+
+/*!	\brief Check if all tests were done at least once.
+*/
+bool CZCudaDeviceInfo::isTested() const {
+	return m_tested;
+}
+
 /*!	\brief Push performance test in thread.
 */
 void CZCudaDeviceInfo::testPerformance(
-	int index			/*!<[in] Index of device in list. */
+	int index,			/*!<[in] Index of device in list. */
+	int heavyMode			/*!<[in] Heavy test mode flag. */
 ) {
-	m_thread->testPerformance(index);
+	m_thread->pushSweep(index, heavyMode);
 }
 
 /*!	\brief Wait for performance test results.
 */
 void CZCudaDeviceInfo::waitPerformance() {
-	m_thread->waitPerformance();
+	m_thread->waitTask(m_thread->pushSweep(-1));
+}
+
+/*!	\brief Push benchmark task in thread.
+	Signal taskFinished() is emitted when the task is over.
+	\returns id of task.
+*/
+int CZCudaDeviceInfo::pushTask(
+	const struct CZTask &task	/*!<[in] Task to push. */
+) {
+	return m_thread->push(task);
+}
+
+/*!	\brief Cancel queued or running benchmark task.
+	\returns \a true if task was queued or running.
+*/
+bool CZCudaDeviceInfo::cancelTask(
+	int id				/*!<[in] Id of task. */
+) {
+	return m_thread->cancel(id);
+}
+
+/*!	\brief Push soak test in thread.
+*/
+void CZCudaDeviceInfo::startSoak(
+	int index,			/*!<[in] Index of device in list. */
+	const struct CZSoakConfig &config,	/*!<[in] Soak test configuration. */
+	int heavyMode			/*!<[in] Heavy test mode flag. */
+) {
+	struct CZTask task;
+
+	memset(&task, 0, sizeof(task));
+	task.type = CZTaskSoak;
+	task.priority = CZTaskPriorityLow;
+	task.index = index;
+	task.soakConfig = config;
+	task.heavyMode = heavyMode;
+
+	m_soakSamplesNum = 0;
+	m_soakTaskId = m_thread->push(task);
+}
+
+/*!	\brief Stop soak test after current test iteration.
+*/
+void CZCudaDeviceInfo::cancelSoak() {
+	m_thread->cancel(m_soakTaskId);
+}
+
+/*!	\brief Check if soak test is queued or running.
+*/
+bool CZCudaDeviceInfo::isSoakRunning() const {
+	return m_thread->hasTask(CZTaskSoak);
+}
+
+/*!	\brief Returns configuration of last soak test.
+*/
+const struct CZSoakConfig &CZCudaDeviceInfo::soakConfig() const {
+	return m_soakConfig;
+}
+
+/*!	\brief Returns analysis results of last soak test.
+*/
+const struct CZSoakResult &CZCudaDeviceInfo::soakResult() const {
+	return m_soakResult;
+}
+
+/*!	\brief Returns time series of last soak test.
+*/
+const struct CZSoakSample *CZCudaDeviceInfo::soakSamples() const {
+	return m_soakSamples;
+}
+
+/*!	\brief Returns number of samples in time series of last soak test.
+*/
+int CZCudaDeviceInfo::soakSamplesNum() const {
+	return m_soakSamplesNum;
 }
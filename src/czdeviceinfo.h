@@ -11,39 +11,78 @@
 #include <QThread>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QList>
 
 #include "cudainfo.h"
+#include "czsoak.h"
 
 class CZCudaDeviceInfo;
 
-class CZUpdateThread: public QThread {
+/*!	\brief Type of benchmark task.
+*/
+enum CZTaskType {
+	CZTaskTest = 0,				/*!< One bandwidth or performance test. */
+	CZTaskSweep,				/*!< All bandwidth and performance tests. */
+	CZTaskSoak,				/*!< Soak test. */
+};
+
+/*!	\brief Priority of benchmark task. Tasks of higher priority run first.
+*/
+enum CZTaskPriority {
+	CZTaskPriorityLow = 0,			/*!< Long background tasks. */
+	CZTaskPriorityNormal,			/*!< Periodic refresh of results. */
+	CZTaskPriorityHigh,			/*!< Quick tasks requested by user. */
+};
+
+/*!	\brief Benchmark task.
+*/
+struct CZTask {
+	int		id;			/*!< Unique task id assigned by CZTaskThread::push(). */
+	int		type;			/*!< Task type. See enum #CZTaskType. */
+	int		priority;		/*!< Task priority. See enum #CZTaskPriority. */
+	int		index;			/*!< Index of device in list, passed back in signals. */
+	int		metric;			/*!< Test of #CZTaskTest task. See enum #CZMetric. */
+	int		heavyMode;		/*!< Heavy test mode flag of task. */
+	struct CZSoakConfig	soakConfig;	/*!< Configuration of #CZTaskSoak task. */
+};
+
+class CZTaskThread: public QThread {
 	Q_OBJECT
 
 public:
-	CZUpdateThread(CZCudaDeviceInfo *info, QObject *parent = 0);
-	~CZUpdateThread();
+	CZTaskThread(CZCudaDeviceInfo *info, QObject *parent = 0);
+	~CZTaskThread();
 
-	void testPerformance(int index);
-	void waitPerformance();
+	int push(const struct CZTask &task);
+	int pushSweep(int index, int heavyMode = 0);
+	bool cancel(int id);
+	void waitTask(int id);
+	void waitInfo();
+	bool hasTask(int type);
+	void snapshot(struct CZDeviceInfo &info);
 
 signals:
+	void taskFinished(int id, int type, int index, bool cancelled);
 	void testedPerformance(int index);
+	void testedSoak(int index);
 
 protected:
 	void run();
 
 private:
 	QMutex m_mutex;
-	QWaitCondition m_newLoop;
-	QWaitCondition m_readyForWork;
-	QWaitCondition m_testStart;
-	QWaitCondition m_testFinish;
+	QWaitCondition m_queueChanged;
+	QWaitCondition m_taskFinished;
 	CZCudaDeviceInfo *m_info;
 
-	int m_index;
+	QList<struct CZTask> m_queue;
+	int m_nextId;
+	int m_runningId;
+	int m_runningType;
+	volatile int m_cancelRunning;
 	bool m_abort;
-	bool m_deviceReady;
-	bool m_testRunning;
+	bool m_infoReady;
+	struct CZDeviceInfo m_snapshot;
 };
 
 class CZCudaDeviceInfo: public QObject {
@@ -55,20 +94,48 @@ public:
 
 	int readInfo();
 	int prepareDevice();
-	int updateInfo();
+	int updateInfo(int heavyMode = 0, volatile int *cancel = NULL);
+	int updateTest(int metric, int heavyMode = 0, volatile int *cancel = NULL);
+	int soakTest(const struct CZSoakConfig &config, int heavyMode = 0, volatile int *cancel = NULL);
 	int cleanDevice();
 
 	struct CZDeviceInfo &info();
+	void infoSnapshot(struct CZDeviceInfo &info);
+	void waitInfo();
+	bool isTested() const;
 
-	void testPerformance(int index);
+	void testPerformance(int index, int heavyMode = 0);
 	void waitPerformance();
 
+	int pushTask(const struct CZTask &task);
+	bool cancelTask(int id);
+
+	void startSoak(int index, const struct CZSoakConfig &config, int heavyMode = 0);
+	void cancelSoak();
+	bool isSoakRunning() const;
+	const struct CZSoakConfig &soakConfig() const;
+	const struct CZSoakResult &soakResult() const;
+	const struct CZSoakSample *soakSamples() const;
+	int soakSamplesNum() const;
+
 signals:
+	void taskFinished(int id, int type, int index, bool cancelled);
 	void testedPerformance(int index);
+	void testedSoak(int index);
+	void soakSampled(float timeSec, float value);
 
 private:
 	struct CZDeviceInfo m_info;
-	CZUpdateThread *m_thread;
+	CZTaskThread *m_thread;
+	volatile bool m_tested;
+
+	int m_soakTaskId;
+	struct CZSoakConfig m_soakConfig;
+	struct CZSoakResult m_soakResult;
+	struct CZSoakSample *m_soakSamples;
+	int m_soakSamplesNum;
+
+	static int soakProgress(void *context, const struct CZSoakSample *sample);
 };
 
 #endif//CZ_DEVICEINFO_H
@@ -7,9 +7,13 @@
 
 #include <time.h>
 
+#include <QStringList>
+
 #include "version.h"
 #include "log.h"
 #include "platform.h"
+#include "cudaarch.h"
+#include "czreport.h"
 #include "czdeviceinfodecoder.h"
 
 /*!	\class CZCudaDeviceInfoDecoder
@@ -22,7 +26,7 @@ CZCudaDeviceInfoDecoder::CZCudaDeviceInfoDecoder(
 	CZCudaDeviceInfo &info,		/*!<[in] CUDA device information. */
 	QObject *parent			/*!<[in,out] Parent of CUDA device information. */
 ) 	: QObject(parent) {
-	m_info = info.info();
+	info.infoSnapshot(m_info);
 }
 
 /*!	\brief Creates CUDA-device information decoder.
@@ -303,6 +307,16 @@ static const QString funcAsyncEngine(const struct CZDeviceInfo &info) {
 		QObject::tr("%1 Yes, Bidirectional").arg(info.mem.asyncEngineCount);
 }
 
+/*!	\brief Get efficiency suffix for measured \a metric.
+	\returns " (NN%)" string, or empty string if theoretical peak is unknown.
+*/
+static const QString funcEfficiency(const struct CZDeviceInfo &info, int metric) {
+	double efficiency = CZArchCalcEfficiency(&info, metric);
+	if(efficiency <= 0)
+		return QString();
+	return QString(" (%1%)").arg(efficiency, 0, 'f', 0);
+}
+
 #define nameMemoryCopy		QT_TR_NOOP("Memory Copy")
 #define funcMemoryCopy		funcNull
 
@@ -311,7 +325,8 @@ static const QString funcHostPinnedToDevice(const struct CZDeviceInfo &info) {
 	if(info.band.copyHDPin == 0)
 		return QString("--");
 	else
-		return CZCudaDeviceInfoDecoder::getValue1024(info.band.copyHDPin, CZCudaDeviceInfoDecoder::prefixKibi, QObject::tr("B/s"));
+		return CZCudaDeviceInfoDecoder::getValue1024(info.band.copyHDPin, CZCudaDeviceInfoDecoder::prefixKibi, QObject::tr("B/s"))
+			+ funcEfficiency(info, CZMetricCopyHDPin);
 }
 
 #define nameHostPageableToDevice	QT_TR_NOOP("Host Pageable to Device")
@@ -319,7 +334,8 @@ static const QString funcHostPageableToDevice(const struct CZDeviceInfo &info) {
 	if(info.band.copyHDPage == 0)
 		return QString("--");
 	else
-		return CZCudaDeviceInfoDecoder::getValue1024(info.band.copyHDPage, CZCudaDeviceInfoDecoder::prefixKibi, QObject::tr("B/s"));
+		return CZCudaDeviceInfoDecoder::getValue1024(info.band.copyHDPage, CZCudaDeviceInfoDecoder::prefixKibi, QObject::tr("B/s"))
+			+ funcEfficiency(info, CZMetricCopyHDPage);
 }
 
 #define nameDeviceToHostPinned	QT_TR_NOOP("Device to Host Pinned")
@@ -327,7 +343,8 @@ static const QString funcDeviceToHostPinned(const struct CZDeviceInfo &info) {
 	if(info.band.copyDHPin == 0)
 		return QString("--");
 	else
-		return CZCudaDeviceInfoDecoder::getValue1024(info.band.copyDHPin, CZCudaDeviceInfoDecoder::prefixKibi, QObject::tr("B/s"));
+		return CZCudaDeviceInfoDecoder::getValue1024(info.band.copyDHPin, CZCudaDeviceInfoDecoder::prefixKibi, QObject::tr("B/s"))
+			+ funcEfficiency(info, CZMetricCopyDHPin);
 }
 
 #define nameDeviceToHostPageable	QT_TR_NOOP("Device to Host Pageable")
@@ -335,7 +352,8 @@ static const QString funcDeviceToHostPageable(const struct CZDeviceInfo &info) {
 	if(info.band.copyDHPage == 0)
 		return QString("--");
 	else
-		return CZCudaDeviceInfoDecoder::getValue1024(info.band.copyDHPage, CZCudaDeviceInfoDecoder::prefixKibi, QObject::tr("B/s"));
+		return CZCudaDeviceInfoDecoder::getValue1024(info.band.copyDHPage, CZCudaDeviceInfoDecoder::prefixKibi, QObject::tr("B/s"))
+			+ funcEfficiency(info, CZMetricCopyDHPage);
 }
 
 #define nameDeviceToDevice	QT_TR_NOOP("Device to Device")
@@ -343,7 +361,8 @@ static const QString funcDeviceToDevice(const struct CZDeviceInfo &info) {
 	if(info.band.copyDD == 0)
 		return QString("--");
 	else
-		return CZCudaDeviceInfoDecoder::getValue1024(info.band.copyDD, CZCudaDeviceInfoDecoder::prefixKibi, QObject::tr("B/s"));
+		return CZCudaDeviceInfoDecoder::getValue1024(info.band.copyDD, CZCudaDeviceInfoDecoder::prefixKibi, QObject::tr("B/s"))
+			+ funcEfficiency(info, CZMetricCopyDD);
 }
 
 #define nameCorePerformance	QT_TR_NOOP("GPU Core Performance")
@@ -354,7 +373,8 @@ static const QString funcFloatRate(const struct CZDeviceInfo &info) {
 	if(info.perf.calcFloat == 0)
 		return QString("--");
 	else
-		return CZCudaDeviceInfoDecoder::getValue1000(info.perf.calcFloat, CZCudaDeviceInfoDecoder::prefixKilo, QObject::tr("flop/s"));
+		return CZCudaDeviceInfoDecoder::getValue1000(info.perf.calcFloat, CZCudaDeviceInfoDecoder::prefixKilo, QObject::tr("flop/s"))
+			+ funcEfficiency(info, CZMetricCalcFloat);
 }
 
 #define nameDoubleRate		QT_TR_NOOP("Double-precision Float")
@@ -364,7 +384,8 @@ static const QString funcDoubleRate(const struct CZDeviceInfo &info) {
 		if(info.perf.calcDouble == 0)
 			return QString("--");
 		else
-			return CZCudaDeviceInfoDecoder::getValue1000(info.perf.calcDouble, CZCudaDeviceInfoDecoder::prefixKilo, QObject::tr("flop/s"));
+			return CZCudaDeviceInfoDecoder::getValue1000(info.perf.calcDouble, CZCudaDeviceInfoDecoder::prefixKilo, QObject::tr("flop/s"))
+				+ funcEfficiency(info, CZMetricCalcDouble);
 	} else {
 		return QObject::tr("Not Supported");
 	}
@@ -375,7 +396,8 @@ static const QString funcInt64Rate(const struct CZDeviceInfo &info) {
 	if(info.perf.calcInteger64 == 0)
 		return QString("--");
 	else
-		return CZCudaDeviceInfoDecoder::getValue1000(info.perf.calcInteger64, CZCudaDeviceInfoDecoder::prefixKilo, QObject::tr("iop/s"));
+		return CZCudaDeviceInfoDecoder::getValue1000(info.perf.calcInteger64, CZCudaDeviceInfoDecoder::prefixKilo, QObject::tr("iop/s"))
+			+ funcEfficiency(info, CZMetricCalcInteger64);
 }
 
 #define nameInt32Rate		QT_TR_NOOP("32-bit Integer")
@@ -383,7 +405,8 @@ static const QString funcInt32Rate(const struct CZDeviceInfo &info) {
 	if(info.perf.calcInteger32 == 0)
 		return QString("--");
 	else
-		return CZCudaDeviceInfoDecoder::getValue1000(info.perf.calcInteger32, CZCudaDeviceInfoDecoder::prefixKilo, QObject::tr("iop/s"));
+		return CZCudaDeviceInfoDecoder::getValue1000(info.perf.calcInteger32, CZCudaDeviceInfoDecoder::prefixKilo, QObject::tr("iop/s"))
+			+ funcEfficiency(info, CZMetricCalcInteger32);
 }
 
 #define nameInt24Rate		QT_TR_NOOP("24-bit Integer")
@@ -391,7 +414,19 @@ static const QString funcInt24Rate(const struct CZDeviceInfo &info) {
 	if(info.perf.calcInteger24 == 0)
 		return QString("--");
 	else
-		return CZCudaDeviceInfoDecoder::getValue1000(info.perf.calcInteger24, CZCudaDeviceInfoDecoder::prefixKilo, QObject::tr("iop/s"));
+		return CZCudaDeviceInfoDecoder::getValue1000(info.perf.calcInteger24, CZCudaDeviceInfoDecoder::prefixKilo, QObject::tr("iop/s"))
+			+ funcEfficiency(info, CZMetricCalcInteger24);
+}
+
+#define namePluginRate		QT_TR_NOOP("Plugin")
+static const QString funcPluginRate(const struct CZDeviceInfo &info) {
+	if(info.perf.pluginName[0] == 0)
+		return QString("--");
+	else if(info.perf.calcPlugin == 0)
+		return QString("%1: --").arg(info.perf.pluginName);
+	else
+		return QString("%1: ").arg(info.perf.pluginName)
+			+ CZCudaDeviceInfoDecoder::getMetricValue(-1, info.perf.calcPlugin);
 }
 
 #define INFO(_id_)		{CZCudaDeviceInfoDecoder::id ## _id_, name ## _id_, func ## _id_}
@@ -449,6 +484,7 @@ static const CZCudaDeviceInfoDecoderInfo s_infoTab[] = {
 	INFO(Int64Rate),
 	INFO(Int32Rate),
 	INFO(Int24Rate),
+	INFO(PluginRate),
 };
 
 /*!	\brief Get a name for the field of information
@@ -489,6 +525,111 @@ const QString CZCudaDeviceInfoDecoder::getValue(
 	return funcNull(m_info);
 }
 
+/*!	\brief Get a measured metric for the field of information
+	\returns Metric (see enum #CZMetric), or \a -1 if field is not a measured metric
+*/
+int CZCudaDeviceInfoDecoder::getMetric(
+	int id				/*!<[in] Field id. */
+) {
+	switch(id) {
+	case idHostPinnedToDevice:	return CZMetricCopyHDPin;
+	case idHostPageableToDevice:	return CZMetricCopyHDPage;
+	case idDeviceToHostPinned:	return CZMetricCopyDHPin;
+	case idDeviceToHostPageable:	return CZMetricCopyDHPage;
+	case idDeviceToDevice:		return CZMetricCopyDD;
+	case idFloatRate:		return CZMetricCalcFloat;
+	case idDoubleRate:		return CZMetricCalcDouble;
+	case idInt64Rate:		return CZMetricCalcInteger64;
+	case idInt32Rate:		return CZMetricCalcInteger32;
+	case idInt24Rate:		return CZMetricCalcInteger24;
+	default:			return -1;
+	}
+}
+
+/*!	\brief Get a theoretical peak for the field of information
+	\returns Theoretical peak of cuda information field
+*/
+const QString CZCudaDeviceInfoDecoder::getPeak(
+	int id				/*!<[in] Field id. */
+) const {
+
+	int metric = getMetric(id);
+	if(metric == -1)
+		return funcNull(m_info);
+
+	double peak = CZArchCalcPeak(&m_info, metric);
+	if(peak <= 0)
+		return funcNull(m_info);
+
+	return getMetricValue(metric, peak);
+}
+
+/*!	\brief Get statistics of measured iterations for the field of information
+	\returns Statistics of cuda information field
+*/
+const QString CZCudaDeviceInfoDecoder::getStat(
+	int id				/*!<[in] Field id. */
+) const {
+	const struct CZDeviceInfoStat *stat;
+
+	int metric = getMetric(id);
+	if(metric != -1)
+		stat = &m_info.stat[metric];
+	else if(id == idPluginRate)
+		stat = &m_info.perf.calcPluginStat;
+	else
+		return funcNull(m_info);
+
+	if(stat->samplesNum == 0)
+		return funcNull(m_info);
+
+	return QString("%1 %2%3%, ").arg(tr("CI95")).arg(QChar(0xb1)).arg(stat->ci95, 0, 'f', 2)
+		+ QString("%1 %2, %3 %4, %5 %6, %7 %8, %9 %10, %11 %12%, n=%13")
+		.arg(tr("min")).arg(getMetricValue(metric, stat->min))
+		.arg(tr("median")).arg(getMetricValue(metric, stat->median))
+		.arg(tr("mean")).arg(getMetricValue(metric, stat->mean))
+		.arg(tr("p95")).arg(getMetricValue(metric, stat->p95))
+		.arg(tr("stddev")).arg(getMetricValue(metric, stat->stddev))
+		.arg(tr("CV")).arg(stat->cv, 0, 'f', 2)
+		.arg(stat->samplesNum);
+}
+
+/*!	\brief Format a value of measured metric with its units.
+	\returns Value and unit string
+*/
+const QString CZCudaDeviceInfoDecoder::getMetricValue(
+	int metric,			/*!<[in] Metric. See enum #CZMetric. */
+	double value			/*!<[in] Value in KiB/s or K(FL)OPS. */
+) {
+	if((metric < 0) || (metric >= CZMetricMax))
+		return getValue1000(value, prefixKilo, tr("op/s"));
+	else if(metric <= CZMetricCopyDD)
+		return getValue1024(value, prefixKibi, tr("B/s"));
+	else if(metric <= CZMetricCalcDouble)
+		return getValue1000(value, prefixKilo, tr("flop/s"));
+	else
+		return getValue1000(value, prefixKilo, tr("iop/s"));
+}
+
+/*!	\brief Convert a value of measured metric to base units.
+	\returns Value in B/s or op/s
+*/
+double CZCudaDeviceInfoDecoder::getMetricBaseValue(
+	int metric,			/*!<[in] Metric. See enum #CZMetric, \a -1 for user-supplied kernel. */
+	double value			/*!<[in] Value in KiB/s or K(FL)OPS. */
+) {
+	return value * CZReportMetricScale(metric);
+}
+
+/*!	\brief Get base unit of measured metric.
+	\returns Unit string of getMetricBaseValue() result
+*/
+const QString CZCudaDeviceInfoDecoder::getMetricBaseUnit(
+	int metric			/*!<[in] Metric. See enum #CZMetric, \a -1 for user-supplied kernel. */
+) {
+	return CZReportMetricUnit(metric);
+}
+
 /*!	\brief This function returns value and unit in SI format.
 */
 const QString CZCudaDeviceInfoDecoder::getValue1000(
@@ -551,14 +692,22 @@ const QString CZCudaDeviceInfoDecoder::getValue1024(
 
 #define CZ_TXT_EXPORT(_id_)		out += getName(id ## _id_) + ": " + getValue(id ## _id_) + "\n"
 #define CZ_TXT_EXPORT_TAB(_id_)		out += "\t" + getName(id ## _id_) + ": " + getValue(id ## _id_) + "\n"
+#define CZ_TXT_EXPORT_PEAK(_id_)	out += "\t" + getName(id ## _id_) + ": " + getValue(id ## _id_) + ", " + tr("Peak") + ": " + getPeak(id ## _id_) + "\n" \
+					+ "\t\t" + tr("Statistics") + ": " + getStat(id ## _id_) + "\n"
 
 /*!	\brief Generate plane text report.
 */
 const QString CZCudaDeviceInfoDecoder::generateTextReport() const {
+	return generateTextHead(tr(CZ_NAME_SHORT " Report")) + generateTextBody() + generateTextTail();
+}
+
+/*!	\brief Generate title and version information of plane text report.
+*/
+const QString CZCudaDeviceInfoDecoder::generateTextHead(
+	const QString &title		/*!<[in] Title of report. */
+) {
 
 	QString out;
-	QString title = tr(CZ_NAME_SHORT " Report");
-	QString subtitle;
 
 	out += title;
 	out += "\n";
@@ -572,6 +721,16 @@ const QString CZCudaDeviceInfoDecoder::generateTextReport() const {
 	out += " " CZ_ORG_URL_MAINPAGE "\n";
 	out += tr("OS Version") + ": " + getOSVersion() + "\n";
 
+	return out;
+}
+
+/*!	\brief Generate device information part of plane text report.
+*/
+const QString CZCudaDeviceInfoDecoder::generateTextBody() const {
+
+	QString out;
+	QString subtitle;
+
 	CZ_TXT_EXPORT(DrvVersion);
 	CZ_TXT_EXPORT(DrvDllVersion);
 	CZ_TXT_EXPORT(RtDllVersion);
@@ -629,19 +788,30 @@ const QString CZCudaDeviceInfoDecoder::generateTextReport() const {
 		out += "-";
 	out += "\n";
 	out += tr("Memory Copy") + "\n";
-	CZ_TXT_EXPORT_TAB(HostPinnedToDevice);
-	CZ_TXT_EXPORT_TAB(HostPageableToDevice);
-	CZ_TXT_EXPORT_TAB(DeviceToHostPinned);
-	CZ_TXT_EXPORT_TAB(DeviceToHostPageable);
-	CZ_TXT_EXPORT_TAB(DeviceToDevice);
+	CZ_TXT_EXPORT_PEAK(HostPinnedToDevice);
+	CZ_TXT_EXPORT_PEAK(HostPageableToDevice);
+	CZ_TXT_EXPORT_PEAK(DeviceToHostPinned);
+	CZ_TXT_EXPORT_PEAK(DeviceToHostPageable);
+	CZ_TXT_EXPORT_PEAK(DeviceToDevice);
 	out += tr("GPU Core Performance") + "\n";
-	CZ_TXT_EXPORT_TAB(FloatRate);
-	CZ_TXT_EXPORT_TAB(DoubleRate);
-	CZ_TXT_EXPORT_TAB(Int64Rate);
-	CZ_TXT_EXPORT_TAB(Int32Rate);
-	CZ_TXT_EXPORT_TAB(Int24Rate);
+	CZ_TXT_EXPORT_PEAK(FloatRate);
+	CZ_TXT_EXPORT_PEAK(DoubleRate);
+	CZ_TXT_EXPORT_PEAK(Int64Rate);
+	CZ_TXT_EXPORT_PEAK(Int32Rate);
+	CZ_TXT_EXPORT_PEAK(Int24Rate);
+	if(m_info.perf.pluginName[0] != 0)
+		CZ_TXT_EXPORT_PEAK(PluginRate);
 	out += "\n";
 
+	return out;
+}
+
+/*!	\brief Generate closing part of plane text report.
+*/
+const QString CZCudaDeviceInfoDecoder::generateTextTail() {
+
+	QString out;
+
 	time_t t;
 	time(&t);
 	out += QString("%1: %2").arg(tr("Generated")).arg(ctime(&t)) + "\n";
@@ -651,13 +821,21 @@ const QString CZCudaDeviceInfoDecoder::generateTextReport() const {
 
 #define CZ_HTML_EXPORT(_id_)		out += "<b>" + getName(id ## _id_) + "</b>: " + getValue(id ## _id_) + "<br/>\n"
 #define CZ_HTML_EXPORT_TAB(_id_)	out += "<tr><th>" + getName(id ## _id_) + "</th><td>" + getValue(id ## _id_) + "</td></tr>\n"
+#define CZ_HTML_EXPORT_PEAK(_id_)	out += "<tr><th>" + getName(id ## _id_) + "</th><td>" + getValue(id ## _id_) + "</td><td>" + getPeak(id ## _id_) + "</td><td>" + getStat(id ## _id_) + "</td></tr>\n"
 
 /*!	\brief Generate HTML v5 report.
 */
 const QString CZCudaDeviceInfoDecoder::generateHTMLReport() const {
+	return generateHTMLHead(tr(CZ_NAME_SHORT " Report")) + generateHTMLBody() + generateHTMLTail();
+}
+
+/*!	\brief Generate header, title and version information of HTML v5 report.
+*/
+const QString CZCudaDeviceInfoDecoder::generateHTMLHead(
+	const QString &title		/*!<[in] Title of report. */
+) {
 
 	QString out;
-	QString title = tr(CZ_NAME_SHORT " Report");
 
 	out += "<!DOCTYPE html>\n"
 		"<html>\n"
@@ -674,6 +852,9 @@ const QString CZCudaDeviceInfoDecoder::generateHTMLReport() const {
 		"table { border-collapse: collapse; width: 500px; }\n"
 		"th { background-color: #deb; text-align: left; }\n"
 		"td { width: 50%; }\n"
+		"table.summary { width: auto; }\n"
+		"table.summary td { width: auto; }\n"
+		"td.outlier { background-color: #fcc; }\n"
 		"a:link { color: #9c3; text-decoration: none; }\n"
 		"a:visited { color: #690; text-decoration: none; }\n"
 		"a:hover { color: #9c3; text-decoration: underline; }\n"
@@ -691,7 +872,18 @@ const QString CZCudaDeviceInfoDecoder::generateHTMLReport() const {
 #endif//CZ_VER_STATE
 	out += " <a href=\"" CZ_ORG_URL_MAINPAGE "\">" CZ_ORG_URL_MAINPAGE "</a><br/>\n";
 	out += "<b>" + tr("OS Version") + ":</b> " + getOSVersion() + "<br/>\n";
+	out += "</small></p>\n";
+
+	return out;
+}
+
+/*!	\brief Generate device information part of HTML v5 report.
+*/
+const QString CZCudaDeviceInfoDecoder::generateHTMLBody() const {
+
+	QString out;
 
+	out += "<p><small>";
 	CZ_HTML_EXPORT(DrvVersion);
 	CZ_HTML_EXPORT(DrvDllVersion);
 	CZ_HTML_EXPORT(RtDllVersion);
@@ -739,20 +931,31 @@ const QString CZCudaDeviceInfoDecoder::generateHTMLReport() const {
 
 	out += "<h2>" + tr("Performance Information") + "</h2>\n";
 	out += "<table>\n";
-	out += "<tr><th colspan=\"2\">" + tr("Memory Copy") + "</th></tr>\n";
-	CZ_HTML_EXPORT_TAB(HostPinnedToDevice);
-	CZ_HTML_EXPORT_TAB(HostPageableToDevice);
-	CZ_HTML_EXPORT_TAB(DeviceToHostPinned);
-	CZ_HTML_EXPORT_TAB(DeviceToHostPageable);
-	CZ_HTML_EXPORT_TAB(DeviceToDevice);
-	out += "<tr><th colspan=\"2\">" + tr("GPU Core Performance") + "</th></tr>\n";
-	CZ_HTML_EXPORT_TAB(FloatRate);
-	CZ_HTML_EXPORT_TAB(DoubleRate);
-	CZ_HTML_EXPORT_TAB(Int64Rate);
-	CZ_HTML_EXPORT_TAB(Int32Rate);
-	CZ_HTML_EXPORT_TAB(Int24Rate);
+	out += "<tr><th>" + tr("Memory Copy") + "</th><th>" + tr("Measured") + "</th><th>" + tr("Peak") + "</th><th>" + tr("Statistics") + "</th></tr>\n";
+	CZ_HTML_EXPORT_PEAK(HostPinnedToDevice);
+	CZ_HTML_EXPORT_PEAK(HostPageableToDevice);
+	CZ_HTML_EXPORT_PEAK(DeviceToHostPinned);
+	CZ_HTML_EXPORT_PEAK(DeviceToHostPageable);
+	CZ_HTML_EXPORT_PEAK(DeviceToDevice);
+	out += "<tr><th colspan=\"4\">" + tr("GPU Core Performance") + "</th></tr>\n";
+	CZ_HTML_EXPORT_PEAK(FloatRate);
+	CZ_HTML_EXPORT_PEAK(DoubleRate);
+	CZ_HTML_EXPORT_PEAK(Int64Rate);
+	CZ_HTML_EXPORT_PEAK(Int32Rate);
+	CZ_HTML_EXPORT_PEAK(Int24Rate);
+	if(m_info.perf.pluginName[0] != 0)
+		CZ_HTML_EXPORT_PEAK(PluginRate);
 	out += "</table>\n";
 
+	return out;
+}
+
+/*!	\brief Generate closing part of HTML v5 report.
+*/
+const QString CZCudaDeviceInfoDecoder::generateHTMLTail() {
+
+	QString out;
+
 	time_t t;
 	time(&t);
 	out +=	"<p><small><b>" + tr("Generated") + ":</b> " + ctime(&t) + "</small></p>\n";
@@ -764,3 +967,650 @@ const QString CZCudaDeviceInfoDecoder::generateHTMLReport() const {
 
 	return out;
 }
+
+/*!	\brief Describe this application for machine-readable reports.
+*/
+static void CZReportOriginInit(
+	struct CZReportOrigin &origin,	/*!<[out] Application writing report. */
+	QByteArray &os			/*!<[out] Storage of operating system version. */
+) {
+	os = getOSVersion().toUtf8();
+	origin.generator = CZ_NAME_SHORT;
+	origin.version = CZ_VERSION;
+	origin.os = os.constData();
+}
+
+/*!	\brief Take text of report written by core.
+	\returns text of report, empty in case of error
+*/
+static const QString CZReportTake(
+	struct CZReportText &out,	/*!<[in,out] Report text, freed on return. */
+	int res				/*!<[in] Result of report writer. */
+) {
+	QString text;
+
+	if(res == 0)
+		text = QString::fromUtf8(out.text, out.len);
+	CZReportTextFree(&out);
+
+	return text;
+}
+
+/*!	\brief Get string field of parsed report.
+	\returns value of field, empty if report has no such field
+*/
+static const QString CZReportString(
+	const struct CZReport &report,	/*!<[in] Report. */
+	const char *key			/*!<[in] Field path. */
+) {
+	return QString::fromUtf8(CZReportValue(&report, key));
+}
+
+/*!	\brief Generate JSON report.
+	Fields are nested objects following their dot separated paths, see
+	#CZ_REPORT_SCHEMA_VERSION. Sizes are in bytes, clocks in Hz and rates
+	in B/s or op/s, every metric has its unit in \a unit field.
+*/
+const QString CZCudaDeviceInfoDecoder::generateJSONReport() const {
+
+	struct CZReportOrigin origin;
+	struct CZReportText out;
+	QByteArray os;
+
+	CZReportOriginInit(origin, os);
+	CZReportTextInit(&out);
+
+	return CZReportTake(out, CZReportWriteJSON(&out, &origin, &m_info));
+}
+
+/*!	\brief Generate CSV report.
+	Every field is a row with its dot separated path, value and unit,
+	the same fields as in generateJSONReport().
+*/
+const QString CZCudaDeviceInfoDecoder::generateCSVReport() const {
+
+	struct CZReportOrigin origin;
+	struct CZReportText out;
+	QByteArray os;
+
+	CZReportOriginInit(origin, os);
+	CZReportTextInit(&out);
+
+	return CZReportTake(out, CZReportWriteCSV(&out, &origin, &m_info));
+}
+
+/*!	\brief Generate plane text report of comparison with baseline.
+*/
+const QString CZCudaDeviceInfoDecoder::generateBaselineReport(
+	const struct CZReport &baseline,	/*!<[in] Fields of baseline report. */
+	const struct CZDeviceInfo &info,	/*!<[in] Current CUDA-device information. */
+	const struct CZBaselineConfig &config,	/*!<[in] Regression gate configuration. */
+	const struct CZBaselineResult *results,	/*!<[in] Comparison results. */
+	int num				/*!<[in] Number of comparison results. */
+) {
+	QString out;
+	int regressedNum = 0;
+	int failedNum = 0;
+
+	out += tr("Baseline Comparison") + ":\n";
+	out += "\t" + tr("Baseline") + ": " + CZReportString(baseline, "device.name") + ", "
+		+ tr("Driver") + " " + CZReportString(baseline, "driver.version") + ", "
+		+ CZReportString(baseline, "report.generated") + "\n";
+	out += "\t" + tr("Current") + ": " + info.deviceName + ", "
+		+ tr("Driver") + " " + ((info.drvVersion == NULL)? "": info.drvVersion) + "\n";
+	out += "\t" + tr("Regression Threshold") + ": " + tr("%1%").arg(config.thresholdPct) + "\n";
+	out += "\t" + tr("Significance Level") + ": " + QString::number(config.alpha) + "\n";
+
+	out += tr("Test") + ": " + tr("Baseline") + " / " + tr("Current") + " (" + tr("Change") + ", p) " + tr("Verdict") + "\n";
+	for(int i = 0; i < num; i++) {
+		const struct CZBaselineResult &result = results[i];
+		QString verdict;
+
+		switch(result.verdict) {
+		case CZBaselineSame: verdict = tr("same"); break;
+		case CZBaselineImproved: verdict = tr("improved"); break;
+		case CZBaselineRegressed: verdict = tr("REGRESSED"); regressedNum++; break;
+		case CZBaselineFailed: verdict = tr("FAILED"); failedNum++; break;
+		default: verdict = tr("no data"); break;
+		}
+
+		out += "\t" + QString(CZMetricName(result.metric)) + ": ";
+		if(result.verdict == CZBaselineNoData) {
+			out += verdict + "\n";
+			continue;
+		}
+		if(result.verdict == CZBaselineFailed) {
+			out += getMetricValue(result.metric, result.base) + " / - " + verdict + "\n";
+			continue;
+		}
+		out += getMetricValue(result.metric, result.base) + " / " + getMetricValue(result.metric, result.current)
+			+ " (" + QString("%1%2%").arg((result.deltaPct > 0)? "+": "").arg(result.deltaPct, 0, 'f', 1)
+			+ ", " + ((result.pValue < 0)? QString("-"): QString::number(result.pValue, 'g', 3)) + ") "
+			+ verdict + "\n";
+	}
+
+	out += tr("Regressions") + ": " + QString::number(regressedNum) + "\n";
+	if(failedNum != 0)
+		out += tr("Failed Tests") + ": " + QString::number(failedNum) + "\n";
+
+	return out;
+}
+
+/*!	\brief Generate plane text report of soak test.
+*/
+const QString CZCudaDeviceInfoDecoder::generateSoakReport(
+	const struct CZSoakConfig &config,	/*!<[in] Soak test configuration. */
+	const struct CZSoakSample *samples,	/*!<[in] Time series. */
+	int num,			/*!<[in] Number of samples in time series. */
+	const struct CZSoakResult &result	/*!<[in] Analysis results. */
+) {
+	QString out;
+
+	out += tr("Soak Test") + ": " + CZMetricName(config.metric) + "\n";
+	out += "\t" + tr("Duration") + ": " + tr("%1 s").arg(config.durationSec) + "\n";
+	out += "\t" + tr("Sampling Interval") + ": " + tr("%1 s").arg(config.intervalSec) + "\n";
+	out += "\t" + tr("Throttling Threshold") + ": " + tr("%1%").arg(config.dropPct) + "\n";
+
+	if(samples != NULL) {
+		out += tr("Time Series") + ":\n";
+		for(int i = 0; i < num; i++) {
+			out += "\t" + tr("%1 s").arg(samples[i].timeSec, 0, 'f', 1) + ": " + getMetricValue(config.metric, samples[i].value) + "\n";
+		}
+	}
+
+	out += tr("Summary") + ":\n";
+	out += "\t" + tr("Initial Plateau") + ": " + getMetricValue(config.metric, result.plateau) + "\n";
+	out += "\t" + tr("Minimum") + ": " + getMetricValue(config.metric, result.minValue) + "\n";
+	out += "\t" + tr("Maximum") + ": " + getMetricValue(config.metric, result.maxValue) + "\n";
+	if(result.steadySec < 0) {
+		out += "\t" + tr("Steady State") + ": " + tr("Not reached") + "\n";
+	} else {
+		out += "\t" + tr("Steady State") + ": " + getMetricValue(config.metric, result.steadyValue) + " " + tr("after %1 s").arg(result.steadySec, 0, 'f', 1) + "\n";
+	}
+	out += "\t" + tr("Throttling Events") + ": " + QString::number(result.eventsNum) + "\n";
+
+	for(int i = 0; (i < result.eventsNum) && (i < CZ_SOAK_EVENTS_MAX); i++) {
+		const struct CZSoakEvent &event = result.events[i];
+		out += "\t\t" + tr("%1 s").arg(event.startSec, 0, 'f', 1) + " - ";
+		if(event.endSec < 0)
+			out += tr("end of test");
+		else
+			out += tr("%1 s").arg(event.endSec, 0, 'f', 1);
+		out += ": " + getMetricValue(config.metric, event.minValue) + " (-" + QString::number(event.dropPct, 'f', 1) + "%)\n";
+	}
+
+	return out;
+}
+
+/*!	\brief Generate plane text report of parallel multi-device benchmark.
+	Every test result is shown as isolated / concurrent value and relative change.
+*/
+const QString CZCudaDeviceInfoDecoder::generateParallelReport(
+	const struct CZDeviceInfo *infos,	/*!<[in] Information of devices. */
+	const struct CZParallelResult *results,	/*!<[in] Results of devices. */
+	int num				/*!<[in] Number of devices. */
+) {
+	double isolatedSum[CZMetricMax];
+	double concurrentSum[CZMetricMax];
+	QString out;
+
+	memset(isolatedSum, 0, sizeof(isolatedSum));
+	memset(concurrentSum, 0, sizeof(concurrentSum));
+
+	out += tr("Parallel Benchmark") + ": " + tr("%1 devices").arg(num) + "\n";
+	out += "\t" + tr("Test") + ": " + tr("Isolated") + " / " + tr("Concurrent") + " (" + tr("Change") + ")\n";
+
+	for(int i = 0; i < num; i++) {
+		const struct CZParallelResult &result = results[i];
+
+		out += tr("Device %1").arg(infos[i].num) + ": " + infos[i].deviceName + "\n";
+		if(!result.ready) {
+			out += "\t" + tr("Not tested") + "\n";
+			continue;
+		}
+
+		for(int metric = 0; metric < CZMetricMax; metric++) {
+			isolatedSum[metric] += result.isolated[metric];
+			concurrentSum[metric] += result.concurrent[metric];
+			out += "\t" + QString(CZMetricName(metric)) + ": "
+				+ getMetricValue(metric, result.isolated[metric]) + " / "
+				+ getMetricValue(metric, result.concurrent[metric]);
+			if(result.isolated[metric] != 0)
+				out += " (" + QString::number(100.0 * (result.concurrent[metric] / result.isolated[metric] - 1), 'f', 1) + "%)";
+			out += "\n";
+		}
+	}
+
+	out += tr("All Devices") + ":\n";
+	for(int metric = 0; metric < CZMetricMax; metric++) {
+		out += "\t" + QString(CZMetricName(metric)) + ": "
+			+ getMetricValue(metric, isolatedSum[metric]) + " / "
+			+ getMetricValue(metric, concurrentSum[metric]);
+		if(isolatedSum[metric] != 0)
+			out += " (" + QString::number(100.0 * (concurrentSum[metric] / isolatedSum[metric] - 1), 'f', 1) + "%)";
+		out += "\n";
+	}
+
+	return out;
+}
+
+/*!	\brief Format deviation from median in percents.
+*/
+static const QString CZReportFleetDeviation(
+	double deviationPct		/*!<[in] Deviation from median in percents. */
+) {
+	return QString("%1%2%").arg((deviationPct >= 0)? "+": "").arg(deviationPct, 0, 'f', 1);
+}
+
+/*!	\brief Format outlier detection thresholds.
+*/
+static const QString CZReportFleetThreshold(
+	const struct CZFleetConfig &config	/*!<[in] Outlier detection configuration. */
+) {
+	QString out;
+
+	if(config.outlierPct > 0)
+		out += QString("%1%").arg(config.outlierPct);
+	if(config.outlierZ > 0)
+		out += QString(out.isEmpty()? "": ", ") + QObject::tr("robust z %1").arg(config.outlierZ);
+	if(out.isEmpty())
+		out = QObject::tr("None");
+
+	return out;
+}
+
+/*!	\brief Format number of outliers of metric. Outliers are not
+	detected among less than #CZ_FLEET_OUTLIER_MIN_NUM devices.
+*/
+static const QString CZReportFleetOutliers(
+	const struct CZFleetSummary &summary	/*!<[in] Distribution of metric. */
+) {
+	if(summary.num < CZ_FLEET_OUTLIER_MIN_NUM)
+		return QObject::tr("n/a (%1 devices needed)").arg(CZ_FLEET_OUTLIER_MIN_NUM);
+
+	return QString::number(summary.outliersNum);
+}
+
+/*!	\brief Generate plane text report of many devices.
+	Summary ranks devices on every metric and marks outliers relative
+	to median of devices, it is followed by reports of all devices.
+*/
+const QString CZCudaDeviceInfoDecoder::generateFleetTextReport(
+	const struct CZDeviceInfo *infos,	/*!<[in] Information of devices. */
+	int num,			/*!<[in] Number of devices. */
+	const struct CZFleetConfig &config	/*!<[in] Outlier detection configuration. */
+) {
+	struct CZFleetSummary summaries[CZMetricMax];
+	struct CZFleetEntry *entries = new struct CZFleetEntry[CZMetricMax * num + 1];
+	QString out;
+	QString subtitle;
+
+	CZReportFleetAnalyze(infos, num, &config, summaries, entries);
+
+	out += generateTextHead(tr(CZ_NAME_SHORT " Fleet Report"));
+	out += tr("Devices") + ": " + QString::number(num) + "\n";
+	out += tr("Outlier Threshold") + ": " + CZReportFleetThreshold(config) + "\n";
+	out += "\n";
+
+	subtitle = tr("Summary");
+	out += subtitle + "\n";
+	out += QString(subtitle.size(), '-') + "\n";
+	for(int metric = 0; metric < CZMetricMax; metric++) {
+		const struct CZFleetSummary &summary = summaries[metric];
+		const struct CZFleetEntry *metricEntries = &entries[metric * num];
+
+		out += QString(CZMetricName(metric)) + ": ";
+		if(summary.num == 0) {
+			out += tr("Not tested") + "\n";
+			continue;
+		}
+		out += tr("Median") + " " + getMetricValue(metric, summary.median)
+			+ ", " + tr("Outliers") + " " + CZReportFleetOutliers(summary) + "\n";
+
+		for(int rank = 1; rank <= num; rank++) {
+			for(int i = 0; i < num; i++) {
+				if(metricEntries[i].rank != rank)
+					continue;
+				out += "\t#" + QString::number(rank) + " " + tr("Device %1").arg(infos[i].num) + " " + infos[i].deviceName + ": "
+					+ getMetricValue(metric, CZMetricValue(&infos[i], metric))
+					+ " (" + CZReportFleetDeviation(metricEntries[i].deviationPct) + ")";
+				if(metricEntries[i].outlier)
+					out += " " + tr("OUTLIER");
+				out += "\n";
+			}
+		}
+	}
+	out += "\n";
+
+	for(int i = 0; i < num; i++) {
+		struct CZDeviceInfo info = infos[i];
+		CZCudaDeviceInfoDecoder decoder(info);
+
+		subtitle = tr("Device %1").arg(info.num) + ": " + info.deviceName;
+		out += subtitle + "\n";
+		out += QString(subtitle.size(), '=') + "\n";
+		out += decoder.generateTextBody();
+	}
+
+	out += generateTextTail();
+
+	delete[] entries;
+
+	return out;
+}
+
+/*!	\brief Generate HTML v5 report of many devices.
+	Summary table ranks devices on every metric and highlights outliers
+	relative to median of devices, it is followed by reports of all devices.
+*/
+const QString CZCudaDeviceInfoDecoder::generateFleetHTMLReport(
+	const struct CZDeviceInfo *infos,	/*!<[in] Information of devices. */
+	int num,			/*!<[in] Number of devices. */
+	const struct CZFleetConfig &config	/*!<[in] Outlier detection configuration. */
+) {
+	struct CZFleetSummary summaries[CZMetricMax];
+	struct CZFleetEntry *entries = new struct CZFleetEntry[CZMetricMax * num + 1];
+	QString out;
+
+	CZReportFleetAnalyze(infos, num, &config, summaries, entries);
+
+	out += generateHTMLHead(tr(CZ_NAME_SHORT " Fleet Report"));
+
+	out += "<h2>" + tr("Summary") + "</h2>\n";
+	out += "<p><small><b>" + tr("Devices") + ":</b> " + QString::number(num)
+		+ " <b>" + tr("Outlier Threshold") + ":</b> " + CZReportFleetThreshold(config) + "</small></p>\n";
+	out += "<table class=\"summary\">\n";
+	out += "<tr><th>" + tr("Device") + "</th>";
+	for(int metric = 0; metric < CZMetricMax; metric++)
+		out += "<th>" + QString(CZMetricName(metric)) + "</th>";
+	out += "</tr>\n";
+
+	for(int i = 0; i < num; i++) {
+		out += "<tr><th>" + tr("Device %1").arg(infos[i].num) + ": " + infos[i].deviceName + "</th>";
+		for(int metric = 0; metric < CZMetricMax; metric++) {
+			const struct CZFleetEntry &entry = entries[metric * num + i];
+			if(entry.rank == 0) {
+				out += "<td>-</td>";
+				continue;
+			}
+			out += QString("<td") + (entry.outlier? " class=\"outlier\"": "") + ">"
+				+ getMetricValue(metric, CZMetricValue(&infos[i], metric))
+				+ "<br/><small>#" + QString::number(entry.rank) + ", " + CZReportFleetDeviation(entry.deviationPct) + "</small></td>";
+		}
+		out += "</tr>\n";
+	}
+
+	out += "<tr><th>" + tr("Median") + "</th>";
+	for(int metric = 0; metric < CZMetricMax; metric++) {
+		if(summaries[metric].num == 0)
+			out += "<td>-</td>";
+		else
+			out += "<td>" + getMetricValue(metric, summaries[metric].median) + "</td>";
+	}
+	out += "</tr>\n";
+	out += "</table>\n";
+
+	for(int i = 0; i < num; i++) {
+		struct CZDeviceInfo info = infos[i];
+		CZCudaDeviceInfoDecoder decoder(info);
+
+		out += "<h1>" + tr("Device %1").arg(info.num) + ": " + info.deviceName + "</h1>\n";
+		out += decoder.generateHTMLBody();
+	}
+
+	out += generateHTMLTail();
+
+	delete[] entries;
+
+	return out;
+}
+
+/*!	\brief Generate JSON report of many devices.
+	Top level object holds distributions of metrics in \a fleet object
+	and full reports of devices in \a devices array. Report of every
+	device has its rank, deviation from median and outlier flag of
+	every metric in its own \a fleet object.
+*/
+const QString CZCudaDeviceInfoDecoder::generateFleetJSONReport(
+	const struct CZDeviceInfo *infos,	/*!<[in] Information of devices. */
+	int num,			/*!<[in] Number of devices. */
+	const struct CZFleetConfig &config	/*!<[in] Outlier detection configuration. */
+) {
+	struct CZReportOrigin origin;
+	struct CZReportText out;
+	QByteArray os;
+
+	CZReportOriginInit(origin, os);
+	CZReportTextInit(&out);
+
+	return CZReportTake(out, CZReportWriteFleetJSON(&out, &origin, infos, num, &config));
+}
+
+/*!	\brief Generate CSV report of many devices.
+	Rows of every device are the same as in generateCSVReport(), followed
+	by its rank, deviation from median and outlier flag of every metric.
+*/
+const QString CZCudaDeviceInfoDecoder::generateFleetCSVReport(
+	const struct CZDeviceInfo *infos,	/*!<[in] Information of devices. */
+	int num,			/*!<[in] Number of devices. */
+	const struct CZFleetConfig &config	/*!<[in] Outlier detection configuration. */
+) {
+	struct CZReportOrigin origin;
+	struct CZReportText out;
+	QByteArray os;
+
+	CZReportOriginInit(origin, os);
+	CZReportTextInit(&out);
+
+	return CZReportTake(out, CZReportWriteFleetCSV(&out, &origin, infos, num, &config));
+}
+
+/*!	\brief Generate plane text report of merged reports of many nodes.
+	Every group of devices of the same model and driver gets distribution
+	of every metric and list of outlier devices.
+*/
+const QString CZCudaDeviceInfoDecoder::generateMergeTextReport(
+	const struct CZMerge &merge	/*!<[in] Merged reports. */
+) {
+	QString out;
+	QString subtitle;
+
+	out += generateTextHead(tr(CZ_NAME_SHORT " Merge Report"));
+	out += tr("Report Files") + ": " + QString::number(merge.filesNum) + "\n";
+	out += tr("Devices") + ": " + QString::number(merge.reportsNum) + "\n";
+	out += tr("Groups") + ": " + QString::number(merge.groupsNum) + "\n";
+	out += tr("Outlier Threshold") + ": " + CZReportFleetThreshold(merge.config) + "\n";
+	out += "\n";
+
+	for(int g = 0; g < merge.groupsNum; g++) {
+		const struct CZMergeGroup &group = merge.groups[g];
+
+		subtitle = QString::fromUtf8(group.deviceName) + ", " + tr("Driver") + " " + QString::fromUtf8(group.drvVersion);
+		out += subtitle + "\n";
+		out += QString(subtitle.size(), '-') + "\n";
+		out += tr("Devices") + ": " + QString::number(group.nodesNum) + "\n";
+
+		for(int metric = 0; metric < CZMetricMax; metric++) {
+			const struct CZFleetSummary &summary = group.summary[metric];
+
+			out += QString(CZMetricName(metric)) + ": ";
+			if(summary.num == 0) {
+				out += tr("Not tested") + "\n";
+				continue;
+			}
+			out += tr("Median") + " " + getMetricValue(metric, summary.median)
+				+ ", " + tr("IQR") + " " + getMetricValue(metric, summary.p25) + " - " + getMetricValue(metric, summary.p75)
+				+ ", " + tr("Range") + " " + getMetricValue(metric, summary.min) + " - " + getMetricValue(metric, summary.max)
+				+ ", " + tr("Outliers") + " " + CZReportFleetOutliers(summary) + "\n";
+
+			for(int i = 0; i < group.nodesNum; i++) {
+				const struct CZFleetEntry &entry = group.entries[metric][i];
+				if(!entry.outlier)
+					continue;
+				out += "\t" + QString::fromUtf8(group.nodes[i].node) + " " + tr("Device %1").arg(group.nodes[i].device) + ": "
+					+ getMetricValue(metric, group.nodes[i].value[metric])
+					+ " (" + CZReportFleetDeviation(entry.deviationPct)
+					+ ", z " + QString::number(entry.robustZ, 'f', 1) + ")\n";
+			}
+		}
+		out += "\n";
+	}
+
+	out += generateTextTail();
+
+	return out;
+}
+
+/*!	\brief Generate HTML v5 report of merged reports of many nodes.
+	Every group of devices of the same model and driver gets table of
+	distributions of metrics and table of all devices with outliers
+	highlighted.
+*/
+const QString CZCudaDeviceInfoDecoder::generateMergeHTMLReport(
+	const struct CZMerge &merge	/*!<[in] Merged reports. */
+) {
+	QString out;
+
+	out += generateHTMLHead(tr(CZ_NAME_SHORT " Merge Report"));
+
+	out += "<p><small><b>" + tr("Report Files") + ":</b> " + QString::number(merge.filesNum)
+		+ " <b>" + tr("Devices") + ":</b> " + QString::number(merge.reportsNum)
+		+ " <b>" + tr("Groups") + ":</b> " + QString::number(merge.groupsNum)
+		+ " <b>" + tr("Outlier Threshold") + ":</b> " + CZReportFleetThreshold(merge.config) + "</small></p>\n";
+
+	for(int g = 0; g < merge.groupsNum; g++) {
+		const struct CZMergeGroup &group = merge.groups[g];
+
+		out += "<h2>" + QString::fromUtf8(group.deviceName) + ", " + tr("Driver") + " " + QString::fromUtf8(group.drvVersion)
+			+ " (" + tr("%1 devices").arg(group.nodesNum) + ")</h2>\n";
+
+		out += "<table class=\"summary\">\n";
+		out += "<tr><th>" + tr("Test") + "</th><th>" + tr("Devices") + "</th><th>" + tr("Min") + "</th><th>25%</th><th>"
+			+ tr("Median") + "</th><th>75%</th><th>" + tr("Max") + "</th><th>" + tr("Outliers") + "</th></tr>\n";
+		for(int metric = 0; metric < CZMetricMax; metric++) {
+			const struct CZFleetSummary &summary = group.summary[metric];
+			out += "<tr><th>" + QString(CZMetricName(metric)) + "</th><td>" + QString::number(summary.num) + "</td>";
+			if(summary.num == 0) {
+				out += "<td colspan=\"6\">" + tr("Not tested") + "</td></tr>\n";
+				continue;
+			}
+			out += "<td>" + getMetricValue(metric, summary.min) + "</td>"
+				+ "<td>" + getMetricValue(metric, summary.p25) + "</td>"
+				+ "<td>" + getMetricValue(metric, summary.median) + "</td>"
+				+ "<td>" + getMetricValue(metric, summary.p75) + "</td>"
+				+ "<td>" + getMetricValue(metric, summary.max) + "</td>"
+				+ "<td" + (summary.outliersNum? " class=\"outlier\"": "") + ">" + CZReportFleetOutliers(summary) + "</td></tr>\n";
+		}
+		out += "</table>\n";
+
+		out += "<p></p>\n";
+		out += "<table class=\"summary\">\n";
+		out += "<tr><th>" + tr("Node") + "</th><th>" + tr("Device") + "</th>";
+		for(int metric = 0; metric < CZMetricMax; metric++)
+			out += "<th>" + QString(CZMetricName(metric)) + "</th>";
+		out += "</tr>\n";
+		for(int i = 0; i < group.nodesNum; i++) {
+			const struct CZMergeNode &node = group.nodes[i];
+			out += "<tr><th>" + QString::fromUtf8(node.node) + "</th><td>" + QString::number(node.device) + "</td>";
+			for(int metric = 0; metric < CZMetricMax; metric++) {
+				const struct CZFleetEntry &entry = group.entries[metric][i];
+				if(entry.rank == 0) {
+					out += "<td>-</td>";
+					continue;
+				}
+				out += QString("<td") + (entry.outlier? " class=\"outlier\"": "") + ">"
+					+ getMetricValue(metric, node.value[metric])
+					+ "<br/><small>" + CZReportFleetDeviation(entry.deviationPct)
+					+ ", z " + QString::number(entry.robustZ, 'f', 1) + "</small></td>";
+			}
+			out += "</tr>\n";
+		}
+		out += "</table>\n";
+	}
+
+	out += generateHTMLTail();
+
+	return out;
+}
+
+/*!	\brief Generate CSV report of merged reports of many nodes.
+	Every tested metric of every device is a row with its group, node,
+	value, median of group and outlier flag. Values are in B/s or op/s.
+*/
+const QString CZCudaDeviceInfoDecoder::generateMergeCSVReport(
+	const struct CZMerge &merge	/*!<[in] Merged reports. */
+) {
+	struct CZReportText out;
+
+	CZReportTextInit(&out);
+
+	return CZReportTake(out, CZReportWriteMergeCSV(&out, &merge));
+}
+
+/*!	\brief Generate plane text report of health check.
+*/
+const QString CZCudaDeviceInfoDecoder::generateHealthReport(
+	const struct CZDeviceInfo &info,	/*!<[in] CUDA-device information. */
+	const struct CZHealthConfig &config,	/*!<[in] Health check configuration. */
+	const struct CZHealthResult *results,	/*!<[in] Results of tests. */
+	int num,			/*!<[in] Number of results. */
+	const struct CZHealthSummary &summary	/*!<[in] Overall verdict. */
+) {
+	QString out;
+
+	out += tr("Health Check") + ": " + (summary.passed? tr("PASS"): tr("FAIL")) + "\n";
+	out += "\t" + tr("Device") + ": " + QString("%1 (%2)").arg(info.deviceName).arg(info.num) + ", "
+		+ tr("Driver") + " " + ((info.drvVersion == NULL)? "": info.drvVersion) + "\n";
+	out += "\t" + tr("Thresholds") + ": " + ((summary.model == NULL)? tr("None"): QString(summary.model->name)) + "\n";
+	out += "\t" + tr("Time") + ": " + tr("%1 s of %2 s").arg(summary.timeMs / 1000, 0, 'f', 2).arg(config.budgetSec)
+		+ (summary.overBudget? " " + tr("(OVER BUDGET)"): QString()) + "\n";
+
+	out += tr("Test") + ": " + tr("Result") + " / " + tr("Threshold") + " (" + tr("Peak") + ") " + tr("Verdict") + "\n";
+	for(int i = 0; i < num; i++) {
+		const struct CZHealthResult &result = results[i];
+		QString verdict;
+
+		switch(result.verdict) {
+		case CZHealthPass: verdict = tr("pass"); break;
+		case CZHealthFail: verdict = tr("FAIL"); break;
+		case CZHealthError: verdict = tr("ERROR"); break;
+		case CZHealthTimeout: verdict = tr("TIMEOUT"); break;
+		default: verdict = tr("pass, no threshold"); break;
+		}
+
+		out += "\t" + QString(CZMetricName(result.metric)) + ": ";
+		if((result.verdict == CZHealthError) || (result.verdict == CZHealthTimeout)) {
+			out += verdict + "\n";
+			continue;
+		}
+		out += getMetricValue(result.metric, result.value) + " / "
+			+ ((result.minValue > 0)? getMetricValue(result.metric, result.minValue): QString("-"))
+			+ " (" + ((result.peakPct > 0)? QString("%1%").arg(result.peakPct, 0, 'f', 1): QString("-")) + ") "
+			+ verdict + "\n";
+	}
+
+	out += tr("Failures") + ": " + QString::number(summary.failedNum) + "\n";
+
+	return out;
+}
+
+/*!	\brief Generate JSON report of health check.
+	Top level object holds overall verdict in \a health object and results
+	of tests in \a checks array. Values are in B/s or op/s.
+*/
+const QString CZCudaDeviceInfoDecoder::generateHealthJSONReport(
+	const struct CZDeviceInfo &info,	/*!<[in] CUDA-device information. */
+	const struct CZHealthConfig &config,	/*!<[in] Health check configuration. */
+	const struct CZHealthResult *results,	/*!<[in] Results of tests. */
+	int num,			/*!<[in] Number of results. */
+	const struct CZHealthSummary &summary	/*!<[in] Overall verdict. */
+) {
+	struct CZReportOrigin origin;
+	struct CZReportText out;
+	QByteArray os;
+
+	CZReportOriginInit(origin, os);
+	CZReportTextInit(&out);
+
+	return CZReportTake(out, CZReportWriteHealthJSON(&out, &origin, &info, &config, results, num, &summary));
+}
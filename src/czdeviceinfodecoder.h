@@ -11,6 +11,13 @@
 #include <QObject>
 
 #include "czdeviceinfo.h"
+#include "czsoak.h"
+#include "czparallel.h"
+#include "czbaseline.h"
+#include "czfleet.h"
+#include "czmerge.h"
+#include "czhealth.h"
+#include "czreport.h"
 
 class CZCudaDeviceInfoDecoder: public QObject {
 	Q_OBJECT
@@ -78,6 +85,7 @@ public:
 		idInt64Rate,
 		idInt32Rate,
 		idInt24Rate,
+		idPluginRate,
 
 		idMax,
 	};
@@ -110,9 +118,31 @@ public:
 
 	const QString getName(int id) const;
 	const QString getValue(int id) const;
+	const QString getPeak(int id) const;
+	const QString getStat(int id) const;
+
+	static int getMetric(int id);
+	static const QString getMetricValue(int metric, double value);
+	static double getMetricBaseValue(int metric, double value);
+	static const QString getMetricBaseUnit(int metric);
 
 	const QString generateTextReport() const;
 	const QString generateHTMLReport() const;
+	const QString generateJSONReport() const;
+	const QString generateCSVReport() const;
+
+	static const QString generateSoakReport(const struct CZSoakConfig &config, const struct CZSoakSample *samples, int num, const struct CZSoakResult &result);
+	static const QString generateParallelReport(const struct CZDeviceInfo *infos, const struct CZParallelResult *results, int num);
+	static const QString generateBaselineReport(const struct CZReport &baseline, const struct CZDeviceInfo &info, const struct CZBaselineConfig &config, const struct CZBaselineResult *results, int num);
+	static const QString generateFleetTextReport(const struct CZDeviceInfo *infos, int num, const struct CZFleetConfig &config);
+	static const QString generateFleetHTMLReport(const struct CZDeviceInfo *infos, int num, const struct CZFleetConfig &config);
+	static const QString generateFleetJSONReport(const struct CZDeviceInfo *infos, int num, const struct CZFleetConfig &config);
+	static const QString generateFleetCSVReport(const struct CZDeviceInfo *infos, int num, const struct CZFleetConfig &config);
+	static const QString generateMergeTextReport(const struct CZMerge &merge);
+	static const QString generateMergeHTMLReport(const struct CZMerge &merge);
+	static const QString generateMergeCSVReport(const struct CZMerge &merge);
+	static const QString generateHealthReport(const struct CZDeviceInfo &info, const struct CZHealthConfig &config, const struct CZHealthResult *results, int num, const struct CZHealthSummary &summary);
+	static const QString generateHealthJSONReport(const struct CZDeviceInfo &info, const struct CZHealthConfig &config, const struct CZHealthResult *results, int num, const struct CZHealthSummary &summary);
 
 	static const QString getValue1000(double value, int valuePrefix, QString unitBase);
 	static const QString getValue1024(double value, int valuePrefix, QString unitBase);
@@ -120,6 +150,13 @@ public:
 private:
 	struct CZDeviceInfo m_info;
 
+	static const QString generateTextHead(const QString &title);
+	const QString generateTextBody() const;
+	static const QString generateTextTail();
+	static const QString generateHTMLHead(const QString &title);
+	const QString generateHTMLBody() const;
+	static const QString generateHTMLTail();
+
 };
 
 #endif//CZ_DEVICEINFODECODER_H
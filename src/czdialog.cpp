@@ -10,6 +10,12 @@
 #include <QMessageBox>
 #include <QTextStream>
 #include <QClipboard>
+#include <QFormLayout>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QDialogButtonBox>
+#include <QDateTime>
 #if QT_VERSION < 0x050000
 #include <QDesktopServices>
 #else
@@ -23,6 +29,10 @@
 #include "log.h"
 #include "czdialog.h"
 #include "czdeviceinfodecoder.h"
+#include "czsoak.h"
+#include "czhistory.h"
+#include "cudaarch.h"
+#include "cztimer.h"
 #include "platform.h"
 #include "version.h"
 
@@ -31,6 +41,7 @@
 */
 
 #define CZ_TIMER_REFRESH	2000	/*!< Test results update timer period (ms). */
+#define CZ_LIVE_WINDOW_SEC	300	/*!< Time window of live charts (s). */
 
 /*!	\name Update progress icons definitions.
 */
@@ -189,11 +200,20 @@ CZDialog::CZDialog(
 	QMenu *exportMenu = new QMenu(pushExport);
 	exportMenu->addAction(tr("to &Text"), this, SLOT(slotExportToText()));
 	exportMenu->addAction(tr("to &HTML"), this, SLOT(slotExportToHTML()));
+	exportMenu->addAction(tr("to &JSON"), this, SLOT(slotExportToJSON()));
+	exportMenu->addAction(tr("to C&SV"), this, SLOT(slotExportToCSV()));
 	exportMenu->addAction(tr("to &Clipboard"), this, SLOT(slotExportToClipboard()));
 	pushExport->setMenu(exportMenu);
+
+	connect(pushSoak, SIGNAL(clicked()), SLOT(slotSoakTest()));
+	connect(comboHistoryMetric, SIGNAL(activated(int)), SLOT(slotHistoryMetric(int)));
+	connect(comboLiveMetric, SIGNAL(activated(int)), SLOT(slotLiveMetric(int)));
+	chartLive->setAxis(CZChart::axisSeconds);
 	
 	readCudaDevices();
+	CZTimerPhase("devices");
 	setupDeviceList();
+	setupMetricLists();
 	setupDeviceInfo(comboDevice->currentIndex());
 	setupAboutTab();
 
@@ -215,34 +235,55 @@ CZDialog::~CZDialog() {
 }
 
 /*!	\brief Reads CUDA devices information.
-	For each of detected CUDA-devices does following:
-	- Initialize CUDA-data structure.
-	- Reads CUDA-information about device.
+	Does following:
+	- Creates CUDA-device information containers, each of them reads
+	  CUDA-information about its device in own thread.
+	- Appends entries of valid devices in to device-list.
 	- Shows progress message in splash screen.
-	- Starts Performance calculation procedure.
-	- Appends entry in to device-list.
+	- Runs Performance calculation procedure for the first device only,
+	  other devices are tested when they are shown.
 */
 void CZDialog::readCudaDevices() {
 
 	int num = getCudaDeviceNumber();
+	QList<CZCudaDeviceInfo*> devices;
 
-	for(int i = 0; i < num; i++) {
+	splash->showMessage(tr("Getting information about %1 device(s) ...").arg(num),
+		Qt::AlignLeft | Qt::AlignBottom);
+	qApp->processEvents();
+
+	for(int i = 0; i < num; i++)
+		devices.append(new CZCudaDeviceInfo(i));
 
-		CZCudaDeviceInfo *info = new CZCudaDeviceInfo(i);
+	for(int i = 0; i < devices.size(); i++) {
 
-		if(info->info().major != 0) {
-			splash->showMessage(tr("Getting information about %1 ...").arg(info->info().deviceName),
-				Qt::AlignLeft | Qt::AlignBottom);
-			qApp->processEvents();
+		CZCudaDeviceInfo *info = devices[i];
+		struct CZDeviceInfo devInfo;
+		info->waitInfo();
+		info->infoSnapshot(devInfo);
 
-			info->waitPerformance();
-			
+		if(devInfo.major != 0) {
 			connect(info, SIGNAL(testedPerformance(int)), SLOT(slotUpdatePerformance(int)));
+			connect(info, SIGNAL(testedSoak(int)), SLOT(slotSoakFinished(int)));
+			connect(info, SIGNAL(soakSampled(float,float)), SLOT(slotSoakSampled(float,float)));
 			m_deviceList.append(info);
+			m_historyStored.append(false);
 		} else {
 			delete info;
 		}
 	}
+	CZTimerPhase("device info");
+
+	if(!m_deviceList.isEmpty()) {
+		struct CZDeviceInfo devInfo;
+		m_deviceList[0]->infoSnapshot(devInfo);
+		splash->showMessage(tr("Getting information about %1 ...").arg(devInfo.deviceName),
+			Qt::AlignLeft | Qt::AlignBottom);
+		qApp->processEvents();
+
+		m_deviceList[0]->waitPerformance();
+		CZTimerPhase("first results");
+	}
 }
 
 /*!	\brief Cleans up after bandwidth tests.
@@ -269,7 +310,9 @@ void CZDialog::setupDeviceList() {
 	comboDevice->clear();
 
 	for(int i = 0; i < m_deviceList.size(); i++) {
-		comboDevice->addItem(QString("%1: %2").arg(i).arg(m_deviceList[i]->info().deviceName));
+		struct CZDeviceInfo info;
+		m_deviceList[i]->infoSnapshot(info);
+		comboDevice->addItem(QString("%1: %2").arg(i).arg(info.deviceName));
 	}
 }
 
@@ -280,9 +323,12 @@ void CZDialog::slotShowDevice(
 ) {
 	m_index = index;
 	setupDeviceInfo(index);
-	if(checkUpdateResults->checkState() == Qt::Checked) {
+	setupSoakButton();
+	if(m_deviceList[index]->isSoakRunning()) {
+		CZLog(CZLogLevelModerate, "Switch device -> soak test is running on device %d", index);
+	} else if((checkUpdateResults->checkState() == Qt::Checked) || !m_deviceList[index]->isTested()) {
 		CZLog(CZLogLevelModerate, "Switch device -> update performance for device %d", index);
-		m_deviceList[index]->testPerformance(index);
+		m_deviceList[index]->testPerformance(index, (checkHeavyMode->checkState() == Qt::Checked)? 1: 0);
 	}
 }
 
@@ -292,8 +338,21 @@ void CZDialog::slotShowDevice(
 void CZDialog::slotUpdatePerformance(
 	int index			/*!<[in] Index of device in list. */
 ) {
-	if(index == comboDevice->currentIndex())
-	setupPerformanceTab(m_deviceList[index]->info());
+	struct CZDeviceInfo info;
+	m_deviceList[index]->infoSnapshot(info);
+
+	appendLivePoints(index);
+	if(index == comboDevice->currentIndex()) {
+		setupPerformanceTab(info);
+		setupLiveChart(index);
+	}
+
+	if(!m_historyStored[index] && m_deviceList[index]->isTested()) {
+		m_historyStored[index] = true;
+		CZHistoryAppend(&info);
+		if(index == comboDevice->currentIndex())
+			setupHistoryTab(index);
+	}
 }
 
 /*!	\brief This slot updates performance information of current device
@@ -302,14 +361,12 @@ void CZDialog::slotUpdatePerformance(
 void CZDialog::slotUpdateTimer() {
 
 	int index = comboDevice->currentIndex();
-	if(checkUpdateResults->checkState() == Qt::Checked) {
-		if(checkHeavyMode->checkState() == Qt::Checked) {
-			m_deviceList[index]->info().heavyMode = 1;
-		} else {
-			m_deviceList[index]->info().heavyMode = 0;
-		}
-		CZLog(CZLogLevelModerate, "Timer shot -> update performance for device %d in mode %d", index, m_deviceList[index]->info().heavyMode);
-		m_deviceList[index]->testPerformance(index);
+	if(m_deviceList[index]->isSoakRunning()) {
+		CZLog(CZLogLevelModerate, "Timer shot -> soak test is running on device %d", index);
+	} else if(checkUpdateResults->checkState() == Qt::Checked) {
+		int heavyMode = (checkHeavyMode->checkState() == Qt::Checked)? 1: 0;
+		CZLog(CZLogLevelModerate, "Timer shot -> update performance for device %d in mode %d", index, heavyMode);
+		m_deviceList[index]->testPerformance(index, heavyMode);
 	} else {
 		CZLog(CZLogLevelModerate, "Timer shot -> update ignored");
 	}
@@ -320,9 +377,14 @@ void CZDialog::slotUpdateTimer() {
 void CZDialog::setupDeviceInfo(
 	int dev				/*!<[in] Number/index of CUDA-device. */
 ) {
-	setupCoreTab(m_deviceList[dev]->info());
-	setupMemoryTab(m_deviceList[dev]->info());
-	setupPerformanceTab(m_deviceList[dev]->info());
+	struct CZDeviceInfo info;
+	m_deviceList[dev]->infoSnapshot(info);
+
+	setupCoreTab(info);
+	setupMemoryTab(info);
+	setupPerformanceTab(info);
+	setupLiveChart(dev);
+	setupHistoryTab(dev);
 }
 
 #define CZ_DLG_FILL(decoder, _id_) \
@@ -331,6 +393,11 @@ void CZDialog::setupDeviceInfo(
 		label ## _id_ ## Text->setText(decoder.getValue(CZCudaDeviceInfoDecoder::id ## _id_)); \
 	}
 
+#define CZ_DLG_PEAK(decoder, label, _id_) \
+	{ \
+		label->setToolTip(tr("Theoretical peak: %1").arg(decoder.getPeak(CZCudaDeviceInfoDecoder::id ## _id_))); \
+	}
+
 /*!	\brief Fill tab "Core" with CUDA devices information.
 */
 void CZDialog::setupCoreTab(
@@ -419,6 +486,162 @@ void CZDialog::setupPerformanceTab(
 	CZ_DLG_FILL(decoder, Int64Rate);
 	CZ_DLG_FILL(decoder, Int32Rate);
 	CZ_DLG_FILL(decoder, Int24Rate);
+
+	CZ_DLG_PEAK(decoder, labelHDRatePinText, HostPinnedToDevice);
+	CZ_DLG_PEAK(decoder, labelHDRatePageText, HostPageableToDevice);
+	CZ_DLG_PEAK(decoder, labelDHRatePinText, DeviceToHostPinned);
+	CZ_DLG_PEAK(decoder, labelDHRatePageText, DeviceToHostPageable);
+	CZ_DLG_PEAK(decoder, labelDDRateText, DeviceToDevice);
+	CZ_DLG_PEAK(decoder, labelFloatRateText, FloatRate);
+	CZ_DLG_PEAK(decoder, labelDoubleRateText, DoubleRate);
+	CZ_DLG_PEAK(decoder, labelInt64RateText, Int64Rate);
+	CZ_DLG_PEAK(decoder, labelInt32RateText, Int32Rate);
+	CZ_DLG_PEAK(decoder, labelInt24RateText, Int24Rate);
+}
+
+/*!	\brief Puts tests in combo boxes of live chart and tab "History".
+*/
+void CZDialog::setupMetricLists() {
+	comboLiveMetric->clear();
+	comboHistoryMetric->clear();
+	m_liveSeries.resize(m_deviceList.size() * CZMetricMax);
+	if(m_deviceList.isEmpty())
+		return;
+
+	CZCudaDeviceInfoDecoder decoder(*m_deviceList[0]);
+	for(int id = CZCudaDeviceInfoDecoder::idMemoryCopy; id < CZCudaDeviceInfoDecoder::idMax; id++) {
+		int metric = CZCudaDeviceInfoDecoder::getMetric(id);
+		if(metric == -1)
+			continue;
+		comboLiveMetric->addItem(decoder.getName(id), metric);
+		comboHistoryMetric->addItem(decoder.getName(id), metric);
+	}
+}
+
+/*!	\brief Appends latest results of device to its live series.
+	Every metric keeps its own series with min/max of test iterations,
+	points older than #CZ_LIVE_WINDOW_SEC are dropped.
+*/
+void CZDialog::appendLivePoints(
+	int dev				/*!<[in] Number/index of CUDA-device. */
+) {
+	struct CZDeviceInfo info;
+	m_deviceList[dev]->infoSnapshot(info);
+	double timeSec = CZTimerNow() / 1000;
+
+	for(int metric = 0; metric < CZMetricMax; metric++) {
+		QList<struct CZChartPoint> &series = m_liveSeries[dev * CZMetricMax + metric];
+
+		struct CZChartPoint point;
+		point.x = timeSec;
+		point.value = CZMetricValue(&info, metric);
+		if(point.value <= 0)
+			continue;
+		point.min = (info.stat[metric].min > 0)? info.stat[metric].min: point.value;
+		point.max = (info.stat[metric].max > 0)? info.stat[metric].max: point.value;
+		series.append(point);
+
+		while(!series.isEmpty() && (series.first().x < timeSec - CZ_LIVE_WINDOW_SEC))
+			series.removeFirst();
+	}
+}
+
+/*!	\brief Shows live series of selected test of device.
+*/
+void CZDialog::setupLiveChart(
+	int dev				/*!<[in] Number/index of CUDA-device. */
+) {
+	int metric = comboLiveMetric->itemData(comboLiveMetric->currentIndex()).toInt();
+	chartLive->setMetric(metric);
+	chartLive->setPoints(m_liveSeries[dev * CZMetricMax + metric]);
+}
+
+/*!	\brief This slot shows live series of selected test.
+*/
+void CZDialog::slotLiveMetric(
+	int index			/*!<[in] Index of test in combo box. */
+) {
+	(void)index;
+	setupLiveChart(comboDevice->currentIndex());
+}
+
+/*!	\brief Fill tab "History" with results of selected test over time.
+	Changes of driver version are marked on chart.
+*/
+void CZDialog::setupHistoryTab(
+	int dev				/*!<[in] Number/index of CUDA-device. */
+) {
+	int metric = comboHistoryMetric->itemData(comboHistoryMetric->currentIndex()).toInt();
+	chartHistory->setMetric(metric);
+
+	if(!CZHistoryIsOpen()) {
+		chartHistory->clear();
+		labelHistoryText->setText(tr("History of results is off."));
+		return;
+	}
+
+	struct CZHistoryRecord *records = new struct CZHistoryRecord[CZ_HISTORY_READ_MAX];
+	struct CZDeviceInfo info;
+	m_deviceList[dev]->infoSnapshot(info);
+	int num = CZHistoryRead(&info, records, CZ_HISTORY_READ_MAX);
+
+	QList<struct CZChartPoint> points;
+	QList<struct CZChartMarker> markers;
+	QString driver;
+	int driversNum = 0;
+
+	for(int i = 0; i < num; i++) {
+		const struct CZHistoryRecord &record = records[i];
+		if(record.value[metric] <= 0)
+			continue;
+
+		struct CZChartPoint point;
+		point.x = record.timeSec;
+		point.value = record.value[metric];
+		point.min = (record.min[metric] > 0)? record.min[metric]: point.value;
+		point.max = (record.max[metric] > 0)? record.max[metric]: point.value;
+
+		if(driver != record.drvVersion) {
+			driver = record.drvVersion;
+			driversNum++;
+			if(!points.isEmpty()) {
+				struct CZChartMarker marker;
+				marker.x = point.x;
+				marker.label = driver;
+				markers.append(marker);
+			}
+		}
+
+		points.append(point);
+	}
+
+	delete[] records;
+
+	chartHistory->setPoints(points);
+	chartHistory->setMarkers(markers);
+
+	if(points.isEmpty()) {
+		labelHistoryText->setText(tr("No results of this test in history yet."));
+		return;
+	}
+
+	const struct CZChartPoint &first = points.first();
+	const struct CZChartPoint &last = points.last();
+	labelHistoryText->setText(tr("%1 runs since %2, %3 driver version(s).\nLatest: %4 (%5% since first run).")
+		.arg(points.size())
+		.arg(QDateTime::fromTime_t((uint)first.x).toString("yyyy-MM-dd"))
+		.arg(driversNum)
+		.arg(CZCudaDeviceInfoDecoder::getMetricValue(metric, last.value))
+		.arg(QString("%1%2").arg((last.value >= first.value)? "+": "").arg(100 * (last.value / first.value - 1), 0, 'f', 1)));
+}
+
+/*!	\brief This slot shows history of selected test.
+*/
+void CZDialog::slotHistoryMetric(
+	int index			/*!<[in] Index of test in combo box. */
+) {
+	(void)index;
+	setupHistoryTab(comboDevice->currentIndex());
 }
 
 /*!	\brief Fill tab "About" with information about this program.
@@ -465,17 +688,159 @@ void CZDialog::slotExportToText() {
 	}
 
 	QTextStream stream(&file);
-	CZCudaDeviceInfoDecoder decoder(m_deviceList[m_index]->info());
+	CZCudaDeviceInfoDecoder decoder(*m_deviceList[m_index]);
 	stream << decoder.generateTextReport();
 }
 
+/*!	\brief Ask user for soak test configuration.
+	\returns \a true if user accepted configuration.
+*/
+static bool CZSoakConfigDialog(
+	QWidget *parent,		/*!<[in,out] Parent of dialog. */
+	struct CZDeviceInfo &info,	/*!<[in] CUDA-device information. */
+	struct CZSoakConfig &config	/*!<[in,out] Soak test configuration. */
+) {
+	QDialog dialog(parent);
+	dialog.setWindowTitle(QObject::tr("Soak Test"));
+
+	QComboBox *comboMetric = new QComboBox(&dialog);
+	CZCudaDeviceInfoDecoder decoder(info);
+	for(int id = CZCudaDeviceInfoDecoder::idMemoryCopy; id < CZCudaDeviceInfoDecoder::idMax; id++) {
+		int metric = CZCudaDeviceInfoDecoder::getMetric(id);
+		if(metric == -1)
+			continue;
+		comboMetric->addItem(decoder.getName(id), metric);
+		if(metric == config.metric)
+			comboMetric->setCurrentIndex(comboMetric->count() - 1);
+	}
+
+	QSpinBox *spinDuration = new QSpinBox(&dialog);
+	spinDuration->setRange(1, 24 * 60);
+	spinDuration->setSuffix(QObject::tr(" min"));
+	spinDuration->setValue((int)(config.durationSec / 60));
+
+	QSpinBox *spinInterval = new QSpinBox(&dialog);
+	spinInterval->setRange(1, 600);
+	spinInterval->setSuffix(QObject::tr(" s"));
+	spinInterval->setValue((int)config.intervalSec);
+
+	QDoubleSpinBox *spinDrop = new QDoubleSpinBox(&dialog);
+	spinDrop->setRange(1, 99);
+	spinDrop->setDecimals(1);
+	spinDrop->setSuffix(QObject::tr("%"));
+	spinDrop->setValue(config.dropPct);
+
+	QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, Qt::Horizontal, &dialog);
+	QObject::connect(buttons, SIGNAL(accepted()), &dialog, SLOT(accept()));
+	QObject::connect(buttons, SIGNAL(rejected()), &dialog, SLOT(reject()));
+
+	QFormLayout *layout = new QFormLayout(&dialog);
+	layout->addRow(QObject::tr("&Test:"), comboMetric);
+	layout->addRow(QObject::tr("&Duration:"), spinDuration);
+	layout->addRow(QObject::tr("Sampling &interval:"), spinInterval);
+	layout->addRow(QObject::tr("Throttling &threshold:"), spinDrop);
+	layout->addRow(buttons);
+
+	if(dialog.exec() != QDialog::Accepted)
+		return false;
+
+	config.metric = comboMetric->itemData(comboMetric->currentIndex()).toInt();
+	config.durationSec = spinDuration->value() * 60;
+	config.intervalSec = spinInterval->value();
+	config.dropPct = spinDrop->value();
+
+	return true;
+}
+
+/*!	\brief Updates soak test button according to state of current device.
+*/
+void CZDialog::setupSoakButton() {
+	if(m_deviceList[m_index]->isSoakRunning())
+		pushSoak->setText(tr("&Stop Soak Test"));
+	else
+		pushSoak->setText(tr("&Soak Test..."));
+}
+
+/*!	\brief Starts or stops soak test of current device.
+*/
+void CZDialog::slotSoakTest() {
+
+	CZCudaDeviceInfo *info = m_deviceList[m_index];
+
+	if(info->isSoakRunning()) {
+		CZLog(CZLogLevelModerate, "Cancel soak test for device %d", m_index);
+		info->cancelSoak();
+		pushSoak->setText(tr("Stopping..."));
+		pushSoak->setEnabled(false);
+		return;
+	}
+
+	struct CZSoakConfig config = info->soakConfig();
+	struct CZDeviceInfo devInfo;
+	info->infoSnapshot(devInfo);
+	if(!CZSoakConfigDialog(this, devInfo, config))
+		return;
+
+	CZLog(CZLogLevelModerate, "Start soak test for device %d", m_index);
+	info->startSoak(m_index, config, (checkHeavyMode->checkState() == Qt::Checked)? 1: 0);
+	setupSoakButton();
+}
+
+/*!	\brief Shows progress of soak test.
+*/
+void CZDialog::slotSoakSampled(
+	float timeSec,			/*!<[in] Time since beginning of test in seconds. */
+	float value			/*!<[in] Sampled throughput. */
+) {
+	CZCudaDeviceInfo *info = qobject_cast<CZCudaDeviceInfo*>(sender());
+	if((info == NULL) || (info != m_deviceList[m_index]) || !pushSoak->isEnabled())
+		return;
+
+	pushSoak->setText(tr("&Stop Soak Test (%1%)").arg((int)(100 * timeSec / info->soakConfig().durationSec)));
+	pushSoak->setToolTip(tr("%1 s: %2").arg(timeSec, 0, 'f', 1)
+		.arg(CZCudaDeviceInfoDecoder::getMetricValue(info->soakConfig().metric, value)));
+}
+
+/*!	\brief Shows results of soak test.
+*/
+void CZDialog::slotSoakFinished(
+	int index			/*!<[in] Index of device in list. */
+) {
+	CZCudaDeviceInfo *info = m_deviceList[index];
+	struct CZDeviceInfo devInfo;
+	info->infoSnapshot(devInfo);
+
+	if(index == m_index) {
+		pushSoak->setEnabled(true);
+		pushSoak->setToolTip(QString());
+		setupSoakButton();
+	}
+
+	if(info->soakSamplesNum() <= 0) {
+		QMessageBox::warning(this, tr(CZ_NAME_SHORT),
+			tr("Can't perform soak test on device %1!").arg(devInfo.deviceName));
+		return;
+	}
+
+	const struct CZSoakResult &result = info->soakResult();
+
+	QMessageBox msgBox(this);
+	msgBox.setWindowTitle(tr(CZ_NAME_SHORT));
+	msgBox.setIcon((result.eventsNum != 0)? QMessageBox::Warning: QMessageBox::Information);
+	msgBox.setText(tr("Soak test of %1 is complete. Throttling events: %2.")
+		.arg(devInfo.deviceName).arg(result.eventsNum));
+	msgBox.setDetailedText(CZCudaDeviceInfoDecoder::generateSoakReport(info->soakConfig(),
+		info->soakSamples(), info->soakSamplesNum(), result));
+	msgBox.exec();
+}
+
 /*!	\brief Export information to clipboard as a plane text.
 */
 void CZDialog::slotExportToClipboard() {
 
 	QClipboard *clipboard = QApplication::clipboard();
 
-	CZCudaDeviceInfoDecoder decoder(m_deviceList[m_index]->info());
+	CZCudaDeviceInfoDecoder decoder(*m_deviceList[m_index]);
 	clipboard->setText(decoder.generateTextReport());
 }
 
@@ -500,10 +865,60 @@ void CZDialog::slotExportToHTML() {
 	}
 
 	QTextStream stream(&file);
-	CZCudaDeviceInfoDecoder decoder(m_deviceList[m_index]->info());
+	CZCudaDeviceInfoDecoder decoder(*m_deviceList[m_index]);
 	stream << decoder.generateHTMLReport();
 }
 
+/*!	\brief Export information to JSON file.
+*/
+void CZDialog::slotExportToJSON() {
+
+	QString fileName = QFileDialog::getSaveFileName(this, tr("Save JSON Report as..."),
+		QDesktopServices::storageLocation(QDesktopServices::DocumentsLocation) + QDir::separator() + tr("%1.json").arg(tr(CZ_NAME_SHORT)),
+		tr("JSON files (*.json);;All files (*.*)"));
+
+	if(fileName.isEmpty())
+		return;
+
+	CZLog(CZLogLevelModerate, "Export to JSON as %s", fileName.toLocal8Bit().data());
+
+	QFile file(fileName);
+	if(!file.open(QFile::WriteOnly | QFile::Text)) {
+		QMessageBox::warning(this, tr(CZ_NAME_SHORT),
+			tr("Cannot write file %1:\n%2.").arg(fileName).arg(file.errorString()));
+		return;
+	}
+
+	QTextStream stream(&file);
+	CZCudaDeviceInfoDecoder decoder(*m_deviceList[m_index]);
+	stream << decoder.generateJSONReport();
+}
+
+/*!	\brief Export information to CSV file.
+*/
+void CZDialog::slotExportToCSV() {
+
+	QString fileName = QFileDialog::getSaveFileName(this, tr("Save CSV Report as..."),
+		QDesktopServices::storageLocation(QDesktopServices::DocumentsLocation) + QDir::separator() + tr("%1.csv").arg(tr(CZ_NAME_SHORT)),
+		tr("CSV files (*.csv);;All files (*.*)"));
+
+	if(fileName.isEmpty())
+		return;
+
+	CZLog(CZLogLevelModerate, "Export to CSV as %s", fileName.toLocal8Bit().data());
+
+	QFile file(fileName);
+	if(!file.open(QFile::WriteOnly | QFile::Text)) {
+		QMessageBox::warning(this, tr(CZ_NAME_SHORT),
+			tr("Cannot write file %1:\n%2.").arg(fileName).arg(file.errorString()));
+		return;
+	}
+
+	QTextStream stream(&file);
+	CZCudaDeviceInfoDecoder decoder(*m_deviceList[m_index]);
+	stream << decoder.generateCSVReport();
+}
+
 /*!	\brief Resend a version request.
 */
 void CZDialog::slotUpdateVersion() {
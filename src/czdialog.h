@@ -16,6 +16,7 @@
 
 #include <QSplashScreen>
 #include <QTimer>
+#include <QVector>
 #ifdef CZ_USE_QHTTP
 #include <QHttp>
 #else
@@ -64,6 +65,8 @@ public:
 
 private:
 	QList<CZCudaDeviceInfo*> m_deviceList;
+	QList<bool> m_historyStored;
+	QVector<QList<struct CZChartPoint> > m_liveSeries;
 	QTimer *m_updateTimer;
 #ifdef CZ_USE_QHTTP
 	QHttp *m_http;
@@ -86,8 +89,13 @@ private:
 	void setupCoreTab(struct CZDeviceInfo &info);
 	void setupMemoryTab(struct CZDeviceInfo &info);
 	void setupPerformanceTab(struct CZDeviceInfo &info);
+	void setupMetricLists();
+	void setupLiveChart(int dev);
+	void appendLivePoints(int dev);
+	void setupHistoryTab(int dev);
 
 	void setupAboutTab();
+	void setupSoakButton();
 
 	void startGetHistoryHttp();
 	void cleanGetHistoryHttp();
@@ -98,9 +106,16 @@ private slots:
 	void slotShowDevice(int index);
 	void slotUpdatePerformance(int index);
 	void slotUpdateTimer();
+	void slotHistoryMetric(int index);
+	void slotLiveMetric(int index);
 	void slotExportToText();
 	void slotExportToHTML();
+	void slotExportToJSON();
+	void slotExportToCSV();
 	void slotExportToClipboard();
+	void slotSoakTest();
+	void slotSoakSampled(float timeSec, float value);
+	void slotSoakFinished(int index);
 	void slotUpdateVersion();
 #ifdef CZ_USE_QHTTP
 	void slotHttpRequestFinished(int id, bool error);
@@ -0,0 +1,153 @@
+/*!	\file czfleet.cpp
+	\brief Comparison of results of many devices source file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "czfleet.h"
+
+#define CZ_FLEET_MAD_SCALE	0.6745			/*!< Scale of robust z-score making it comparable to normal one. */
+#define CZ_FLEET_Z_MIN_NUM	5			/*!< Minimal number of devices for robust z-score check. */
+
+/*!	\brief Fill outlier detection configuration with default values.
+*/
+void CZFleetConfigDefault(
+	struct CZFleetConfig *config	/*!<[out] Outlier detection configuration. */
+) {
+	if(config == NULL)
+		return;
+
+	config->outlierPct = CZ_FLEET_DEF_OUTLIER_PCT;
+	config->outlierZ = CZ_FLEET_DEF_OUTLIER_Z;
+}
+
+/*!	\brief Compare two doubles for qsort().
+*/
+static int CZFleetCompare(
+	const void *a,			/*!<[in] First value. */
+	const void *b			/*!<[in] Second value. */
+) {
+	double da = *(const double*)a;
+	double db = *(const double*)b;
+	return (da < db)? -1: (da > db)? 1: 0;
+}
+
+/*!	\brief Get percentile of sorted values by linear interpolation.
+	\returns percentile value.
+*/
+static double CZFleetPercentile(
+	const double *sorted,		/*!<[in] Sorted values. */
+	int num,			/*!<[in] Number of values. */
+	double p			/*!<[in] Percentile in range [0, 1]. */
+) {
+	double pos = p * (num - 1);
+	int i = (int)pos;
+
+	if(i >= num - 1)
+		return sorted[num - 1];
+	return sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]);
+}
+
+/*!	\brief Analyse distribution of one metric over devices.
+	Devices with value \a 0 or less were not tested and are left out.
+	Device is an outlier if it deviates from median by more than
+	\a outlierPct percents and its robust z-score exceeds \a outlierZ.
+	Robust z-score is based on median absolute deviation, so a few slow
+	devices do not hide each other as they would with mean and standard
+	deviation. It is only checked with at least #CZ_FLEET_Z_MIN_NUM
+	devices and non-zero deviation, so small nodes are judged by
+	percents alone and tiny but consistent differences of big fleets
+	are not reported. With less than #CZ_FLEET_OUTLIER_MIN_NUM devices
+	nothing is an outlier: median of two devices lies halfway between
+	them, so both would deviate from it equally.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZFleetAnalyze(
+	const struct CZFleetConfig *config,	/*!<[in] Outlier detection configuration. */
+	const double *values,		/*!<[in] Values of metric of devices. */
+	int num,			/*!<[in] Number of devices. */
+	struct CZFleetSummary *summary,	/*!<[out] Distribution of metric. */
+	struct CZFleetEntry *entries	/*!<[out] Positions of devices, \a num entries, may be \a NULL. */
+) {
+	double *sorted;
+	double sum = 0;
+	int n = 0;
+	int i;
+
+	if((config == NULL) || (values == NULL) || (summary == NULL) || (num < 0))
+		return -1;
+
+	memset(summary, 0, sizeof(*summary));
+	if(entries != NULL)
+		memset(entries, 0, num * sizeof(entries[0]));
+
+	sorted = (double*)malloc((num + 1) * sizeof(sorted[0]));
+	if(sorted == NULL)
+		return -1;
+
+	for(i = 0; i < num; i++) {
+		if(values[i] > 0) {
+			sorted[n++] = values[i];
+			sum += values[i];
+		}
+	}
+
+	if(n == 0) {
+		free(sorted);
+		return 0;
+	}
+
+	qsort(sorted, n, sizeof(sorted[0]), CZFleetCompare);
+
+	summary->num = n;
+	summary->min = sorted[0];
+	summary->max = sorted[n - 1];
+	summary->mean = sum / n;
+	summary->median = CZFleetPercentile(sorted, n, 0.5);
+	summary->p25 = CZFleetPercentile(sorted, n, 0.25);
+	summary->p75 = CZFleetPercentile(sorted, n, 0.75);
+
+	for(i = 0; i < n; i++)
+		sorted[i] = fabs(sorted[i] - summary->median);
+	qsort(sorted, n, sizeof(sorted[0]), CZFleetCompare);
+	summary->mad = CZFleetPercentile(sorted, n, 0.5);
+
+	free(sorted);
+
+	for(i = 0; i < num; i++) {
+		struct CZFleetEntry entry;
+		int checkZ = (config->outlierZ > 0) && (summary->mad > 0) && (n >= CZ_FLEET_Z_MIN_NUM);
+		int outlier = (n >= CZ_FLEET_OUTLIER_MIN_NUM) && ((config->outlierPct > 0) || checkZ);
+
+		if(values[i] <= 0)
+			continue;
+
+		memset(&entry, 0, sizeof(entry));
+		entry.rank = 1;
+		for(int j = 0; j < num; j++) {
+			if(values[j] > values[i])
+				entry.rank++;
+		}
+
+		entry.deviationPct = 100 * (values[i] / summary->median - 1);
+		if(summary->mad > 0)
+			entry.robustZ = CZ_FLEET_MAD_SCALE * (values[i] - summary->median) / summary->mad;
+
+		if((config->outlierPct > 0) && (fabs(entry.deviationPct) <= config->outlierPct))
+			outlier = 0;
+		if(checkZ && (fabs(entry.robustZ) <= config->outlierZ))
+			outlier = 0;
+		entry.outlier = outlier;
+		summary->outliersNum += outlier;
+
+		if(entries != NULL)
+			entries[i] = entry;
+	}
+
+	return 0;
+}
@@ -0,0 +1,56 @@
+/*!	\file czfleet.h
+	\brief Comparison of results of many devices definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_FLEET_H
+#define CZ_FLEET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_FLEET_DEF_OUTLIER_PCT	10		/*!< Default outlier threshold relative to median in percents. */
+#define CZ_FLEET_DEF_OUTLIER_Z	3.5			/*!< Default outlier threshold of robust z-score. */
+#define CZ_FLEET_OUTLIER_MIN_NUM	3		/*!< Minimal number of tested devices for outlier detection. */
+
+/*!	\brief Outlier detection configuration.
+*/
+struct CZFleetConfig {
+	float		outlierPct;		/*!< Deviation from median treated as outlier in percents, \a 0 to disable. */
+	float		outlierZ;		/*!< Robust z-score treated as outlier, \a 0 to disable. */
+};
+
+/*!	\brief Distribution of one metric over devices.
+*/
+struct CZFleetSummary {
+	int		num;			/*!< Number of devices with results. */
+	double		min;			/*!< Minimal value. */
+	double		max;			/*!< Maximal value. */
+	double		mean;			/*!< Arithmetic mean value. */
+	double		median;			/*!< Median value. */
+	double		p25;			/*!< 25th percentile. */
+	double		p75;			/*!< 75th percentile. */
+	double		mad;			/*!< Median absolute deviation from median. */
+	int		outliersNum;		/*!< Number of outliers. */
+};
+
+/*!	\brief Position of one device in distribution of metric.
+*/
+struct CZFleetEntry {
+	int		rank;			/*!< Rank of device, \a 1 is the fastest, \a 0 if not tested. */
+	double		deviationPct;		/*!< Deviation from median in percents. */
+	double		robustZ;		/*!< Robust (median/MAD based) z-score, \a 0 if MAD is \a 0. */
+	int		outlier;		/*!< \a 1 if device is an outlier. */
+};
+
+void CZFleetConfigDefault(struct CZFleetConfig *config);
+int CZFleetAnalyze(const struct CZFleetConfig *config, const double *values, int num, struct CZFleetSummary *summary, struct CZFleetEntry *entries);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_FLEET_H
@@ -0,0 +1,365 @@
+/*!	\file czhealth.cpp
+	\brief Quick health check of device source file.
+	Health check runs a minimal set of short tests within a strict time
+	budget and compares results with thresholds of device model.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "log.h"
+#include "cztimer.h"
+#include "cudaarch.h"
+#include "czhealth.h"
+
+#define CZ_HEALTH_PRECISION	2.0			/*!< Target precision of adaptive test mode in percents. */
+#define CZ_HEALTH_LOOPS_SHARE	0.5			/*!< Part of remaining budget of one test given to measured loops. */
+
+/*!	\brief Tests of health check.
+*/
+static const int s_healthMetrics[CZ_HEALTH_TESTS_NUM] = {
+	CZMetricCopyHDPin,
+	CZMetricCopyDHPin,
+	CZMetricCopyDD,
+	CZMetricCalcFloat,
+};
+
+/*!	\brief Names of verdicts used in exported files.
+*/
+static const char *s_verdictNames[] = {
+	"pass",		/* CZHealthNoLimit */
+	"pass",		/* CZHealthPass */
+	"fail",		/* CZHealthFail */
+	"error",	/* CZHealthError */
+	"timeout",	/* CZHealthTimeout */
+};
+
+/*!	\brief Fill health check configuration with default values.
+*/
+void CZHealthConfigDefault(
+	struct CZHealthConfig *config	/*!<[out] Health check configuration. */
+) {
+	if(config == NULL)
+		return;
+
+	memset(config, 0, sizeof(*config));
+	config->budgetSec = CZ_HEALTH_DEF_BUDGET;
+}
+
+/*!	\brief Read next token of configuration line.
+	Token is a word or a double quoted string.
+	\returns pointer to the rest of line, \a NULL if there are no more tokens.
+*/
+static char *CZHealthNextToken(
+	char *line,			/*!<[in,out] Line to parse. */
+	char **token			/*!<[out] Zero terminated token. */
+) {
+	while(isspace((unsigned char)*line))
+		line++;
+
+	if((*line == 0) || (*line == '#'))
+		return NULL;
+
+	*token = line;
+	while((*line != 0) && !isspace((unsigned char)*line)) {
+		if(*line == '"') {
+			memmove(line, line + 1, strlen(line));
+			while((*line != 0) && (*line != '"'))
+				line++;
+			if(*line == '"')
+				memmove(line, line + 1, strlen(line));
+		} else {
+			line++;
+		}
+	}
+
+	if(*line != 0)
+		*line++ = 0;
+
+	return line;
+}
+
+/*!	\brief Parse threshold of one metric.
+	Threshold is either a part of theoretical peak (e.g. \a 70%), or a
+	value in B/s or op/s with optional \a k, \a M, \a G or \a T prefix
+	(e.g. \a 11.5G).
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZHealthParseLimit(
+	int metric,			/*!<[in] Metric. See enum #CZMetric. */
+	const char *value,		/*!<[in] Threshold string. */
+	struct CZHealthLimit *limit	/*!<[out] Threshold. */
+) {
+	char *end;
+	double number = strtod(value, &end);
+
+	if((end == value) || (number < 0))
+		return -1;
+
+	switch(*end) {
+	case '%':
+		limit->minPeakPct = number;
+		return (end[1] == 0)? 0: -1;
+	case 'k': number *= 1e3; end++; break;
+	case 'M': number *= 1e6; end++; break;
+	case 'G': number *= 1e9; end++; break;
+	case 'T': number *= 1e12; end++; break;
+	default: break;
+	}
+
+	if(*end != 0)
+		return -1;
+
+	/* Convert B/s to KiB/s and op/s to Kop/s. */
+	limit->minValue = (metric <= CZMetricCopyDD)? number / 1024: number / 1000;
+
+	return 0;
+}
+
+/*!	\brief Read thresholds of device models from file.
+	Every non-empty line of file describes one model as a list of
+	\a key=value pairs. Key \a name is a device name as reported by driver,
+	or \a * for any device. Other keys are short names of metrics (see
+	CZMetricName()) with thresholds, see CZHealthParseLimit(). Text after
+	\a # is ignored.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZHealthConfigure(
+	struct CZHealthConfig *config,	/*!<[in,out] Health check configuration. */
+	const char *fileName		/*!<[in] Name of thresholds file. */
+) {
+	char line[1024];
+	int lineNum = 0;
+	FILE *fp;
+
+	if((config == NULL) || (fileName == NULL))
+		return -1;
+
+	fp = fopen(fileName, "r");
+	if(fp == NULL) {
+		CZLog(CZLogLevelError, "Can't open health check thresholds file %s.", fileName);
+		return -1;
+	}
+
+	config->modelsNum = 0;
+
+	while(fgets(line, sizeof(line), fp) != NULL) {
+		struct CZHealthModel *model = &config->models[config->modelsNum];
+		char *rest = line;
+		char *token;
+		int params = 0;
+
+		lineNum++;
+
+		if(config->modelsNum >= CZ_HEALTH_MODELS_MAX) {
+			CZLog(CZLogLevelWarning, "Too many device models in %s.", fileName);
+			break;
+		}
+
+		memset(model, 0, sizeof(*model));
+
+		while((rest = CZHealthNextToken(rest, &token)) != NULL) {
+			char *value = strchr(token, '=');
+			int metric;
+
+			if(value != NULL)
+				*value++ = 0;
+
+			if((value != NULL) && (strcmp(token, "name") == 0)) {
+				strncpy(model->name, value, sizeof(model->name) - 1);
+			} else if((value == NULL) || ((metric = CZMetricFind(token)) == -1) ||
+				(CZHealthParseLimit(metric, value, &model->limits[metric]) != 0)) {
+				CZLog(CZLogLevelError, "Wrong parameter '%s' in %s:%d.", token, fileName, lineNum);
+				fclose(fp);
+				return -1;
+			}
+			params++;
+		}
+
+		if(params == 0)
+			continue;
+
+		if(model->name[0] == 0) {
+			CZLog(CZLogLevelError, "Device model has no name in %s:%d.", fileName, lineNum);
+			fclose(fp);
+			return -1;
+		}
+
+		config->modelsNum++;
+	}
+
+	fclose(fp);
+
+	CZLog(CZLogLevelLow, "Read thresholds of %d device model(s) from %s.", config->modelsNum, fileName);
+
+	return 0;
+}
+
+/*!	\brief Find thresholds of device model.
+	Exact name of device takes precedence over #CZ_HEALTH_ANY_MODEL.
+	\returns thresholds of model, or \a NULL if model is not configured.
+*/
+const struct CZHealthModel *CZHealthFindModel(
+	const struct CZHealthConfig *config,	/*!<[in] Health check configuration. */
+	const char *deviceName		/*!<[in] Name of device. */
+) {
+	const struct CZHealthModel *any = NULL;
+	int i;
+
+	if((config == NULL) || (deviceName == NULL))
+		return NULL;
+
+	for(i = 0; i < config->modelsNum; i++) {
+		if(strcmp(config->models[i].name, deviceName) == 0)
+			return &config->models[i];
+		if((any == NULL) && (strcmp(config->models[i].name, CZ_HEALTH_ANY_MODEL) == 0))
+			any = &config->models[i];
+	}
+
+	return any;
+}
+
+/*!	\brief Run health check of device.
+	Device is prepared in quick mode within time budget, so its buffers
+	are small. Tests are short pinned host to device and device to host
+	copies, device to device copy and single-precision float calculations
+	in heavy mode, so every multiprocessor runs a saturated burst.
+	Every test runs in adaptive mode and is stopped by deadline at its
+	share of remaining time budget, warm-up loops included. Tests that
+	do not fit into budget are not started.
+	\returns number of results (#CZ_HEALTH_TESTS_NUM), or \a -1 in case of error.
+*/
+int CZHealthRun(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	const struct CZHealthConfig *config,	/*!<[in] Health check configuration. */
+	struct CZHealthResult *results,	/*!<[out] Results of tests, #CZ_HEALTH_TESTS_NUM entries. */
+	struct CZHealthSummary *summary	/*!<[out] Overall verdict. */
+) {
+	float precision;
+	float budgetMs;
+	int quickMode;
+	int heavyMode;
+	double deadlineMs;
+	double totalMs;
+	double startMs;
+	int i;
+
+	if((info == NULL) || (config == NULL) || (results == NULL) || (summary == NULL))
+		return -1;
+
+	memset(results, 0, CZ_HEALTH_TESTS_NUM * sizeof(results[0]));
+	memset(summary, 0, sizeof(*summary));
+	summary->model = CZHealthFindModel(config, info->deviceName);
+	if(summary->model == NULL)
+		CZLog(CZLogLevelWarning, "No health check thresholds for %s.", info->deviceName);
+
+	precision = info->precision;
+	budgetMs = info->budgetMs;
+	quickMode = info->quickMode;
+	heavyMode = info->heavyMode;
+	deadlineMs = info->deadlineMs;
+	totalMs = config->budgetSec * 1000;
+	startMs = CZTimerNow();
+
+	info->quickMode = 1;
+	info->heavyMode = 1;
+	if(CZCudaPrepareDevice(info) != 0) {
+		CZLog(CZLogLevelError, "Can't prepare device %d!", info->num);
+		info->quickMode = quickMode;
+		info->heavyMode = heavyMode;
+		return -1;
+	}
+	CZLog(CZLogLevelLow, "Device %s is prepared for health check in %.0f ms.", info->deviceName, CZTimerNow() - startMs);
+
+	for(i = 0; i < CZ_HEALTH_TESTS_NUM; i++) {
+		struct CZHealthResult *result = &results[i];
+		double testMs = CZTimerNow();
+		double leftMs = totalMs - (testMs - startMs);
+		double peak;
+
+		result->metric = s_healthMetrics[i];
+
+		if(leftMs <= 0) {
+			result->verdict = CZHealthTimeout;
+			summary->failedNum++;
+			continue;
+		}
+
+		info->precision = CZ_HEALTH_PRECISION;
+		info->deadlineMs = testMs + leftMs / (CZ_HEALTH_TESTS_NUM - i);
+		info->budgetMs = (info->deadlineMs - testMs) * CZ_HEALTH_LOOPS_SHARE;
+
+		CZLog(CZLogLevelLow, "Health check %s with budget %.0f ms.", CZMetricName(result->metric), info->budgetMs);
+		if(CZCudaCalcDeviceTest(info, result->metric) != 0) {
+			result->timeMs = CZTimerNow() - testMs;
+			if(CZTimerNow() >= info->deadlineMs) {
+				CZLog(CZLogLevelWarning, "Test %s on device %d is stopped by deadline.", CZMetricName(result->metric), info->num);
+				result->verdict = CZHealthTimeout;
+			} else {
+				CZLog(CZLogLevelError, "Can't perform test %s on device %d!", CZMetricName(result->metric), info->num);
+				result->verdict = CZHealthError;
+			}
+			summary->failedNum++;
+			continue;
+		}
+
+		result->timeMs = CZTimerNow() - testMs;
+		result->value = CZMetricValue(info, result->metric);
+		peak = CZArchCalcPeak(info, result->metric);
+		if(peak > 0)
+			result->peakPct = 100 * result->value / peak;
+
+		if(result->value <= 0) {
+			result->verdict = CZHealthError;
+			summary->failedNum++;
+			continue;
+		}
+
+		result->verdict = CZHealthNoLimit;
+		if(summary->model != NULL) {
+			const struct CZHealthLimit *limit = &summary->model->limits[result->metric];
+
+			result->minValue = limit->minValue;
+			if((limit->minPeakPct > 0) && (peak > 0) && (peak * limit->minPeakPct / 100 > result->minValue))
+				result->minValue = peak * limit->minPeakPct / 100;
+
+			if(result->minValue > 0)
+				result->verdict = (result->value >= result->minValue)? CZHealthPass: CZHealthFail;
+		}
+
+		if(result->verdict == CZHealthFail)
+			summary->failedNum++;
+	}
+
+	info->precision = precision;
+	info->budgetMs = budgetMs;
+	info->quickMode = quickMode;
+	info->heavyMode = heavyMode;
+	info->deadlineMs = deadlineMs;
+
+	summary->timeMs = CZTimerNow() - startMs;
+	summary->overBudget = (summary->timeMs > totalMs);
+	summary->passed = (summary->failedNum == 0) && !summary->overBudget;
+
+	CZLog(CZLogLevelLow, "Health check of %s %s in %.0f ms.", info->deviceName,
+		summary->passed? "passed": "failed", summary->timeMs);
+
+	return CZ_HEALTH_TESTS_NUM;
+}
+
+/*!	\brief Get name of verdict used in exported files.
+	\returns name of verdict.
+*/
+const char *CZHealthVerdictName(
+	int verdict			/*!<[in] Verdict. See enum #CZHealthVerdict. */
+) {
+	if((verdict < 0) || (verdict > CZHealthTimeout))
+		return "";
+
+	return s_verdictNames[verdict];
+}
@@ -0,0 +1,85 @@
+/*!	\file czhealth.h
+	\brief Quick health check of device definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_HEALTH_H
+#define CZ_HEALTH_H
+
+#include "cudainfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_HEALTH_MODELS_MAX	64			/*!< Maximal number of device models in health check configuration. */
+#define CZ_HEALTH_TESTS_NUM	4			/*!< Number of tests of health check. */
+#define CZ_HEALTH_DEF_BUDGET	0.5			/*!< Default time budget of whole health check in seconds. */
+#define CZ_HEALTH_ANY_MODEL	"*"			/*!< Name of model matching any device. */
+
+/*!	\brief Verdict of one test of health check.
+*/
+enum CZHealthVerdict {
+	CZHealthNoLimit = 0,			/*!< Test passed, there is no threshold for it. */
+	CZHealthPass,				/*!< Result is within thresholds. */
+	CZHealthFail,				/*!< Result is below threshold. */
+	CZHealthError,				/*!< Test failed to run. */
+	CZHealthTimeout,			/*!< Test was skipped or stopped because time budget is exhausted. */
+};
+
+/*!	\brief Thresholds of one metric.
+*/
+struct CZHealthLimit {
+	double		minValue;		/*!< Minimal value in units of #CZDeviceInfo, \a 0 if not checked. */
+	float		minPeakPct;		/*!< Minimal part of theoretical peak in percents, \a 0 if not checked. */
+};
+
+/*!	\brief Thresholds of one device model.
+*/
+struct CZHealthModel {
+	char		name[256];		/*!< Device name, or #CZ_HEALTH_ANY_MODEL. */
+	struct CZHealthLimit limits[CZMetricMax];	/*!< Thresholds of metrics. See enum #CZMetric. */
+};
+
+/*!	\brief Health check configuration.
+*/
+struct CZHealthConfig {
+	float		budgetSec;		/*!< Time budget of whole health check in seconds. */
+	int		modelsNum;		/*!< Number of device models. */
+	struct CZHealthModel models[CZ_HEALTH_MODELS_MAX];	/*!< Thresholds of device models. */
+};
+
+/*!	\brief Result of one test of health check.
+*/
+struct CZHealthResult {
+	int		metric;			/*!< Tested metric. See enum #CZMetric. */
+	int		verdict;		/*!< Verdict. See enum #CZHealthVerdict. */
+	double		value;			/*!< Measured value in units of #CZDeviceInfo, \a 0 if not measured. */
+	double		minValue;		/*!< Effective threshold in units of #CZDeviceInfo, \a 0 if none. */
+	double		peakPct;		/*!< Measured part of theoretical peak in percents, \a 0 if unknown. */
+	double		timeMs;			/*!< Duration of test in milliseconds. */
+};
+
+/*!	\brief Summary of health check.
+*/
+struct CZHealthSummary {
+	int		passed;			/*!< Overall verdict, \a 1 if device is healthy. */
+	int		failedNum;		/*!< Number of tests that failed, did not run or timed out. */
+	double		timeMs;			/*!< Duration of whole health check in milliseconds. */
+	int		overBudget;		/*!< Health check exceeded its time budget. */
+	const struct CZHealthModel *model;	/*!< Matched thresholds, \a NULL if device model is not configured. */
+};
+
+void CZHealthConfigDefault(struct CZHealthConfig *config);
+int CZHealthConfigure(struct CZHealthConfig *config, const char *fileName);
+const struct CZHealthModel *CZHealthFindModel(const struct CZHealthConfig *config, const char *deviceName);
+int CZHealthRun(struct CZDeviceInfo *info, const struct CZHealthConfig *config, struct CZHealthResult *results, struct CZHealthSummary *summary);
+const char *CZHealthVerdictName(int verdict);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_HEALTH_H
@@ -0,0 +1,316 @@
+/*!	\file czhistory.cpp
+	\brief Local history of test results source file.
+	Every run appends results of tested devices to a binary log with
+	fixed size records, so results can be followed over time, across
+	driver updates.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "log.h"
+#include "cudaarch.h"
+#include "czhistory.h"
+
+#if (defined(WIN64) || defined(_WIN64) || defined(__WIN64__)) || (defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
+#define CZ_HISTORY_WIN
+#include <windows.h>
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#define CZ_HISTORY_BYTE_ORDER	0x01020304		/*!< Byte order mark. */
+#define CZ_HISTORY_PATH_LEN	1024			/*!< Maximal length of history file name. */
+
+/*!	\brief History file header.
+*/
+struct CZHistoryHeader {
+	char		magic[8];		/*!< File signature #CZ_HISTORY_MAGIC. */
+	int		version;		/*!< File format version #CZ_HISTORY_VERSION. */
+	int		byteOrder;		/*!< Byte order mark #CZ_HISTORY_BYTE_ORDER. */
+	int		recordSize;		/*!< Size of struct #CZHistoryRecord. */
+	int		metricsNum;		/*!< Number of metrics #CZMetricMax. */
+};
+
+static bool s_historyOpen = false;			/*!< History is used. */
+static char s_historyFileName[CZ_HISTORY_PATH_LEN];	/*!< Name of history file. */
+
+/*!	\brief Create directory if it does not exist.
+*/
+static void CZHistoryMakeDir(
+	const char *dirName		/*!<[in] Name of directory. */
+) {
+#ifdef CZ_HISTORY_WIN
+	_mkdir(dirName);
+#else
+	mkdir(dirName, 0755);
+#endif
+}
+
+/*!	\brief Build name of history file in default location of user data:
+	\a %LOCALAPPDATA%\\cuda-z on Windows, \a ~/Library/Application \a Support/cuda-z
+	on Mac OS X and \a $XDG_DATA_HOME/cuda-z or \a ~/.local/share/cuda-z
+	on other systems. Missing directories are created.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZHistoryDefaultFileName(
+	char *fileName,			/*!<[out] Name of history file. */
+	int size			/*!<[in] Size of \a fileName buffer. */
+) {
+	char dirName[CZ_HISTORY_PATH_LEN];
+	const char *base;
+
+#ifdef CZ_HISTORY_WIN
+	base = getenv("LOCALAPPDATA");
+	if(base == NULL)
+		return -1;
+	snprintf(dirName, sizeof(dirName), "%s\\cuda-z", base);
+	CZHistoryMakeDir(dirName);
+	if(snprintf(fileName, size, "%s\\" CZ_HISTORY_FILE_NAME, dirName) >= size)
+		return -1;
+#else
+	base = getenv("HOME");
+#ifdef __APPLE__
+	if(base == NULL)
+		return -1;
+	snprintf(dirName, sizeof(dirName), "%s/Library/Application Support/cuda-z", base);
+#else
+	if((getenv("XDG_DATA_HOME") != NULL) && (getenv("XDG_DATA_HOME")[0] == '/')) {
+		snprintf(dirName, sizeof(dirName), "%s/cuda-z", getenv("XDG_DATA_HOME"));
+	} else {
+		if(base == NULL)
+			return -1;
+		snprintf(dirName, sizeof(dirName), "%s/.local", base);
+		CZHistoryMakeDir(dirName);
+		snprintf(dirName, sizeof(dirName), "%s/.local/share", base);
+		CZHistoryMakeDir(dirName);
+		snprintf(dirName, sizeof(dirName), "%s/.local/share/cuda-z", base);
+	}
+#endif
+	CZHistoryMakeDir(dirName);
+	if(snprintf(fileName, size, "%s/" CZ_HISTORY_FILE_NAME, dirName) >= size)
+		return -1;
+#endif
+
+	return 0;
+}
+
+/*!	\brief Fill header of history file.
+*/
+static void CZHistoryMakeHeader(
+	struct CZHistoryHeader *header	/*!<[out] History file header. */
+) {
+	memset(header, 0, sizeof(*header));
+	strncpy(header->magic, CZ_HISTORY_MAGIC, sizeof(header->magic));
+	header->version = CZ_HISTORY_VERSION;
+	header->byteOrder = CZ_HISTORY_BYTE_ORDER;
+	header->recordSize = sizeof(struct CZHistoryRecord);
+	header->metricsNum = CZMetricMax;
+}
+
+/*!	\brief Open history file for reading and check its header.
+	\returns file pointer, or \a NULL if file is missing or not compatible.
+*/
+static FILE *CZHistoryOpenRead(void) {
+	struct CZHistoryHeader expected;
+	struct CZHistoryHeader header;
+	FILE *fp;
+
+	fp = fopen(s_historyFileName, "rb");
+	if(fp == NULL)
+		return NULL;
+
+	CZHistoryMakeHeader(&expected);
+	if((fread(&header, sizeof(header), 1, fp) != 1) ||
+		(memcmp(&header, &expected, sizeof(header)) != 0)) {
+		fclose(fp);
+		return NULL;
+	}
+
+	return fp;
+}
+
+/*!	\brief Check if history record is the same device.
+	Device is identified by PCI location and name, so results stay
+	together across driver updates.
+*/
+static bool CZHistorySameDevice(
+	const struct CZHistoryRecord *record,	/*!<[in] History record. */
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	return (record->pciDomainID == info->core.pciDomainID) &&
+		(record->pciBusID == info->core.pciBusID) &&
+		(record->pciDeviceID == info->core.pciDeviceID) &&
+		(strncmp(record->deviceName, info->deviceName, sizeof(record->deviceName)) == 0);
+}
+
+/*!	\brief Reverse order of history records.
+*/
+static void CZHistoryReverse(
+	struct CZHistoryRecord *records,	/*!<[in,out] History records. */
+	int num				/*!<[in] Number of records. */
+) {
+	struct CZHistoryRecord tmp;
+
+	for(int i = 0; i < num / 2; i++) {
+		tmp = records[i];
+		records[i] = records[num - 1 - i];
+		records[num - 1 - i] = tmp;
+	}
+}
+
+/*!	\brief Start using history of test results.
+	Existing file which is not compatible is kept untouched and history
+	is not used.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZHistoryOpen(
+	const char *fileName		/*!<[in] Name of history file, \a NULL for default location. */
+) {
+	FILE *fp;
+
+	CZHistoryClose();
+
+	if(fileName != NULL) {
+		strncpy(s_historyFileName, fileName, sizeof(s_historyFileName) - 1);
+		s_historyFileName[sizeof(s_historyFileName) - 1] = 0;
+	} else if(CZHistoryDefaultFileName(s_historyFileName, sizeof(s_historyFileName)) != 0) {
+		CZLog(CZLogLevelWarning, "Can't find location of history file.");
+		return -1;
+	}
+
+	fp = fopen(s_historyFileName, "rb");
+	if(fp != NULL) {
+		fclose(fp);
+		fp = CZHistoryOpenRead();
+		if(fp == NULL) {
+			CZLog(CZLogLevelWarning, "History file %s is not compatible, history is off.", s_historyFileName);
+			return -1;
+		}
+		fclose(fp);
+	}
+
+	s_historyOpen = true;
+	CZLog(CZLogLevelLow, "History file %s.", s_historyFileName);
+
+	return 0;
+}
+
+/*!	\brief Stop using history of test results.
+*/
+void CZHistoryClose(void) {
+	s_historyOpen = false;
+}
+
+/*!	\brief Check if history of test results is used.
+*/
+bool CZHistoryIsOpen(void) {
+	return s_historyOpen;
+}
+
+/*!	\brief Append results of device to history.
+	Records are only appended, history file is never rewritten.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZHistoryAppend(
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	struct CZHistoryRecord record;
+	FILE *fp;
+	int res = 0;
+
+	if(!s_historyOpen || (info == NULL))
+		return -1;
+
+	memset(&record, 0, sizeof(record));
+	record.timeSec = (double)time(NULL);
+	if(info->drvVersion != NULL)
+		strncpy(record.drvVersion, info->drvVersion, sizeof(record.drvVersion) - 1);
+	record.drvDllVer = info->drvDllVer;
+	record.rtDllVer = info->rtDllVer;
+	record.pciDomainID = info->core.pciDomainID;
+	record.pciBusID = info->core.pciBusID;
+	record.pciDeviceID = info->core.pciDeviceID;
+	memcpy(record.deviceName, info->deviceName, sizeof(record.deviceName) - 1);
+	record.heavyMode = info->heavyMode;
+
+	for(int metric = 0; metric < CZMetricMax; metric++) {
+		record.value[metric] = CZMetricValue(info, metric);
+		record.min[metric] = info->stat[metric].min;
+		record.max[metric] = info->stat[metric].max;
+	}
+
+	fp = fopen(s_historyFileName, "ab");
+	if(fp == NULL) {
+		CZLog(CZLogLevelWarning, "Can't write history file %s.", s_historyFileName);
+		return -1;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	if(ftell(fp) == 0) {
+		struct CZHistoryHeader header;
+		CZHistoryMakeHeader(&header);
+		if(fwrite(&header, sizeof(header), 1, fp) != 1)
+			res = -1;
+	}
+
+	if((res == 0) && (fwrite(&record, sizeof(record), 1, fp) != 1))
+		res = -1;
+
+	if(res != 0)
+		CZLog(CZLogLevelWarning, "Can't write history file %s.", s_historyFileName);
+	else
+		CZLog(CZLogLevelLow, "Results of device %d are added to history.", info->num);
+
+	fclose(fp);
+
+	return res;
+}
+
+/*!	\brief Read history of device, oldest record first.
+	If device has more than \a maxNum records, the latest ones are returned.
+	\returns number of records, or \a -1 in case of error.
+*/
+int CZHistoryRead(
+	const struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	struct CZHistoryRecord *records,	/*!<[out] History records. */
+	int maxNum			/*!<[in] Size of \a records buffer. */
+) {
+	struct CZHistoryRecord record;
+	FILE *fp;
+	int total = 0;
+	int num;
+
+	if(!s_historyOpen || (info == NULL) || (records == NULL) || (maxNum <= 0))
+		return -1;
+
+	fp = CZHistoryOpenRead();
+	if(fp == NULL)
+		return 0;
+
+	while(fread(&record, sizeof(record), 1, fp) == 1) {
+		if(!CZHistorySameDevice(&record, info))
+			continue;
+		records[total % maxNum] = record;
+		total++;
+	}
+
+	fclose(fp);
+
+	num = (total < maxNum)? total: maxNum;
+	if(total > maxNum) {
+		int first = total % maxNum;
+		CZHistoryReverse(records, first);
+		CZHistoryReverse(records + first, maxNum - first);
+		CZHistoryReverse(records, maxNum);
+	}
+
+	return num;
+}
@@ -0,0 +1,49 @@
+/*!	\file czhistory.h
+	\brief Local history of test results definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_HISTORY_H
+#define CZ_HISTORY_H
+
+#include "cudainfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_HISTORY_MAGIC	"CZHIST"		/*!< History file signature. */
+#define CZ_HISTORY_VERSION	1			/*!< History file format version. */
+#define CZ_HISTORY_FILE_NAME	"history.log"		/*!< Name of history file in default location. */
+#define CZ_HISTORY_READ_MAX	4096			/*!< Maximal number of records read back for one device. */
+
+/*!	\brief Results of one run on one device.
+*/
+struct CZHistoryRecord {
+	double		timeSec;		/*!< Time of run in seconds since epoch. */
+	char		drvVersion[64];		/*!< Driver version string. */
+	int		drvDllVer;		/*!< Driver Dll version. */
+	int		rtDllVer;		/*!< Runtime Dll version. */
+	int		pciDomainID;		/*!< PCI domain identifier of the device. */
+	int		pciBusID;		/*!< PCI bus identifier of the device. */
+	int		pciDeviceID;		/*!< PCI device identifier of the device. */
+	char		deviceName[256];	/*!< ASCII string identifying the device name. */
+	int		heavyMode;		/*!< Heavy test mode flag. */
+	float		value[CZMetricMax];	/*!< Value of metric, \a 0 if not tested. See enum #CZMetric. */
+	float		min[CZMetricMax];	/*!< Minimal value of measured iterations. */
+	float		max[CZMetricMax];	/*!< Maximal value of measured iterations. */
+};
+
+int CZHistoryOpen(const char *fileName);
+void CZHistoryClose(void);
+bool CZHistoryIsOpen(void);
+int CZHistoryAppend(const struct CZDeviceInfo *info);
+int CZHistoryRead(const struct CZDeviceInfo *info, struct CZHistoryRecord *records, int maxNum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_HISTORY_H
@@ -0,0 +1,249 @@
+/*!	\file czkernels.cu
+	\brief CUDA performance test kernels.
+	This file is compiled separately for every target architecture
+	and embedded in application by script make_kernels.pl.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include "czkernels.h"
+
+/*!	\brief 16 MAD instructions for float point test.
+*/
+#define CZ_CALC_FMAD_16(a, b) \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+
+/*!	\brief 256 MAD instructions for float point test.
+*/
+#define CZ_CALC_FMAD_256(a, b) \
+	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
+	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
+	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
+	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
+	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
+	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
+	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
+	CZ_CALC_FMAD_16(a, b) CZ_CALC_FMAD_16(a, b) \
+
+/*!	\brief 16 DMAD instructions for double-precision test.
+*/
+#define CZ_CALC_DFMAD_16(a, b) \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+
+/*	a = fma(a, a, a); b = fma(b, b, b); a = fma(a, a, a); b = fma(b, b, b); \
+	a = fma(a, a, a); b = fma(b, b, b); a = fma(a, a, a); b = fma(b, b, b); \
+	a = fma(a, a, a); b = fma(b, b, b); a = fma(a, a, a); b = fma(b, b, b); \
+	a = fma(a, a, a); b = fma(b, b, b); a = fma(a, a, a); b = fma(b, b, b); \*/
+
+/*!	\brief 256 MAD instructions for float point test.
+*/
+#define CZ_CALC_DFMAD_256(a, b) \
+	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
+	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
+	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
+	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
+	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
+	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
+	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
+	CZ_CALC_DFMAD_16(a, b) CZ_CALC_DFMAD_16(a, b) \
+
+/*!	\brief 16 MAD instructions for 32-bit integer test.
+*/
+#define CZ_CALC_IMAD32_16(a, b) \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+
+/*!	\brief 256 MAD instructions for 32-bit integer test.
+*/
+#define CZ_CALC_IMAD32_256(a, b) \
+	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
+	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
+	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
+	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
+	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
+	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
+	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
+	CZ_CALC_IMAD32_16(a, b) CZ_CALC_IMAD32_16(a, b) \
+
+/*!	\brief 16 MAD instructions for 64-bit integer test.
+*/
+#define CZ_CALC_IMAD64_16(a, b) \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+	a = a * a + a; b = b * b + b; a = a * a + a; b = b * b + b; \
+
+/*!	\brief 256 MAD instructions for 64-bit integer test.
+*/
+#define CZ_CALC_IMAD64_256(a, b) \
+	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
+	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
+	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
+	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
+	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
+	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
+	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
+	CZ_CALC_IMAD64_16(a, b) CZ_CALC_IMAD64_16(a, b) \
+
+/*!	\brief 16 MAD instructions for 24-bit integer test.
+*/
+#define CZ_CALC_IMAD24_16(a, b) \
+	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
+	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
+	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
+	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
+	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
+	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
+	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
+	a = __mul24(a, a) + a; b = __mul24(b, b) + b; \
+
+/*!	\brief 256 MAD instructions for 24-bit integer test.
+*/
+#define CZ_CALC_IMAD24_256(a, b) \
+	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
+	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
+	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
+	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
+	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
+	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
+	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
+	CZ_CALC_IMAD24_16(a, b) CZ_CALC_IMAD24_16(a, b)\
+
+/*!	\brief GPU code for float point test.
+*/
+extern "C" __global__ void CZCudaCalcKernelFloat(
+	void *buf,			/*!<[in] Data buffer. */
+	int loops			/*!<[in] Number of calculation loops, at most #CZ_CALC_BLOCK_LOOPS. */
+) {
+	int index = blockIdx.x * blockDim.x + threadIdx.x;
+	float *arr = (float*)buf;
+	float val1 = index;
+	float val2 = arr[index];
+	int i;
+
+	for(i = 0; i < loops; i++) {
+		CZ_CALC_FMAD_256(val1, val2);
+		CZ_CALC_FMAD_256(val1, val2);
+		CZ_CALC_FMAD_256(val1, val2);
+		CZ_CALC_FMAD_256(val1, val2);
+		CZ_CALC_FMAD_256(val1, val2);
+		CZ_CALC_FMAD_256(val1, val2);
+		CZ_CALC_FMAD_256(val1, val2);
+		CZ_CALC_FMAD_256(val1, val2);
+	}
+
+	arr[index] = val1 + val2;
+}
+
+/*!	\brief GPU code for double-precision test.
+*/
+extern "C" __global__ void CZCudaCalcKernelDouble(
+	void *buf,			/*!<[in] Data buffer. */
+	int loops			/*!<[in] Number of calculation loops, at most #CZ_CALC_BLOCK_LOOPS. */
+) {
+	int index = blockIdx.x * blockDim.x + threadIdx.x;
+	double *arr = (double*)buf;
+	double val1 = index;
+	double val2 = arr[index];
+	int i;
+
+	for(i = 0; i < loops; i++) {
+		CZ_CALC_DFMAD_256(val1, val2);
+		CZ_CALC_DFMAD_256(val1, val2);
+		CZ_CALC_DFMAD_256(val1, val2);
+		CZ_CALC_DFMAD_256(val1, val2);
+		CZ_CALC_DFMAD_256(val1, val2);
+		CZ_CALC_DFMAD_256(val1, val2);
+		CZ_CALC_DFMAD_256(val1, val2);
+		CZ_CALC_DFMAD_256(val1, val2);
+	}
+
+	arr[index] = val1 + val2;
+}
+
+/*!	\brief GPU code for 32-bit integer test.
+*/
+extern "C" __global__ void CZCudaCalcKernelInteger32(
+	void *buf,			/*!<[in] Data buffer. */
+	int loops			/*!<[in] Number of calculation loops, at most #CZ_CALC_BLOCK_LOOPS. */
+) {
+	int index = blockIdx.x * blockDim.x + threadIdx.x;
+	int *arr = (int*)buf;
+	int val1 = index;
+	int val2 = arr[index];
+	int i;
+
+	for(i = 0; i < loops; i++) {
+		CZ_CALC_IMAD32_256(val1, val2);
+		CZ_CALC_IMAD32_256(val1, val2);
+		CZ_CALC_IMAD32_256(val1, val2);
+		CZ_CALC_IMAD32_256(val1, val2);
+		CZ_CALC_IMAD32_256(val1, val2);
+		CZ_CALC_IMAD32_256(val1, val2);
+		CZ_CALC_IMAD32_256(val1, val2);
+		CZ_CALC_IMAD32_256(val1, val2);
+	}
+
+	arr[index] = val1 + val2;
+}
+
+/*!	\brief GPU code for 24-bit integer test.
+*/
+extern "C" __global__ void CZCudaCalcKernelInteger24(
+	void *buf,			/*!<[in] Data buffer. */
+	int loops			/*!<[in] Number of calculation loops, at most #CZ_CALC_BLOCK_LOOPS. */
+) {
+	int index = blockIdx.x * blockDim.x + threadIdx.x;
+	int *arr = (int*)buf;
+	int val1 = index;
+	int val2 = arr[index];
+	int i;
+
+	for(i = 0; i < loops; i++) {
+		CZ_CALC_IMAD24_256(val1, val2);
+		CZ_CALC_IMAD24_256(val1, val2);
+		CZ_CALC_IMAD24_256(val1, val2);
+		CZ_CALC_IMAD24_256(val1, val2);
+		CZ_CALC_IMAD24_256(val1, val2);
+		CZ_CALC_IMAD24_256(val1, val2);
+		CZ_CALC_IMAD24_256(val1, val2);
+		CZ_CALC_IMAD24_256(val1, val2);
+	}
+
+	arr[index] = val1 + val2;
+}
+
+/*!	\brief GPU code for 64-bit integer test.
+*/
+extern "C" __global__ void CZCudaCalcKernelInteger64(
+	void *buf,			/*!<[in] Data buffer. */
+	int loops			/*!<[in] Number of calculation loops, at most #CZ_CALC_BLOCK_LOOPS. */
+) {
+	int index = blockIdx.x * blockDim.x + threadIdx.x;
+	long long *arr = (long long*)buf;
+	long long val1 = index;
+	long long val2 = arr[index];
+	int i;
+
+	for(i = 0; i < loops; i++) {
+		CZ_CALC_IMAD64_256(val1, val2);
+		CZ_CALC_IMAD64_256(val1, val2);
+		CZ_CALC_IMAD64_256(val1, val2);
+		CZ_CALC_IMAD64_256(val1, val2);
+		CZ_CALC_IMAD64_256(val1, val2);
+		CZ_CALC_IMAD64_256(val1, val2);
+		CZ_CALC_IMAD64_256(val1, val2);
+		CZ_CALC_IMAD64_256(val1, val2);
+	}
+
+	arr[index] = val1 + val2;
+}
@@ -0,0 +1,55 @@
+/*!	\file czkernels.h
+	\brief CUDA performance test kernels definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_KERNELS_H
+#define CZ_KERNELS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_CALC_BLOCK_LOOPS	32			/*!< Number of calculation loops of one test iteration. */
+#define CZ_CALC_QUICK_LOOPS	4			/*!< Number of calculation loops of one test iteration in quick mode. */
+#define CZ_CALC_BLOCK_SIZE	256			/*!< Size of instruction block. */
+#define CZ_CALC_BLOCK_NUM	8			/*!< Number of instruction blocks in loop. */
+#define CZ_CALC_OPS_NUM		2			/*!< Number of operations per one loop. */
+
+#define CZ_CALC_MODE_FLOAT	0	/*!< Single-precision float point test mode. */
+#define CZ_CALC_MODE_DOUBLE	1	/*!< Double-precision float point test mode. */
+#define CZ_CALC_MODE_INTEGER32	2	/*!< 32-bit integer test mode. */
+#define CZ_CALC_MODE_INTEGER24	3	/*!< 24-bit integer test mode. */
+#define CZ_CALC_MODE_INTEGER64	4	/*!< 64-bit integer test mode. */
+#define CZ_CALC_MODE_NUM	5	/*!< Number of test modes. */
+
+/*!	\brief Names of test kernels indexed by test mode.
+*/
+#define CZ_CALC_KERNEL_NAMES { \
+	"CZCudaCalcKernelFloat", \
+	"CZCudaCalcKernelDouble", \
+	"CZCudaCalcKernelInteger32", \
+	"CZCudaCalcKernelInteger24", \
+	"CZCudaCalcKernelInteger64", \
+}
+
+/*!	\brief Compiled image of test kernels.
+	Images are generated by script make_kernels.pl.
+*/
+struct CZKernelImage {
+	int		arch;			/*!< Target architecture. E.g. 35 for sm_35. */
+	int		isPtx;			/*!< 1 for PTX code (zero terminated), 0 for cubin. */
+	const unsigned char	*data;		/*!< Image data. */
+	unsigned int	size;			/*!< Image size in bytes. */
+};
+
+extern const struct CZKernelImage CZKernelImageTab[];
+extern const int CZKernelImageNum;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_KERNELS_H
@@ -0,0 +1,355 @@
+/*!	\file czmerge.cpp
+	\brief Merge of reports of many nodes source file.
+	Reports are only read from files, so merge does not need CUDA.
+	Exported reports of many nodes are grouped by device model and driver
+	version, and outlier devices are found in every group.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "cudaarch.h"
+#include "czreport.h"
+#include "czmerge.h"
+
+#if (defined(WIN64) || defined(_WIN64) || defined(__WIN64__)) || (defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
+#define CZ_MERGE_WIN
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#endif
+
+/*!	\brief Copy string to fixed size buffer, truncating it if needed.
+*/
+static void CZMergeCopy(
+	char *dst,			/*!<[out] Destination buffer. */
+	int size,			/*!<[in] Size of destination buffer. */
+	const char *src			/*!<[in] Source string, may be \a NULL. */
+) {
+	int len = (src == NULL)? 0: (int)strlen(src);
+
+	if(len > size - 1)
+		len = size - 1;
+	if(len > 0)
+		memcpy(dst, src, len);
+	dst[len] = 0;
+}
+
+/*!	\brief Order devices of group by node and index of device.
+*/
+static int CZMergeNodeCompare(
+	const void *a,			/*!<[in] First device. */
+	const void *b			/*!<[in] Second device. */
+) {
+	const struct CZMergeNode *na = (const struct CZMergeNode*)a;
+	const struct CZMergeNode *nb = (const struct CZMergeNode*)b;
+	int res = strcmp(na->node, nb->node);
+
+	if(res != 0)
+		return res;
+	return (na->device < nb->device)? -1: (na->device > nb->device)? 1: 0;
+}
+
+/*!	\brief Order groups by device model and driver version.
+*/
+static int CZMergeGroupCompare(
+	const void *a,			/*!<[in] First group. */
+	const void *b			/*!<[in] Second group. */
+) {
+	const struct CZMergeGroup *ga = (const struct CZMergeGroup*)a;
+	const struct CZMergeGroup *gb = (const struct CZMergeGroup*)b;
+	int res = strcmp(ga->deviceName, gb->deviceName);
+
+	if(res != 0)
+		return res;
+	return strcmp(ga->drvVersion, gb->drvVersion);
+}
+
+/*!	\brief Order file names for qsort().
+*/
+static int CZMergeNameCompare(
+	const void *a,			/*!<[in] First name. */
+	const void *b			/*!<[in] Second name. */
+) {
+	return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/*!	\brief Initialize empty merge.
+*/
+void CZMergeInit(
+	struct CZMerge *merge,		/*!<[out] Merge. */
+	const struct CZFleetConfig *config	/*!<[in] Outlier detection configuration. */
+) {
+	memset(merge, 0, sizeof(*merge));
+	merge->config = *config;
+}
+
+/*!	\brief Free groups of merge.
+*/
+void CZMergeFree(
+	struct CZMerge *merge		/*!<[in,out] Merge. */
+) {
+	int g, metric;
+
+	for(g = 0; g < merge->groupsNum; g++) {
+		free(merge->groups[g].nodes);
+		for(metric = 0; metric < CZMetricMax; metric++)
+			free(merge->groups[g].entries[metric]);
+	}
+	free(merge->groups);
+	merge->groups = NULL;
+	merge->groupsNum = 0;
+}
+
+/*!	\brief Find group of device model and driver version, add it if missing.
+	\returns group, or \a NULL in case of error.
+*/
+static struct CZMergeGroup *CZMergeFindGroup(
+	struct CZMerge *merge,		/*!<[in,out] Merge. */
+	const char *deviceName,		/*!<[in] Name of device model. */
+	const char *drvVersion		/*!<[in] Driver version. */
+) {
+	struct CZMergeGroup *group;
+	int g;
+
+	for(g = 0; g < merge->groupsNum; g++) {
+		group = &merge->groups[g];
+		if((strncmp(group->deviceName, deviceName, sizeof(group->deviceName) - 1) == 0)
+			&& (strncmp(group->drvVersion, drvVersion, sizeof(group->drvVersion) - 1) == 0))
+			return group;
+	}
+
+	group = (struct CZMergeGroup*)realloc(merge->groups, (merge->groupsNum + 1) * sizeof(struct CZMergeGroup));
+	if(group == NULL)
+		return NULL;
+	merge->groups = group;
+
+	group = &merge->groups[merge->groupsNum++];
+	memset(group, 0, sizeof(*group));
+	CZMergeCopy(group->deviceName, sizeof(group->deviceName), deviceName);
+	CZMergeCopy(group->drvVersion, sizeof(group->drvVersion), drvVersion);
+
+	return group;
+}
+
+/*!	\brief Get name of node from name of report file.
+	Directories and the last extension are removed.
+*/
+static void CZMergeBaseName(
+	char *node,			/*!<[out] Name of node, buffer of #CZ_MERGE_NAME_LEN characters. */
+	const char *fileName		/*!<[in] Name of report file. */
+) {
+	const char *base = fileName;
+	const char *p;
+	char *dot;
+
+	for(p = fileName; *p != 0; p++) {
+		if((*p == '/') || (*p == '\\'))
+			base = p + 1;
+	}
+
+	CZMergeCopy(node, CZ_MERGE_NAME_LEN, base);
+	dot = strrchr(node, '.');
+	if((dot != NULL) && (dot != node))
+		*dot = 0;
+}
+
+/*!	\brief Read JSON or CSV report file of one or many devices.
+	Files that are not reports are skipped with a warning.
+	\returns number of devices read, or \a -1 in case of error.
+*/
+int CZMergeAddFile(
+	struct CZMerge *merge,		/*!<[in,out] Merge. */
+	const char *fileName		/*!<[in] Name of report file. */
+) {
+	struct CZReport *reports;
+	int num;
+	int i, metric;
+
+	if(CZReportRead(fileName, &reports, &num) != 0) {
+		CZLog(CZLogLevelWarning, "Skipping %s, it is not a report.", fileName);
+		return -1;
+	}
+
+	for(i = 0; i < num; i++) {
+		const struct CZReport *report = &reports[i];
+		const char *deviceName = CZReportValue(report, "device.name");
+		const char *drvVersion = CZReportValue(report, "driver.version");
+		const char *host = CZReportValue(report, "report.host");
+		struct CZMergeGroup *group = CZMergeFindGroup(merge,
+			(deviceName == NULL)? "": deviceName, (drvVersion == NULL)? "": drvVersion);
+		struct CZMergeNode *node;
+
+		if(group == NULL)
+			break;
+		node = (struct CZMergeNode*)realloc(group->nodes, (group->nodesNum + 1) * sizeof(struct CZMergeNode));
+		if(node == NULL)
+			break;
+		group->nodes = node;
+		node = &group->nodes[group->nodesNum++];
+
+		if((host == NULL) || (host[0] == 0))
+			CZMergeBaseName(node->node, fileName);
+		else
+			CZMergeCopy(node->node, sizeof(node->node), host);
+		CZMergeCopy(node->fileName, sizeof(node->fileName), fileName);
+		node->device = (int)CZReportNumber(report, "device.index");
+
+		for(metric = 0; metric < CZMetricMax; metric++) {
+			if(CZReportMetric(report, metric, &node->value[metric], NULL) != 0)
+				node->value[metric] = 0;
+		}
+	}
+
+	CZReportFreeAll(reports, num);
+
+	if(i != num) {
+		CZLog(CZLogLevelError, "Not enough memory to merge %s!", fileName);
+		return -1;
+	}
+
+	merge->filesNum++;
+	merge->reportsNum += num;
+
+	CZLog(CZLogLevelLow, "Read %d device(s) from %s.", num, fileName);
+
+	return num;
+}
+
+/*!	\brief Read all JSON and CSV report files of directory.
+	Files are read in order of their names.
+	\returns number of devices read, or \a -1 in case of error.
+*/
+int CZMergeAddDir(
+	struct CZMerge *merge,		/*!<[in,out] Merge. */
+	const char *dirName		/*!<[in] Name of directory. */
+) {
+	char **names = NULL;
+	int namesNum = 0;
+	char path[CZ_MERGE_PATH_LEN];
+	int num = 0;
+	int i;
+
+#ifdef CZ_MERGE_WIN
+	WIN32_FIND_DATAA data;
+	HANDLE find;
+
+	if(snprintf(path, sizeof(path), "%s\\*", dirName) >= (int)sizeof(path)) {
+		CZLog(CZLogLevelError, "Directory name %s is too long!", dirName);
+		return -1;
+	}
+	find = FindFirstFileA(path, &data);
+	if(find == INVALID_HANDLE_VALUE) {
+		CZLog(CZLogLevelError, "Directory %s does not exist!", dirName);
+		return -1;
+	}
+	do {
+		const char *name = data.cFileName;
+		if((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+			continue;
+#else
+	DIR *dir = opendir(dirName);
+	struct dirent *entry;
+
+	if(dir == NULL) {
+		CZLog(CZLogLevelError, "Directory %s does not exist!", dirName);
+		return -1;
+	}
+	while((entry = readdir(dir)) != NULL) {
+		const char *name = entry->d_name;
+#endif
+		const char *ext = strrchr(name, '.');
+		char **grown;
+
+		if((ext == NULL) || ((strcmp(ext, ".json") != 0) && (strcmp(ext, ".csv") != 0)))
+			continue;
+
+		grown = (char**)realloc(names, (namesNum + 1) * sizeof(char*));
+		if(grown == NULL)
+			break;
+		names = grown;
+		names[namesNum] = (char*)malloc(strlen(name) + 1);
+		if(names[namesNum] == NULL)
+			break;
+		strcpy(names[namesNum++], name);
+#ifdef CZ_MERGE_WIN
+	} while(FindNextFileA(find, &data));
+	FindClose(find);
+#else
+	}
+	closedir(dir);
+#endif
+
+	qsort(names, namesNum, sizeof(char*), CZMergeNameCompare);
+
+	for(i = 0; i < namesNum; i++) {
+		if(snprintf(path, sizeof(path), "%s/%s", dirName, names[i]) >= (int)sizeof(path)) {
+			CZLog(CZLogLevelWarning, "Skipping %s, its path is too long.", names[i]);
+			continue;
+		}
+#ifndef CZ_MERGE_WIN
+		struct stat st;
+		if((stat(path, &st) != 0) || !S_ISREG(st.st_mode))
+			continue;
+#endif
+		int r = CZMergeAddFile(merge, path);
+		if(r > 0)
+			num += r;
+	}
+
+	for(i = 0; i < namesNum; i++)
+		free(names[i]);
+	free(names);
+
+	return num;
+}
+
+/*!	\brief Find distributions of metrics and outliers of every group.
+	Groups get ordered by model and driver version and devices of every
+	group by node and index of device.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZMergeAnalyze(
+	struct CZMerge *merge		/*!<[in,out] Merge. */
+) {
+	int g, i, metric;
+
+	qsort(merge->groups, merge->groupsNum, sizeof(struct CZMergeGroup), CZMergeGroupCompare);
+
+	for(g = 0; g < merge->groupsNum; g++) {
+		struct CZMergeGroup *group = &merge->groups[g];
+		int num = group->nodesNum;
+		double *values = (double*)malloc((num + 1) * sizeof(double));
+
+		if(values == NULL) {
+			CZLog(CZLogLevelError, "Not enough memory to merge reports!");
+			return -1;
+		}
+
+		qsort(group->nodes, num, sizeof(struct CZMergeNode), CZMergeNodeCompare);
+
+		for(metric = 0; metric < CZMetricMax; metric++) {
+			free(group->entries[metric]);
+			group->entries[metric] = (struct CZFleetEntry*)calloc(num + 1, sizeof(struct CZFleetEntry));
+			if(group->entries[metric] == NULL) {
+				CZLog(CZLogLevelError, "Not enough memory to merge reports!");
+				free(values);
+				return -1;
+			}
+			for(i = 0; i < num; i++)
+				values[i] = group->nodes[i].value[metric];
+			CZFleetAnalyze(&merge->config, values, num, &group->summary[metric], group->entries[metric]);
+		}
+
+		free(values);
+	}
+
+	return 0;
+}
@@ -0,0 +1,61 @@
+/*!	\file czmerge.h
+	\brief Merge of reports of many nodes header file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_MERGE_H
+#define CZ_MERGE_H
+
+#include "cudainfo.h"
+#include "czfleet.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_MERGE_NAME_LEN	256			/*!< Maximal length of node, device and driver names. */
+#define CZ_MERGE_PATH_LEN	1024			/*!< Maximal length of report file name. */
+
+/*!	\brief Results of one device of one node read from report file.
+*/
+struct CZMergeNode {
+	char		node[CZ_MERGE_NAME_LEN];	/*!< Host name of node, or name of report file for older reports. */
+	char		fileName[CZ_MERGE_PATH_LEN];	/*!< Name of report file. */
+	int		device;			/*!< Index of device on node. */
+	double		value[CZMetricMax];	/*!< Values of metrics in units of #CZDeviceInfo, \a 0 if not tested. */
+};
+
+/*!	\brief Devices of the same model running the same driver.
+*/
+struct CZMergeGroup {
+	char		deviceName[CZ_MERGE_NAME_LEN];	/*!< Name of device model. */
+	char		drvVersion[CZ_MERGE_NAME_LEN];	/*!< Driver version. */
+	struct CZMergeNode *nodes;		/*!< Devices of group, sorted by node after CZMergeAnalyze(). */
+	int		nodesNum;		/*!< Number of devices of group. */
+	struct CZFleetSummary summary[CZMetricMax];	/*!< Distributions of metrics. */
+	struct CZFleetEntry *entries[CZMetricMax];	/*!< Positions of devices in distributions of metrics, \a nodesNum entries each. */
+};
+
+/*!	\brief Reports of many nodes grouped by device model and driver version.
+*/
+struct CZMerge {
+	struct CZFleetConfig config;		/*!< Outlier detection configuration. */
+	struct CZMergeGroup *groups;		/*!< Groups of devices, ordered by model and driver version after CZMergeAnalyze(). */
+	int		groupsNum;		/*!< Number of groups. */
+	int		filesNum;		/*!< Number of report files read. */
+	int		reportsNum;		/*!< Number of device reports read. */
+};
+
+void CZMergeInit(struct CZMerge *merge, const struct CZFleetConfig *config);
+void CZMergeFree(struct CZMerge *merge);
+int CZMergeAddFile(struct CZMerge *merge, const char *fileName);
+int CZMergeAddDir(struct CZMerge *merge, const char *dirName);
+int CZMergeAnalyze(struct CZMerge *merge);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_MERGE_H
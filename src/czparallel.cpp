@@ -0,0 +1,165 @@
+/*!	\file czparallel.cpp
+	\brief Parallel multi-device benchmark source file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <string.h>
+
+#include "log.h"
+#include "cudaarch.h"
+#include "czparallel.h"
+
+/*!	\class CZBarrier
+	\brief This class implements reusable barrier of a fixed number of threads.
+*/
+
+/*!	\brief Creates the barrier.
+*/
+CZBarrier::CZBarrier(
+	int count			/*!<[in] Number of threads to wait for. */
+) {
+	m_count = count;
+	m_waiting = 0;
+	m_generation = 0;
+}
+
+/*!	\brief Wait until all threads reach the barrier.
+*/
+void CZBarrier::wait() {
+
+	m_mutex.lock();
+	int generation = m_generation;
+	if(++m_waiting >= m_count) {
+		m_waiting = 0;
+		m_generation++;
+		m_release.wakeAll();
+	} else {
+		while(generation == m_generation)
+			m_release.wait(&m_mutex);
+	}
+	m_mutex.unlock();
+}
+
+/*!	\class CZParallelThread
+	\brief This class implements test thread of one device.
+*/
+
+/*!	\brief Creates test thread of device.
+*/
+CZParallelThread::CZParallelThread(
+	CZParallelBench *bench,		/*!<[in,out] Parallel benchmark. */
+	int index			/*!<[in] Index of device in benchmark. */
+) {
+	m_bench = bench;
+	m_index = index;
+}
+
+/*!	\brief Main work function of the thread.
+*/
+void CZParallelThread::run() {
+	m_bench->runDevice(m_index);
+}
+
+/*!	\class CZParallelBench
+	\brief This class benchmarks several devices in isolation and concurrently.
+	Every device is tested from its own thread. First every device runs
+	all tests while other devices are idle. Then every test is started on
+	all devices at once, synchronized with a barrier. A drop of concurrent
+	results relative to isolated ones shows resources shared by devices,
+	like PCIe switch or root complex in case of copy tests.
+*/
+
+/*!	\brief Creates parallel benchmark of devices.
+	Devices information should be already read.
+*/
+CZParallelBench::CZParallelBench(
+	struct CZDeviceInfo *infos,	/*!<[in,out] Information of devices. */
+	int num				/*!<[in] Number of devices. */
+)	: m_barrier(num) {
+
+	m_infos = infos;
+	m_num = num;
+	m_results = new struct CZParallelResult[num];
+	memset(m_results, 0, num * sizeof(m_results[0]));
+}
+
+/*!	\brief Destroys parallel benchmark.
+*/
+CZParallelBench::~CZParallelBench() {
+	delete[] m_results;
+}
+
+/*!	\brief Run benchmark on all devices.
+	\returns \a 0 in case of success, \a -1 if no device was tested.
+*/
+int CZParallelBench::run() {
+	CZParallelThread **threads = new CZParallelThread*[m_num];
+	int readyNum = 0;
+
+	CZLog(CZLogLevelModerate, "Parallel benchmark of %d devices.", m_num);
+
+	for(int i = 0; i < m_num; i++) {
+		threads[i] = new CZParallelThread(this, i);
+		threads[i]->start();
+	}
+
+	for(int i = 0; i < m_num; i++) {
+		threads[i]->wait();
+		delete threads[i];
+		if(m_results[i].ready)
+			readyNum++;
+	}
+
+	delete[] threads;
+
+	return (readyNum != 0)? 0: -1;
+}
+
+/*!	\brief Returns results of benchmark in order of devices.
+*/
+const struct CZParallelResult *CZParallelBench::results() const {
+	return m_results;
+}
+
+/*!	\brief Test one device. Called from test thread of device.
+	Every thread passes the same sequence of barriers, even if its device
+	failed to prepare, so other devices are never blocked.
+*/
+void CZParallelBench::runDevice(
+	int index			/*!<[in] Index of device in benchmark. */
+) {
+	struct CZDeviceInfo *info = &m_infos[index];
+	struct CZParallelResult *result = &m_results[index];
+	int metric;
+
+	result->ready = (CZCudaCalcDeviceSelect(info) == 0) && (CZCudaPrepareDevice(info) == 0);
+	if(!result->ready)
+		CZLog(CZLogLevelError, "Can't prepare device %d for parallel benchmark.", info->num);
+
+	for(int turn = 0; turn < m_num; turn++) {
+		m_barrier.wait();
+		if((turn != index) || !result->ready)
+			continue;
+
+		CZLog(CZLogLevelLow, "Isolated tests of device %d.", info->num);
+		for(metric = 0; metric < CZMetricMax; metric++) {
+			if(CZCudaCalcDeviceTest(info, metric) == 0)
+				result->isolated[metric] = CZMetricValue(info, metric);
+		}
+	}
+
+	for(metric = 0; metric < CZMetricMax; metric++) {
+		m_barrier.wait();
+		if(!result->ready)
+			continue;
+
+		CZLog(CZLogLevelLow, "Concurrent test %s of device %d.", CZMetricName(metric), info->num);
+		if(CZCudaCalcDeviceTest(info, metric) == 0)
+			result->concurrent[metric] = CZMetricValue(info, metric);
+	}
+
+	if(result->ready)
+		CZCudaCleanDevice(info);
+}
@@ -0,0 +1,73 @@
+/*!	\file czparallel.h
+	\brief Parallel multi-device benchmark header file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_PARALLEL_H
+#define CZ_PARALLEL_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "cudainfo.h"
+
+/*!	\brief Results of parallel multi-device benchmark for one device.
+*/
+struct CZParallelResult {
+	int		ready;			/*!< Device was prepared successfully. */
+	float		isolated[CZMetricMax];	/*!< Results of tests when other devices are idle. */
+	float		concurrent[CZMetricMax];	/*!< Results of tests started on all devices at once. */
+};
+
+class CZBarrier {
+public:
+	CZBarrier(int count);
+
+	void wait();
+
+private:
+	QMutex m_mutex;
+	QWaitCondition m_release;
+	int m_count;
+	int m_waiting;
+	int m_generation;
+};
+
+class CZParallelBench;
+
+class CZParallelThread: public QThread {
+public:
+	CZParallelThread(CZParallelBench *bench, int index);
+
+protected:
+	void run();
+
+private:
+	CZParallelBench *m_bench;
+	int m_index;
+};
+
+class CZParallelBench {
+public:
+	CZParallelBench(struct CZDeviceInfo *infos, int num);
+	~CZParallelBench();
+
+	int run();
+
+	const struct CZParallelResult *results() const;
+
+private:
+	friend class CZParallelThread;
+
+	struct CZDeviceInfo *m_infos;
+	struct CZParallelResult *m_results;
+	int m_num;
+	CZBarrier m_barrier;
+
+	void runDevice(int index);
+};
+
+#endif//CZ_PARALLEL_H
@@ -0,0 +1,188 @@
+/*!	\file czplugin.cpp
+	\brief User-supplied kernel (plugin) helpers source file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include "log.h"
+#include "czplugin.h"
+
+/*!	\brief Read plugin source file.
+	\returns zero terminated source code allocated with malloc(),
+	\a NULL in case of error.
+*/
+char *CZPluginReadSource(
+	const char *fileName		/*!<[in] Name of CUDA C source file. */
+) {
+	FILE *fp;
+	char *source;
+	size_t size;
+
+	if(fileName == NULL)
+		return NULL;
+
+	fp = fopen(fileName, "rb");
+	if(fp == NULL) {
+		CZLog(CZLogLevelError, "Can't open plugin file %s.", fileName);
+		return NULL;
+	}
+
+	source = (char*)malloc(CZ_PLUGIN_SOURCE_MAX + 1);
+	if(source == NULL) {
+		fclose(fp);
+		return NULL;
+	}
+
+	size = fread(source, 1, CZ_PLUGIN_SOURCE_MAX + 1, fp);
+	fclose(fp);
+
+	if(size > CZ_PLUGIN_SOURCE_MAX) {
+		CZLog(CZLogLevelError, "Plugin file %s is too big.", fileName);
+		free(source);
+		return NULL;
+	}
+	source[size] = 0;
+
+	return source;
+}
+
+/*!	\brief State of formula parser.
+*/
+struct CZPluginParser {
+	const char	*p;			/*!< Current position in formula. */
+	int		error;			/*!< Parse error flag. */
+};
+
+static double CZPluginParseSum(struct CZPluginParser *parser);
+
+/*!	\brief Skip white spaces in formula.
+*/
+static void CZPluginSkipSpaces(
+	struct CZPluginParser *parser	/*!<[in,out] Parser state. */
+) {
+	while(isspace((unsigned char)*parser->p))
+		parser->p++;
+}
+
+/*!	\brief Parse number, parenthesized expression or unary minus.
+	\returns value of parsed term.
+*/
+static double CZPluginParseTerm(
+	struct CZPluginParser *parser	/*!<[in,out] Parser state. */
+) {
+	double value;
+	char *end;
+
+	CZPluginSkipSpaces(parser);
+
+	if(*parser->p == '(') {
+		parser->p++;
+		value = CZPluginParseSum(parser);
+		CZPluginSkipSpaces(parser);
+		if(*parser->p != ')') {
+			parser->error = 1;
+			return 0;
+		}
+		parser->p++;
+		return value;
+	}
+
+	if(*parser->p == '-') {
+		parser->p++;
+		return -CZPluginParseTerm(parser);
+	}
+
+	value = strtod(parser->p, &end);
+	if(end == parser->p) {
+		parser->error = 1;
+		return 0;
+	}
+	parser->p = end;
+
+	return value;
+}
+
+/*!	\brief Parse product or quotient of terms.
+	\returns value of parsed expression.
+*/
+static double CZPluginParseProduct(
+	struct CZPluginParser *parser	/*!<[in,out] Parser state. */
+) {
+	double value = CZPluginParseTerm(parser);
+
+	for(;;) {
+		CZPluginSkipSpaces(parser);
+		if(*parser->p == '*') {
+			parser->p++;
+			value *= CZPluginParseTerm(parser);
+		} else if(*parser->p == '/') {
+			double divisor;
+			parser->p++;
+			divisor = CZPluginParseTerm(parser);
+			if(divisor == 0) {
+				parser->error = 1;
+				return 0;
+			}
+			value /= divisor;
+		} else {
+			return value;
+		}
+	}
+}
+
+/*!	\brief Parse sum or difference of products.
+	\returns value of parsed expression.
+*/
+static double CZPluginParseSum(
+	struct CZPluginParser *parser	/*!<[in,out] Parser state. */
+) {
+	double value = CZPluginParseProduct(parser);
+
+	for(;;) {
+		CZPluginSkipSpaces(parser);
+		if(*parser->p == '+') {
+			parser->p++;
+			value += CZPluginParseProduct(parser);
+		} else if(*parser->p == '-') {
+			parser->p++;
+			value -= CZPluginParseProduct(parser);
+		} else {
+			return value;
+		}
+	}
+}
+
+/*!	\brief Evaluate number of operations per thread.
+	Formula is an arithmetic expression of numbers, operators \a + \a - \a * \a /
+	and parentheses. E.g. "32 * 8 * 256 * 2".
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZPluginEvalOps(
+	const char *formula,		/*!<[in] Formula to evaluate. */
+	double *ops			/*!<[out] Number of operations per thread. */
+) {
+	struct CZPluginParser parser;
+	double value;
+
+	if((formula == NULL) || (ops == NULL))
+		return -1;
+
+	parser.p = formula;
+	parser.error = 0;
+
+	value = CZPluginParseSum(&parser);
+	CZPluginSkipSpaces(&parser);
+
+	if(parser.error || (*parser.p != 0) || (value <= 0)) {
+		CZLog(CZLogLevelError, "Wrong operations per thread formula '%s'.", formula);
+		return -1;
+	}
+
+	*ops = value;
+	return 0;
+}
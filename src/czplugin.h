@@ -0,0 +1,25 @@
+/*!	\file czplugin.h
+	\brief User-supplied kernel (plugin) helpers header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_PLUGIN_H
+#define CZ_PLUGIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_PLUGIN_KERNEL_NAME	"CZPluginKernel"	/*!< Default name of plugin kernel. */
+#define CZ_PLUGIN_SOURCE_MAX	(1 << 20)		/*!< Maximal size of plugin source file. */
+
+char *CZPluginReadSource(const char *fileName);
+int CZPluginEvalOps(const char *formula, double *ops);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_PLUGIN_H
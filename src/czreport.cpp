@@ -0,0 +1,1553 @@
+/*!	\file czreport.cpp
+	\brief Machine-readable reports source file.
+	JSON and CSV reports are written and read here without Qt, so every
+	build, including command line and library ones, shares the same schema.
+	Numbers are always written and read with dot as decimal separator,
+	whatever locale the application has set.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <locale.h>
+#include <time.h>
+
+#include "log.h"
+#include "cudaarch.h"
+#include "czreport.h"
+
+#if (defined(WIN64) || defined(_WIN64) || defined(__WIN64__)) || (defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
+#define CZ_REPORT_WIN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define CZ_REPORT_DEPTH_MAX	16			/*!< Maximal nesting of JSON objects. */
+#define CZ_REPORT_TEXT_MIN	4096			/*!< Initial size of report text buffer. */
+#define CZ_REPORT_NUMBER_LEN	64			/*!< Maximal length of formatted number. */
+
+/*!	\brief Initialize empty report.
+*/
+void CZReportInit(
+	struct CZReport *report		/*!<[out] Report. */
+) {
+	report->fields = NULL;
+	report->num = 0;
+	report->size = 0;
+}
+
+/*!	\brief Free fields of report.
+*/
+void CZReportFree(
+	struct CZReport *report		/*!<[in,out] Report. */
+) {
+	free(report->fields);
+	CZReportInit(report);
+}
+
+/*!	\brief Copy string to fixed size buffer, truncating it if needed.
+*/
+static void CZReportCopy(
+	char *dst,			/*!<[out] Destination buffer. */
+	int size,			/*!<[in] Size of destination buffer. */
+	const char *src			/*!<[in] Source string, may be \a NULL. */
+) {
+	int len = (src == NULL)? 0: (int)strlen(src);
+
+	if(len > size - 1)
+		len = size - 1;
+	if(len > 0)
+		memcpy(dst, src, len);
+	dst[len] = 0;
+}
+
+/*!	\brief Append empty field to report.
+	\returns new field, or \a NULL in case of failure.
+*/
+static struct CZReportField *CZReportAddField(
+	struct CZReport *report,	/*!<[in,out] Report. */
+	const char *key			/*!<[in] Field path. */
+) {
+	struct CZReportField *field;
+
+	if(report->num == report->size) {
+		int size = (report->size == 0)? 64: report->size * 2;
+		struct CZReportField *fields = (struct CZReportField*)realloc(report->fields, size * sizeof(struct CZReportField));
+		if(fields == NULL) {
+			CZLog(CZLogLevelError, "Not enough memory for report!");
+			return NULL;
+		}
+		report->fields = fields;
+		report->size = size;
+	}
+
+	field = &report->fields[report->num++];
+	CZReportCopy(field->key, sizeof(field->key), key);
+	field->value[0] = 0;
+	field->isString = 0;
+	field->unit[0] = 0;
+
+	return field;
+}
+
+/*!	\brief Format number with dot as decimal separator.
+*/
+static void CZReportFormatNumber(
+	char *buf,			/*!<[out] Buffer of #CZ_REPORT_NUMBER_LEN characters. */
+	double value,			/*!<[in] Value. */
+	int digits			/*!<[in] Number of significant digits. */
+) {
+	const char *point = localeconv()->decimal_point;
+	char *p;
+
+	snprintf(buf, CZ_REPORT_NUMBER_LEN, "%.*g", digits, value);
+
+	if((point == NULL) || (strcmp(point, ".") == 0) || (point[0] == 0))
+		return;
+
+	p = strstr(buf, point);
+	if(p != NULL) {
+		*p = '.';
+		memmove(p + 1, p + strlen(point), strlen(p + strlen(point)) + 1);
+	}
+}
+
+/*!	\brief Read number written with dot as decimal separator.
+	\returns value, or \a 0 if string is not a number.
+*/
+static double CZReportParseNumber(
+	const char *str			/*!<[in] String. */
+) {
+	const char *point = localeconv()->decimal_point;
+	char buf[CZ_REPORT_NUMBER_LEN * 2];
+	const char *dot;
+
+	if(str == NULL)
+		return 0;
+
+	dot = strchr(str, '.');
+	if((dot == NULL) || (point == NULL) || (strcmp(point, ".") == 0) || (point[0] == 0)
+		|| ((int)(strlen(str) + strlen(point)) >= (int)sizeof(buf)))
+		return strtod(str, NULL);
+
+	memcpy(buf, str, dot - str);
+	strcpy(buf + (dot - str), point);
+	strcat(buf, dot + 1);
+
+	return strtod(buf, NULL);
+}
+
+/*!	\brief Append string field to report.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZReportAddString(
+	struct CZReport *report,	/*!<[in,out] Report. */
+	const char *key,		/*!<[in] Field path. */
+	const char *value		/*!<[in] Field value, may be \a NULL. */
+) {
+	struct CZReportField *field = CZReportAddField(report, key);
+	if(field == NULL)
+		return -1;
+
+	CZReportCopy(field->value, sizeof(field->value), value);
+	field->isString = 1;
+
+	return 0;
+}
+
+/*!	\brief Append numeric field to report.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZReportAddNumber(
+	struct CZReport *report,	/*!<[in,out] Report. */
+	const char *key,		/*!<[in] Field path. */
+	double value,			/*!<[in] Field value. */
+	const char *unit		/*!<[in] Base unit of value, may be \a NULL. */
+) {
+	char number[CZ_REPORT_NUMBER_LEN];
+	struct CZReportField *field = CZReportAddField(report, key);
+	if(field == NULL)
+		return -1;
+
+	CZReportFormatNumber(number, value, 15);
+	CZReportCopy(field->value, sizeof(field->value), number);
+	CZReportCopy(field->unit, sizeof(field->unit), unit);
+
+	return 0;
+}
+
+/*!	\brief Find value of report field.
+	The last field wins if the path is repeated.
+	\returns value, or \a NULL if report has no such field.
+*/
+const char *CZReportValue(
+	const struct CZReport *report,	/*!<[in] Report. */
+	const char *key			/*!<[in] Field path. */
+) {
+	int i;
+
+	for(i = report->num - 1; i >= 0; i--) {
+		if(strcmp(report->fields[i].key, key) == 0)
+			return report->fields[i].value;
+	}
+
+	return NULL;
+}
+
+/*!	\brief Find numeric value of report field.
+	\returns value, or \a 0 if report has no such field.
+*/
+double CZReportNumber(
+	const struct CZReport *report,	/*!<[in] Report. */
+	const char *key			/*!<[in] Field path. */
+) {
+	return CZReportParseNumber(CZReportValue(report, key));
+}
+
+/*!	\brief Get base scale of measured metric.
+	\returns multiplier from KiB/s or K(FL)OPS to B/s or op/s.
+*/
+double CZReportMetricScale(
+	int metric			/*!<[in] Metric. See enum #CZMetric, \a -1 for user-supplied kernel. */
+) {
+	if((metric >= 0) && (metric <= CZMetricCopyDD))
+		return 1024;
+	else
+		return 1000;
+}
+
+/*!	\brief Get base unit of measured metric.
+	\returns unit of values scaled with CZReportMetricScale().
+*/
+const char *CZReportMetricUnit(
+	int metric			/*!<[in] Metric. See enum #CZMetric, \a -1 for user-supplied kernel. */
+) {
+	if((metric >= 0) && (metric <= CZMetricCopyDD))
+		return "B/s";
+	else
+		return "op/s";
+}
+
+/*!	\brief Get metric from fields of parsed report.
+	Value and statistics are converted back to units of #CZDeviceInfo.
+	\returns \a 0 if metric is present in report, \a -1 otherwise.
+*/
+int CZReportMetric(
+	const struct CZReport *report,	/*!<[in] Report. */
+	int metric,			/*!<[in] Metric. See enum #CZMetric. */
+	double *value,			/*!<[out] Value of metric. */
+	struct CZDeviceInfoStat *stat	/*!<[out] Statistics of metric, may be \a NULL. */
+) {
+	double scale = CZReportMetricScale(metric);
+	char key[CZ_REPORT_KEY_LEN];
+	const char *name = CZMetricName(metric);
+
+	*value = 0;
+	if(stat != NULL)
+		memset(stat, 0, sizeof(*stat));
+
+#define CZ_REPORT_METRIC_KEY(field) \
+	(snprintf(key, sizeof(key), "metrics.%s." field, name), key)
+
+	if(CZReportValue(report, CZ_REPORT_METRIC_KEY("value")) == NULL)
+		return -1;
+
+	*value = CZReportNumber(report, key) / scale;
+	if(stat != NULL) {
+		stat->samplesNum = (int)CZReportNumber(report, CZ_REPORT_METRIC_KEY("stat.samples"));
+		stat->min = CZReportNumber(report, CZ_REPORT_METRIC_KEY("stat.min")) / scale;
+		stat->max = CZReportNumber(report, CZ_REPORT_METRIC_KEY("stat.max")) / scale;
+		stat->median = CZReportNumber(report, CZ_REPORT_METRIC_KEY("stat.median")) / scale;
+		stat->mean = CZReportNumber(report, CZ_REPORT_METRIC_KEY("stat.mean")) / scale;
+		stat->p95 = CZReportNumber(report, CZ_REPORT_METRIC_KEY("stat.p95")) / scale;
+		stat->stddev = CZReportNumber(report, CZ_REPORT_METRIC_KEY("stat.stddev")) / scale;
+		stat->cv = CZReportNumber(report, CZ_REPORT_METRIC_KEY("stat.cv"));
+		stat->ci95 = CZReportNumber(report, CZ_REPORT_METRIC_KEY("stat.ci95"));
+	}
+
+#undef CZ_REPORT_METRIC_KEY
+
+	return 0;
+}
+
+/*!	\brief Append measured metric and its statistics to report.
+	Values are converted from KiB/s and K(FL)OPS to B/s and op/s.
+*/
+static void CZReportAddMetric(
+	struct CZReport *report,	/*!<[in,out] Report. */
+	const struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	int metric,			/*!<[in] Metric, \a -1 for user-supplied kernel. */
+	const char *name,		/*!<[in] Metric name. */
+	double value,			/*!<[in] Measured value. */
+	const struct CZDeviceInfoStat *stat	/*!<[in] Statistics of measured iterations. */
+) {
+	double scale = CZReportMetricScale(metric);
+	const char *unit = CZReportMetricUnit(metric);
+	char key[CZ_REPORT_KEY_LEN];
+
+#define CZ_REPORT_METRIC_KEY(field) \
+	(snprintf(key, sizeof(key), "metrics.%s." field, name), key)
+
+	CZReportAddString(report, CZ_REPORT_METRIC_KEY("unit"), unit);
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("value"), value * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("peak"), (metric == -1)? 0: CZArchCalcPeak(info, metric) * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("stat.samples"), stat->samplesNum, NULL);
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("stat.min"), stat->min * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("stat.max"), stat->max * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("stat.median"), stat->median * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("stat.mean"), stat->mean * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("stat.p95"), stat->p95 * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("stat.stddev"), stat->stddev * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("stat.cv"), stat->cv, "%");
+	CZReportAddNumber(report, CZ_REPORT_METRIC_KEY("stat.ci95"), stat->ci95, "%");
+
+#undef CZ_REPORT_METRIC_KEY
+}
+
+/*!	\brief Get host name of this node.
+*/
+static void CZReportHostName(
+	char *buf,			/*!<[out] Buffer of host name. */
+	int size			/*!<[in] Size of buffer. */
+) {
+#ifdef CZ_REPORT_WIN
+	DWORD len = size;
+	if(!GetComputerNameA(buf, &len))
+		buf[0] = 0;
+#else
+	if(gethostname(buf, size) != 0)
+		buf[0] = 0;
+#endif
+	buf[size - 1] = 0;
+}
+
+/*!	\brief Collect fields describing report itself.
+*/
+static void CZReportCollectHead(
+	struct CZReport *report,	/*!<[out] Report. */
+	const struct CZReportOrigin *origin	/*!<[in] Application writing report. */
+) {
+	char host[CZ_REPORT_VALUE_LEN];
+	char generated[32];
+	time_t now = time(NULL);
+	struct tm *tm = gmtime(&now);
+
+	if((tm == NULL) || (strftime(generated, sizeof(generated), "%Y-%m-%dT%H:%M:%SZ", tm) == 0))
+		generated[0] = 0;
+	CZReportHostName(host, sizeof(host));
+
+	CZReportAddString(report, "report.schema", CZ_REPORT_SCHEMA);
+	CZReportAddNumber(report, "report.schema_version", CZ_REPORT_SCHEMA_VERSION, NULL);
+	CZReportAddString(report, "report.generator", origin->generator);
+	CZReportAddString(report, "report.version", origin->version);
+	CZReportAddNumber(report, "report.word_size", sizeof(void*) * 8, "bit");
+	CZReportAddString(report, "report.os", origin->os);
+	CZReportAddString(report, "report.host", host);
+	CZReportAddString(report, "report.generated", generated);
+}
+
+/*!	\brief Collect all fields of report of one device.
+	Sizes are in bytes, clocks in Hz, rates in B/s or op/s.
+*/
+static void CZReportCollect(
+	struct CZReport *report,	/*!<[out] Report. */
+	const struct CZReportOrigin *origin,	/*!<[in] Application writing report. */
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	int metric;
+
+	CZReportCollectHead(report, origin);
+
+	CZReportAddString(report, "driver.version", info->drvVersion);
+	CZReportAddNumber(report, "driver.dll_version", info->drvDllVer, NULL);
+	CZReportAddString(report, "driver.dll_version_string", info->drvDllVerStr);
+	CZReportAddNumber(report, "runtime.dll_version", info->rtDllVer, NULL);
+	CZReportAddString(report, "runtime.dll_version_string", info->rtDllVerStr);
+
+	CZReportAddNumber(report, "device.index", info->num, NULL);
+	CZReportAddString(report, "device.name", info->deviceName);
+	CZReportAddNumber(report, "device.major", info->major, NULL);
+	CZReportAddNumber(report, "device.minor", info->minor, NULL);
+	CZReportAddString(report, "device.architecture", info->archName);
+	CZReportAddNumber(report, "device.tcc_driver", info->tccDriver, NULL);
+
+	CZReportAddNumber(report, "core.clock_rate", info->core.clockRate * 1000.0, "Hz");
+	CZReportAddNumber(report, "core.pci_domain", info->core.pciDomainID, NULL);
+	CZReportAddNumber(report, "core.pci_bus", info->core.pciBusID, NULL);
+	CZReportAddNumber(report, "core.pci_device", info->core.pciDeviceID, NULL);
+	CZReportAddNumber(report, "core.multiprocessors", info->core.muliProcCount, NULL);
+	CZReportAddNumber(report, "core.cuda_cores", info->core.cudaCores, NULL);
+	CZReportAddNumber(report, "core.threads_per_multiprocessor", info->core.maxThreadsPerMultiProcessor, NULL);
+	CZReportAddNumber(report, "core.warp_size", info->core.SIMDWidth, NULL);
+	CZReportAddNumber(report, "core.registers_per_block", info->core.regsPerBlock, NULL);
+	CZReportAddNumber(report, "core.threads_per_block", info->core.maxThreadsPerBlock, NULL);
+	CZReportAddNumber(report, "core.threads_dim_x", info->core.maxThreadsDim[0], NULL);
+	CZReportAddNumber(report, "core.threads_dim_y", info->core.maxThreadsDim[1], NULL);
+	CZReportAddNumber(report, "core.threads_dim_z", info->core.maxThreadsDim[2], NULL);
+	CZReportAddNumber(report, "core.grid_dim_x", info->core.maxGridSize[0], NULL);
+	CZReportAddNumber(report, "core.grid_dim_y", info->core.maxGridSize[1], NULL);
+	CZReportAddNumber(report, "core.grid_dim_z", info->core.maxGridSize[2], NULL);
+	CZReportAddNumber(report, "core.watchdog", info->core.watchdogEnabled, NULL);
+	CZReportAddNumber(report, "core.integrated", info->core.integratedGpu, NULL);
+	CZReportAddNumber(report, "core.concurrent_kernels", info->core.concurrentKernels, NULL);
+	CZReportAddNumber(report, "core.compute_mode", info->core.computeMode, NULL);
+	CZReportAddNumber(report, "core.stream_priorities", info->core.streamPrioritiesSupported, NULL);
+
+	CZReportAddNumber(report, "memory.total_global", info->mem.totalGlobal, "B");
+	CZReportAddNumber(report, "memory.bus_width", info->mem.memoryBusWidth, "bit");
+	CZReportAddNumber(report, "memory.clock_rate", info->mem.memoryClockRate * 1000.0, "Hz");
+	CZReportAddNumber(report, "memory.error_correction", info->mem.errorCorrection, NULL);
+	CZReportAddNumber(report, "memory.l2_cache", info->mem.l2CacheSize, "B");
+	CZReportAddNumber(report, "memory.shared_per_block", info->mem.sharedPerBlock, "B");
+	CZReportAddNumber(report, "memory.max_pitch", info->mem.maxPitch, "B");
+	CZReportAddNumber(report, "memory.total_const", info->mem.totalConst, "B");
+	CZReportAddNumber(report, "memory.texture_alignment", info->mem.textureAlignment, "B");
+	CZReportAddNumber(report, "memory.texture_1d", info->mem.texture1D[0], NULL);
+	CZReportAddNumber(report, "memory.texture_2d_w", info->mem.texture2D[0], NULL);
+	CZReportAddNumber(report, "memory.texture_2d_h", info->mem.texture2D[1], NULL);
+	CZReportAddNumber(report, "memory.texture_3d_w", info->mem.texture3D[0], NULL);
+	CZReportAddNumber(report, "memory.texture_3d_h", info->mem.texture3D[1], NULL);
+	CZReportAddNumber(report, "memory.texture_3d_d", info->mem.texture3D[2], NULL);
+	CZReportAddNumber(report, "memory.gpu_overlap", info->mem.gpuOverlap, NULL);
+	CZReportAddNumber(report, "memory.map_host_memory", info->mem.mapHostMemory, NULL);
+	CZReportAddNumber(report, "memory.unified_addressing", info->mem.unifiedAddressing, NULL);
+	CZReportAddNumber(report, "memory.async_engines", info->mem.asyncEngineCount, NULL);
+
+	for(metric = 0; metric < CZMetricMax; metric++)
+		CZReportAddMetric(report, info, metric, CZMetricName(metric), CZMetricValue(info, metric), &info->stat[metric]);
+
+	if(info->perf.pluginName[0] != 0) {
+		CZReportAddString(report, "metrics.plugin.kernel", info->perf.pluginName);
+		CZReportAddMetric(report, info, -1, "plugin", info->perf.calcPlugin, &info->perf.calcPluginStat);
+	}
+}
+
+/*!	\brief Analyse distribution of every metric over devices.
+*/
+void CZReportFleetAnalyze(
+	const struct CZDeviceInfo *infos,	/*!<[in] Information of devices. */
+	int num,			/*!<[in] Number of devices. */
+	const struct CZFleetConfig *config,	/*!<[in] Outlier detection configuration. */
+	struct CZFleetSummary *summaries,	/*!<[out] Distributions of metrics, #CZMetricMax entries. */
+	struct CZFleetEntry *entries	/*!<[out] Positions of devices, \a num entries per metric. */
+) {
+	double *values = (double*)malloc((num + 1) * sizeof(double));
+	int metric, i;
+
+	if(values == NULL) {
+		memset(summaries, 0, CZMetricMax * sizeof(*summaries));
+		memset(entries, 0, CZMetricMax * num * sizeof(*entries));
+		return;
+	}
+
+	for(metric = 0; metric < CZMetricMax; metric++) {
+		for(i = 0; i < num; i++)
+			values[i] = CZMetricValue(&infos[i], metric);
+		CZFleetAnalyze(config, values, num, &summaries[metric], &entries[metric * num]);
+	}
+
+	free(values);
+}
+
+/*!	\brief Append summary of metric over devices to report.
+*/
+static void CZReportAddFleetSummary(
+	struct CZReport *report,	/*!<[in,out] Report. */
+	int metric,			/*!<[in] Metric. See enum #CZMetric. */
+	const struct CZFleetSummary *summary	/*!<[in] Distribution of metric. */
+) {
+	double scale = CZReportMetricScale(metric);
+	const char *unit = CZReportMetricUnit(metric);
+	const char *name = CZMetricName(metric);
+	char key[CZ_REPORT_KEY_LEN];
+
+#define CZ_REPORT_FLEET_KEY(field) \
+	(snprintf(key, sizeof(key), "fleet.%s." field, name), key)
+
+	CZReportAddString(report, CZ_REPORT_FLEET_KEY("unit"), unit);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("devices"), summary->num, NULL);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("min"), summary->min * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("max"), summary->max * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("mean"), summary->mean * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("median"), summary->median * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("p25"), summary->p25 * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("p75"), summary->p75 * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("mad"), summary->mad * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("outliers"), summary->outliersNum, NULL);
+
+#undef CZ_REPORT_FLEET_KEY
+}
+
+/*!	\brief Append position of device in distribution of metric to report.
+*/
+static void CZReportAddFleetEntry(
+	struct CZReport *report,	/*!<[in,out] Report. */
+	int metric,			/*!<[in] Metric. See enum #CZMetric. */
+	const struct CZFleetSummary *summary,	/*!<[in] Distribution of metric. */
+	const struct CZFleetEntry *entry	/*!<[in] Position of device. */
+) {
+	double scale = CZReportMetricScale(metric);
+	const char *unit = CZReportMetricUnit(metric);
+	const char *name = CZMetricName(metric);
+	char key[CZ_REPORT_KEY_LEN];
+
+#define CZ_REPORT_FLEET_KEY(field) \
+	(snprintf(key, sizeof(key), "fleet.%s." field, name), key)
+
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("rank"), entry->rank, NULL);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("median"), summary->median * scale, unit);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("deviation"), entry->deviationPct, "%");
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("robust_z"), entry->robustZ, NULL);
+	CZReportAddNumber(report, CZ_REPORT_FLEET_KEY("outlier"), entry->outlier, NULL);
+
+#undef CZ_REPORT_FLEET_KEY
+}
+
+/*!	\brief Initialize empty report text.
+*/
+void CZReportTextInit(
+	struct CZReportText *out	/*!<[out] Report text. */
+) {
+	out->text = NULL;
+	out->len = 0;
+	out->size = 0;
+}
+
+/*!	\brief Free report text.
+*/
+void CZReportTextFree(
+	struct CZReportText *out	/*!<[in,out] Report text. */
+) {
+	free(out->text);
+	CZReportTextInit(out);
+}
+
+/*!	\brief Append formatted string to report text.
+	In case of failure text is dropped and marked with negative size,
+	so writers can check it once at the end.
+*/
+static void CZReportPrint(struct CZReportText *out, const char *fmt, ...)
+#if (defined(Q_CC_GNU) || defined(__GNUC__)) && !defined(__INSURE__)
+	__attribute__ ((format (printf, 2, 3)))
+#endif
+;
+
+static void CZReportPrint(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const char *fmt,		/*!<[in] Format string. */
+	...				/*!<[in] Arguments. */
+) {
+	va_list ap;
+	int len;
+
+	if(out->size < 0)
+		return;
+
+	for(;;) {
+		if(out->size - out->len > 1) {
+			va_start(ap, fmt);
+			len = vsnprintf(out->text + out->len, out->size - out->len, fmt, ap);
+			va_end(ap);
+			if(len < 0)
+				break;
+			if(out->len + len < out->size) {
+				out->len += len;
+				return;
+			}
+		} else
+			len = 0;
+
+		int size = (out->size == 0)? CZ_REPORT_TEXT_MIN: out->size * 2;
+		while(size <= out->len + len)
+			size *= 2;
+		char *text = (char*)realloc(out->text, size);
+		if(text == NULL)
+			break;
+		out->text = text;
+		out->size = size;
+	}
+
+	CZLog(CZLogLevelError, "Not enough memory for report!");
+	free(out->text);
+	out->text = NULL;
+	out->len = 0;
+	out->size = -1;
+}
+
+/*!	\brief Append indentation to report text.
+*/
+static void CZReportIndent(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	int indent			/*!<[in] Indentation level. */
+) {
+	static const char tabs[] = "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+
+	if(indent > (int)sizeof(tabs) - 1)
+		indent = sizeof(tabs) - 1;
+	CZReportPrint(out, "%.*s", indent, tabs);
+}
+
+/*!	\brief Append quoted JSON string to report text.
+*/
+static void CZReportJSONString(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const char *str			/*!<[in] String to quote. */
+) {
+	const unsigned char *p;
+
+	CZReportPrint(out, "\"");
+	for(p = (const unsigned char*)str; *p != 0; p++) {
+		if(*p == '"')
+			CZReportPrint(out, "\\\"");
+		else if(*p == '\\')
+			CZReportPrint(out, "\\\\");
+		else if(*p == '\n')
+			CZReportPrint(out, "\\n");
+		else if(*p == '\r')
+			CZReportPrint(out, "\\r");
+		else if(*p == '\t')
+			CZReportPrint(out, "\\t");
+		else if(*p < 0x20)
+			CZReportPrint(out, "\\u%04x", *p);
+		else
+			CZReportPrint(out, "%c", *p);
+	}
+	CZReportPrint(out, "\"");
+}
+
+/*!	\brief Append CSV column to report text, quoted if needed.
+*/
+static void CZReportCSVString(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const char *str			/*!<[in] String to quote. */
+) {
+	const char *p;
+
+	if(strpbrk(str, ",\"\n\r") == NULL) {
+		CZReportPrint(out, "%s", str);
+		return;
+	}
+
+	CZReportPrint(out, "\"");
+	for(p = str; *p != 0; p++) {
+		if(*p == '"')
+			CZReportPrint(out, "\"\"");
+		else
+			CZReportPrint(out, "%c", *p);
+	}
+	CZReportPrint(out, "\"");
+}
+
+/*!	\brief Split field path into its components.
+	Components over #CZ_REPORT_DEPTH_MAX stay in the last one.
+	\returns number of components.
+*/
+static int CZReportSplitKey(
+	const char *key,		/*!<[in] Dot separated field path. */
+	char path[][CZ_REPORT_KEY_LEN]	/*!<[out] Components, #CZ_REPORT_DEPTH_MAX entries. */
+) {
+	int num = 0;
+
+	for(;;) {
+		const char *dot = strchr(key, '.');
+		int len = (dot == NULL)? (int)strlen(key): (int)(dot - key);
+
+		if((dot == NULL) || (num == CZ_REPORT_DEPTH_MAX - 1)) {
+			CZReportCopy(path[num++], CZ_REPORT_KEY_LEN, key);
+			return num;
+		}
+
+		memcpy(path[num], key, len);
+		path[num++][len] = 0;
+		key = dot + 1;
+	}
+}
+
+/*!	\brief Append JSON object of report fields to report text.
+	Fields are nested objects following their dot separated paths.
+*/
+static void CZReportJSONObject(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const struct CZReport *report,	/*!<[in] Report. */
+	int indent,			/*!<[in] Indentation level of object. */
+	const struct CZReportText *members	/*!<[in] Formatted members appended after fields, may be \a NULL. */
+) {
+	char path[CZ_REPORT_DEPTH_MAX][CZ_REPORT_KEY_LEN];
+	char keyPath[CZ_REPORT_DEPTH_MAX][CZ_REPORT_KEY_LEN];
+	int depth = 0;
+	int first = 1;
+	int i;
+
+	CZReportPrint(out, "{");
+	for(i = 0; i < report->num; i++) {
+		const struct CZReportField *field = &report->fields[i];
+		int parents = CZReportSplitKey(field->key, keyPath) - 1;
+		int common = 0;
+
+		while((common < depth) && (common < parents) && (strcmp(path[common], keyPath[common]) == 0))
+			common++;
+
+		while(depth > common) {
+			depth--;
+			CZReportPrint(out, "\n");
+			CZReportIndent(out, indent + depth + 1);
+			CZReportPrint(out, "}");
+			first = 0;
+		}
+
+		while(depth < parents) {
+			CZReportPrint(out, "%s\n", first? "": ",");
+			CZReportIndent(out, indent + depth + 1);
+			CZReportJSONString(out, keyPath[depth]);
+			CZReportPrint(out, ": {");
+			strcpy(path[depth], keyPath[depth]);
+			depth++;
+			first = 1;
+		}
+
+		CZReportPrint(out, "%s\n", first? "": ",");
+		CZReportIndent(out, indent + depth + 1);
+		CZReportJSONString(out, keyPath[parents]);
+		CZReportPrint(out, ": ");
+		if(field->isString)
+			CZReportJSONString(out, field->value);
+		else
+			CZReportPrint(out, "%s", field->value);
+		first = 0;
+	}
+
+	while(depth > 0) {
+		depth--;
+		CZReportPrint(out, "\n");
+		CZReportIndent(out, indent + depth + 1);
+		CZReportPrint(out, "}");
+	}
+	if((members != NULL) && (members->text != NULL))
+		CZReportPrint(out, "%s", members->text);
+	CZReportPrint(out, "\n");
+	CZReportIndent(out, indent);
+	CZReportPrint(out, "}");
+}
+
+/*!	\brief Append CSV rows of report fields of one device to report text.
+*/
+static void CZReportCSVRows(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const struct CZReport *report,	/*!<[in] Report. */
+	int device			/*!<[in] Index of device. */
+) {
+	int i;
+
+	for(i = 0; i < report->num; i++) {
+		CZReportPrint(out, "%d,%d,%s,", CZ_REPORT_SCHEMA_VERSION, device, report->fields[i].key);
+		CZReportCSVString(out, report->fields[i].value);
+		CZReportPrint(out, ",%s\n", report->fields[i].unit);
+	}
+}
+
+/*!	\brief Write JSON report of one device.
+	Fields are nested objects following their dot separated paths, see
+	#CZ_REPORT_SCHEMA_VERSION. Sizes are in bytes, clocks in Hz and rates
+	in B/s or op/s, every metric has its unit in \a unit field.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZReportWriteJSON(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const struct CZReportOrigin *origin,	/*!<[in] Application writing report. */
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	struct CZReport report;
+
+	CZReportInit(&report);
+	CZReportCollect(&report, origin, info);
+	CZReportJSONObject(out, &report, 0, NULL);
+	CZReportPrint(out, "\n");
+	CZReportFree(&report);
+
+	return (out->size < 0)? -1: 0;
+}
+
+/*!	\brief Write CSV report of one device.
+	Every field is a row with its dot separated path, value and unit,
+	the same fields as in CZReportWriteJSON().
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZReportWriteCSV(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const struct CZReportOrigin *origin,	/*!<[in] Application writing report. */
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	struct CZReport report;
+
+	CZReportInit(&report);
+	CZReportCollect(&report, origin, info);
+	CZReportPrint(out, "%s", CZ_REPORT_CSV_HEADER);
+	CZReportCSVRows(out, &report, info->num);
+	CZReportFree(&report);
+
+	return (out->size < 0)? -1: 0;
+}
+
+/*!	\brief Write JSON report of many devices.
+	Top level object holds distributions of metrics in \a fleet object
+	and full reports of devices in \a devices array. Report of every
+	device has its rank, deviation from median and outlier flag of
+	every metric in its own \a fleet object.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZReportWriteFleetJSON(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const struct CZReportOrigin *origin,	/*!<[in] Application writing report. */
+	const struct CZDeviceInfo *infos,	/*!<[in] Information of devices. */
+	int num,			/*!<[in] Number of devices. */
+	const struct CZFleetConfig *config	/*!<[in] Outlier detection configuration. */
+) {
+	struct CZFleetSummary summaries[CZMetricMax];
+	struct CZFleetEntry *entries = (struct CZFleetEntry*)malloc((CZMetricMax * num + 1) * sizeof(struct CZFleetEntry));
+	struct CZReport report;
+	struct CZReportText devices;
+	int metric, i;
+
+	if(entries == NULL) {
+		CZLog(CZLogLevelError, "Not enough memory for report!");
+		return -1;
+	}
+
+	CZReportFleetAnalyze(infos, num, config, summaries, entries);
+
+	CZReportInit(&report);
+	CZReportCollectHead(&report, origin);
+	CZReportAddString(&report, "report.kind", "fleet");
+	CZReportAddNumber(&report, "fleet.devices", num, NULL);
+	CZReportAddNumber(&report, "fleet.outlier_threshold", config->outlierPct, "%");
+	CZReportAddNumber(&report, "fleet.outlier_z", config->outlierZ, NULL);
+	for(metric = 0; metric < CZMetricMax; metric++)
+		CZReportAddFleetSummary(&report, metric, &summaries[metric]);
+
+	CZReportTextInit(&devices);
+	CZReportPrint(&devices, ",\n\t");
+	CZReportJSONString(&devices, "devices");
+	CZReportPrint(&devices, ": [");
+	for(i = 0; i < num; i++) {
+		struct CZReport device;
+
+		CZReportInit(&device);
+		CZReportCollect(&device, origin, &infos[i]);
+		for(metric = 0; metric < CZMetricMax; metric++)
+			CZReportAddFleetEntry(&device, metric, &summaries[metric], &entries[metric * num + i]);
+
+		CZReportPrint(&devices, "%s\n\t\t", (i == 0)? "": ",");
+		CZReportJSONObject(&devices, &device, 2, NULL);
+		CZReportFree(&device);
+	}
+	CZReportPrint(&devices, "\n\t]");
+
+	if(devices.size < 0) {
+		CZReportTextFree(out);
+		out->size = -1;
+	}
+	CZReportJSONObject(out, &report, 0, &devices);
+	CZReportPrint(out, "\n");
+
+	CZReportTextFree(&devices);
+	CZReportFree(&report);
+	free(entries);
+
+	return (out->size < 0)? -1: 0;
+}
+
+/*!	\brief Write CSV report of many devices.
+	Rows of every device are the same as in CZReportWriteCSV(), followed
+	by its rank, deviation from median and outlier flag of every metric.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZReportWriteFleetCSV(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const struct CZReportOrigin *origin,	/*!<[in] Application writing report. */
+	const struct CZDeviceInfo *infos,	/*!<[in] Information of devices. */
+	int num,			/*!<[in] Number of devices. */
+	const struct CZFleetConfig *config	/*!<[in] Outlier detection configuration. */
+) {
+	struct CZFleetSummary summaries[CZMetricMax];
+	struct CZFleetEntry *entries = (struct CZFleetEntry*)malloc((CZMetricMax * num + 1) * sizeof(struct CZFleetEntry));
+	int metric, i;
+
+	if(entries == NULL) {
+		CZLog(CZLogLevelError, "Not enough memory for report!");
+		return -1;
+	}
+
+	CZReportFleetAnalyze(infos, num, config, summaries, entries);
+
+	CZReportPrint(out, "%s", CZ_REPORT_CSV_HEADER);
+	for(i = 0; i < num; i++) {
+		struct CZReport report;
+
+		CZReportInit(&report);
+		CZReportCollect(&report, origin, &infos[i]);
+		for(metric = 0; metric < CZMetricMax; metric++)
+			CZReportAddFleetEntry(&report, metric, &summaries[metric], &entries[metric * num + i]);
+
+		CZReportCSVRows(out, &report, infos[i].num);
+		CZReportFree(&report);
+	}
+
+	free(entries);
+
+	return (out->size < 0)? -1: 0;
+}
+
+/*!	\brief Write CSV report of merged reports of many nodes.
+	Every tested metric of every device is a row with its group, node,
+	value, median of group and outlier flag. Values are in B/s or op/s.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZReportWriteMergeCSV(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const struct CZMerge *merge	/*!<[in] Merged reports after CZMergeAnalyze(). */
+) {
+	char value[CZ_REPORT_NUMBER_LEN];
+	char median[CZ_REPORT_NUMBER_LEN];
+	char deviation[CZ_REPORT_NUMBER_LEN];
+	char robustZ[CZ_REPORT_NUMBER_LEN];
+	int g, i, metric;
+
+	CZReportPrint(out, "device_name,driver_version,node,device,file,metric,value,unit,median,deviation,robust_z,outlier\n");
+	for(g = 0; g < merge->groupsNum; g++) {
+		const struct CZMergeGroup *group = &merge->groups[g];
+
+		for(i = 0; i < group->nodesNum; i++) {
+			const struct CZMergeNode *node = &group->nodes[i];
+
+			for(metric = 0; metric < CZMetricMax; metric++) {
+				const struct CZFleetEntry *entry = &group->entries[metric][i];
+				if(entry->rank == 0)
+					continue;
+
+				CZReportFormatNumber(value, node->value[metric] * CZReportMetricScale(metric), 15);
+				CZReportFormatNumber(median, group->summary[metric].median * CZReportMetricScale(metric), 15);
+				CZReportFormatNumber(deviation, entry->deviationPct, 6);
+				CZReportFormatNumber(robustZ, entry->robustZ, 6);
+
+				CZReportCSVString(out, group->deviceName);
+				CZReportPrint(out, ",");
+				CZReportCSVString(out, group->drvVersion);
+				CZReportPrint(out, ",");
+				CZReportCSVString(out, node->node);
+				CZReportPrint(out, ",%d,", node->device);
+				CZReportCSVString(out, node->fileName);
+				CZReportPrint(out, ",%s,%s,%s,%s,%s,%s,%d\n", CZMetricName(metric), value,
+					CZReportMetricUnit(metric), median, deviation, robustZ, entry->outlier);
+			}
+		}
+	}
+
+	return (out->size < 0)? -1: 0;
+}
+
+/*!	\brief Write JSON report of health check.
+	Top level object holds overall verdict in \a health object and results
+	of tests in \a checks array. Values are in B/s or op/s.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZReportWriteHealthJSON(
+	struct CZReportText *out,	/*!<[in,out] Report text. */
+	const struct CZReportOrigin *origin,	/*!<[in] Application writing report. */
+	const struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	const struct CZHealthConfig *config,	/*!<[in] Health check configuration. */
+	const struct CZHealthResult *results,	/*!<[in] Results of tests. */
+	int num,			/*!<[in] Number of results. */
+	const struct CZHealthSummary *summary	/*!<[in] Overall verdict. */
+) {
+	struct CZReport report;
+	struct CZReportText checks;
+	int i;
+
+	CZReportInit(&report);
+	CZReportCollectHead(&report, origin);
+	CZReportAddString(&report, "report.kind", "health");
+	CZReportAddString(&report, "driver.version", info->drvVersion);
+	CZReportAddNumber(&report, "device.index", info->num, NULL);
+	CZReportAddString(&report, "device.name", info->deviceName);
+	CZReportAddString(&report, "health.verdict", summary->passed? "pass": "fail");
+	CZReportAddNumber(&report, "health.failed", summary->failedNum, NULL);
+	CZReportAddString(&report, "health.thresholds", (summary->model == NULL)? "": summary->model->name);
+	CZReportAddNumber(&report, "health.time", summary->timeMs / 1000, "s");
+	CZReportAddNumber(&report, "health.budget", config->budgetSec, "s");
+	CZReportAddNumber(&report, "health.over_budget", summary->overBudget, NULL);
+
+	CZReportTextInit(&checks);
+	CZReportPrint(&checks, ",\n\t");
+	CZReportJSONString(&checks, "checks");
+	CZReportPrint(&checks, ": [");
+	for(i = 0; i < num; i++) {
+		const struct CZHealthResult *result = &results[i];
+		double scale = CZReportMetricScale(result->metric);
+		const char *unit = CZReportMetricUnit(result->metric);
+		struct CZReport check;
+
+		CZReportInit(&check);
+		CZReportAddString(&check, "metric", CZMetricName(result->metric));
+		CZReportAddString(&check, "verdict", CZHealthVerdictName(result->verdict));
+		CZReportAddString(&check, "unit", unit);
+		CZReportAddNumber(&check, "value", result->value * scale, unit);
+		CZReportAddNumber(&check, "threshold", result->minValue * scale, unit);
+		CZReportAddNumber(&check, "peak_pct", result->peakPct, "%");
+		CZReportAddNumber(&check, "time", result->timeMs / 1000, "s");
+
+		CZReportPrint(&checks, "%s\n\t\t", (i == 0)? "": ",");
+		CZReportJSONObject(&checks, &check, 2, NULL);
+		CZReportFree(&check);
+	}
+	CZReportPrint(&checks, "\n\t]");
+
+	if(checks.size < 0) {
+		CZReportTextFree(out);
+		out->size = -1;
+	}
+	CZReportJSONObject(out, &report, 0, &checks);
+	CZReportPrint(out, "\n");
+
+	CZReportTextFree(&checks);
+	CZReportFree(&report);
+
+	return (out->size < 0)? -1: 0;
+}
+
+/*!	\brief Skip white space of JSON text.
+*/
+static void CZReportJSONSkip(
+	const char **pos		/*!<[in,out] Current position. */
+) {
+	while((**pos != 0) && isspace((unsigned char)**pos))
+		(*pos)++;
+}
+
+/*!	\brief Append character to fixed size string, dropping it if string is full.
+*/
+static void CZReportAppendChar(
+	char *str,			/*!<[in,out] String. */
+	int *len,			/*!<[in,out] Length of string. */
+	int size,			/*!<[in] Size of string buffer. */
+	unsigned int c			/*!<[in] Byte to append. */
+) {
+	if(*len < size - 1) {
+		str[(*len)++] = (char)c;
+		str[*len] = 0;
+	}
+}
+
+/*!	\brief Parse JSON string.
+	Escaped characters are converted to UTF-8, too long strings are truncated.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZReportJSONParseString(
+	const char **pos,		/*!<[in,out] Current position, at opening quote. */
+	char *str,			/*!<[out] Unquoted string. */
+	int size			/*!<[in] Size of string buffer. */
+) {
+	const char *p = *pos;
+	int len = 0;
+
+	str[0] = 0;
+	if(*p != '"')
+		return -1;
+
+	for(p++; *p != 0; p++) {
+		unsigned int c = (unsigned char)*p;
+		if(c == '"') {
+			*pos = p + 1;
+			return 0;
+		}
+		if(c != '\\') {
+			CZReportAppendChar(str, &len, size, c);
+			continue;
+		}
+		c = (unsigned char)*++p;
+		if(c == 0)
+			break;
+		if(c == 'n')
+			CZReportAppendChar(str, &len, size, '\n');
+		else if(c == 'r')
+			CZReportAppendChar(str, &len, size, '\r');
+		else if(c == 't')
+			CZReportAppendChar(str, &len, size, '\t');
+		else if(c == 'b')
+			CZReportAppendChar(str, &len, size, '\b');
+		else if(c == 'f')
+			CZReportAppendChar(str, &len, size, '\f');
+		else if(c == 'u') {
+			char hex[5];
+			char *end;
+			unsigned long code;
+
+			memcpy(hex, p + 1, 4);
+			hex[4] = 0;
+			if(strlen(hex) != 4)
+				break;
+			code = strtoul(hex, &end, 16);
+			if(*end != 0)
+				break;
+			p += 4;
+			if(code < 0x80)
+				CZReportAppendChar(str, &len, size, code);
+			else if(code < 0x800) {
+				CZReportAppendChar(str, &len, size, 0xc0 | (code >> 6));
+				CZReportAppendChar(str, &len, size, 0x80 | (code & 0x3f));
+			} else {
+				CZReportAppendChar(str, &len, size, 0xe0 | (code >> 12));
+				CZReportAppendChar(str, &len, size, 0x80 | ((code >> 6) & 0x3f));
+				CZReportAppendChar(str, &len, size, 0x80 | (code & 0x3f));
+			}
+		} else
+			CZReportAppendChar(str, &len, size, c);
+	}
+
+	*pos = p;
+	return -1;
+}
+
+/*!	\brief Parse JSON value into flat list of fields.
+	Nested objects give dot separated field paths, elements of arrays
+	get their index as the last path component.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZReportJSONParse(
+	const char **pos,		/*!<[in,out] Current position. */
+	char *key,			/*!<[in] Path of value, buffer of #CZ_REPORT_KEY_LEN characters. */
+	struct CZReport *report		/*!<[in,out] Fields of report. */
+) {
+	int keyLen = (int)strlen(key);
+	const char *start;
+
+	CZReportJSONSkip(pos);
+	if(**pos == 0)
+		return -1;
+
+	if(**pos == '{') {
+		(*pos)++;
+		CZReportJSONSkip(pos);
+		if(**pos == '}') {
+			(*pos)++;
+			return 0;
+		}
+		for(;;) {
+			char name[CZ_REPORT_KEY_LEN];
+
+			CZReportJSONSkip(pos);
+			if(CZReportJSONParseString(pos, name, sizeof(name)) != 0)
+				return -1;
+			CZReportJSONSkip(pos);
+			if(**pos != ':')
+				return -1;
+			(*pos)++;
+
+			CZReportCopy(key + keyLen, CZ_REPORT_KEY_LEN - keyLen, (keyLen == 0)? "": ".");
+			CZReportCopy(key + strlen(key), CZ_REPORT_KEY_LEN - (int)strlen(key), name);
+			if(CZReportJSONParse(pos, key, report) != 0)
+				return -1;
+			key[keyLen] = 0;
+
+			CZReportJSONSkip(pos);
+			if(**pos == '}') {
+				(*pos)++;
+				return 0;
+			}
+			if(**pos != ',')
+				return -1;
+			(*pos)++;
+		}
+	} else if(**pos == '[') {
+		int index;
+
+		(*pos)++;
+		CZReportJSONSkip(pos);
+		if(**pos == ']') {
+			(*pos)++;
+			return 0;
+		}
+		for(index = 0;; index++) {
+			char name[16];
+
+			snprintf(name, sizeof(name), "%d", index);
+			CZReportCopy(key + keyLen, CZ_REPORT_KEY_LEN - keyLen, (keyLen == 0)? "": ".");
+			CZReportCopy(key + strlen(key), CZ_REPORT_KEY_LEN - (int)strlen(key), name);
+			if(CZReportJSONParse(pos, key, report) != 0)
+				return -1;
+			key[keyLen] = 0;
+
+			CZReportJSONSkip(pos);
+			if(**pos == ']') {
+				(*pos)++;
+				return 0;
+			}
+			if(**pos != ',')
+				return -1;
+			(*pos)++;
+		}
+	} else if(**pos == '"') {
+		char value[CZ_REPORT_VALUE_LEN];
+
+		if(CZReportJSONParseString(pos, value, sizeof(value)) != 0)
+			return -1;
+		return CZReportAddString(report, key, value);
+	}
+
+	start = *pos;
+	while((**pos != 0) && (**pos != ',') && (**pos != '}') && (**pos != ']') && !isspace((unsigned char)**pos))
+		(*pos)++;
+	if(*pos == start)
+		return -1;
+
+	struct CZReportField *field = CZReportAddField(report, key);
+	if(field == NULL)
+		return -1;
+	int len = (int)(*pos - start);
+	if(len > (int)sizeof(field->value) - 1)
+		len = sizeof(field->value) - 1;
+	memcpy(field->value, start, len);
+	field->value[len] = 0;
+
+	return 0;
+}
+
+/*!	\brief Split JSON report of many devices into reports of devices.
+	Fields of every element of \a devices array make report of one device.
+	\returns number of devices, or \a -1 in case of error.
+*/
+static int CZReportSplitDevices(
+	const struct CZReport *all,	/*!<[in] Fields of whole report. */
+	struct CZReport **reports	/*!<[out] Reports of devices. */
+) {
+	int num = 0;
+	int i;
+
+	*reports = NULL;
+
+	for(i = 0; i < all->num; i++) {
+		const char *key = all->fields[i].key;
+		char *end;
+		long index;
+
+		if(strncmp(key, "devices.", 8) != 0)
+			continue;
+		index = strtol(key + 8, &end, 10);
+		if((end == key + 8) || (*end != '.') || (index < 0) || (index > 65535))
+			continue;
+
+		if(index >= num) {
+			struct CZReport *grown = (struct CZReport*)realloc(*reports, (index + 1) * sizeof(struct CZReport));
+			if(grown == NULL) {
+				CZReportFreeAll(*reports, num);
+				*reports = NULL;
+				return -1;
+			}
+			*reports = grown;
+			for(; num <= index; num++)
+				CZReportInit(&(*reports)[num]);
+		}
+
+		struct CZReportField *field = CZReportAddField(&(*reports)[index], end + 1);
+		if(field == NULL) {
+			CZReportFreeAll(*reports, num);
+			*reports = NULL;
+			return -1;
+		}
+		strcpy(field->value, all->fields[i].value);
+		field->isString = all->fields[i].isString;
+	}
+
+	for(i = 0; i < num; i++) {
+		if((*reports)[i].num == 0)
+			break;
+	}
+	while(num > i)
+		CZReportFree(&(*reports)[--num]);
+
+	return num;
+}
+
+/*!	\brief Read one CSV column.
+	\returns position after column separator, or \a NULL at end of line.
+*/
+static const char *CZReportCSVColumn(
+	const char *p,			/*!<[in] Position of column in line. */
+	char *column,			/*!<[out] Unquoted column. */
+	int size			/*!<[in] Size of column buffer. */
+) {
+	int quoted = 0;
+	int len = 0;
+
+	column[0] = 0;
+	for(; *p != 0; p++) {
+		if(quoted) {
+			if((p[0] == '"') && (p[1] == '"')) {
+				CZReportAppendChar(column, &len, size, '"');
+				p++;
+			} else if(*p == '"')
+				quoted = 0;
+			else
+				CZReportAppendChar(column, &len, size, (unsigned char)*p);
+		} else if(*p == '"')
+			quoted = 1;
+		else if(*p == ',')
+			return p + 1;
+		else
+			CZReportAppendChar(column, &len, size, (unsigned char)*p);
+	}
+
+	return NULL;
+}
+
+/*!	\brief Parse CSV report into reports of devices.
+	The first line is the header, every value of \a device column
+	makes report of one device.
+	\returns number of devices, or \a -1 in case of error.
+*/
+static int CZReportParseCSV(
+	const char *text,		/*!<[in] CSV text. */
+	struct CZReport **reports	/*!<[out] Reports of devices. */
+) {
+	char (*devices)[CZ_REPORT_KEY_LEN] = NULL;
+	char *line = NULL;
+	int lineSize = 0;
+	int num = 0;
+	int failed = 0;
+
+	*reports = NULL;
+
+	text = strchr(text, '\n');
+	text = (text == NULL)? "": text + 1;
+
+	while(!failed && (*text != 0)) {
+		const char *next = strchr(text, '\n');
+		int len = (next == NULL)? (int)strlen(text): (int)(next - text);
+		char columns[5][CZ_REPORT_VALUE_LEN];
+		const char *p;
+		int columnsNum = 0;
+		int index;
+
+		if(len + 1 > lineSize) {
+			char *grown = (char*)realloc(line, len + 1);
+			if(grown == NULL) {
+				failed = 1;
+				break;
+			}
+			line = grown;
+			lineSize = len + 1;
+		}
+		memcpy(line, text, len);
+		while((len > 0) && isspace((unsigned char)line[len - 1]))
+			len--;
+		line[len] = 0;
+		text = (next == NULL)? text + strlen(text): next + 1;
+
+		for(p = line; isspace((unsigned char)*p); p++);
+		while((p != NULL) && (columnsNum < 5))
+			p = CZReportCSVColumn(p, columns[columnsNum++], CZ_REPORT_VALUE_LEN);
+		if(columnsNum < 4)
+			continue;
+
+		for(index = 0; index < num; index++) {
+			if(strncmp(devices[index], columns[1], CZ_REPORT_KEY_LEN - 1) == 0)
+				break;
+		}
+		if(index == num) {
+			char (*grownDevices)[CZ_REPORT_KEY_LEN] = (char(*)[CZ_REPORT_KEY_LEN])realloc(devices, (num + 1) * sizeof(*devices));
+			struct CZReport *grownReports = (grownDevices == NULL)? NULL: (struct CZReport*)realloc(*reports, (num + 1) * sizeof(struct CZReport));
+			if(grownDevices != NULL)
+				devices = grownDevices;
+			if(grownReports == NULL) {
+				failed = 1;
+				break;
+			}
+			*reports = grownReports;
+			CZReportCopy(devices[num], CZ_REPORT_KEY_LEN, columns[1]);
+			CZReportInit(&(*reports)[num]);
+			num++;
+		}
+
+		struct CZReportField *field = CZReportAddField(&(*reports)[index], columns[2]);
+		if(field == NULL) {
+			failed = 1;
+			break;
+		}
+		CZReportCopy(field->value, sizeof(field->value), columns[3]);
+		if(columnsNum > 4)
+			CZReportCopy(field->unit, sizeof(field->unit), columns[4]);
+	}
+
+	free(line);
+	free(devices);
+
+	if(failed) {
+		CZReportFreeAll(*reports, num);
+		*reports = NULL;
+		return -1;
+	}
+
+	return num;
+}
+
+/*!	\brief Parse JSON or CSV report of one or many devices into fields
+	of every device. JSON report written by CZReportWriteFleetJSON()
+	gives one device per element of its \a devices array, CSV report
+	gives one device per value of \a device column.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZReportParse(
+	const char *text,		/*!<[in] Text of report. */
+	struct CZReport **reports,	/*!<[out] Reports of devices, free with CZReportFreeAll(). */
+	int *num			/*!<[out] Number of reports. */
+) {
+	const char *pos = text;
+	int i;
+
+	*reports = NULL;
+	*num = 0;
+
+	CZReportJSONSkip(&pos);
+	if(*pos == '{') {
+		struct CZReport all;
+		char key[CZ_REPORT_KEY_LEN];
+
+		key[0] = 0;
+		CZReportInit(&all);
+		if(CZReportJSONParse(&pos, key, &all) != 0) {
+			CZLog(CZLogLevelWarning, "Wrong JSON report at position %d!", (int)(pos - text));
+			CZReportFree(&all);
+			return -1;
+		}
+
+		if(CZReportValue(&all, "devices.0.report.schema") != NULL) {
+			*num = CZReportSplitDevices(&all, reports);
+			CZReportFree(&all);
+		} else {
+			*reports = (struct CZReport*)malloc(sizeof(struct CZReport));
+			if(*reports == NULL)
+				CZReportFree(&all);
+			else {
+				**reports = all;
+				*num = 1;
+			}
+		}
+	} else {
+		if(strncmp(pos, "schema_version,", 15) != 0) {
+			CZLog(CZLogLevelWarning, "Unknown format of report!");
+			return -1;
+		}
+		*num = CZReportParseCSV(pos, reports);
+	}
+
+	if(*num < 0) {
+		CZLog(CZLogLevelError, "Not enough memory for report!");
+		*num = 0;
+		return -1;
+	}
+
+	if(*num == 0) {
+		CZLog(CZLogLevelWarning, "Report has no devices!");
+		return -1;
+	}
+
+	for(i = 0; i < *num; i++) {
+		const char *schema = CZReportValue(&(*reports)[i], "report.schema");
+		const char *version = CZReportValue(&(*reports)[i], "report.schema_version");
+
+		if((schema == NULL) || (strcmp(schema, CZ_REPORT_SCHEMA) != 0)) {
+			CZLog(CZLogLevelWarning, "Report is not a " CZ_REPORT_SCHEMA " report!");
+			break;
+		}
+
+		if((version == NULL) || (atoi(version) != CZ_REPORT_SCHEMA_VERSION)) {
+			CZLog(CZLogLevelWarning, "Unsupported report schema version %s!", (version == NULL)? "": version);
+			break;
+		}
+	}
+
+	if(i != *num) {
+		CZReportFreeAll(*reports, *num);
+		*reports = NULL;
+		*num = 0;
+		return -1;
+	}
+
+	return 0;
+}
+
+/*!	\brief Read JSON or CSV report file of one or many devices.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZReportRead(
+	const char *fileName,		/*!<[in] Name of report file. */
+	struct CZReport **reports,	/*!<[out] Reports of devices, free with CZReportFreeAll(). */
+	int *num			/*!<[out] Number of reports. */
+) {
+	FILE *file;
+	char *text = NULL;
+	int len = 0;
+	int size = 0;
+	int res;
+
+	*reports = NULL;
+	*num = 0;
+
+	file = fopen(fileName, "rb");
+	if(file == NULL) {
+		CZLog(CZLogLevelWarning, "Cannot read file %s:\n%s.", fileName, strerror(errno));
+		return -1;
+	}
+
+	for(;;) {
+		if(size - len < 2) {
+			char *grown = (char*)realloc(text, (size == 0)? CZ_REPORT_TEXT_MIN: size * 2);
+			if(grown == NULL) {
+				CZLog(CZLogLevelError, "Not enough memory for report!");
+				free(text);
+				fclose(file);
+				return -1;
+			}
+			text = grown;
+			size = (size == 0)? CZ_REPORT_TEXT_MIN: size * 2;
+		}
+		int r = (int)fread(text + len, 1, size - len - 1, file);
+		if(r <= 0)
+			break;
+		len += r;
+	}
+	text[len] = 0;
+
+	if(ferror(file)) {
+		CZLog(CZLogLevelWarning, "Cannot read file %s:\n%s.", fileName, strerror(errno));
+		free(text);
+		fclose(file);
+		return -1;
+	}
+	fclose(file);
+
+	res = CZReportParse(text, reports, num);
+	free(text);
+
+	return res;
+}
+
+/*!	\brief Free reports returned by CZReportParse() or CZReportRead().
+*/
+void CZReportFreeAll(
+	struct CZReport *reports,	/*!<[in] Reports. */
+	int num				/*!<[in] Number of reports. */
+) {
+	int i;
+
+	for(i = 0; i < num; i++)
+		CZReportFree(&reports[i]);
+	if(num >= 0)
+		free(reports);
+}
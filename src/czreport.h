@@ -0,0 +1,92 @@
+/*!	\file czreport.h
+	\brief Machine-readable reports definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_REPORT_H
+#define CZ_REPORT_H
+
+#include "cudainfo.h"
+#include "czfleet.h"
+#include "czhealth.h"
+#include "czmerge.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_REPORT_SCHEMA	"cuda-z-report"		/*!< Schema name of machine-readable reports. */
+#define CZ_REPORT_SCHEMA_VERSION	1		/*!< Schema version of machine-readable reports. Increased on incompatible changes of fields. */
+#define CZ_REPORT_CSV_HEADER	"schema_version,device,field,value,unit\n"	/*!< Header line of CSV report. */
+
+#define CZ_REPORT_KEY_LEN	128			/*!< Maximal length of field path. */
+#define CZ_REPORT_VALUE_LEN	256			/*!< Maximal length of field value. */
+#define CZ_REPORT_UNIT_LEN	8			/*!< Maximal length of field unit. */
+
+/*!	\brief Field of machine-readable report.
+*/
+struct CZReportField {
+	char		key[CZ_REPORT_KEY_LEN];	/*!< Dot separated field path. */
+	char		value[CZ_REPORT_VALUE_LEN];	/*!< Value of field. */
+	int		isString;		/*!< Value is a string, not a number. */
+	char		unit[CZ_REPORT_UNIT_LEN];	/*!< Base unit of value, empty if it has no unit. */
+};
+
+/*!	\brief Fields of machine-readable report of one device.
+*/
+struct CZReport {
+	struct CZReportField *fields;		/*!< Fields in order of appending. */
+	int		num;			/*!< Number of fields. */
+	int		size;			/*!< Number of allocated fields. */
+};
+
+/*!	\brief Application writing report.
+	These strings come from the application, so the core does not depend
+	on its version and platform information.
+*/
+struct CZReportOrigin {
+	const char	*generator;		/*!< Name of application. */
+	const char	*version;		/*!< Version of application. */
+	const char	*os;			/*!< Version of operating system. */
+};
+
+/*!	\brief Text of generated report.
+*/
+struct CZReportText {
+	char		*text;			/*!< Zero terminated UTF-8 text, \a NULL if empty. */
+	int		len;			/*!< Length of text. */
+	int		size;			/*!< Size of allocated buffer. */
+};
+
+void CZReportInit(struct CZReport *report);
+void CZReportFree(struct CZReport *report);
+int CZReportAddString(struct CZReport *report, const char *key, const char *value);
+int CZReportAddNumber(struct CZReport *report, const char *key, double value, const char *unit);
+const char *CZReportValue(const struct CZReport *report, const char *key);
+double CZReportNumber(const struct CZReport *report, const char *key);
+int CZReportMetric(const struct CZReport *report, int metric, double *value, struct CZDeviceInfoStat *stat);
+
+double CZReportMetricScale(int metric);
+const char *CZReportMetricUnit(int metric);
+void CZReportFleetAnalyze(const struct CZDeviceInfo *infos, int num, const struct CZFleetConfig *config, struct CZFleetSummary *summaries, struct CZFleetEntry *entries);
+
+void CZReportTextInit(struct CZReportText *out);
+void CZReportTextFree(struct CZReportText *out);
+int CZReportWriteJSON(struct CZReportText *out, const struct CZReportOrigin *origin, const struct CZDeviceInfo *info);
+int CZReportWriteCSV(struct CZReportText *out, const struct CZReportOrigin *origin, const struct CZDeviceInfo *info);
+int CZReportWriteFleetJSON(struct CZReportText *out, const struct CZReportOrigin *origin, const struct CZDeviceInfo *infos, int num, const struct CZFleetConfig *config);
+int CZReportWriteFleetCSV(struct CZReportText *out, const struct CZReportOrigin *origin, const struct CZDeviceInfo *infos, int num, const struct CZFleetConfig *config);
+int CZReportWriteMergeCSV(struct CZReportText *out, const struct CZMerge *merge);
+int CZReportWriteHealthJSON(struct CZReportText *out, const struct CZReportOrigin *origin, const struct CZDeviceInfo *info, const struct CZHealthConfig *config, const struct CZHealthResult *results, int num, const struct CZHealthSummary *summary);
+
+int CZReportParse(const char *text, struct CZReport **reports, int *num);
+int CZReportRead(const char *fileName, struct CZReport **reports, int *num);
+void CZReportFreeAll(struct CZReport *reports, int num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_REPORT_H
@@ -0,0 +1,619 @@
+/*!	\file czsession.cpp
+	\brief Recording and replay of benchmark sessions source file.
+	Session file consists of a header and a sequence of records. Every
+	record is a record type, device index and payload size followed by
+	payload. All values are stored in host byte order, header keeps
+	byte order mark and sizes of raw structures to detect incompatible files.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "cudainfo.h"
+#include "cudaarch.h"
+#include "czstat.h"
+#include "czbackend.h"
+#include "czsession.h"
+
+#define CZ_SESSION_BYTE_ORDER	0x01020304		/*!< Byte order mark. */
+#define CZ_SESSION_RECORD_MAX	4096			/*!< Maximal size of one record. */
+#define CZ_SESSION_STR_LEN	256			/*!< Maximal length of stored string. */
+
+/*!	\brief Session file header.
+*/
+struct CZSessionHeader {
+	char		magic[8];		/*!< File signature #CZ_SESSION_MAGIC. */
+	int		version;		/*!< File format version #CZ_SESSION_VERSION. */
+	int		byteOrder;		/*!< Byte order mark #CZ_SESSION_BYTE_ORDER. */
+	int		coreSize;		/*!< Size of struct #CZDeviceInfoCore. */
+	int		memSize;		/*!< Size of struct #CZDeviceInfoMem. */
+};
+
+/*!	\brief Session file record header.
+*/
+struct CZSessionRecordHeader {
+	int		type;			/*!< Record type. See enum #CZSessionRecordType. */
+	int		device;			/*!< Device index, \a -1 if not applicable. */
+	int		size;			/*!< Size of payload in bytes. */
+};
+
+/*!	\brief Replayed device.
+*/
+struct CZSessionDevice {
+	int		valid;			/*!< Device information is present in session. */
+	struct CZDeviceInfo	info;		/*!< Recorded device information. */
+	char		drvVersion[CZ_SESSION_STR_LEN];		/*!< Storage of driver version string. */
+	char		drvDllVerStr[CZ_SESSION_STR_LEN];	/*!< Storage of driver Dll version string. */
+	char		rtDllVerStr[CZ_SESSION_STR_LEN];	/*!< Storage of runtime Dll version string. */
+};
+
+/*!	\brief Replayed test.
+*/
+struct CZSessionLoops {
+	int		device;			/*!< Device index. */
+	int		metric;			/*!< Metric, \a -1 for user-supplied kernel. */
+	int		num;			/*!< Number of measured iterations. */
+	float		*values;		/*!< Results of measured iterations. */
+	int		used;			/*!< Test is already replayed. */
+};
+
+static FILE *s_recordFile = NULL;			/*!< Session file being recorded. */
+
+static int s_replayPresent = 0;				/*!< Replayed result of CZCudaCheck(). */
+static int s_replayDevicesNum = 0;			/*!< Replayed result of CZCudaDeviceFound(). */
+static struct CZSessionDevice s_replayDevices[CZ_SESSION_DEVICES_MAX];	/*!< Replayed devices. */
+static struct CZSessionLoops *s_replayLoops = NULL;	/*!< Replayed tests. */
+static int s_replayLoopsNum = 0;			/*!< Number of replayed tests. */
+
+/*!	\brief Append data to record buffer.
+	\returns new size of record.
+*/
+static int CZSessionPut(
+	unsigned char *buf,		/*!<[in,out] Record buffer. */
+	int size,			/*!<[in] Current size of record. */
+	const void *data,		/*!<[in] Data to append. */
+	int dataSize			/*!<[in] Size of data. */
+) {
+	if((size < 0) || ((size + dataSize) > CZ_SESSION_RECORD_MAX))
+		return -1;
+
+	memcpy(buf + size, data, dataSize);
+	return size + dataSize;
+}
+
+/*!	\brief Append length prefixed string to record buffer.
+	\returns new size of record.
+*/
+static int CZSessionPutStr(
+	unsigned char *buf,		/*!<[in,out] Record buffer. */
+	int size,			/*!<[in] Current size of record. */
+	const char *str			/*!<[in] String to append, may be \a NULL. */
+) {
+	int len = (str == NULL)? 0: (int)strlen(str);
+
+	if(len >= CZ_SESSION_STR_LEN)
+		len = CZ_SESSION_STR_LEN - 1;
+
+	size = CZSessionPut(buf, size, &len, sizeof(len));
+	return CZSessionPut(buf, size, str, len);
+}
+
+/*!	\brief Write one record to session file.
+	Record is written with one call, so records of different threads do not mix.
+*/
+static void CZSessionWrite(
+	int type,			/*!<[in] Record type. See enum #CZSessionRecordType. */
+	int device,			/*!<[in] Device index. */
+	const unsigned char *payload,	/*!<[in] Payload. */
+	int size			/*!<[in] Size of payload. */
+) {
+	unsigned char buf[sizeof(struct CZSessionRecordHeader) + CZ_SESSION_RECORD_MAX];
+	struct CZSessionRecordHeader header;
+	FILE *fp = s_recordFile;
+
+	if((fp == NULL) || (size < 0))
+		return;
+
+	header.type = type;
+	header.device = device;
+	header.size = size;
+	memcpy(buf, &header, sizeof(header));
+	memcpy(buf + sizeof(header), payload, size);
+
+	if(fwrite(buf, sizeof(header) + size, 1, fp) != 1)
+		CZLog(CZLogLevelError, "Can't write session record.");
+	fflush(fp);
+}
+
+/*!	\brief Record measured iterations of test. Called by CZStatSubmit().
+*/
+static void CZSessionRecordTest(
+	void *context,			/*!<[in] Not used. */
+	const struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	int metric,			/*!<[in] Measured metric, \a -1 for user-supplied kernel. */
+	const float *values,		/*!<[in] Results of measured iterations. */
+	int num				/*!<[in] Number of measured iterations. */
+) {
+	unsigned char buf[CZ_SESSION_RECORD_MAX];
+	int size = 0;
+
+	(void)context;
+
+	size = CZSessionPut(buf, size, &metric, sizeof(metric));
+	size = CZSessionPut(buf, size, &num, sizeof(num));
+	size = CZSessionPut(buf, size, values, num * sizeof(values[0]));
+
+	CZSessionWrite(CZSessionRecordLoops, info->num, buf, size);
+}
+
+/*!	\brief Start recording of session.
+	Every query result and every measured iteration is written to \a fileName.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZSessionRecordStart(
+	const char *fileName		/*!<[in] Name of session file. */
+) {
+	struct CZSessionHeader header;
+
+	CZSessionRecordStop();
+
+	s_recordFile = fopen(fileName, "wb");
+	if(s_recordFile == NULL) {
+		CZLog(CZLogLevelError, "Can't create session file %s.", fileName);
+		return -1;
+	}
+
+	memset(&header, 0, sizeof(header));
+	strncpy(header.magic, CZ_SESSION_MAGIC, sizeof(header.magic));
+	header.version = CZ_SESSION_VERSION;
+	header.byteOrder = CZ_SESSION_BYTE_ORDER;
+	header.coreSize = sizeof(struct CZDeviceInfoCore);
+	header.memSize = sizeof(struct CZDeviceInfoMem);
+
+	if(fwrite(&header, sizeof(header), 1, s_recordFile) != 1) {
+		CZLog(CZLogLevelError, "Can't write session file %s.", fileName);
+		fclose(s_recordFile);
+		s_recordFile = NULL;
+		return -1;
+	}
+
+	CZStatSetSink(CZSessionRecordTest, NULL);
+	CZLog(CZLogLevelLow, "Recording session to %s.", fileName);
+
+	return 0;
+}
+
+/*!	\brief Stop recording of session.
+*/
+void CZSessionRecordStop(void) {
+
+	if(s_recordFile == NULL)
+		return;
+
+	CZStatSetSink(NULL, NULL);
+	fclose(s_recordFile);
+	s_recordFile = NULL;
+}
+
+/*!	\brief Record result of CZCudaCheck().
+*/
+void CZSessionRecordCheckResult(
+	bool present			/*!<[in] CUDA is present. */
+) {
+	int value = present? 1: 0;
+	CZSessionWrite(CZSessionRecordCheck, -1, (const unsigned char*)&value, sizeof(value));
+}
+
+/*!	\brief Record result of CZCudaDeviceFound().
+*/
+void CZSessionRecordDevicesNum(
+	int num				/*!<[in] Number of devices. */
+) {
+	CZSessionWrite(CZSessionRecordDevices, -1, (const unsigned char*)&num, sizeof(num));
+}
+
+/*!	\brief Record result of CZCudaReadDeviceInfo().
+*/
+void CZSessionRecordDeviceInfo(
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	unsigned char buf[CZ_SESSION_RECORD_MAX];
+	int size = 0;
+
+	if((s_recordFile == NULL) || (info == NULL))
+		return;
+
+	size = CZSessionPutStr(buf, size, info->deviceName);
+	size = CZSessionPut(buf, size, &info->major, sizeof(info->major));
+	size = CZSessionPut(buf, size, &info->minor, sizeof(info->minor));
+	size = CZSessionPutStr(buf, size, info->archName);
+	size = CZSessionPutStr(buf, size, info->drvVersion);
+	size = CZSessionPut(buf, size, &info->drvDllVer, sizeof(info->drvDllVer));
+	size = CZSessionPutStr(buf, size, info->drvDllVerStr);
+	size = CZSessionPut(buf, size, &info->rtDllVer, sizeof(info->rtDllVer));
+	size = CZSessionPutStr(buf, size, info->rtDllVerStr);
+	size = CZSessionPut(buf, size, &info->tccDriver, sizeof(info->tccDriver));
+	size = CZSessionPut(buf, size, &info->core, sizeof(info->core));
+	size = CZSessionPut(buf, size, &info->mem, sizeof(info->mem));
+
+	CZSessionWrite(CZSessionRecordInfo, info->num, buf, size);
+}
+
+/*!	\brief Take data from record payload.
+	\returns new read position, \a -1 in case of error.
+*/
+static int CZSessionGet(
+	const unsigned char *buf,	/*!<[in] Record payload. */
+	int size,			/*!<[in] Size of payload. */
+	int pos,			/*!<[in] Current read position. */
+	void *data,			/*!<[out] Data. */
+	int dataSize			/*!<[in] Size of data. */
+) {
+	if((pos < 0) || ((pos + dataSize) > size))
+		return -1;
+
+	memcpy(data, buf + pos, dataSize);
+	return pos + dataSize;
+}
+
+/*!	\brief Take length prefixed string from record payload.
+	\returns new read position, \a -1 in case of error.
+*/
+static int CZSessionGetStr(
+	const unsigned char *buf,	/*!<[in] Record payload. */
+	int size,			/*!<[in] Size of payload. */
+	int pos,			/*!<[in] Current read position. */
+	char *str			/*!<[out] String buffer of #CZ_SESSION_STR_LEN bytes. */
+) {
+	int len;
+
+	pos = CZSessionGet(buf, size, pos, &len, sizeof(len));
+	if((pos < 0) || (len < 0) || (len >= CZ_SESSION_STR_LEN))
+		return -1;
+
+	pos = CZSessionGet(buf, size, pos, str, len);
+	if(pos >= 0)
+		str[len] = 0;
+	return pos;
+}
+
+/*!	\brief Parse one record of replayed session.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSessionParse(
+	const struct CZSessionRecordHeader *header,	/*!<[in] Record header. */
+	const unsigned char *buf	/*!<[in] Record payload. */
+) {
+	int size = header->size;
+	int pos = 0;
+
+	switch(header->type) {
+	case CZSessionRecordCheck:
+		pos = CZSessionGet(buf, size, pos, &s_replayPresent, sizeof(s_replayPresent));
+		break;
+
+	case CZSessionRecordDevices:
+		pos = CZSessionGet(buf, size, pos, &s_replayDevicesNum, sizeof(s_replayDevicesNum));
+		if(s_replayDevicesNum > CZ_SESSION_DEVICES_MAX)
+			s_replayDevicesNum = CZ_SESSION_DEVICES_MAX;
+		break;
+
+	case CZSessionRecordInfo: {
+		struct CZSessionDevice *dev;
+		struct CZDeviceInfo *info;
+		char str[CZ_SESSION_STR_LEN];
+
+		if((header->device < 0) || (header->device >= CZ_SESSION_DEVICES_MAX))
+			return -1;
+
+		dev = &s_replayDevices[header->device];
+		info = &dev->info;
+		memset(dev, 0, sizeof(*dev));
+		info->num = header->device;
+
+		pos = CZSessionGetStr(buf, size, pos, str);
+		strncpy(info->deviceName, str, sizeof(info->deviceName));
+		pos = CZSessionGet(buf, size, pos, &info->major, sizeof(info->major));
+		pos = CZSessionGet(buf, size, pos, &info->minor, sizeof(info->minor));
+		pos = CZSessionGetStr(buf, size, pos, str);
+		strncpy(info->archName, str, sizeof(info->archName));
+		pos = CZSessionGetStr(buf, size, pos, dev->drvVersion);
+		pos = CZSessionGet(buf, size, pos, &info->drvDllVer, sizeof(info->drvDllVer));
+		pos = CZSessionGetStr(buf, size, pos, dev->drvDllVerStr);
+		pos = CZSessionGet(buf, size, pos, &info->rtDllVer, sizeof(info->rtDllVer));
+		pos = CZSessionGetStr(buf, size, pos, dev->rtDllVerStr);
+		pos = CZSessionGet(buf, size, pos, &info->tccDriver, sizeof(info->tccDriver));
+		pos = CZSessionGet(buf, size, pos, &info->core, sizeof(info->core));
+		pos = CZSessionGet(buf, size, pos, &info->mem, sizeof(info->mem));
+		info->drvVersion = dev->drvVersion;
+		info->drvDllVerStr = dev->drvDllVerStr;
+		info->rtDllVerStr = dev->rtDllVerStr;
+		dev->valid = (pos >= 0);
+		} break;
+
+	case CZSessionRecordLoops: {
+		struct CZSessionLoops *loops = &s_replayLoops[s_replayLoopsNum];
+
+		loops->device = header->device;
+		loops->used = 0;
+		pos = CZSessionGet(buf, size, pos, &loops->metric, sizeof(loops->metric));
+		pos = CZSessionGet(buf, size, pos, &loops->num, sizeof(loops->num));
+		if((pos < 0) || (loops->num <= 0) || (loops->num > CZ_STAT_SAMPLES_MAX))
+			return -1;
+
+		loops->values = (float*)malloc(loops->num * sizeof(loops->values[0]));
+		if(loops->values == NULL)
+			return -1;
+		pos = CZSessionGet(buf, size, pos, loops->values, loops->num * sizeof(loops->values[0]));
+		if(pos < 0) {
+			free(loops->values);
+			return -1;
+		}
+		s_replayLoopsNum++;
+		} break;
+
+	default: /* unknown records of newer versions are skipped */
+		break;
+	}
+
+	return (pos < 0)? -1: 0;
+}
+
+/*!	\brief Forget replayed session.
+*/
+static void CZSessionReplayClear(void) {
+
+	for(int i = 0; i < s_replayLoopsNum; i++)
+		free(s_replayLoops[i].values);
+	free(s_replayLoops);
+
+	s_replayLoops = NULL;
+	s_replayLoopsNum = 0;
+	s_replayPresent = 0;
+	s_replayDevicesNum = 0;
+	memset(s_replayDevices, 0, sizeof(s_replayDevices));
+}
+
+/*!	\brief Load session file and select replay backend.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZSessionReplayOpen(
+	const char *fileName		/*!<[in] Name of session file. */
+) {
+	struct CZSessionHeader header;
+	struct CZSessionRecordHeader recHeader;
+	unsigned char buf[CZ_SESSION_RECORD_MAX];
+	long recordsMax;
+	FILE *fp;
+
+	CZSessionReplayClear();
+
+	fp = fopen(fileName, "rb");
+	if(fp == NULL) {
+		CZLog(CZLogLevelError, "Can't open session file %s.", fileName);
+		return -1;
+	}
+
+	if((fread(&header, sizeof(header), 1, fp) != 1) ||
+		(strncmp(header.magic, CZ_SESSION_MAGIC, sizeof(header.magic)) != 0) ||
+		(header.version != CZ_SESSION_VERSION) ||
+		(header.byteOrder != CZ_SESSION_BYTE_ORDER) ||
+		(header.coreSize != sizeof(struct CZDeviceInfoCore)) ||
+		(header.memSize != sizeof(struct CZDeviceInfoMem))) {
+		CZLog(CZLogLevelError, "File %s is not a compatible session file.", fileName);
+		fclose(fp);
+		return -1;
+	}
+
+	/* Every test record is larger than its header, so file size limits number of tests. */
+	fseek(fp, 0, SEEK_END);
+	recordsMax = ftell(fp) / sizeof(recHeader) + 1;
+	fseek(fp, sizeof(header), SEEK_SET);
+
+	s_replayLoops = (struct CZSessionLoops*)malloc(recordsMax * sizeof(s_replayLoops[0]));
+	if(s_replayLoops == NULL) {
+		fclose(fp);
+		return -1;
+	}
+
+	while(fread(&recHeader, sizeof(recHeader), 1, fp) == 1) {
+		if((recHeader.size < 0) || (recHeader.size > CZ_SESSION_RECORD_MAX) ||
+			(fread(buf, 1, recHeader.size, fp) != (size_t)recHeader.size) ||
+			(CZSessionParse(&recHeader, buf) != 0)) {
+			CZLog(CZLogLevelWarning, "Session file %s is truncated or damaged.", fileName);
+			break;
+		}
+	}
+
+	fclose(fp);
+
+	CZLog(CZLogLevelLow, "Replaying session %s: %d device(s), %d test(s).", fileName, s_replayDevicesNum, s_replayLoopsNum);
+
+	return CZBackendSelect(CZBackendReplay.name);
+}
+
+/*!	\brief Check if CUDA was present in session.
+*/
+static bool CZSessionReplayCheck(void) {
+	return s_replayPresent != 0;
+}
+
+/*!	\brief Get number of devices in session.
+	\returns number of devices.
+*/
+static int CZSessionReplayDeviceFound(void) {
+	return s_replayDevicesNum;
+}
+
+/*!	\brief Read information about a recorded device.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSessionReplayReadDeviceInfo(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int num				/*!<[in] Number (index) of device. */
+) {
+	const struct CZDeviceInfo *rec;
+
+	if((info == NULL) || (num < 0) || (num >= s_replayDevicesNum) || !s_replayDevices[num].valid)
+		return -1;
+
+	rec = &s_replayDevices[num].info;
+
+	info->num = num;
+	memcpy(info->deviceName, rec->deviceName, sizeof(info->deviceName));
+	info->major = rec->major;
+	info->minor = rec->minor;
+	memcpy(info->archName, rec->archName, sizeof(info->archName));
+	info->drvVersion = rec->drvVersion;
+	info->drvDllVer = rec->drvDllVer;
+	info->drvDllVerStr = rec->drvDllVerStr;
+	info->rtDllVer = rec->rtDllVer;
+	info->rtDllVerStr = rec->rtDllVerStr;
+	info->tccDriver = rec->tccDriver;
+	info->core = rec->core;
+	info->mem = rec->mem;
+
+	return 0;
+}
+
+/*!	\brief Check if device was recorded.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSessionReplayCalcDeviceSelect(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	if((info == NULL) || (info->num < 0) || (info->num >= s_replayDevicesNum))
+		return -1;
+
+	return 0;
+}
+
+/*!	\brief Replay next recorded run of test.
+	Runs of every test are replayed in the same order as they were recorded.
+	\returns \a 0 if there is no more recorded runs, \a other is mean value.
+*/
+static float CZSessionReplayTest(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int metric,			/*!<[in] Measured metric, \a -1 for user-supplied kernel. */
+	struct CZDeviceInfoStat *stat	/*!<[out] Statistics of test. */
+) {
+	memset(stat, 0, sizeof(*stat));
+
+	for(int i = 0; i < s_replayLoopsNum; i++) {
+		struct CZSessionLoops *loops = &s_replayLoops[i];
+
+		if(loops->used || (loops->device != info->num) || (loops->metric != metric))
+			continue;
+
+		loops->used = 1;
+		if(CZStatSubmit(info, metric, loops->values, loops->num, stat) != 0)
+			return 0;
+		return stat->mean;
+	}
+
+	CZLog(CZLogLevelLow, "No more recorded runs of %s on %s.", (metric < 0)? info->perf.pluginName: CZMetricName(metric), info->deviceName);
+	return 0;
+}
+
+/*!	\brief Replay one bandwidth or performance test.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSessionReplayCalcDeviceTest(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int metric			/*!<[in] Test to run. See enum #CZMetric. */
+) {
+	float value;
+
+	if((CZSessionReplayCalcDeviceSelect(info) != 0) || (metric < 0) || (metric >= CZMetricMax))
+		return -1;
+
+	value = CZSessionReplayTest(info, metric, &info->stat[metric]);
+	CZMetricSetValue(info, metric, value);
+
+	return (value == 0)? -1: 0;
+}
+
+/*!	\brief Replay bandwidth tests.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSessionReplayCalcDeviceBandwidth(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	int found = 0;
+
+	for(int metric = CZMetricCopyHDPin; metric <= CZMetricCopyDD; metric++) {
+		if(CZSessionReplayCalcDeviceTest(info, metric) == 0)
+			found++;
+	}
+
+	return (found != 0)? 0: -1;
+}
+
+/*!	\brief Replay performance tests.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSessionReplayCalcDevicePerformance(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	int found = 0;
+
+	for(int metric = CZMetricCalcFloat; metric <= CZMetricCalcInteger24; metric++) {
+		if(CZSessionReplayCalcDeviceTest(info, metric) == 0)
+			found++;
+	}
+
+	return (found != 0)? 0: -1;
+}
+
+/*!	\brief Replay user-supplied kernel test. Source code is ignored.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSessionReplayCalcDevicePlugin(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	const char *source,		/*!<[in] Not used. */
+	const char *kernelName,		/*!<[in] Name of kernel function. */
+	double opsPerThread		/*!<[in] Not used. */
+) {
+	(void)source;
+	(void)opsPerThread;
+
+	if((CZSessionReplayCalcDeviceSelect(info) != 0) || (kernelName == NULL))
+		return -1;
+
+	strncpy(info->perf.pluginName, kernelName, CZ_PLUGIN_NAME_LEN - 1);
+	info->perf.pluginName[CZ_PLUGIN_NAME_LEN - 1] = 0;
+	info->perf.calcPlugin = CZSessionReplayTest(info, -1, &info->perf.calcPluginStat);
+
+	return (info->perf.calcPlugin == 0)? -1: 0;
+}
+
+/*!	\brief Nothing to prepare or clean for replayed device.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSessionReplayPrepareDevice(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	return CZSessionReplayCalcDeviceSelect(info);
+}
+
+/*!	\brief Session replay backend.
+*/
+const struct CZBackend CZBackendReplay = {
+	"replay",
+	CZSessionReplayCheck,
+	CZSessionReplayDeviceFound,
+	CZSessionReplayReadDeviceInfo,
+	NULL,
+	CZSessionReplayCalcDeviceSelect,
+	CZSessionReplayPrepareDevice,
+	CZSessionReplayCalcDeviceBandwidth,
+	CZSessionReplayCalcDevicePerformance,
+	CZSessionReplayCalcDeviceTest,
+	CZSessionReplayCalcDevicePlugin,
+	CZSessionReplayPrepareDevice,
+};
@@ -0,0 +1,42 @@
+/*!	\file czsession.h
+	\brief Recording and replay of benchmark sessions definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_SESSION_H
+#define CZ_SESSION_H
+
+#include "cudainfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_SESSION_MAGIC	"CZ-SESS"		/*!< Session file signature. */
+#define CZ_SESSION_VERSION	1			/*!< Session file format version. */
+#define CZ_SESSION_DEVICES_MAX	64			/*!< Maximal number of devices in session. */
+
+/*!	\brief Type of session file record.
+*/
+enum CZSessionRecordType {
+	CZSessionRecordCheck = 1,		/*!< Result of CZCudaCheck(): int. */
+	CZSessionRecordDevices,			/*!< Result of CZCudaDeviceFound(): int. */
+	CZSessionRecordInfo,			/*!< Result of CZCudaReadDeviceInfo(): strings, versions, core and memory information. */
+	CZSessionRecordLoops,			/*!< Measured iterations of one test: metric, number, float values. */
+};
+
+int CZSessionRecordStart(const char *fileName);
+void CZSessionRecordStop(void);
+void CZSessionRecordCheckResult(bool present);
+void CZSessionRecordDevicesNum(int num);
+void CZSessionRecordDeviceInfo(const struct CZDeviceInfo *info);
+
+int CZSessionReplayOpen(const char *fileName);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_SESSION_H
@@ -0,0 +1,518 @@
+/*!	\file czsim.cpp
+	\brief Simulated benchmark backend source file.
+	Describes configurable fake devices and produces test results from
+	a deterministic performance model, so the whole application can run
+	on a host without GPU.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "log.h"
+#include "cudainfo.h"
+#include "cudaarch.h"
+#include "czkernels.h"
+#include "czstat.h"
+#include "czbackend.h"
+#include "czsim.h"
+
+#define CZ_SIM_CONFIG_ENV	"CZ_SIM_CONFIG"		/*!< Environment variable with name of device description file. */
+
+#define CZ_SIM_COPY_SIZE_KB	(16 * 1024)		/*!< Simulated transfer buffer size in KiB. */
+#define CZ_SIM_QUICK_SIZE_KB	1024			/*!< Simulated transfer buffer size in quick mode in KiB. */
+#define CZ_SIM_LOOPS_NUM	8			/*!< Number of measured loops of every test in fixed mode. */
+#define CZ_SIM_THREADS_NUM	1024			/*!< Number of threads per block. */
+#define CZ_SIM_WARMUP_RATE	0.8			/*!< Relative throughput of warm-up loops. */
+
+#define CZ_SIM_DRV_VER		12000			/*!< Simulated driver and runtime version. */
+
+/*!	\brief Built-in simulated devices.
+*/
+static const struct CZSimDevice s_defDevices[] = {
+	{"CUDA-Z Simulated GP104", 6, 1, 20, 1733, 5005, 256, 8192, 0, 100, 1, 0, 0},
+	{"CUDA-Z Simulated TU104", 7, 5, 40, 1815, 7001, 256, 8192, 0, 100, 1, 0, 0},
+};
+
+/*!	\brief Part of theoretical peak reached by test kernels indexed by metric.
+*/
+static const double s_metricEfficiency[CZMetricMax] = {
+	0.82,	/* CZMetricCopyHDPin */
+	0.55,	/* CZMetricCopyHDPage */
+	0.84,	/* CZMetricCopyDHPin */
+	0.50,	/* CZMetricCopyDHPage */
+	0.85,	/* CZMetricCopyDD */
+	0.97,	/* CZMetricCalcFloat */
+	0.95,	/* CZMetricCalcDouble */
+	0.85,	/* CZMetricCalcInteger64 */
+	0.90,	/* CZMetricCalcInteger32 */
+	0.90,	/* CZMetricCalcInteger24 */
+};
+
+static struct CZSimDevice s_devices[CZ_SIM_DEVICES_MAX];	/*!< Simulated devices. */
+static int s_devicesNum = -1;				/*!< Number of simulated devices, \a -1 if not configured. */
+static double s_busyMs[CZ_SIM_DEVICES_MAX];		/*!< Simulated busy time of every device. */
+static unsigned int s_loopSeq[CZ_SIM_DEVICES_MAX];	/*!< Number of simulated loops of every device. */
+
+/*!	\brief Set list of simulated devices.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZSimSetDevices(
+	const struct CZSimDevice *devices,	/*!<[in] Descriptions of devices. */
+	int num				/*!<[in] Number of devices. */
+) {
+	if((devices == NULL) || (num < 0) || (num > CZ_SIM_DEVICES_MAX))
+		return -1;
+
+	memcpy(s_devices, devices, num * sizeof(s_devices[0]));
+	memset(s_busyMs, 0, sizeof(s_busyMs));
+	memset(s_loopSeq, 0, sizeof(s_loopSeq));
+	s_devicesNum = num;
+
+	return 0;
+}
+
+/*!	\brief Read next token of device description line.
+	Token is a word or a double quoted string.
+	\returns pointer to the rest of line, \a NULL if there are no more tokens.
+*/
+static char *CZSimNextToken(
+	char *line,			/*!<[in,out] Line to parse. */
+	char **token			/*!<[out] Zero terminated token. */
+) {
+	while(isspace((unsigned char)*line))
+		line++;
+
+	if((*line == 0) || (*line == '#'))
+		return NULL;
+
+	*token = line;
+	while((*line != 0) && !isspace((unsigned char)*line)) {
+		if(*line == '"') {
+			memmove(line, line + 1, strlen(line));
+			while((*line != 0) && (*line != '"'))
+				line++;
+			if(*line == '"')
+				memmove(line, line + 1, strlen(line));
+		} else {
+			line++;
+		}
+	}
+
+	if(*line != 0)
+		*line++ = 0;
+
+	return line;
+}
+
+/*!	\brief Parse one \a key=value pair of device description.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSimParseParam(
+	struct CZSimDevice *dev,	/*!<[in,out] Device description. */
+	const char *key,		/*!<[in] Parameter name. */
+	const char *value		/*!<[in] Parameter value. */
+) {
+	if(strcmp(key, "name") == 0) {
+		strncpy(dev->name, value, sizeof(dev->name) - 1);
+		dev->name[sizeof(dev->name) - 1] = 0;
+	} else if(strcmp(key, "cc") == 0) {
+		if(sscanf(value, "%d.%d", &dev->major, &dev->minor) != 2)
+			return -1;
+	} else if(strcmp(key, "mp") == 0) {
+		dev->multiProc = atoi(value);
+	} else if(strcmp(key, "clock") == 0) {
+		dev->clockMHz = atoi(value);
+	} else if(strcmp(key, "memclock") == 0) {
+		dev->memClockMHz = atoi(value);
+	} else if(strcmp(key, "bus") == 0) {
+		dev->memBusWidth = atoi(value);
+	} else if(strcmp(key, "mem") == 0) {
+		dev->memSizeMiB = atoi(value);
+	} else if(strcmp(key, "integrated") == 0) {
+		dev->integrated = atoi(value);
+	} else if(strcmp(key, "eff") == 0) {
+		dev->efficiency = atof(value);
+	} else if(strcmp(key, "noise") == 0) {
+		dev->noisePct = atof(value);
+	} else if(strcmp(key, "throttle") == 0) {
+		if(sscanf(value, "%f@%f", &dev->throttlePct, &dev->throttleSec) != 2)
+			return -1;
+	} else {
+		return -1;
+	}
+
+	return 0;
+}
+
+/*!	\brief Read descriptions of simulated devices from file.
+	Every non-empty line of file describes one device as a list of
+	\a key=value pairs. Known keys are \a name, \a cc (e.g. 8.6), \a mp,
+	\a clock and \a memclock (MHz), \a bus (bits), \a mem (MiB),
+	\a integrated, \a eff and \a noise (percents) and \a throttle
+	(\a pct\@sec). Missing keys are taken from the first built-in device.
+	Text after \a # is ignored.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZSimConfigure(
+	const char *fileName		/*!<[in] Name of device description file. */
+) {
+	struct CZSimDevice devices[CZ_SIM_DEVICES_MAX];
+	char line[1024];
+	int lineNum = 0;
+	int num = 0;
+	FILE *fp;
+
+	if(fileName == NULL)
+		return -1;
+
+	fp = fopen(fileName, "r");
+	if(fp == NULL) {
+		CZLog(CZLogLevelError, "Can't open simulated device file %s.", fileName);
+		return -1;
+	}
+
+	while(fgets(line, sizeof(line), fp) != NULL) {
+		char *rest = line;
+		char *token;
+		int params = 0;
+
+		lineNum++;
+
+		if(num >= CZ_SIM_DEVICES_MAX) {
+			CZLog(CZLogLevelWarning, "Too many simulated devices in %s.", fileName);
+			break;
+		}
+
+		devices[num] = s_defDevices[0];
+		snprintf(devices[num].name, sizeof(devices[num].name), "CUDA-Z Simulated Device %d", num);
+
+		while((rest = CZSimNextToken(rest, &token)) != NULL) {
+			char *value = strchr(token, '=');
+			if(value != NULL)
+				*value++ = 0;
+			if((value == NULL) || (CZSimParseParam(&devices[num], token, value) != 0)) {
+				CZLog(CZLogLevelError, "Wrong parameter '%s' in %s:%d.", token, fileName, lineNum);
+				fclose(fp);
+				return -1;
+			}
+			params++;
+		}
+
+		if(params != 0)
+			num++;
+	}
+
+	fclose(fp);
+
+	CZLog(CZLogLevelLow, "Read %d simulated device(s) from %s.", num, fileName);
+
+	return CZSimSetDevices(devices, num);
+}
+
+/*!	\brief Get simulated devices configured on first use.
+	Devices are read from file named by environment variable \a CZ_SIM_CONFIG,
+	or built-in ones are used.
+	\returns number of simulated devices.
+*/
+static int CZSimDevicesNum(void) {
+
+	if(s_devicesNum < 0) {
+		const char *fileName = getenv(CZ_SIM_CONFIG_ENV);
+		if((fileName == NULL) || (CZSimConfigure(fileName) != 0))
+			CZSimSetDevices(s_defDevices, sizeof(s_defDevices) / sizeof(s_defDevices[0]));
+	}
+
+	return s_devicesNum;
+}
+
+/*!	\brief Check if CUDA is present here.
+*/
+static bool CZSimCheck(void) {
+	return true;
+}
+
+/*!	\brief Check how many simulated devices are present.
+	\returns number of simulated devices.
+*/
+static int CZSimDeviceFound(void) {
+	return CZSimDevicesNum();
+}
+
+/*!	\brief Read information about a simulated device.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSimReadDeviceInfo(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int num				/*!<[in] Number (index) of device. */
+) {
+	static char drvVersion[] = "Simulated";
+	static char dllVerStr[] = "12.0 (simulated)";
+	const struct CZSimDevice *dev;
+
+	if(info == NULL)
+		return -1;
+
+	if((num < 0) || (num >= CZSimDevicesNum()))
+		return -1;
+
+	dev = &s_devices[num];
+
+	info->num = num;
+	strncpy(info->deviceName, dev->name, sizeof(info->deviceName) - 1);
+	info->deviceName[sizeof(info->deviceName) - 1] = 0;
+	info->major = dev->major;
+	info->minor = dev->minor;
+	strncpy(info->archName, CZArchName(dev->major, dev->minor), sizeof(info->archName) - 1);
+	info->archName[sizeof(info->archName) - 1] = 0;
+	info->drvVersion = drvVersion;
+	info->drvDllVer = CZ_SIM_DRV_VER;
+	info->drvDllVerStr = dllVerStr;
+	info->rtDllVer = CZ_SIM_DRV_VER;
+	info->rtDllVerStr = dllVerStr;
+	info->tccDriver = 0;
+
+	info->core.regsPerBlock = 65536;
+	info->core.SIMDWidth = 32;
+	info->core.maxThreadsPerBlock = CZ_SIM_THREADS_NUM;
+	info->core.maxThreadsDim[0] = 1024;
+	info->core.maxThreadsDim[1] = 1024;
+	info->core.maxThreadsDim[2] = 64;
+	info->core.maxGridSize[0] = 2147483647;
+	info->core.maxGridSize[1] = 65535;
+	info->core.maxGridSize[2] = 65535;
+	info->core.clockRate = dev->clockMHz * 1000;
+	info->core.muliProcCount = dev->multiProc;
+	info->core.watchdogEnabled = 0;
+	info->core.integratedGpu = dev->integrated;
+	info->core.concurrentKernels = 1;
+	info->core.computeMode = CZComputeModeDefault;
+	info->core.pciBusID = num + 1;
+	info->core.pciDeviceID = 0;
+	info->core.pciDomainID = 0;
+	info->core.maxThreadsPerMultiProcessor = 2048;
+	info->core.cudaCores = CZArchCoresPerMP(dev->major, dev->minor) * dev->multiProc;
+	info->core.streamPrioritiesSupported = 1;
+
+	info->mem.totalGlobal = (size_t)dev->memSizeMiB << 20;
+	info->mem.sharedPerBlock = 48 << 10;
+	info->mem.maxPitch = 2147483647;
+	info->mem.totalConst = 64 << 10;
+	info->mem.textureAlignment = 512;
+	info->mem.texture1D[0] = 131072;
+	info->mem.texture2D[0] = 131072;
+	info->mem.texture2D[1] = 65536;
+	info->mem.texture3D[0] = 16384;
+	info->mem.texture3D[1] = 16384;
+	info->mem.texture3D[2] = 16384;
+	info->mem.gpuOverlap = 1;
+	info->mem.mapHostMemory = 1;
+	info->mem.errorCorrection = 0;
+	info->mem.asyncEngineCount = 2;
+	info->mem.unifiedAddressing = 1;
+	info->mem.memoryClockRate = dev->memClockMHz * 1000;
+	info->mem.memoryBusWidth = dev->memBusWidth;
+	info->mem.l2CacheSize = 4 << 20;
+
+	return 0;
+}
+
+/*!	\brief Set device for current thread.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSimCalcDeviceSelect(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	if((info == NULL) || (info->num < 0) || (info->num >= CZSimDevicesNum()))
+		return -1;
+
+	CZLog(CZLogLevelLow, "Selecting %s.", info->deviceName);
+
+	return 0;
+}
+
+/*!	\brief Prepare device for tests. Nothing to do for simulated device.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSimPrepareDevice(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	return CZSimCalcDeviceSelect(info);
+}
+
+/*!	\brief Get deterministic pseudo-random number.
+	\returns value in range [-1, 1].
+*/
+static double CZSimNoise(
+	unsigned int seed		/*!<[in] Seed value. */
+) {
+	/* integer hash by Thomas Wang */
+	seed = (seed ^ 61) ^ (seed >> 16);
+	seed *= 9;
+	seed = seed ^ (seed >> 4);
+	seed *= 0x27d4eb2d;
+	seed = seed ^ (seed >> 15);
+
+	return (double)(seed & 0xffff) / 32767.5 - 1;
+}
+
+/*!	\brief Simulate one loop of test.
+	\returns result of loop in KiB/s or KOPS, time of loop is returned in \a loopMs.
+*/
+static double CZSimLoop(
+	struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	int metric,			/*!<[in] Simulated test. See enum #CZMetric. */
+	int warmup,			/*!<[in] Warm-up loop flag. */
+	double *loopMs			/*!<[out] Simulated loop time. */
+) {
+	const struct CZSimDevice *dev = &s_devices[info->num];
+	double value;
+	double workK;
+
+	value = CZArchCalcPeak(info, metric) * s_metricEfficiency[metric] * dev->efficiency / 100;
+
+	if((dev->throttlePct > 0) && (s_busyMs[info->num] >= (dev->throttleSec * 1000)))
+		value *= 1 - dev->throttlePct / 100;
+
+	if(warmup)
+		value *= CZ_SIM_WARMUP_RATE;
+
+	value *= 1 + dev->noisePct / 100 * CZSimNoise(s_loopSeq[info->num]++ * 31 + info->num * 7919 + metric);
+
+	/* Work is in KiB or in K operations, throughput is per second. */
+	if(metric <= CZMetricCopyDD)
+		workK = info->quickMode? CZ_SIM_QUICK_SIZE_KB: CZ_SIM_COPY_SIZE_KB;
+	else
+		workK = (double)info->core.muliProcCount * CZ_SIM_THREADS_NUM *
+			(info->quickMode? CZ_CALC_QUICK_LOOPS: CZ_CALC_BLOCK_LOOPS) *
+			CZ_CALC_OPS_NUM * CZ_CALC_BLOCK_SIZE * CZ_CALC_BLOCK_NUM / 1000;
+
+	*loopMs = (value > 0)? 1000 * workK / value: 0;
+	s_busyMs[info->num] += *loopMs;
+
+	return value;
+}
+
+/*!	\brief Run one simulated test.
+	Loops are organized in the same way as in CUDA backend, but time is simulated.
+	\returns \a 0 in case of error, \a other is mean value in KiB/s or KOPS.
+*/
+static float CZSimTest(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int metric,			/*!<[in] Simulated test. See enum #CZMetric. */
+	struct CZDeviceInfoStat *stat	/*!<[out] Statistics of test. */
+) {
+	float values[CZ_STAT_SAMPLES_MAX];
+	double elapsedMs = 0;
+	double loopMs;
+	int i;
+
+	memset(stat, 0, sizeof(*stat));
+
+	if(CZArchCalcPeak(info, metric) <= 0)
+		return 0;
+
+	CZLog(CZLogLevelLow, "Starting simulated %s test on %s.", CZMetricName(metric), info->deviceName);
+
+	for(i = -CZStatWarmupNum(info); ((i <= 0) && !CZStatStopped(info)) || !CZStatLoopsDone(info, values, i, CZ_SIM_LOOPS_NUM, elapsedMs); i++) {
+		double value = CZSimLoop(info, metric, i < 0, &loopMs);
+		elapsedMs += loopMs;
+		if(i >= 0)
+			values[i] = value;
+	}
+
+	CZLog(CZLogLevelLow, "Test complete in %f ms.", elapsedMs);
+
+	if(CZStatSubmit(info, metric, values, i, stat) != 0)
+		return 0;
+	CZStatLog(stat, (metric <= CZMetricCopyDD)? "KiB/s": "KOPS");
+
+	return stat->mean;
+}
+
+/*!	\brief Run one bandwidth or performance test.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSimCalcDeviceTest(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	int metric			/*!<[in] Test to run. See enum #CZMetric. */
+) {
+	float value;
+
+	if((info == NULL) || (info->num < 0) || (info->num >= CZSimDevicesNum()))
+		return -1;
+
+	if((metric < 0) || (metric >= CZMetricMax))
+		return -1;
+
+	value = CZSimTest(info, metric, &info->stat[metric]);
+	CZMetricSetValue(info, metric, value);
+
+	if(value == 0)
+		return -1;
+
+	return 0;
+}
+
+/*!	\brief Calculate bandwidth information about simulated device.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSimCalcDeviceBandwidth(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	for(int metric = CZMetricCopyHDPin; metric <= CZMetricCopyDD; metric++) {
+		if(CZSimCalcDeviceTest(info, metric) != 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+/*!	\brief Calculate performance information about simulated device.
+	Unsupported tests (e.g. double precision on old devices) are left zero.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSimCalcDevicePerformance(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	if((info == NULL) || (info->num < 0) || (info->num >= CZSimDevicesNum()))
+		return -1;
+
+	for(int metric = CZMetricCalcFloat; metric <= CZMetricCalcInteger24; metric++)
+		CZSimCalcDeviceTest(info, metric);
+
+	return 0;
+}
+
+/*!	\brief Cleanup after tests. Nothing to do for simulated device.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+static int CZSimCleanDevice(
+	struct CZDeviceInfo *info	/*!<[in,out] CUDA-device information. */
+) {
+	if(info == NULL)
+		return -1;
+
+	return 0;
+}
+
+/*!	\brief Simulated backend.
+*/
+const struct CZBackend CZBackendSim = {
+	"sim",
+	CZSimCheck,
+	CZSimDeviceFound,
+	CZSimReadDeviceInfo,
+	NULL,
+	CZSimCalcDeviceSelect,
+	CZSimPrepareDevice,
+	CZSimCalcDeviceBandwidth,
+	CZSimCalcDevicePerformance,
+	CZSimCalcDeviceTest,
+	NULL,
+	CZSimCleanDevice,
+};
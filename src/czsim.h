@@ -0,0 +1,42 @@
+/*!	\file czsim.h
+	\brief Simulated benchmark backend definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_SIM_H
+#define CZ_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_SIM_DEVICES_MAX	16			/*!< Maximal number of simulated devices. */
+
+/*!	\brief Description of simulated device.
+*/
+struct CZSimDevice {
+	char		name[256];		/*!< Device name. */
+	int		major;			/*!< Major revision number of compute capability. */
+	int		minor;			/*!< Minor revision number of compute capability. */
+	int		multiProc;		/*!< Number of multiprocessors. */
+	int		clockMHz;		/*!< Core clock in MHz. */
+	int		memClockMHz;		/*!< Memory clock in MHz as reported by driver. */
+	int		memBusWidth;		/*!< Memory bus width in bits. */
+	int		memSizeMiB;		/*!< Global memory size in MiB. */
+	int		integrated;		/*!< 1 for integrated GPU. */
+	float		efficiency;		/*!< Achieved part of theoretical peaks in percents. */
+	float		noisePct;		/*!< Amplitude of measurement noise in percents. */
+	float		throttlePct;		/*!< Throughput drop after throttling in percents, \a 0 for none. */
+	float		throttleSec;		/*!< Busy time after which device throttles in seconds. */
+};
+
+int CZSimConfigure(const char *fileName);
+int CZSimSetDevices(const struct CZSimDevice *devices, int num);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_SIM_H
@@ -0,0 +1,214 @@
+/*!	\file czsoak.cpp
+	\brief Sustained load (soak) test source file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "cztimer.h"
+#include "cudaarch.h"
+#include "czsoak.h"
+
+#define CZ_SOAK_DEF_DURATION	600			/*!< Default test duration in seconds. */
+#define CZ_SOAK_DEF_INTERVAL	10			/*!< Default sampling interval in seconds. */
+#define CZ_SOAK_DEF_DROP	10			/*!< Default throttling threshold in percents. */
+#define CZ_SOAK_DEF_STEADY	5			/*!< Default steady state band in percents. */
+
+#define CZ_SOAK_PLATEAU_NUM	3			/*!< Number of first samples defining initial plateau. */
+#define CZ_SOAK_STEADY_NUM	3			/*!< Minimal number of samples in steady state. */
+
+/*!	\brief Fill soak test configuration with default values.
+*/
+void CZSoakConfigDefault(
+	struct CZSoakConfig *config	/*!<[out] Soak test configuration. */
+) {
+	if(config == NULL)
+		return;
+
+	config->metric = CZMetricCalcFloat;
+	config->durationSec = CZ_SOAK_DEF_DURATION;
+	config->intervalSec = CZ_SOAK_DEF_INTERVAL;
+	config->dropPct = CZ_SOAK_DEF_DROP;
+	config->steadyPct = CZ_SOAK_DEF_STEADY;
+}
+
+/*!	\brief Compare two floats for qsort().
+*/
+static int CZSoakCompare(
+	const void *a,			/*!<[in] First value. */
+	const void *b			/*!<[in] Second value. */
+) {
+	float fa = *(const float*)a;
+	float fb = *(const float*)b;
+	return (fa < fb)? -1: (fa > fb)? 1: 0;
+}
+
+/*!	\brief Analyse soak test time series.
+	Initial plateau is a median of first samples. Throttling event is a
+	period of time when throughput stays more than \a dropPct percents
+	below initial plateau. Steady state begins at the earliest sample after
+	which the spread of throughput stays within \a steadyPct percents
+	of its mean.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZSoakAnalyze(
+	const struct CZSoakConfig *config,	/*!<[in] Soak test configuration. */
+	const struct CZSoakSample *samples,	/*!<[in] Time series. */
+	int num,			/*!<[in] Number of samples in time series. */
+	struct CZSoakResult *result	/*!<[out] Analysis results. */
+) {
+	float plateau[CZ_SOAK_PLATEAU_NUM];
+	struct CZSoakEvent *event = NULL;
+	float threshold;
+	float tailMin, tailMax;
+	double tailSum;
+	int plateauNum;
+	int inEvent;
+	int i;
+
+	if((config == NULL) || (samples == NULL) || (result == NULL))
+		return -1;
+
+	memset(result, 0, sizeof(*result));
+	result->steadySec = -1;
+	result->samplesNum = num;
+
+	if(num <= 0)
+		return -1;
+
+	plateauNum = (num < CZ_SOAK_PLATEAU_NUM)? num: CZ_SOAK_PLATEAU_NUM;
+	for(i = 0; i < plateauNum; i++)
+		plateau[i] = samples[i].value;
+	qsort(plateau, plateauNum, sizeof(plateau[0]), CZSoakCompare);
+	result->plateau = plateau[plateauNum / 2];
+
+	threshold = result->plateau * (1 - config->dropPct / 100);
+	result->minValue = samples[0].value;
+	result->maxValue = samples[0].value;
+	inEvent = 0;
+
+	for(i = 0; i < num; i++) {
+		float value = samples[i].value;
+
+		if(value < result->minValue)
+			result->minValue = value;
+		if(value > result->maxValue)
+			result->maxValue = value;
+
+		if(value < threshold) {
+			if(!inEvent) {
+				inEvent = 1;
+				event = (result->eventsNum < CZ_SOAK_EVENTS_MAX)? &result->events[result->eventsNum]: NULL;
+				result->eventsNum++;
+				if(event != NULL) {
+					event->startSec = samples[i].timeSec;
+					event->endSec = -1;
+					event->minValue = value;
+				}
+			}
+			if(event != NULL) {
+				if(value < event->minValue)
+					event->minValue = value;
+				event->dropPct = 100 * (1 - event->minValue / result->plateau);
+			}
+		} else if(inEvent) {
+			inEvent = 0;
+			if(event != NULL)
+				event->endSec = samples[i].timeSec;
+			event = NULL;
+		}
+	}
+
+	tailMin = tailMax = samples[num - 1].value;
+	tailSum = 0;
+	for(i = num - 1; i >= 0; i--) {
+		float value = samples[i].value;
+		float newMin = (value < tailMin)? value: tailMin;
+		float newMax = (value > tailMax)? value: tailMax;
+		double newMean = (tailSum + value) / (num - i);
+
+		if((newMax - newMin) > (newMean * config->steadyPct / 100))
+			break;
+
+		tailMin = newMin;
+		tailMax = newMax;
+		tailSum += value;
+	}
+	i++; /* first sample of steady state */
+
+	if((num - i) >= CZ_SOAK_STEADY_NUM) {
+		result->steadySec = samples[i].timeSec;
+		result->steadyValue = tailSum / (num - i);
+	}
+
+	return 0;
+}
+
+/*!	\brief Run soak test.
+	The test of \a config->metric is run back to back for \a config->durationSec
+	seconds. Every \a config->intervalSec seconds an average throughput is
+	appended to time series and reported via \a progress callback.
+	\returns number of collected samples, \a -1 in case of error.
+*/
+int CZSoakRun(
+	struct CZDeviceInfo *info,	/*!<[in,out] CUDA-device information. */
+	const struct CZSoakConfig *config,	/*!<[in] Soak test configuration. */
+	struct CZSoakSample *samples,	/*!<[out] Time series buffer. */
+	int maxNum,			/*!<[in] Size of time series buffer. */
+	CZSoakProgress progress,	/*!<[in] Progress callback, may be \a NULL. */
+	void *context			/*!<[in] Context of progress callback. */
+) {
+	double startMs, intervalMs, nowMs;
+	double sum = 0;
+	int count = 0;
+	int num = 0;
+
+	if((info == NULL) || (config == NULL) || (samples == NULL))
+		return -1;
+
+	if((config->metric < 0) || (config->metric >= CZMetricMax) || (config->intervalSec <= 0))
+		return -1;
+
+	CZLog(CZLogLevelModerate, "Soak test of %s on %s for %.0f s.",
+		CZMetricName(config->metric), info->deviceName, config->durationSec);
+
+	startMs = CZTimerNow();
+	intervalMs = startMs;
+
+	for(;;) {
+		if((info->cancel != NULL) && *info->cancel)
+			break;
+
+		if(CZCudaCalcDeviceTest(info, config->metric) != 0)
+			return -1;
+
+		sum += CZMetricValue(info, config->metric);
+		count++;
+
+		nowMs = CZTimerNow();
+		if((nowMs - intervalMs) >= (config->intervalSec * 1000)) {
+			samples[num].timeSec = (nowMs - startMs) / 1000;
+			samples[num].value = sum / count;
+			CZLog(CZLogLevelLow, "Soak sample %d at %.1f s: %f.", num, samples[num].timeSec, samples[num].value);
+
+			sum = 0;
+			count = 0;
+			intervalMs = nowMs;
+
+			num++;
+			if((progress != NULL) && (progress(context, &samples[num - 1]) != 0))
+				break;
+			if(num >= maxNum)
+				break;
+		}
+
+		if((nowMs - startMs) >= (config->durationSec * 1000))
+			break;
+	}
+
+	return num;
+}
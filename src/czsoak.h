@@ -0,0 +1,72 @@
+/*!	\file czsoak.h
+	\brief Sustained load (soak) test definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_SOAK_H
+#define CZ_SOAK_H
+
+#include "cudainfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_SOAK_EVENTS_MAX	16			/*!< Maximal number of reported throttling events. */
+#define CZ_SOAK_SAMPLES_MAX	4096			/*!< Maximal number of time series samples. */
+
+/*!	\brief Soak test configuration.
+*/
+struct CZSoakConfig {
+	int		metric;			/*!< Metric to load device with. See enum #CZMetric. */
+	float		durationSec;		/*!< Test duration in seconds. */
+	float		intervalSec;		/*!< Time series sampling interval in seconds. */
+	float		dropPct;		/*!< Throttling threshold: drop below initial plateau in percents. */
+	float		steadyPct;		/*!< Steady state band: allowed spread of throughput in percents. */
+};
+
+/*!	\brief One point of soak test time series.
+*/
+struct CZSoakSample {
+	float		timeSec;		/*!< Time since beginning of test in seconds. */
+	float		value;			/*!< Average throughput over sampling interval. */
+};
+
+/*!	\brief Throttling event.
+*/
+struct CZSoakEvent {
+	float		startSec;		/*!< Time when throughput dropped below threshold. */
+	float		endSec;			/*!< Time when throughput recovered, \a -1 if it never did. */
+	float		minValue;		/*!< Lowest throughput during event. */
+	float		dropPct;		/*!< Largest drop below initial plateau in percents. */
+};
+
+/*!	\brief Soak test analysis results.
+*/
+struct CZSoakResult {
+	int		samplesNum;		/*!< Number of analysed samples. */
+	float		plateau;		/*!< Initial plateau throughput. */
+	float		minValue;		/*!< Lowest sampled throughput. */
+	float		maxValue;		/*!< Highest sampled throughput. */
+	float		steadySec;		/*!< Time to reach steady state, \a -1 if it was never reached. */
+	float		steadyValue;		/*!< Mean throughput in steady state. */
+	int		eventsNum;		/*!< Number of throttling events (may exceed #CZ_SOAK_EVENTS_MAX). */
+	struct CZSoakEvent	events[CZ_SOAK_EVENTS_MAX];	/*!< First throttling events. */
+};
+
+/*!	\brief Soak test progress callback.
+	\returns \a 0 to continue test, \a other to stop it.
+*/
+typedef int (*CZSoakProgress)(void *context, const struct CZSoakSample *sample);
+
+void CZSoakConfigDefault(struct CZSoakConfig *config);
+int CZSoakAnalyze(const struct CZSoakConfig *config, const struct CZSoakSample *samples, int num, struct CZSoakResult *result);
+int CZSoakRun(struct CZDeviceInfo *info, const struct CZSoakConfig *config, struct CZSoakSample *samples, int maxNum, CZSoakProgress progress, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_SOAK_H
@@ -0,0 +1,228 @@
+/*!	\file czstat.cpp
+	\brief Statistics of repeated measurements source file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "log.h"
+#include "cztimer.h"
+#include "czstat.h"
+
+#define CZ_WARMUP_MAX_NUM	16			/*!< Maximal number of warm-up loops. */
+
+#define CZ_ADAPT_MIN_LOOPS	3			/*!< Minimal number of measured loops in adaptive mode. */
+
+static CZStatSink s_sink = NULL;		/*!< Receiver of measured iterations. */
+static void *s_sinkContext = NULL;		/*!< Context of receiver. */
+
+/*!	\brief Compare two floats for qsort().
+*/
+static int CZStatCompare(
+	const void *a,			/*!<[in] First value. */
+	const void *b			/*!<[in] Second value. */
+) {
+	float fa = *(const float*)a;
+	float fb = *(const float*)b;
+	return (fa < fb)? -1: (fa > fb)? 1: 0;
+}
+
+/*!	\brief Get two-sided 95% quantile of Student's t-distribution.
+	\returns quantile value.
+*/
+static double CZStatStudent95(
+	int df				/*!<[in] Degrees of freedom. */
+) {
+	static const double tTab[] = {
+		12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+	};
+
+	if(df < 1)
+		return 0;
+	if(df <= (int)(sizeof(tTab) / sizeof(tTab[0])))
+		return tTab[df - 1];
+	if(df <= 60)
+		return 2.000;
+	if(df <= 120)
+		return 1.980;
+	return 1.960;
+}
+
+/*!	\brief Calculate statistics of measured iterations.
+	Percentile is taken by nearest-rank method, standard deviation is
+	a sample one (with \a num - 1 denominator). Confidence interval of
+	mean is based on Student's t-distribution.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZStatCalc(
+	const float *values,		/*!<[in] Results of measured iterations. */
+	int num,			/*!<[in] Number of measured iterations. */
+	struct CZDeviceInfoStat *stat	/*!<[out] Statistics. */
+) {
+	float sorted[CZ_STAT_SAMPLES_MAX];
+	double sum = 0;
+	double sqSum = 0;
+	int rank;
+	int i;
+
+	if(stat == NULL)
+		return -1;
+
+	memset(stat, 0, sizeof(*stat));
+
+	if((values == NULL) || (num <= 0))
+		return -1;
+
+	if(num > CZ_STAT_SAMPLES_MAX)
+		num = CZ_STAT_SAMPLES_MAX;
+
+	memcpy(sorted, values, num * sizeof(sorted[0]));
+	qsort(sorted, num, sizeof(sorted[0]), CZStatCompare);
+
+	for(i = 0; i < num; i++)
+		sum += sorted[i];
+
+	stat->samplesNum = num;
+	stat->min = sorted[0];
+	stat->max = sorted[num - 1];
+	stat->mean = sum / num;
+	stat->median = (num % 2)? sorted[num / 2]: (sorted[num / 2 - 1] + sorted[num / 2]) / 2;
+
+	rank = (int)ceil(0.95 * num);
+	stat->p95 = sorted[rank - 1];
+
+	if(num > 1) {
+		for(i = 0; i < num; i++)
+			sqSum += (sorted[i] - stat->mean) * (sorted[i] - stat->mean);
+		stat->stddev = sqrt(sqSum / (num - 1));
+	}
+
+	if(stat->mean != 0) {
+		stat->cv = 100 * stat->stddev / stat->mean;
+		stat->ci95 = CZStatStudent95(num - 1) * stat->cv / sqrt((double)num);
+	}
+
+	return 0;
+}
+
+/*!	\brief Set receiver of measured iterations of every test.
+	Pass \a NULL to remove receiver.
+*/
+void CZStatSetSink(
+	CZStatSink sink,		/*!<[in] Receiver of measured iterations. */
+	void *context			/*!<[in] Context of receiver. */
+) {
+	s_sinkContext = context;
+	s_sink = sink;
+}
+
+/*!	\brief Finish test: pass its measured iterations to receiver
+	and calculate statistics.
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZStatSubmit(
+	const struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	int metric,			/*!<[in] Measured metric, \a -1 for user-supplied kernel. */
+	const float *values,		/*!<[in] Results of measured iterations. */
+	int num,			/*!<[in] Number of measured iterations. */
+	struct CZDeviceInfoStat *stat	/*!<[out] Statistics. */
+) {
+	CZStatSink sink = s_sink;
+
+	if((sink != NULL) && (values != NULL) && (num > 0))
+		sink(s_sinkContext, info, metric, values, num);
+
+	return CZStatCalc(values, num, stat);
+}
+
+/*!	\brief Get number of warm-up loops to run before measured ones.
+	\returns number of warm-up loops.
+*/
+int CZStatWarmupNum(
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	if(info->warmupNum < 0)
+		return 0;
+	if(info->warmupNum > CZ_WARMUP_MAX_NUM)
+		return CZ_WARMUP_MAX_NUM;
+	return info->warmupNum;
+}
+
+/*!	\brief Check if running test must stop, either because it is
+	cancelled via \a info->cancel or because \a info->deadlineMs is
+	reached. Stopped test runs no more loops, warm-up ones included.
+	\returns \a 1 if test must stop, \a 0 otherwise.
+*/
+int CZStatStopped(
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	if((info->cancel != NULL) && *info->cancel)
+		return 1;
+
+	if((info->deadlineMs > 0) && (CZTimerNow() >= info->deadlineMs))
+		return 1;
+
+	return 0;
+}
+
+/*!	\brief Check if enough loops of test are measured.
+	In fixed mode exactly \a loopsNum loops are run. In adaptive mode
+	(\a info->precision > 0) loops are run until relative half-width
+	of 95% confidence interval of mean drops below \a info->precision,
+	or until time budget of test is exhausted. Test is always complete
+	if it is stopped, see CZStatStopped().
+	\returns \a 1 if test is complete, \a 0 if more loops are needed.
+*/
+int CZStatLoopsDone(
+	const struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	const float *values,		/*!<[in] Results of measured loops. */
+	int num,			/*!<[in] Number of measured loops. */
+	int loopsNum,			/*!<[in] Number of loops in fixed mode. */
+	double elapsedMs		/*!<[in] Time since start of test. */
+) {
+	struct CZDeviceInfoStat stat;
+	float budgetMs;
+
+	if(CZStatStopped(info))
+		return 1;
+
+	if(info->precision <= 0)
+		return num >= loopsNum;
+
+	if(num >= CZ_STAT_SAMPLES_MAX)
+		return 1;
+
+	if(num < CZ_ADAPT_MIN_LOOPS)
+		return 0;
+
+	if(CZStatCalc(values, num, &stat) != 0)
+		return 1;
+
+	if(stat.ci95 <= info->precision)
+		return 1;
+
+	budgetMs = (info->budgetMs > 0)? info->budgetMs: CZ_ADAPT_DEF_BUDGET_MS;
+	if(elapsedMs >= budgetMs) {
+		CZLog(CZLogLevelModerate, "Time budget of %.0f ms is exhausted with precision %.2f%% after %d loop(s).",
+			budgetMs, stat.ci95, num);
+		return 1;
+	}
+
+	return 0;
+}
+
+/*!	\brief Log statistics of measured loops.
+*/
+void CZStatLog(
+	const struct CZDeviceInfoStat *stat,	/*!<[in] Statistics of test. */
+	const char *unit		/*!<[in] Unit of values. */
+) {
+	CZLog(CZLogLevelLow, "Test statistics over %d loop(s): min %f, median %f, mean %f, p95 %f, stddev %f %s, CV %.2f%%, CI95 %.2f%%.",
+		stat->samplesNum, stat->min, stat->median, stat->mean, stat->p95, stat->stddev, unit, stat->cv, stat->ci95);
+}
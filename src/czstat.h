@@ -0,0 +1,37 @@
+/*!	\file czstat.h
+	\brief Statistics of repeated measurements definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_STAT_H
+#define CZ_STAT_H
+
+#include "cudainfo.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_STAT_SAMPLES_MAX	256			/*!< Maximal number of measured iterations of one test. */
+#define CZ_ADAPT_DEF_BUDGET_MS	2000			/*!< Default time budget of one test in adaptive mode. */
+
+/*!	\brief Receiver of measured iterations of every test.
+	\a metric is \a -1 for user-supplied kernel.
+*/
+typedef void (*CZStatSink)(void *context, const struct CZDeviceInfo *info, int metric, const float *values, int num);
+
+int CZStatCalc(const float *values, int num, struct CZDeviceInfoStat *stat);
+int CZStatSubmit(const struct CZDeviceInfo *info, int metric, const float *values, int num, struct CZDeviceInfoStat *stat);
+void CZStatSetSink(CZStatSink sink, void *context);
+int CZStatWarmupNum(const struct CZDeviceInfo *info);
+int CZStatStopped(const struct CZDeviceInfo *info);
+int CZStatLoopsDone(const struct CZDeviceInfo *info, const float *values, int num, int loopsNum, double elapsedMs);
+void CZStatLog(const struct CZDeviceInfoStat *stat, const char *unit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_STAT_H
@@ -0,0 +1,190 @@
+/*!	\file cztimer.cpp
+	\brief Monotonic timer source file.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include "log.h"
+#include "cztimer.h"
+
+/*!	\fn CZTimerProcessAge
+	\brief Get age of current process.
+	Startup of process before main() mostly consists of loading of shared
+	libraries. On Linux the age has resolution of scheduler tick.
+	\returns time since process creation in milliseconds, or \a -1 if unknown.
+*/
+
+/*!	\fn CZTimerNow
+	\brief Read monotonic clock.
+	The clock is not related to wall time and is not affected by its changes.
+	\returns time in milliseconds since an arbitrary point in the past.
+*/
+#if (defined(WIN64) || defined(_WIN64) || defined(__WIN64__)) || (defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
+#include <windows.h>
+
+double CZTimerNow(void) {
+	static LARGE_INTEGER frequency = {0};
+	LARGE_INTEGER counter;
+
+	if(frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+}
+
+double CZTimerProcessAge(void) {
+	FILETIME creation, exitTime, kernelTime, userTime, now;
+	ULARGE_INTEGER start, current;
+
+	if(!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernelTime, &userTime))
+		return -1;
+	GetSystemTimeAsFileTime(&now);
+
+	start.LowPart = creation.dwLowDateTime;
+	start.HighPart = creation.dwHighDateTime;
+	current.LowPart = now.dwLowDateTime;
+	current.HighPart = now.dwHighDateTime;
+
+	return (double)(current.QuadPart - start.QuadPart) / 1.0e4;
+}
+
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+
+double CZTimerNow(void) {
+	static mach_timebase_info_data_t timebase = {0, 0};
+
+	if(timebase.denom == 0)
+		mach_timebase_info(&timebase);
+
+	return (double)mach_absolute_time() * timebase.numer / timebase.denom / 1.0e6;
+}
+
+#include <sys/types.h>
+#include <sys/sysctl.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+double CZTimerProcessAge(void) {
+	int mib[4] = {CTL_KERN, KERN_PROC, KERN_PROC_PID, 0};
+	struct kinfo_proc proc;
+	size_t size = sizeof(proc);
+	struct timeval now;
+
+	mib[3] = getpid();
+	if(sysctl(mib, 4, &proc, &size, NULL, 0) != 0)
+		return -1;
+	gettimeofday(&now, NULL);
+
+	return (double)(now.tv_sec - proc.kp_proc.p_starttime.tv_sec) * 1000.0 +
+		(double)(now.tv_usec - proc.kp_proc.p_starttime.tv_usec) / 1000.0;
+}
+
+#else
+#include <time.h>
+
+double CZTimerNow(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6;
+}
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+double CZTimerProcessAge(void) {
+	char buffer[1024];
+	const char *p;
+	unsigned long long startTicks = 0;
+	struct timespec ts;
+	FILE *fp;
+	size_t len;
+	int field;
+
+	fp = fopen("/proc/self/stat", "r");
+	if(fp == NULL)
+		return -1;
+	len = fread(buffer, 1, sizeof(buffer) - 1, fp);
+	fclose(fp);
+	buffer[len] = '\0';
+
+	/* Process name may contain spaces, so fields are counted after it. */
+	p = strrchr(buffer, ')');
+	if(p == NULL)
+		return -1;
+	for(field = 2; (field < 22) && (p != NULL); field++)
+		p = strchr(p + 1, ' ');
+	if((p == NULL) || (sscanf(p + 1, "%llu", &startTicks) != 1))
+		return -1;
+
+	if(clock_gettime(CLOCK_BOOTTIME, &ts) != 0)
+		return -1;
+
+	return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1.0e6 -
+		(double)startTicks * 1000.0 / (double)sysconf(_SC_CLK_TCK);
+}
+
+#endif
+
+/*!	\brief Startup phase record.
+*/
+struct CZTimerPhaseInfo {
+	const char	*name;			/*!< Name of phase. */
+	double		timeMs;			/*!< Time of phase end. */
+};
+
+/*!	\brief Startup phases recorded by CZTimerPhase().
+*/
+static struct CZTimerPhaseInfo s_phaseTab[CZ_TIMER_PHASES_MAX];
+
+/*!	\brief Number of recorded startup phases.
+*/
+static int s_phaseNum = 0;
+
+/*!	\brief Age of process at first startup phase, \a -1 if unknown.
+*/
+static double s_phaseLoadMs = -1;
+
+/*!	\brief Mark end of startup phase.
+	First call marks the beginning of startup and takes age of process,
+	i.e. time of loading before main(). This function should be called
+	from main thread only.
+*/
+void CZTimerPhase(
+	const char *name		/*!<[in] Name of phase, must be static string. */
+) {
+	if(s_phaseNum >= CZ_TIMER_PHASES_MAX)
+		return;
+
+	if(s_phaseNum == 0)
+		s_phaseLoadMs = CZTimerProcessAge();
+
+	s_phaseTab[s_phaseNum].name = name;
+	s_phaseTab[s_phaseNum].timeMs = CZTimerNow();
+	s_phaseNum++;
+}
+
+/*!	\brief Log duration of all recorded startup phases.
+*/
+void CZTimerPhaseLog(void) {
+	int i;
+
+	if(s_phaseNum < 2)
+		return;
+
+	if(s_phaseLoadMs >= 0)
+		CZLog(CZLogLevelModerate, "Startup phase load: %.1f ms.", s_phaseLoadMs);
+
+	for(i = 1; i < s_phaseNum; i++) {
+		CZLog(CZLogLevelModerate, "Startup phase %s: %.1f ms.",
+			s_phaseTab[i].name, s_phaseTab[i].timeMs - s_phaseTab[i - 1].timeMs);
+	}
+
+	CZLog(CZLogLevelModerate, "Startup time: %.1f ms.",
+		s_phaseTab[s_phaseNum - 1].timeMs - s_phaseTab[0].timeMs + ((s_phaseLoadMs >= 0)? s_phaseLoadMs: 0));
+}
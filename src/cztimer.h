@@ -0,0 +1,27 @@
+/*!	\file cztimer.h
+	\brief Monotonic timer definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_TIMER_H
+#define CZ_TIMER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_TIMER_PHASES_MAX	32			/*!< Maximal number of startup phases. */
+
+double CZTimerNow(void);
+double CZTimerProcessAge(void);
+
+void CZTimerPhase(const char *name);
+void CZTimerPhaseLog(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_TIMER_H
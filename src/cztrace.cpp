@@ -0,0 +1,331 @@
+/*!	\file cztrace.cpp
+	\brief Low-overhead tracing source file.
+	Every thread writes events into its own ring buffer without locks, so
+	tracing can stay on in measured loops. Buffers are exported as Chrome
+	trace JSON (chrome://tracing, Perfetto) by CZTraceClose().
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "cudaarch.h"
+#include "cztimer.h"
+#include "cztrace.h"
+
+#if (defined(WIN64) || defined(_WIN64) || defined(__WIN64__)) || (defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__))
+#define CZ_TRACE_WIN
+#include <windows.h>
+#endif
+
+#if defined(_MSC_VER)
+#define CZ_TRACE_TLS	__declspec(thread)	/*!< Thread local storage qualifier. */
+#else
+#define CZ_TRACE_TLS	__thread		/*!< Thread local storage qualifier. */
+#endif
+
+#define CZ_TRACE_FILE_NAME_LEN	1024		/*!< Maximal length of trace file name. */
+
+/*!	\brief Ring buffer of events of one thread.
+	Only owner thread writes events. \a head is the number of events
+	ever written, it is incremented after event is complete.
+*/
+struct CZTraceBuffer {
+	char		name[CZ_TRACE_NAME_LEN];	/*!< Name of thread. */
+	volatile unsigned int head;		/*!< Number of events written. */
+	struct CZTraceEvent events[CZ_TRACE_EVENTS_MAX];	/*!< Ring of events. */
+};
+
+/*!	\brief Names of phases in trace.
+*/
+static const char *s_phaseNames[CZTracePhaseMax] = {
+	"info",
+	"prepare",
+	"clean",
+	"wait",
+	"task",
+	"test",
+	"loop",
+	"alloc",
+	"free",
+	"copy",
+	"launch",
+	"sync",
+};
+
+/*!	\brief Tracing is on flag.
+*/
+static volatile int s_traceOn = 0;
+
+/*!	\brief Time of tracing start, origin of timestamps in trace file.
+*/
+static double s_originMs = 0;
+
+/*!	\brief Name of trace file.
+*/
+static char s_fileName[CZ_TRACE_FILE_NAME_LEN];
+
+/*!	\brief Buffers of all traced threads.
+	Buffers are never released because threads may still keep them.
+*/
+static struct CZTraceBuffer *volatile s_buffers[CZ_TRACE_THREADS_MAX];
+
+/*!	\brief Number of claimed slots of \a s_buffers.
+*/
+static volatile int s_buffersNum = 0;
+
+/*!	\brief Buffer of current thread.
+*/
+static CZ_TRACE_TLS struct CZTraceBuffer *s_threadBuffer = NULL;
+
+/*!	\brief No free slot for current thread flag.
+*/
+static CZ_TRACE_TLS int s_threadFull = 0;
+
+/*!	\brief Full memory barrier.
+*/
+static void CZTraceBarrier(void) {
+#ifdef CZ_TRACE_WIN
+	MemoryBarrier();
+#else
+	__sync_synchronize();
+#endif
+}
+
+/*!	\brief Atomically claim next slot of buffer table.
+	\returns index of claimed slot.
+*/
+static int CZTraceClaimSlot(void) {
+#ifdef CZ_TRACE_WIN
+	return (int)InterlockedIncrement((volatile LONG*)&s_buffersNum) - 1;
+#else
+	return __sync_fetch_and_add(&s_buffersNum, 1);
+#endif
+}
+
+/*!	\brief Get ring buffer of current thread, allocate it on first use.
+	\returns buffer, or \a NULL if thread can not be traced.
+*/
+static struct CZTraceBuffer *CZTraceThreadBuffer(void) {
+	struct CZTraceBuffer *buffer;
+	int slot;
+
+	if(s_threadBuffer != NULL)
+		return s_threadBuffer;
+	if(s_threadFull)
+		return NULL;
+
+	slot = CZTraceClaimSlot();
+	if(slot >= CZ_TRACE_THREADS_MAX) {
+		s_threadFull = 1;
+		return NULL;
+	}
+
+	buffer = (struct CZTraceBuffer*)calloc(1, sizeof(*buffer));
+	if(buffer == NULL) {
+		s_threadFull = 1;
+		return NULL;
+	}
+	snprintf(buffer->name, sizeof(buffer->name), "thread %d", slot);
+
+	CZTraceBarrier();
+	s_buffers[slot] = buffer;
+	s_threadBuffer = buffer;
+
+	return buffer;
+}
+
+/*!	\brief Start tracing. Events are written to \a fileName by CZTraceClose().
+	\returns \a 0 in case of success, \a -1 in case of error.
+*/
+int CZTraceOpen(
+	const char *fileName		/*!<[in] Name of Chrome trace file. */
+) {
+	if((fileName == NULL) || (fileName[0] == '\0'))
+		return -1;
+
+	strncpy(s_fileName, fileName, sizeof(s_fileName) - 1);
+	s_fileName[sizeof(s_fileName) - 1] = '\0';
+
+	s_originMs = CZTimerNow();
+	CZTraceBarrier();
+	s_traceOn = 1;
+
+	CZLog(CZLogLevelLow, "Tracing to %s.", s_fileName);
+
+	return 0;
+}
+
+/*!	\brief Write events of one thread to trace file.
+	Events overwritten in ring buffer before or during export are skipped.
+	\returns number of events written.
+*/
+static int CZTraceExportBuffer(
+	FILE *fp,			/*!<[in,out] Trace file. */
+	int tid,			/*!<[in] Index of thread in trace file. */
+	struct CZTraceBuffer *buffer,	/*!<[in] Buffer of thread. */
+	struct CZTraceEvent *events	/*!<[out] Temporary space for #CZ_TRACE_EVENTS_MAX events. */
+) {
+	unsigned int head;
+	unsigned int first;
+	unsigned int last;
+	unsigned int i;
+	int num = 0;
+
+	fprintf(fp, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+		tid, buffer->name);
+
+	head = buffer->head;
+	CZTraceBarrier();
+	first = (head > CZ_TRACE_EVENTS_MAX)? head - CZ_TRACE_EVENTS_MAX: 0;
+	for(i = first; i != head; i++)
+		events[i & (CZ_TRACE_EVENTS_MAX - 1)] = buffer->events[i & (CZ_TRACE_EVENTS_MAX - 1)];
+	CZTraceBarrier();
+
+	/* Events up to last are overwritten, and event last itself may be
+	being written into slot of event last - CZ_TRACE_EVENTS_MAX. */
+	last = buffer->head;
+	if(last - first >= CZ_TRACE_EVENTS_MAX)
+		first = last - CZ_TRACE_EVENTS_MAX + 1;
+	if(first > head)
+		first = head;
+	if(first > 0)
+		CZLog(CZLogLevelWarning, "Trace of %s lost %u events.", buffer->name, first);
+
+	for(i = first; i != head; i++) {
+		const struct CZTraceEvent *event = &events[i & (CZ_TRACE_EVENTS_MAX - 1)];
+
+		if((event->phase < 0) || (event->phase >= CZTracePhaseMax))
+			continue;
+
+		fprintf(fp, ",\n{\"name\": \"%s\", \"cat\": \"cuda-z\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d, \"args\": {\"device\": %d",
+			s_phaseNames[event->phase],
+			(event->startMs - s_originMs) * 1000.0, event->durationMs * 1000.0,
+			tid, event->device);
+		if(event->arg >= 0) {
+			if(event->phase == CZTracePhaseTask)
+				fprintf(fp, ", \"task\": %d", event->arg);
+			else if(event->phase >= CZTracePhaseTest)
+				fprintf(fp, ", \"metric\": \"%s\"", CZMetricName(event->arg));
+		}
+		fprintf(fp, "}}");
+		num++;
+	}
+
+	return num;
+}
+
+/*!	\brief Stop tracing and write all recorded events to trace file.
+*/
+void CZTraceClose(void) {
+	struct CZTraceEvent *events;
+	FILE *fp;
+	int buffersNum;
+	int num = 0;
+	int i;
+
+	if(!s_traceOn)
+		return;
+	s_traceOn = 0;
+	CZTraceBarrier();
+
+	fp = fopen(s_fileName, "w");
+	if(fp == NULL) {
+		CZLog(CZLogLevelError, "Can't write trace file %s!", s_fileName);
+		return;
+	}
+
+	events = (struct CZTraceEvent*)malloc(CZ_TRACE_EVENTS_MAX * sizeof(events[0]));
+	if(events == NULL) {
+		fclose(fp);
+		return;
+	}
+
+	fprintf(fp, "{\"traceEvents\": [\n");
+	fprintf(fp, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"CUDA-Z\"}}");
+
+	buffersNum = s_buffersNum;
+	if(buffersNum > CZ_TRACE_THREADS_MAX)
+		buffersNum = CZ_TRACE_THREADS_MAX;
+	for(i = 0; i < buffersNum; i++) {
+		if(s_buffers[i] != NULL)
+			num += CZTraceExportBuffer(fp, i, s_buffers[i], events);
+	}
+
+	fprintf(fp, "\n], \"displayTimeUnit\": \"ms\"}\n");
+	fclose(fp);
+	free(events);
+
+	CZLog(CZLogLevelModerate, "Trace of %d events written to %s.", num, s_fileName);
+}
+
+/*!	\brief Check if tracing is on.
+	\returns \a 1 if tracing is on, \a 0 otherwise.
+*/
+int CZTraceIsOn(void) {
+	return s_traceOn;
+}
+
+/*!	\brief Set name of current thread shown in trace.
+*/
+void CZTraceThreadName(
+	const char *name		/*!<[in] Name of thread. */
+) {
+	struct CZTraceBuffer *buffer;
+
+	if(!s_traceOn || (name == NULL))
+		return;
+
+	buffer = CZTraceThreadBuffer();
+	if(buffer == NULL)
+		return;
+
+	strncpy(buffer->name, name, sizeof(buffer->name) - 1);
+	buffer->name[sizeof(buffer->name) - 1] = '\0';
+}
+
+/*!	\brief Get start time of a span.
+	\returns current time, or \a 0 if tracing is off.
+*/
+double CZTraceStart(void) {
+	if(!s_traceOn)
+		return 0;
+	return CZTimerNow();
+}
+
+/*!	\brief Record span of work that started at \a startMs and ends now.
+	Spans started while tracing was off are not recorded.
+*/
+void CZTraceSpan(
+	int phase,			/*!<[in] Phase of work. See enum #CZTracePhase. */
+	int device,			/*!<[in] Index of device, \a -1 if not related to device. */
+	int arg,			/*!<[in] Metric of test or type of task, \a -1 if not used. */
+	double startMs			/*!<[in] Start time from CZTraceStart() or CZTimerNow(). */
+) {
+	struct CZTraceBuffer *buffer;
+	struct CZTraceEvent *event;
+	double endMs;
+
+	if(!s_traceOn || (startMs == 0))
+		return;
+
+	endMs = CZTimerNow();
+
+	buffer = CZTraceThreadBuffer();
+	if(buffer == NULL)
+		return;
+
+	event = &buffer->events[buffer->head & (CZ_TRACE_EVENTS_MAX - 1)];
+	event->startMs = startMs;
+	event->durationMs = endMs - startMs;
+	event->phase = phase;
+	event->device = device;
+	event->arg = arg;
+
+	CZTraceBarrier();
+	buffer->head++;
+}
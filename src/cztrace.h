@@ -0,0 +1,58 @@
+/*!	\file cztrace.h
+	\brief Low-overhead tracing definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_TRACE_H
+#define CZ_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_TRACE_EVENTS_MAX	16384			/*!< Number of events in ring buffer of one thread, must be power of two. */
+#define CZ_TRACE_THREADS_MAX	64			/*!< Maximal number of traced threads. */
+#define CZ_TRACE_NAME_LEN	32			/*!< Maximal length of thread name. */
+
+/*!	\brief Phases of work recorded in trace.
+*/
+typedef enum {
+	CZTracePhaseInfo = 0,		/*!< Reading of device information. */
+	CZTracePhasePrepare,		/*!< Preparation of device for tests. */
+	CZTracePhaseClean,		/*!< Cleaning of device after tests. */
+	CZTracePhaseWait,		/*!< Waiting of device thread for a task. */
+	CZTracePhaseTask,		/*!< Task of device thread. */
+	CZTracePhaseTest,		/*!< One test of metric. */
+	CZTracePhaseLoop,		/*!< One loop of test measured with events. */
+	CZTracePhaseAlloc,		/*!< Allocation of memory buffers. */
+	CZTracePhaseFree,		/*!< Release of memory buffers. */
+	CZTracePhaseCopy,		/*!< Memory copy call. */
+	CZTracePhaseLaunch,		/*!< Kernel launch call. */
+	CZTracePhaseSync,		/*!< Synchronization with device. */
+	CZTracePhaseMax,		/*!< Number of phases. */
+} CZTracePhase;
+
+/*!	\brief One traced event of fixed size.
+*/
+struct CZTraceEvent {
+	double		startMs;		/*!< Start time from CZTimerNow() in milliseconds. */
+	double		durationMs;		/*!< Duration in milliseconds. */
+	int		phase;			/*!< Phase of work. See enum #CZTracePhase. */
+	int		device;			/*!< Index of device, \a -1 if not related to device. */
+	int		arg;			/*!< Metric of test or type of task, \a -1 if not used. */
+};
+
+int CZTraceOpen(const char *fileName);
+void CZTraceClose(void);
+int CZTraceIsOn(void);
+void CZTraceThreadName(const char *name);
+double CZTraceStart(void);
+void CZTraceSpan(int phase, int device, int arg, double startMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_TRACE_H
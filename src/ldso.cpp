@@ -0,0 +1,462 @@
+/*!	\file ldso.cpp
+	\brief Linux shared library resolver source file.
+	Shared libraries are searched the same way as the dynamic linker does:
+	in \a LD_LIBRARY_PATH, in \a /etc/ld.so.cache, in directories of
+	\a /etc/ld.so.conf and its includes and in default directories.
+	All files are read in process, nothing is forked. For testing all
+	paths may be taken relative to a fixture root directory.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <glob.h>
+#include <link.h>
+#include <stdint.h>
+
+#include "log.h"
+#include "ldso.h"
+
+#define CZ_LD_SO_CACHE		"/etc/ld.so.cache"	/*!< ld.so cache file. */
+#define CZ_LD_SO_CONF		"/etc/ld.so.conf"	/*!< ld.so configuration file. */
+#define CZ_LD_SO_LINE_MAX	1024			/*!< ld.so configuration line length. */
+#define CZ_LD_SO_INCLUDE_MAX	8			/*!< Maximal depth of ld.so configuration includes. */
+
+#define CZ_LD_SO_CACHE_MAGIC_OLD	"ld.so-1.7.0"		/*!< Signature of old ld.so cache format. */
+#define CZ_LD_SO_CACHE_MAGIC_NEW	"glibc-ld.so.cache1.1"	/*!< Signature of new ld.so cache format. */
+#define CZ_LD_SO_CACHE_HEADER_OLD	16		/*!< Size of old format header. */
+#define CZ_LD_SO_CACHE_ENTRY_OLD	12		/*!< Size of old format entry. */
+#define CZ_LD_SO_CACHE_HEADER_NEW	48		/*!< Size of new format header. */
+#define CZ_LD_SO_CACHE_ENTRY_NEW	24		/*!< Size of new format entry. */
+#define CZ_LD_SO_CACHE_TYPE_MASK	0x00ff		/*!< Mask of library type in entry flags. */
+#define CZ_LD_SO_CACHE_ELF_LIBC6	0x0003		/*!< Library type of glibc libraries. */
+
+/*!	\def CZ_LD_SO_CACHE_ARCH
+	\brief Architecture flags of ld.so cache entries usable by this process.
+*/
+#if defined(__x86_64__) && defined(__ILP32__)
+#define CZ_LD_SO_CACHE_ARCH	0x0800
+#elif defined(__x86_64__)
+#define CZ_LD_SO_CACHE_ARCH	0x0300
+#elif defined(__aarch64__)
+#define CZ_LD_SO_CACHE_ARCH	0x0a00
+#elif defined(__powerpc64__)
+#define CZ_LD_SO_CACHE_ARCH	0x0500
+#else
+#define CZ_LD_SO_CACHE_ARCH	0x0000
+#endif
+
+/*!	\brief Default library directories. They are searched after
+	directories of ld.so configuration.
+*/
+static const char *s_ldSoDefaultDirs[] = {
+	"/lib64",
+	"/usr/lib64",
+	"/lib",
+	"/usr/lib",
+	"/usr/lib/nvidia-current",
+	"/usr/lib32",
+	"/usr/lib32/nvidia-current",
+	"/usr/lib64/nvidia-current",
+};
+
+static char s_ldSoRoot[CZ_LD_SO_PATH_LEN] = "";		/*!< Fixture root directory, empty for real system. */
+static bool s_ldSoRootSet = false;			/*!< Root directory was set. */
+
+/*!	\brief Found library paths.
+*/
+struct CZLdSoResult {
+	const char	*name;			/*!< Name of library. */
+	CZLdSoPath	*paths;			/*!< Found paths. */
+	int		num;			/*!< Number of found paths. */
+	int		max;			/*!< Size of \a paths array. */
+};
+
+/*!	\brief Set fixture root directory. All system files and directories
+	are taken relative to \a root.
+*/
+void CZLdSoSetRoot(
+	const char *root		/*!<[in] Root directory, \a NULL or empty for real system. */
+) {
+	s_ldSoRoot[0] = 0;
+	if(root != NULL)
+		strncpy(s_ldSoRoot, root, sizeof(s_ldSoRoot) - 1);
+
+	/* Trailing slash would give double slashes in paths. */
+	int len = strlen(s_ldSoRoot);
+	while((len > 0) && (s_ldSoRoot[len - 1] == '/'))
+		s_ldSoRoot[--len] = 0;
+
+	s_ldSoRootSet = true;
+}
+
+/*!	\brief Get fixture root directory. If it is not set yet, it is taken
+	from environment variable \a CZ_LD_SO_ROOT.
+	\returns root directory, empty string for real system.
+*/
+const char *CZLdSoRoot(void) {
+
+	if(!s_ldSoRootSet)
+		CZLdSoSetRoot(getenv(CZ_LD_SO_ROOT_ENV));
+
+	return s_ldSoRoot;
+}
+
+/*!	\brief Append library file to found paths if it exists.
+*/
+static void CZLdSoAddFile(
+	struct CZLdSoResult *res,	/*!<[in,out] Found paths. */
+	const char *dir,		/*!<[in] Directory relative to root, or \a NULL if \a file is full path. */
+	const char *file		/*!<[in] File name. */
+) {
+	CZLdSoPath path;
+	int len;
+
+	if(res->num >= res->max)
+		return;
+
+	if(dir != NULL)
+		len = snprintf(path, sizeof(path), "%s%s%s/%s", CZLdSoRoot(), (dir[0] == '/')? "": "/", dir, file);
+	else
+		len = snprintf(path, sizeof(path), "%s%s", CZLdSoRoot(), file);
+
+	/* Truncated path could name another file. */
+	if((len < 0) || (len >= (int)sizeof(path)) || (access(path, F_OK) != 0))
+		return;
+
+	for(int i = 0; i < res->num; i++) {
+		if(strcmp(res->paths[i], path) == 0)
+			return;
+	}
+
+	CZLog(CZLogLevelLow, "Found %s.", path);
+	strcpy(res->paths[res->num++], path);
+}
+
+/*!	\brief Search library in directory list of \a LD_LIBRARY_PATH.
+*/
+static void CZLdSoSearchEnv(
+	struct CZLdSoResult *res	/*!<[in,out] Found paths. */
+) {
+	const char *env = getenv("LD_LIBRARY_PATH");
+	char buf[CZ_LD_SO_LINE_MAX];
+	char *save = NULL;
+
+	if(env == NULL)
+		return;
+
+	strncpy(buf, env, sizeof(buf) - 1);
+	buf[sizeof(buf) - 1] = 0;
+
+	for(char *dir = strtok_r(buf, ":;", &save); dir != NULL; dir = strtok_r(NULL, ":;", &save))
+		CZLdSoAddFile(res, dir, res->name);
+}
+
+/*!	\brief Read unsigned 32-bit value from ld.so cache data.
+*/
+static uint32_t CZLdSoGet32(
+	const unsigned char *data,	/*!<[in] Cache data. */
+	long offset			/*!<[in] Offset of value. */
+) {
+	uint32_t value;
+	memcpy(&value, data + offset, sizeof(value));
+	return value;
+}
+
+/*!	\brief Append library from ld.so cache entry if its name and
+	architecture match.
+*/
+static void CZLdSoCacheEntry(
+	struct CZLdSoResult *res,	/*!<[in,out] Found paths. */
+	const unsigned char *data,	/*!<[in] Cache data. */
+	long size,			/*!<[in] Size of cache data. */
+	long strings,			/*!<[in] Offset of string table. */
+	int flags,			/*!<[in] Entry flags. */
+	uint32_t key,			/*!<[in] Offset of library name in string table. */
+	uint32_t value			/*!<[in] Offset of library path in string table. */
+) {
+	if((flags & CZ_LD_SO_CACHE_TYPE_MASK) != CZ_LD_SO_CACHE_ELF_LIBC6)
+		return;
+
+	if((CZ_LD_SO_CACHE_ARCH != 0) && ((flags & ~CZ_LD_SO_CACHE_TYPE_MASK) != CZ_LD_SO_CACHE_ARCH))
+		return;
+
+	if((strings + key >= size) || (strings + value >= size))
+		return;
+
+	/* The whole file is zero terminated by CZLdSoSearchCache(). */
+	if(strcmp((const char*)data + strings + key, res->name) == 0)
+		CZLdSoAddFile(res, NULL, (const char*)data + strings + value);
+}
+
+/*!	\brief Search library in \a /etc/ld.so.cache. Both old format and new
+	format of glibc are supported.
+*/
+static void CZLdSoSearchCache(
+	struct CZLdSoResult *res	/*!<[in,out] Found paths. */
+) {
+	CZLdSoPath fileName;
+	unsigned char *data;
+	long size;
+	long offset = 0;
+	FILE *fp;
+
+	if(snprintf(fileName, sizeof(fileName), "%s%s", CZLdSoRoot(), CZ_LD_SO_CACHE) >= (int)sizeof(fileName))
+		return;
+
+	fp = fopen(fileName, "rb");
+	if(fp == NULL)
+		return;
+
+	fseek(fp, 0, SEEK_END);
+	size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	data = (size > 0)? (unsigned char*)malloc(size + 1): NULL;
+	if((data == NULL) || (fread(data, 1, size, fp) != (size_t)size)) {
+		CZLog(CZLogLevelWarning, "Can't read %s.", fileName);
+		free(data);
+		fclose(fp);
+		return;
+	}
+	data[size] = 0;
+	fclose(fp);
+
+	if((size >= CZ_LD_SO_CACHE_HEADER_OLD) &&
+		(memcmp(data, CZ_LD_SO_CACHE_MAGIC_OLD, strlen(CZ_LD_SO_CACHE_MAGIC_OLD)) == 0)) {
+		long nlibs = CZLdSoGet32(data, 12);
+		long strings = CZ_LD_SO_CACHE_HEADER_OLD + nlibs * CZ_LD_SO_CACHE_ENTRY_OLD;
+
+		if((nlibs < 0) || (strings > size)) {
+			free(data);
+			return;
+		}
+
+		/* New format may follow old one aligned to 8 bytes. */
+		offset = (strings + 7) & ~7L;
+		if((offset + CZ_LD_SO_CACHE_HEADER_NEW > size) ||
+			(memcmp(data + offset, CZ_LD_SO_CACHE_MAGIC_NEW, strlen(CZ_LD_SO_CACHE_MAGIC_NEW)) != 0)) {
+			for(long i = 0; i < nlibs; i++) {
+				long entry = CZ_LD_SO_CACHE_HEADER_OLD + i * CZ_LD_SO_CACHE_ENTRY_OLD;
+				CZLdSoCacheEntry(res, data, size, strings, (int)CZLdSoGet32(data, entry),
+					CZLdSoGet32(data, entry + 4), CZLdSoGet32(data, entry + 8));
+			}
+			free(data);
+			return;
+		}
+	}
+
+	if((offset + CZ_LD_SO_CACHE_HEADER_NEW <= size) &&
+		(memcmp(data + offset, CZ_LD_SO_CACHE_MAGIC_NEW, strlen(CZ_LD_SO_CACHE_MAGIC_NEW)) == 0)) {
+		long nlibs = CZLdSoGet32(data, offset + 20);
+
+		if((nlibs >= 0) && (offset + CZ_LD_SO_CACHE_HEADER_NEW + nlibs * CZ_LD_SO_CACHE_ENTRY_NEW <= size)) {
+			for(long i = 0; i < nlibs; i++) {
+				long entry = offset + CZ_LD_SO_CACHE_HEADER_NEW + i * CZ_LD_SO_CACHE_ENTRY_NEW;
+				CZLdSoCacheEntry(res, data, size, offset, (int)CZLdSoGet32(data, entry),
+					CZLdSoGet32(data, entry + 4), CZLdSoGet32(data, entry + 8));
+			}
+		}
+	} else {
+		CZLog(CZLogLevelLow, "Unknown format of %s.", fileName);
+	}
+
+	free(data);
+}
+
+static void CZLdSoSearchConf(struct CZLdSoResult *res, const char *confName, int depth);
+
+/*!	\brief Search library in configuration files matching \a pattern
+	of ld.so configuration \a include statement.
+*/
+static void CZLdSoSearchInclude(
+	struct CZLdSoResult *res,	/*!<[in,out] Found paths. */
+	const char *confName,		/*!<[in] Configuration file with include statement, relative to root. */
+	const char *pattern,		/*!<[in] File name pattern. */
+	int depth			/*!<[in] Depth of includes. */
+) {
+	CZLdSoPath path;
+	glob_t files;
+	int rootLen = strlen(CZLdSoRoot());
+
+	int len;
+
+	if(pattern[0] == '/') {
+		len = snprintf(path, sizeof(path), "%s%s", CZLdSoRoot(), pattern);
+	} else {
+		const char *p = strrchr(confName, '/');
+		int dirLen = (p == NULL)? 0: (int)(p - confName);
+		len = snprintf(path, sizeof(path), "%s%.*s/%s", CZLdSoRoot(), dirLen, confName, pattern);
+	}
+	if(len >= (int)sizeof(path))
+		return;
+
+	/* Files are sorted by glob(), so the order does not depend on file system. */
+	if(glob(path, 0, NULL, &files) != 0)
+		return;
+
+	for(size_t i = 0; i < files.gl_pathc; i++)
+		CZLdSoSearchConf(res, files.gl_pathv[i] + rootLen, depth + 1);
+
+	globfree(&files);
+}
+
+/*!	\brief Search library in directories of ld.so configuration file.
+*/
+static void CZLdSoSearchConf(
+	struct CZLdSoResult *res,	/*!<[in,out] Found paths. */
+	const char *confName,		/*!<[in] Configuration file, relative to root. */
+	int depth			/*!<[in] Depth of includes. */
+) {
+	CZLdSoPath fileName;
+	char line[CZ_LD_SO_LINE_MAX];
+	FILE *fp;
+
+	if(depth > CZ_LD_SO_INCLUDE_MAX) {
+		CZLog(CZLogLevelWarning, "Too deep includes in %s.", confName);
+		return;
+	}
+
+	if(snprintf(fileName, sizeof(fileName), "%s%s", CZLdSoRoot(), confName) >= (int)sizeof(fileName))
+		return;
+
+	fp = fopen(fileName, "r");
+	if(fp == NULL)
+		return;
+
+	while(fgets(line, sizeof(line), fp) != NULL) {
+		char *save = NULL;
+		char *p;
+
+		if((p = strchr(line, '#')) != NULL)
+			*p = 0;
+
+		p = strtok_r(line, " \t\r\n", &save);
+		if(p == NULL)
+			continue;
+
+		if(strcmp(p, "include") == 0) {
+			while((p = strtok_r(NULL, " \t\r\n", &save)) != NULL)
+				CZLdSoSearchInclude(res, confName, p, depth);
+		} else if(strcmp(p, "hwcap") == 0) {
+			continue;
+		} else {
+			do {
+				/* Old configurations may separate directories with commas or colons. */
+				char *saveDir = NULL;
+				for(char *dir = strtok_r(p, ",:=", &saveDir); dir != NULL; dir = strtok_r(NULL, ",:=", &saveDir)) {
+					if(dir[0] == '/')
+						CZLdSoAddFile(res, dir, res->name);
+				}
+			} while((p = strtok_r(NULL, " \t\r\n", &save)) != NULL);
+		}
+	}
+
+	fclose(fp);
+}
+
+/*!	\brief Find shared library.
+	Paths are returned in the order of \a LD_LIBRARY_PATH, \a /etc/ld.so.cache,
+	\a /etc/ld.so.conf and default directories. Only existing files are
+	returned. If fixture root directory is set, paths begin with it.
+	\returns number of found paths.
+*/
+int CZLdSoFind(
+	const char *name,		/*!<[in] Library file name, e.g. "libcuda.so.1". */
+	CZLdSoPath *paths,		/*!<[out] Found paths. */
+	int num				/*!<[in] Size of \a paths array. */
+) {
+	struct CZLdSoResult res;
+
+	res.name = name;
+	res.paths = paths;
+	res.num = 0;
+	res.max = num;
+
+	CZLdSoSearchEnv(&res);
+	CZLdSoSearchCache(&res);
+	CZLdSoSearchConf(&res, CZ_LD_SO_CONF, 0);
+
+	for(unsigned int i = 0; i < sizeof(s_ldSoDefaultDirs) / sizeof(s_ldSoDefaultDirs[0]); i++)
+		CZLdSoAddFile(&res, s_ldSoDefaultDirs[i], name);
+
+	return res.num;
+}
+
+/*!	\brief Search state of CZLdSoLoaded().
+*/
+struct CZLdSoLoadedSearch {
+	const char	*name;			/*!< Name of library. */
+	char		*path;			/*!< Path of loaded library. */
+	int		size;			/*!< Size of \a path buffer. */
+	int		found;			/*!< Library is found. */
+};
+
+/*!	\brief Check one loaded object. Called by \a dl_iterate_phdr().
+	\returns \a 1 to stop iteration if library is found.
+*/
+static int CZLdSoLoadedCheck(
+	struct dl_phdr_info *info,	/*!<[in] Loaded object. */
+	size_t size,			/*!<[in] Size of \a info. */
+	void *data			/*!<[in,out] Search state. */
+) {
+	struct CZLdSoLoadedSearch *search = (struct CZLdSoLoadedSearch*)data;
+	const char *base;
+	int len = strlen(search->name);
+
+	(void)size;
+
+	if((info->dlpi_name == NULL) || (info->dlpi_name[0] == 0))
+		return 0;
+
+	base = strrchr(info->dlpi_name, '/');
+	base = (base == NULL)? info->dlpi_name: base + 1;
+
+	if((strncmp(base, search->name, len) != 0) || ((base[len] != '.') && (base[len] != 0)))
+		return 0;
+
+	strncpy(search->path, info->dlpi_name, search->size - 1);
+	search->path[search->size - 1] = 0;
+	search->found = 1;
+	return 1;
+}
+
+/*!	\brief Find path of shared library loaded by this process.
+	Symbolic links are resolved, so file name of \a path usually
+	includes full library version.
+	\returns \a 0 in case of success, \a -1 if library is not loaded.
+*/
+int CZLdSoLoaded(
+	const char *name,		/*!<[in] Library file name without version, e.g. "libcuda.so". */
+	char *path,			/*!<[out] Path of library. */
+	int size			/*!<[in] Size of \a path buffer. */
+) {
+	struct CZLdSoLoadedSearch search;
+	char realPath[PATH_MAX];
+
+	search.name = name;
+	search.path = path;
+	search.size = size;
+	search.found = 0;
+
+	dl_iterate_phdr(CZLdSoLoadedCheck, &search);
+
+	if(!search.found)
+		return -1;
+
+	if(realpath(path, realPath) != NULL) {
+		strncpy(path, realPath, size - 1);
+		path[size - 1] = 0;
+	}
+
+	return 0;
+}
@@ -0,0 +1,32 @@
+/*!	\file ldso.h
+	\brief Linux shared library resolver definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_LDSO_H
+#define CZ_LDSO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CZ_LD_SO_PATH_LEN	1024			/*!< Maximal length of library path. */
+#define CZ_LD_SO_FIND_MAX	32			/*!< Maximal number of found library paths. */
+#define CZ_LD_SO_ROOT_ENV	"CZ_LD_SO_ROOT"		/*!< Environment variable setting fixture root directory. */
+
+/*!	\brief Path of shared library.
+*/
+typedef char CZLdSoPath[CZ_LD_SO_PATH_LEN];
+
+void CZLdSoSetRoot(const char *root);
+const char *CZLdSoRoot(void);
+int CZLdSoFind(const char *name, CZLdSoPath *paths, int num);
+int CZLdSoLoaded(const char *name, char *path, int size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//CZ_LDSO_H
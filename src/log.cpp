@@ -3,16 +3,22 @@
 	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
 	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
 	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+	Without Qt messages are written to standard error stream, so the core
+	modules can be built and used without Qt.
 */
 
+#ifdef QT_CORE_LIB
 #include <QString>
+#endif
 
 #include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #include "log.h"
 
 #define CZ_LOG_BUFFER_LENGTH		4096	/*!< Log bufer size. */
-#ifdef QT_NO_DEBUG
+#if defined(QT_NO_DEBUG) || defined(NDEBUG)
 #define CZ_LOG_DEFAULT_LEVEL		CZLogLevelHigh	/*!< Default logging level. */
 #else
 #define CZ_LOG_DEFAULT_LEVEL		CZLogLevelLow	/*!< Default logging level. */
@@ -33,39 +39,13 @@ int CZLogSetVerbosityLevel(
 	return oldVerbosityLevel;
 }
 
-/*!	\brief C-like logging function.
-*/
-void CZLog(
-	CZLogLevel level,		/*!<[in] Log level value. */
-	const char *fmt,		/*!<[in] printf()-like format string. */
-	...				/* Additional arguments for printout. */
-) {
-	QString text;
-
-	if(level > s_verbosityLevel) {
-		return;
-	}
-
-	va_list ap;
-	va_start(ap, fmt);
-	if(fmt)
-		text.vsprintf(fmt, ap);
-	va_end(ap);
-
-	CZLog(level, text);
-}
-
-/*!	\brief C++ logging function.
+/*!	\brief Write logging message to Qt message handler or to standard error.
 */
-void CZLog(
+static void CZLogOutput(
 	CZLogLevel level,		/*!<[in] Log level value. */
-	QString text			/*!<[in] Qt string. */
+	const char *text		/*!<[in] Message text. */
 ) {
-
-	if(level > s_verbosityLevel) {
-		return;
-	}
-
+#ifdef QT_CORE_LIB
 	QtMsgType type;
 	switch(level) {
 	case CZLogLevelFatal:
@@ -83,9 +63,38 @@ void CZLog(
 	}
 
 #if QT_VERSION < 0x050000
-	qt_message_output(type, text.toLocal8Bit().constData());
+	qt_message_output(type, text);
 #else
 	QMessageLogContext context;
-	qt_message_output(type, context, text.toLocal8Bit().constData());
+	qt_message_output(type, context, text);
 #endif//QT_VERSION
+#else
+	fprintf(stderr, "%s\n", text);
+	if(level == CZLogLevelFatal)
+		abort();
+#endif//QT_CORE_LIB
+}
+
+/*!	\brief C-like logging function.
+*/
+void CZLog(
+	CZLogLevel level,		/*!<[in] Log level value. */
+	const char *fmt,		/*!<[in] printf()-like format string. */
+	...				/* Additional arguments for printout. */
+) {
+	char text[CZ_LOG_BUFFER_LENGTH];
+
+	if(level > s_verbosityLevel) {
+		return;
+	}
+
+	text[0] = '\0';
+
+	va_list ap;
+	va_start(ap, fmt);
+	if(fmt)
+		vsnprintf(text, sizeof(text), fmt, ap);
+	va_end(ap);
+
+	CZLogOutput(level, text);
 }
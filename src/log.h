@@ -8,8 +8,11 @@
 #ifndef CZ_LOG_H
 #define CZ_LOG_H
 
-#ifdef __cplusplus
+#if defined(__cplusplus) && defined(QT_CORE_LIB)
 #include <QString>
+#endif
+
+#ifdef __cplusplus
 extern "C" {
 #endif
 
@@ -26,15 +29,26 @@ typedef enum {
 
 int CZLogSetVerbosityLevel(int newVerbosityLevel);
 void CZLog(CZLogLevel level, const char *fmt, ...)
-#if defined(Q_CC_GNU) && !defined(__INSURE__)
+#if (defined(Q_CC_GNU) || defined(__GNUC__)) && !defined(__INSURE__)
 	__attribute__ ((format (printf, 2, 3)))
 #endif
 ;
 
 #ifdef __cplusplus
 }
+#endif
 
-void CZLog(CZLogLevel level, QString text);
+#if defined(__cplusplus) && defined(QT_CORE_LIB)
+/*!	\brief C++ logging function.
+	Core library is built without Qt, so this wrapper is compiled
+	into application sources.
+*/
+inline void CZLog(
+	CZLogLevel level,		/*!<[in] Log level value. */
+	const QString &text		/*!<[in] Qt string. */
+) {
+	CZLog(level, "%s", text.toLocal8Bit().constData());
+}
 #endif
 
 #endif//CZ_LOG_H
@@ -5,16 +5,29 @@
 	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
 */
 
+#ifdef CZ_CLI_ONLY
+#include <QCoreApplication>
+#else
 #include <QApplication>
 #include <QMessageBox>
+#endif
 #include <QString>
 #include <QDebug>
 
 #include "log.h"
+#ifndef CZ_CLI_ONLY
 #include "czdialog.h"
+#endif
 #include "cudainfo.h"
 #include "version.h"
 #include "czcommandline.h"
+#include "cztimer.h"
+#include "czbackend.h"
+#include "czsim.h"
+#include "czsession.h"
+#include "czcache.h"
+#include "czhistory.h"
+#include "cztrace.h"
 
 /*!	\brief Call function that checks CUDA presents.
 */
@@ -47,7 +60,7 @@ int getCudaDeviceNum() {
 	return res;
 }
 
-#ifdef Q_OS_WIN
+#if defined(Q_OS_WIN) && !defined(CZ_CLI_ONLY)
 #include <Windows.h>
 /*!	\brief Sleep function.
 */
@@ -98,16 +111,23 @@ static void check_open_windows_console(
 */
 static int main_cli(
 	int argc,		/*!<[in] Count of command line arguments. */
-	char *argv[]		/*!<[in] List of command line arguments. */
+	char *argv[],		/*!<[in] List of command line arguments. */
+	bool offline		/*!<[in] Work on files only, CUDA is not needed. */
 ) {
 	QCoreApplication app(argc, argv);
 
+	if(offline) {
+		CZCommandLine cli(argc, argv);
+		return cli.exec();
+	}
+
 	CZLog(CZLogLevelLow, QObject::tr("Checking CUDA ..."));
 	if(!testCudaPresent()) {
 		CZLog(CZLogLevelError, QObject::tr("CUDA not found!"));
 		CZLog(CZLogLevelHigh, QObject::tr("Please update your NVIDIA driver and try again"));
 		return 1;
 	}
+	CZTimerPhase("driver");
 
 	int devs = getCudaDeviceNum();
 	if(devs == 0) {
@@ -117,11 +137,13 @@ static int main_cli(
 	}
 
 	CZLog(CZLogLevelLow, QObject::tr("Found %1 CUDA Device(s) ...").arg(devs));
+	CZTimerPhase("enumeration");
 
 	CZCommandLine cli(argc, argv);
 	return cli.exec();
 }
 
+#ifndef CZ_CLI_ONLY
 /*!	\brief Main initialization function for GUI mode.
 */
 static int main_gui(
@@ -153,6 +175,7 @@ static int main_gui(
 		delete splash;
 		exit(1);
 	}
+	CZTimerPhase("driver");
 
 //	sleep(5);
 
@@ -169,6 +192,7 @@ static int main_gui(
 	splash->showMessage(QObject::tr("Found %1 CUDA Device(s) ...").arg(devs),
 		Qt::AlignLeft | Qt::AlignBottom);
 	app.processEvents();
+	CZTimerPhase("enumeration");
 
 //	sleep(5);
 
@@ -176,6 +200,8 @@ static int main_gui(
 	CZDialog window;
 	window.show(); 
 	splash->finish(&window);
+	CZTimerPhase("window");
+	CZTimerPhaseLog();
 
 	app.connect(&app, SIGNAL(lastWindowClosed()), &app, SLOT(quit()));
 
@@ -184,6 +210,7 @@ static int main_gui(
 
 	CZLog(CZLogLevelLow, QObject::tr("CUDA-Z Stopped!"));
 }
+#endif//CZ_CLI_ONLY
 
 /*!	\brief Main initialization function.
 */
@@ -191,19 +218,92 @@ int main(
 	int argc,		/*!<[in] Count of command line arguments. */
 	char *argv[]		/*!<[in] List of command line arguments. */
 ) {
+#ifdef CZ_CLI_ONLY
+	bool runAsCli = true;
+#else
 	bool runAsCli = false;
+#endif
+	CZTimerPhase("start");
 	bool runVerbose = false;
+	const char *backendName = NULL;
+	const char *simConfig = NULL;
+	const char *recordName = NULL;
+	const char *replayName = NULL;
+	const char *cacheName = NULL;
+	bool useCache = true;
+	const char *historyName = NULL;
+	bool useHistory = true;
+	bool runOffline = false;
+	const char *traceName = NULL;
+	int res;
 
 	for(int i = 1; i < argc; i++) {
 		if(QString(argv[i]) == "-cli")
 			runAsCli = true;
 		if(QString(argv[i]) == "-verbose")
 			runVerbose = true;
+		if((QString(argv[i]) == "-backend") && ((i + 1) < argc))
+			backendName = argv[i + 1];
+		if((QString(argv[i]) == "-simconfig") && ((i + 1) < argc))
+			simConfig = argv[i + 1];
+		if((QString(argv[i]) == "-record") && ((i + 1) < argc))
+			recordName = argv[i + 1];
+		if((QString(argv[i]) == "-replay") && ((i + 1) < argc))
+			replayName = argv[i + 1];
+		if((QString(argv[i]) == "-cache") && ((i + 1) < argc))
+			cacheName = argv[i + 1];
+		if(QString(argv[i]) == "-nocache")
+			useCache = false;
+		if((QString(argv[i]) == "-history") && ((i + 1) < argc))
+			historyName = argv[i + 1];
+		if(QString(argv[i]) == "-nohistory")
+			useHistory = false;
+		if(QString(argv[i]) == "-merge") {
+			/* Merge of reports has no GUI. */
+			runAsCli = true;
+			runOffline = true;
+		}
+		if((QString(argv[i]) == "-trace") && ((i + 1) < argc))
+			traceName = argv[i + 1];
 	}
 
 	if(runVerbose)
 		CZLogSetVerbosityLevel(CZLogLevelLow);
 
-	return runAsCli? main_cli(argc, argv): main_gui(argc, argv);
+	if((backendName != NULL) && (CZBackendSelect(backendName) != 0))
+		return 1;
+
+	if((simConfig != NULL) && (CZSimConfigure(simConfig) != 0))
+		return 1;
+
+	if((replayName != NULL) && (CZSessionReplayOpen(replayName) != 0))
+		return 1;
+
+	if((recordName != NULL) && (CZSessionRecordStart(recordName) != 0))
+		return 1;
+
+	if(useCache)
+		CZCacheOpen(cacheName);
+
+	/* Simulated and replayed results must not mix with results of real
+	devices, so like the cache history needs backend identifying them. */
+	if(useHistory && (CZBackendGet()->readDeviceKey != NULL))
+		CZHistoryOpen(historyName);
+
+	if(traceName != NULL)
+		CZTraceOpen(traceName);
+
+#ifdef CZ_CLI_ONLY
+	(void)runAsCli;
+	res = main_cli(argc, argv, runOffline);
+#else
+	res = runAsCli? main_cli(argc, argv, runOffline): main_gui(argc, argv);
+#endif
+
+	CZTraceClose();
+	CZHistoryClose();
+	CZCacheClose();
+	CZSessionRecordStop();
+	return res;
 }
 
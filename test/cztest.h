@@ -0,0 +1,57 @@
+/*!	\file cztest.h
+	\brief Test checks definitions header.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#ifndef CZ_TEST_H
+#define CZ_TEST_H
+
+#include <stdio.h>
+#include <string.h>
+
+static int s_czTestFailed = 0;		/*!< Number of failed checks. */
+
+/*!	\brief Check condition, report it and count it as failed if it is false.
+*/
+#define CZ_TEST_CHECK(cond) \
+	do { \
+		if(!(cond)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			s_czTestFailed++; \
+		} \
+	} while(0)
+
+/*!	\brief Check two integer values are equal.
+*/
+#define CZ_TEST_EQUAL(actual, expected) \
+	do { \
+		long long czActual = (long long)(actual); \
+		long long czExpected = (long long)(expected); \
+		if(czActual != czExpected) { \
+			fprintf(stderr, "%s:%d: check failed: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, czActual, czExpected); \
+			s_czTestFailed++; \
+		} \
+	} while(0)
+
+/*!	\brief Check two strings are equal.
+*/
+#define CZ_TEST_STRING(actual, expected) \
+	do { \
+		const char *czActual = (actual); \
+		const char *czExpected = (expected); \
+		if((czActual == NULL) || (strcmp(czActual, czExpected) != 0)) { \
+			fprintf(stderr, "%s:%d: check failed: %s is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, #actual, (czActual == NULL)? "(null)": czActual, czExpected); \
+			s_czTestFailed++; \
+		} \
+	} while(0)
+
+/*!	\brief Report result of test and get exit code of test application.
+*/
+#define CZ_TEST_RESULT(name) \
+	((s_czTestFailed == 0)? \
+		(printf("%s: passed\n", (name)), 0): \
+		(printf("%s: %d check(s) failed\n", (name), s_czTestFailed), 1))
+
+#endif//CZ_TEST_H
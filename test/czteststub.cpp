@@ -0,0 +1,35 @@
+/*!	\file czteststub.cpp
+	\brief Stub of CUDA backend for tests.
+	Tests are built without CUDA toolkit, so CUDA backend finds no devices
+	and tests select simulated backend.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdlib.h>
+
+#include "czbackend.h"
+
+/*!	\brief Check if CUDA is present here.
+	\returns always \a false.
+*/
+static bool CZTestStubCheck(void) {
+	return false;
+}
+
+/*!	\brief Check how many CUDA-devices are present.
+	\returns always \a 0.
+*/
+static int CZTestStubDeviceFound(void) {
+	return 0;
+}
+
+/*!	\brief Stub CUDA backend without devices.
+*/
+const struct CZBackend CZBackendCuda = {
+	"cuda",
+	CZTestStubCheck,
+	CZTestStubDeviceFound,
+	NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+};
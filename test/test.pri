@@ -0,0 +1,48 @@
+#	\file test.pri
+#	\brief CUDA-Z test common project include file.
+#	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+#	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+#	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+
+#
+# Every test is console application built from plain C sources of core
+# library. CUDA backend is replaced by stub reporting no devices (see
+# czteststub.cpp), so tests select simulated backend or read fixtures.
+#
+
+TEMPLATE = app
+CONFIG -= qt app_bundle
+CONFIG += console warn_on testcase
+CONFIG += debug
+
+CZ_SOURCE_DIR = $$PWD/..
+CZ_TEST_DIR = $$PWD
+CZ_TEST_DATA_DIR = $$PWD/data
+
+INCLUDEPATH += $$CZ_SOURCE_DIR/src
+INCLUDEPATH += $$CZ_TEST_DIR
+DEFINES += CZ_TEST_DATA_DIR=\\\"$$CZ_TEST_DATA_DIR\\\"
+
+HEADERS += $$CZ_TEST_DIR/cztest.h
+SOURCES += $$CZ_TEST_DIR/czteststub.cpp
+SOURCES += $$CZ_SOURCE_DIR/src/log.cpp \
+	$$CZ_SOURCE_DIR/src/cudaarch.cpp \
+	$$CZ_SOURCE_DIR/src/cztimer.cpp \
+	$$CZ_SOURCE_DIR/src/czstat.cpp \
+	$$CZ_SOURCE_DIR/src/czbackend.cpp \
+	$$CZ_SOURCE_DIR/src/czsim.cpp \
+	$$CZ_SOURCE_DIR/src/czsession.cpp \
+	$$CZ_SOURCE_DIR/src/czasync.cpp \
+	$$CZ_SOURCE_DIR/src/czcache.cpp \
+	$$CZ_SOURCE_DIR/src/czhistory.cpp \
+	$$CZ_SOURCE_DIR/src/czfleet.cpp \
+	$$CZ_SOURCE_DIR/src/cztrace.cpp \
+	$$CZ_SOURCE_DIR/src/czhealth.cpp \
+	$$CZ_SOURCE_DIR/src/czreport.cpp \
+	$$CZ_SOURCE_DIR/src/czmerge.cpp
+linux:SOURCES += $$CZ_SOURCE_DIR/src/ldso.cpp
+
+unix:LIBS += -lpthread
+linux:LIBS += -ldl
+
+OBJECTS_DIR = bld/o
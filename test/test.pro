@@ -0,0 +1,15 @@
+#	\file test.pro
+#	\brief CUDA-Z tests project file.
+#	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+#	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+#	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+
+#
+# Tests of plain C core modules. They run on simulated backend and fixture
+# files, so neither CUDA toolkit nor CUDA device is needed. Build and run:
+#	qmake test.pro && make && make check
+#
+
+TEMPLATE = subdirs
+SUBDIRS += tst_arch tst_async tst_merge
+linux:SUBDIRS += tst_ldso
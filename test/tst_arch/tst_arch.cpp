@@ -0,0 +1,175 @@
+/*!	\file tst_arch.cpp
+	\brief Architecture database and theoretical peaks test.
+	Tesla K20X (3.5), GeForce GTX 1080 (6.1) and GeForce RTX 3080 (8.6)
+	are described by their reference clocks and memory buses. Expected
+	peaks are computed here from published per-multiprocessor rates.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "cztest.h"
+#include "log.h"
+#include "cudaarch.h"
+
+#define CZ_TEST_ARCH_PCIE3	(16 * 8.0e9 * 128 / 130 / 8 / 1024)	/*!< PCI Express 3.0 x16 in KiB/s. */
+#define CZ_TEST_ARCH_PCIE4	(16 * 16.0e9 * 128 / 130 / 8 / 1024)	/*!< PCI Express 4.0 x16 in KiB/s. */
+
+/*!	\brief Check if two values are equal within relative \a 1e-6.
+*/
+static bool CZTestArchNear(
+	double actual,			/*!<[in] Actual value. */
+	double expected			/*!<[in] Expected value. */
+) {
+	return fabs(actual - expected) <= 1e-6 * fabs(expected);
+}
+
+/*!	\brief Fill device information of given compute capability and clocks.
+*/
+static void CZTestArchDevice(
+	struct CZDeviceInfo *info,	/*!<[out] CUDA-device information. */
+	int major,			/*!<[in] Major revision of compute capability. */
+	int minor,			/*!<[in] Minor revision of compute capability. */
+	int mpNum,			/*!<[in] Number of multiprocessors. */
+	int clockRate,			/*!<[in] Core clock in kHz. */
+	int memoryClockRate,		/*!<[in] Memory clock in kHz. */
+	int memoryBusWidth		/*!<[in] Memory bus width in bits. */
+) {
+	memset(info, 0, sizeof(*info));
+	info->major = major;
+	info->minor = minor;
+	info->core.muliProcCount = mpNum;
+	info->core.clockRate = clockRate;
+	info->mem.memoryClockRate = memoryClockRate;
+	info->mem.memoryBusWidth = memoryBusWidth;
+}
+
+/*!	\brief Device memory copy peak in KiB/s. Every byte is read and written.
+*/
+static double CZTestArchCopyDD(
+	const struct CZDeviceInfo *info	/*!<[in] CUDA-device information. */
+) {
+	return (double)info->mem.memoryClockRate * 1000 * 2 * info->mem.memoryBusWidth / 8 / 2 / 1024;
+}
+
+/*!	\brief Calculation peak in KOPS, multiply-add is two operations.
+*/
+static double CZTestArchCalc(
+	const struct CZDeviceInfo *info,	/*!<[in] CUDA-device information. */
+	double opsPerClock		/*!<[in] Throughput per clock per multiprocessor. */
+) {
+	return 2 * opsPerClock * info->core.muliProcCount * (double)info->core.clockRate;
+}
+
+/*!	\brief Kepler GK110: 192 cores, full rate 1/3 double precision.
+*/
+static void CZTestArchKepler(void) {
+	struct CZDeviceInfo info;
+
+	CZ_TEST_STRING(CZArchName(3, 5), "Kepler");
+	CZ_TEST_EQUAL(CZArchCoresPerMP(3, 5), 192);
+
+	CZTestArchDevice(&info, 3, 5, 14, 732000, 2600000, 384);
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCalcFloat), CZTestArchCalc(&info, 192)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCalcDouble), CZTestArchCalc(&info, 64)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCalcInteger32), CZTestArchCalc(&info, 32)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCalcInteger24), CZTestArchCalc(&info, 32)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCalcInteger64), CZTestArchCalc(&info, 8)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCopyDD), CZTestArchCopyDD(&info)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCopyHDPin), CZ_TEST_ARCH_PCIE3));
+
+	/* 3.94 TFLOPS of single precision, 250 GB/s of memory. */
+	CZ_TEST_CHECK(fabs(CZArchCalcPeak(&info, CZMetricCalcFloat) / 1e9 - 3.935) < 0.01);
+	CZ_TEST_CHECK(fabs(CZArchCalcPeak(&info, CZMetricCopyDD) * 2 * 1024 / 1e9 - 249.6) < 0.1);
+}
+
+/*!	\brief Pascal GP104: 128 cores, 1/32 rate double precision.
+*/
+static void CZTestArchPascal(void) {
+	struct CZDeviceInfo info;
+
+	CZ_TEST_STRING(CZArchName(6, 1), "Pascal");
+	CZ_TEST_EQUAL(CZArchCoresPerMP(6, 1), 128);
+
+	CZTestArchDevice(&info, 6, 1, 20, 1733000, 5005000, 256);
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCalcFloat), CZTestArchCalc(&info, 128)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCalcDouble), CZTestArchCalc(&info, 4)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCopyDD), CZTestArchCopyDD(&info)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCopyDHPage), CZ_TEST_ARCH_PCIE3));
+
+	/* 8.87 TFLOPS of single precision. */
+	CZ_TEST_CHECK(fabs(CZArchCalcPeak(&info, CZMetricCalcFloat) / 1e9 - 8.873) < 0.01);
+
+	/* Integrated GPU shares memory with host. */
+	info.core.integratedGpu = 1;
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCopyHDPin), CZTestArchCopyDD(&info)));
+}
+
+/*!	\brief Ampere GA102: 128 cores, PCI Express 4.0.
+*/
+static void CZTestArchAmpere(void) {
+	struct CZDeviceInfo info;
+
+	CZ_TEST_STRING(CZArchName(8, 6), "Ampere");
+	CZ_TEST_EQUAL(CZArchCoresPerMP(8, 6), 128);
+
+	CZTestArchDevice(&info, 8, 6, 68, 1710000, 9501000, 320);
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCalcFloat), CZTestArchCalc(&info, 128)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCalcDouble), CZTestArchCalc(&info, 2)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCalcInteger32), CZTestArchCalc(&info, 64)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCopyDD), CZTestArchCopyDD(&info)));
+	CZ_TEST_CHECK(CZTestArchNear(CZArchCalcPeak(&info, CZMetricCopyHDPin), CZ_TEST_ARCH_PCIE4));
+
+	/* 29.77 TFLOPS of single precision, 760 GB/s of memory. */
+	CZ_TEST_CHECK(fabs(CZArchCalcPeak(&info, CZMetricCalcFloat) / 1e9 - 29.768) < 0.01);
+	CZ_TEST_CHECK(fabs(CZArchCalcPeak(&info, CZMetricCopyDD) * 2 * 1024 / 1e9 - 760.1) < 0.1);
+
+	/* Efficiency is measured value to peak ratio. */
+	CZMetricSetValue(&info, CZMetricCalcFloat, (float)(CZArchCalcPeak(&info, CZMetricCalcFloat) / 2));
+	CZ_TEST_CHECK(fabs(CZArchCalcEfficiency(&info, CZMetricCalcFloat) - 50) < 0.01);
+}
+
+/*!	\brief Unknown minor revision falls back to older minor revision,
+	unknown major revision has no peaks.
+*/
+static void CZTestArchUnknown(void) {
+	struct CZDeviceInfo info;
+	const struct CZArchInfo *arch;
+
+	arch = CZArchFind(8, 8);
+	CZ_TEST_CHECK(arch != NULL);
+	if(arch != NULL) {
+		CZ_TEST_EQUAL(arch->major, 8);
+		CZ_TEST_EQUAL(arch->minor, 7);
+	}
+	CZ_TEST_EQUAL(CZArchCoresPerMP(3, 6), 192);
+
+	CZ_TEST_CHECK(CZArchFind(99, 0) == NULL);
+	CZ_TEST_CHECK(CZArchFind(3, -1) == NULL);
+	CZ_TEST_STRING(CZArchName(99, 0), "");
+	CZ_TEST_EQUAL(CZArchCoresPerMP(99, 0), 0);
+	CZ_TEST_EQUAL(CZArchCoresPerMP(4, 0), 0);
+
+	CZTestArchDevice(&info, 99, 0, 100, 2000000, 10000000, 512);
+	CZMetricSetValue(&info, CZMetricCalcFloat, 1000.0f);
+	for(int i = 0; i < CZMetricMax; i++) {
+		CZ_TEST_CHECK(CZArchCalcPeak(&info, i) == 0);
+		CZ_TEST_CHECK(CZArchCalcEfficiency(&info, i) == 0);
+	}
+	CZ_TEST_CHECK(CZArchCalcPeak(NULL, CZMetricCalcFloat) == 0);
+}
+
+int main(void) {
+	CZLogSetVerbosityLevel(CZLogLevelFatal);
+
+	CZTestArchKepler();
+	CZTestArchPascal();
+	CZTestArchAmpere();
+	CZTestArchUnknown();
+
+	return CZ_TEST_RESULT("tst_arch");
+}
@@ -0,0 +1,341 @@
+/*!	\file tst_async.cpp
+	\brief Asynchronous benchmark API test.
+	Jobs run on simulated backend, so tests are fast and need no device.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdlib.h>
+
+#include "cztest.h"
+#include "log.h"
+#include "cztimer.h"
+#include "czbackend.h"
+#include "czasync.h"
+
+#define CZ_TEST_WAIT_MS		10000			/*!< Time limit of waiting for one job. */
+
+/*!	\brief Context of callbacks of test job.
+*/
+struct CZTestAsyncContext {
+	volatile int	cancel;			/*!< Cancellation token of job. */
+	int		cancelMetric;		/*!< Test before which job is cancelled, \a -1 for none. */
+	double		stallMs;		/*!< Time spent in prepare phase progress callback. */
+	int		progressNum;		/*!< Number of progress callbacks. */
+	int		doneNum;		/*!< Number of progress callbacks of done phase. */
+	volatile int	completeNum;		/*!< Number of completion callbacks. */
+	int		completeStatus;		/*!< Status passed to completion callback. */
+	struct CZAsyncJob * volatile freeJob;	/*!< Job released by completion callback, may be \a NULL. */
+};
+
+/*!	\brief Progress callback of test job.
+*/
+static void CZTestAsyncProgress(
+	void *context,			/*!<[in,out] Test context. */
+	int phase,			/*!<[in] Current phase. */
+	int metric,			/*!<[in] Current test. */
+	int testsDone,			/*!<[in] Number of finished tests. */
+	int testsNum			/*!<[in] Number of requested tests. */
+) {
+	struct CZTestAsyncContext *ctx = (struct CZTestAsyncContext*)context;
+
+	(void)testsDone;
+	(void)testsNum;
+
+	ctx->progressNum++;
+	if(phase == CZAsyncPhaseDone)
+		ctx->doneNum++;
+	if((phase == CZAsyncPhasePrepare) && (ctx->stallMs > 0)) {
+		double endMs = CZTimerNow() + ctx->stallMs;
+		while(CZTimerNow() < endMs);
+	}
+	if((ctx->cancelMetric >= 0) && (metric == ctx->cancelMetric))
+		ctx->cancel = 1;
+}
+
+/*!	\brief Completion callback of test job.
+*/
+static void CZTestAsyncComplete(
+	void *context,			/*!<[in,out] Test context. */
+	int status,			/*!<[in] Final status. */
+	const struct CZDeviceInfo *info	/*!<[in] Results of job. */
+) {
+	struct CZTestAsyncContext *ctx = (struct CZTestAsyncContext*)context;
+
+	(void)info;
+
+	ctx->completeStatus = status;
+	if(ctx->freeJob != NULL)
+		CZAsyncFree(ctx->freeJob);
+	ctx->completeNum++;
+}
+
+/*!	\brief Prepare request of test job with callbacks bound to \a ctx.
+*/
+static void CZTestAsyncRequest(
+	struct CZAsyncRequest *request,	/*!<[out] Benchmark request. */
+	struct CZTestAsyncContext *ctx	/*!<[out] Test context. */
+) {
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->cancelMetric = -1;
+
+	CZAsyncRequestDefault(request);
+	request->metrics = (1 << CZMetricCopyHDPin) | (1 << CZMetricCopyDD) | (1 << CZMetricCalcFloat);
+	request->cancel = &ctx->cancel;
+	request->progress = CZTestAsyncProgress;
+	request->complete = CZTestAsyncComplete;
+	request->context = ctx;
+}
+
+/*!	\brief Job runs all requested tests and reports completion once.
+*/
+static void CZTestAsyncDone(void) {
+	struct CZAsyncRequest request;
+	struct CZTestAsyncContext ctx;
+	struct CZAsyncJob *job;
+	const struct CZDeviceInfo *info;
+	int status;
+
+	CZTestAsyncRequest(&request, &ctx);
+	job = CZAsyncStart(&request);
+	CZ_TEST_CHECK(job != NULL);
+	if(job == NULL)
+		return;
+
+	status = CZAsyncWait(job, CZ_TEST_WAIT_MS);
+	CZ_TEST_EQUAL(status, CZAsyncStatusDone);
+	CZ_TEST_EQUAL(CZAsyncPoll(job), CZAsyncStatusDone);
+
+	info = CZAsyncResult(job);
+	CZ_TEST_CHECK(info != NULL);
+	CZ_TEST_CHECK(info->stat[CZMetricCopyHDPin].samplesNum > 0);
+	CZ_TEST_CHECK(info->stat[CZMetricCopyDD].samplesNum > 0);
+	CZ_TEST_CHECK(info->stat[CZMetricCalcFloat].samplesNum > 0);
+	CZ_TEST_EQUAL(info->stat[CZMetricCalcDouble].samplesNum, 0);
+	CZ_TEST_CHECK(info->band.copyDD > 0);
+	CZ_TEST_CHECK(info->perf.calcFloat > 0);
+
+	CZAsyncFree(job);
+
+	/* Callbacks are over when job is released. */
+	CZ_TEST_EQUAL(ctx.completeNum, 1);
+	CZ_TEST_EQUAL(ctx.completeStatus, CZAsyncStatusDone);
+	CZ_TEST_EQUAL(ctx.doneNum, 1);
+	CZ_TEST_EQUAL(ctx.progressNum, 1 + 3 + 1);
+}
+
+/*!	\brief Polling job without waiting reaches final status.
+*/
+static void CZTestAsyncPoll(void) {
+	struct CZAsyncRequest request;
+	struct CZTestAsyncContext ctx;
+	struct CZAsyncJob *job;
+	double endMs;
+	int status;
+
+	CZTestAsyncRequest(&request, &ctx);
+	job = CZAsyncStart(&request);
+	CZ_TEST_CHECK(job != NULL);
+	if(job == NULL)
+		return;
+
+	endMs = CZTimerNow() + CZ_TEST_WAIT_MS;
+	do {
+		status = CZAsyncPoll(job);
+	} while((status == CZAsyncStatusRunning) && (CZTimerNow() < endMs));
+	CZ_TEST_EQUAL(status, CZAsyncStatusDone);
+
+	CZAsyncFree(job);
+}
+
+/*!	\brief Job cancelled before its start runs no tests.
+*/
+static void CZTestAsyncCancelEarly(void) {
+	struct CZAsyncRequest request;
+	struct CZTestAsyncContext ctx;
+	struct CZAsyncJob *job;
+	int metric;
+
+	CZTestAsyncRequest(&request, &ctx);
+	ctx.cancel = 1;
+	job = CZAsyncStart(&request);
+	CZ_TEST_CHECK(job != NULL);
+	if(job == NULL)
+		return;
+
+	CZ_TEST_EQUAL(CZAsyncWait(job, CZ_TEST_WAIT_MS), CZAsyncStatusCancelled);
+	for(metric = 0; metric < CZMetricMax; metric++)
+		CZ_TEST_EQUAL(CZAsyncResult(job)->stat[metric].samplesNum, 0);
+
+	CZAsyncFree(job);
+	CZ_TEST_EQUAL(ctx.completeStatus, CZAsyncStatusCancelled);
+}
+
+/*!	\brief Token raised by caller during job stops remaining tests.
+*/
+static void CZTestAsyncCancelToken(void) {
+	struct CZAsyncRequest request;
+	struct CZTestAsyncContext ctx;
+	struct CZAsyncJob *job;
+	const struct CZDeviceInfo *info;
+
+	CZTestAsyncRequest(&request, &ctx);
+	ctx.cancelMetric = CZMetricCopyDD;
+	job = CZAsyncStart(&request);
+	CZ_TEST_CHECK(job != NULL);
+	if(job == NULL)
+		return;
+
+	CZ_TEST_EQUAL(CZAsyncWait(job, CZ_TEST_WAIT_MS), CZAsyncStatusCancelled);
+	info = CZAsyncResult(job);
+	CZ_TEST_CHECK(info->stat[CZMetricCopyHDPin].samplesNum > 0);
+	CZ_TEST_EQUAL(info->stat[CZMetricCalcFloat].samplesNum, 0);
+
+	CZAsyncFree(job);
+	CZ_TEST_EQUAL(ctx.completeStatus, CZAsyncStatusCancelled);
+}
+
+/*!	\brief CZAsyncCancel() stops job and leaves token of caller alone.
+*/
+static void CZTestAsyncCancelCall(void) {
+	struct CZAsyncRequest request;
+	struct CZTestAsyncContext ctx;
+	struct CZAsyncJob *job;
+	int status;
+
+	CZTestAsyncRequest(&request, &ctx);
+	ctx.stallMs = 50;
+	job = CZAsyncStart(&request);
+	CZ_TEST_CHECK(job != NULL);
+	if(job == NULL)
+		return;
+
+	/* Job is stalled in prepare phase, so it can't be over yet. */
+	CZ_TEST_EQUAL(CZAsyncPoll(job), CZAsyncStatusRunning);
+	CZAsyncCancel(job);
+	CZ_TEST_EQUAL(ctx.cancel, 0);
+
+	status = CZAsyncWait(job, CZ_TEST_WAIT_MS);
+	CZ_TEST_EQUAL(status, CZAsyncStatusCancelled);
+	CZ_TEST_EQUAL(CZAsyncResult(job)->stat[CZMetricCalcFloat].samplesNum, 0);
+
+	CZAsyncFree(job);
+}
+
+/*!	\brief Releasing running job does not cancel other job sharing its token.
+*/
+static void CZTestAsyncSharedToken(void) {
+	struct CZAsyncRequest request;
+	struct CZTestAsyncContext ctx;
+	struct CZAsyncJob *first;
+	struct CZAsyncJob *second;
+
+	CZTestAsyncRequest(&request, &ctx);
+	ctx.stallMs = 50;
+	first = CZAsyncStart(&request);
+	second = CZAsyncStart(&request);
+	CZ_TEST_CHECK((first != NULL) && (second != NULL));
+	if((first == NULL) || (second == NULL)) {
+		CZAsyncFree(first);
+		CZAsyncFree(second);
+		return;
+	}
+
+	CZAsyncFree(first);
+	CZ_TEST_EQUAL(ctx.cancel, 0);
+	CZ_TEST_EQUAL(CZAsyncWait(second, CZ_TEST_WAIT_MS), CZAsyncStatusDone);
+
+	CZAsyncFree(second);
+}
+
+/*!	\brief Job released from its completion callback is freed by its thread.
+*/
+static void CZTestAsyncFreeInCallback(void) {
+	struct CZAsyncRequest request;
+	struct CZTestAsyncContext ctx;
+	struct CZAsyncJob *job;
+	double endMs;
+
+	CZTestAsyncRequest(&request, &ctx);
+	ctx.stallMs = 50;
+	job = CZAsyncStart(&request);
+	CZ_TEST_CHECK(job != NULL);
+	if(job == NULL)
+		return;
+	ctx.freeJob = job;
+
+	endMs = CZTimerNow() + CZ_TEST_WAIT_MS;
+	while((ctx.completeNum == 0) && (CZTimerNow() < endMs));
+	CZ_TEST_EQUAL(ctx.completeNum, 1);
+	CZ_TEST_EQUAL(ctx.completeStatus, CZAsyncStatusDone);
+
+	/* Give detached thread time to free job before leak check at exit. */
+	endMs = CZTimerNow() + 100;
+	while(CZTimerNow() < endMs);
+}
+
+/*!	\brief Job past its deadline reports timeout, also in fixed test mode.
+*/
+static void CZTestAsyncDeadline(void) {
+	struct CZAsyncRequest request;
+	struct CZTestAsyncContext ctx;
+	struct CZAsyncJob *job;
+
+	CZTestAsyncRequest(&request, &ctx);
+	request.precision = 0;
+	request.deadlineMs = 10;
+	ctx.stallMs = 50;
+	job = CZAsyncStart(&request);
+	CZ_TEST_CHECK(job != NULL);
+	if(job == NULL)
+		return;
+
+	CZ_TEST_EQUAL(CZAsyncWait(job, CZ_TEST_WAIT_MS), CZAsyncStatusTimeout);
+	CZ_TEST_EQUAL(CZAsyncResult(job)->stat[CZMetricCalcFloat].samplesNum, 0);
+	CZ_TEST_EQUAL(ctx.cancel, 0);
+
+	CZAsyncFree(job);
+	CZ_TEST_EQUAL(ctx.completeStatus, CZAsyncStatusTimeout);
+}
+
+/*!	\brief Job of missing device fails.
+*/
+static void CZTestAsyncFailed(void) {
+	struct CZAsyncRequest request;
+	struct CZTestAsyncContext ctx;
+	struct CZAsyncJob *job;
+
+	CZTestAsyncRequest(&request, &ctx);
+	request.device = CZCudaDeviceFound();
+	job = CZAsyncStart(&request);
+	CZ_TEST_CHECK(job != NULL);
+	if(job == NULL)
+		return;
+
+	CZ_TEST_EQUAL(CZAsyncWait(job, CZ_TEST_WAIT_MS), CZAsyncStatusFailed);
+
+	CZAsyncFree(job);
+	CZ_TEST_EQUAL(ctx.completeStatus, CZAsyncStatusFailed);
+}
+
+int main(void) {
+	CZLogSetVerbosityLevel(CZLogLevelError);
+
+	if((CZBackendSelect("sim") != 0) || !CZCudaCheck() || (CZCudaDeviceFound() == 0)) {
+		fprintf(stderr, "Simulated backend is not available!\n");
+		return 1;
+	}
+
+	CZTestAsyncDone();
+	CZTestAsyncPoll();
+	CZTestAsyncCancelEarly();
+	CZTestAsyncCancelToken();
+	CZTestAsyncCancelCall();
+	CZTestAsyncSharedToken();
+	CZTestAsyncFreeInCallback();
+	CZTestAsyncDeadline();
+	CZTestAsyncFailed();
+
+	return CZ_TEST_RESULT("tst_async");
+}
@@ -0,0 +1,10 @@
+#	\file tst_async.pro
+#	\brief Asynchronous benchmark API test project file.
+#	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+#	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+#	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+
+TARGET = tst_async
+include(../test.pri)
+
+SOURCES += tst_async.cpp
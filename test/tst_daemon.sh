@@ -0,0 +1,78 @@
+#!/bin/sh
+#	\file tst_daemon.sh
+#	\brief Benchmark daemon metrics endpoint test.
+#	Starts daemon on simulated backend and scrapes its metrics endpoint
+#	the way Prometheus does. Needs built cuda-z-cli and curl:
+#	   # sh test/tst_daemon.sh bin/cuda-z-cli
+#	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+#	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+#	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+
+BIN=${1:-bin/cuda-z-cli}
+PORT=${CZ_TEST_PORT:-19464}
+URL=http://127.0.0.1:$PORT
+TMP=${TMPDIR:-/tmp}/tst_daemon.$$
+FAILED=0
+
+if [ ! -x "$BIN" ]; then
+	echo "Usage: $0 <cuda-z-cli binary>" >&2
+	exit 1
+fi
+if ! command -v curl >/dev/null 2>&1; then
+	echo "tst_daemon: curl is not found" >&2
+	exit 1
+fi
+
+check() {
+	if ! grep -q -E "$1" "$TMP.metrics"; then
+		echo "tst_daemon: check failed: $2" >&2
+		FAILED=$((FAILED + 1))
+	fi
+}
+
+"$BIN" -cli -daemon -backend sim -nocache -nohistory -port "$PORT" -interval 3600 >"$TMP.log" 2>&1 &
+PID=$!
+trap 'kill $PID 2>/dev/null; wait $PID 2>/dev/null; rm -f "$TMP".*' EXIT INT TERM
+
+# The first run starts at once, simulated tests take a moment.
+TRIES=0
+until curl -s -f -o "$TMP.metrics" "$URL/metrics" && grep -q '^cuda_z_runs_total{device="0"} [1-9]' "$TMP.metrics"; do
+	TRIES=$((TRIES + 1))
+	if [ $TRIES -ge 100 ] || ! kill -0 $PID 2>/dev/null; then
+		echo "tst_daemon: no finished run at $URL/metrics" >&2
+		cat "$TMP.log" >&2
+		exit 1
+	fi
+	sleep 0.2
+done
+
+check '^# TYPE cuda_z_device_info gauge$' "device_info family"
+check '^cuda_z_device_info\{device="0",name="[^"]+",arch="[^"]*",capability="[0-9]+\.[0-9]+",driver="[^"]*",pci="[0-9a-f]{4}:[0-9a-f]{2}:[0-9a-f]{2}"\} 1$' "device_info labels"
+for test in hd-pin dh-pin dd float; do
+	check "^cuda_z_value\{device=\"0\",test=\"$test\",unit=\"[a-zA-Z/]+\"\} [1-9][0-9.e+]*$" "value of $test"
+	check "^cuda_z_peak\{device=\"0\",test=\"$test\",unit=\"[a-zA-Z/]+\"\} [0-9.e+]+$" "peak of $test"
+	check "^cuda_z_stat_samples\{device=\"0\",test=\"$test\",unit=\"[a-zA-Z/]+\"\} [1-9][0-9]*$" "samples of $test"
+done
+check '^# TYPE cuda_z_runs_total counter$' "runs_total family"
+check '^cuda_z_last_run_timestamp_seconds\{device="0"\} [1-9][0-9]*$' "last run timestamp"
+check '^cuda_z_last_run_duration_seconds\{device="0"\} [0-9]+\.[0-9]{3}$' "last run duration"
+
+# Every sample line must follow the text exposition format.
+if grep -v -E '^(# (HELP|TYPE) cuda_z_[a-z0-9_]+ .+|cuda_z_[a-z0-9_]+\{[^}]*\} [-+0-9.e]+(inf|nan)?)$' "$TMP.metrics" | grep -q .; then
+	echo "tst_daemon: check failed: malformed lines:" >&2
+	grep -v -E '^(# (HELP|TYPE) cuda_z_[a-z0-9_]+ .+|cuda_z_[a-z0-9_]+\{[^}]*\} [-+0-9.e]+(inf|nan)?)$' "$TMP.metrics" >&2
+	FAILED=$((FAILED + 1))
+fi
+
+STATUS=$(curl -s -o /dev/null -w '%{http_code}' "$URL/nothing")
+if [ "$STATUS" != "404" ]; then
+	echo "tst_daemon: check failed: unknown path gives $STATUS" >&2
+	FAILED=$((FAILED + 1))
+fi
+
+if [ $FAILED -ne 0 ]; then
+	echo "tst_daemon: $FAILED check(s) failed"
+	exit 1
+fi
+echo "tst_daemon: passed"
+exit 0
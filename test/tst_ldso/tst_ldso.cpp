@@ -0,0 +1,139 @@
+/*!	\file tst_ldso.cpp
+	\brief Linux shared library resolver test.
+	Libraries are resolved in fixture root \a data/ldso. Its ld.so.cache
+	has \a libcuda.so.1 entries of x86_64, aarch64, ppc64 and i386 and
+	\a libcudart.so.9.0 entry of x86_64, its ld.so.conf includes
+	configurations of ld.so.conf.d folder.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdlib.h>
+
+#include "cztest.h"
+#include "log.h"
+#include "ldso.h"
+
+#define CZ_TEST_LD_SO_ROOT	CZ_TEST_DATA_DIR "/ldso"	/*!< Fixture root directory. */
+
+/*!	\def CZ_TEST_CACHE_DIR
+	\brief Folder of libraries of this architecture in fixture ld.so.cache.
+*/
+#if defined(__x86_64__) && !defined(__ILP32__)
+#define CZ_TEST_CACHE_DIR	"/usr/lib/x86_64-linux-gnu"
+#elif defined(__aarch64__)
+#define CZ_TEST_CACHE_DIR	"/usr/lib/aarch64-linux-gnu"
+#elif defined(__powerpc64__)
+#define CZ_TEST_CACHE_DIR	"/usr/lib/powerpc64le-linux-gnu"
+#endif
+
+/*!	\brief Check if \a path of fixture was found.
+	\returns index of path, or \a -1 if it was not found.
+*/
+static int CZTestLdSoIndex(
+	CZLdSoPath *paths,		/*!<[in] Found paths. */
+	int num,			/*!<[in] Number of found paths. */
+	const char *path		/*!<[in] Path relative to fixture root. */
+) {
+	for(int i = 0; i < num; i++) {
+		if((strncmp(paths[i], CZ_TEST_LD_SO_ROOT, strlen(CZ_TEST_LD_SO_ROOT)) == 0) &&
+			(strcmp(paths[i] + strlen(CZ_TEST_LD_SO_ROOT), path) == 0))
+			return i;
+	}
+	return -1;
+}
+
+/*!	\brief Root directory is taken from environment until it is set.
+*/
+static void CZTestLdSoRoot(void) {
+	setenv(CZ_LD_SO_ROOT_ENV, CZ_TEST_LD_SO_ROOT "//", 1);
+	CZ_TEST_STRING(CZLdSoRoot(), CZ_TEST_LD_SO_ROOT);
+
+	/* Later changes of environment are not seen. */
+	setenv(CZ_LD_SO_ROOT_ENV, "/nonexistent", 1);
+	CZ_TEST_STRING(CZLdSoRoot(), CZ_TEST_LD_SO_ROOT);
+	unsetenv(CZ_LD_SO_ROOT_ENV);
+
+	CZLdSoSetRoot(NULL);
+	CZ_TEST_STRING(CZLdSoRoot(), "");
+
+	CZLdSoSetRoot(CZ_TEST_LD_SO_ROOT "/");
+	CZ_TEST_STRING(CZLdSoRoot(), CZ_TEST_LD_SO_ROOT);
+}
+
+/*!	\brief Driver library is found in \a LD_LIBRARY_PATH, ld.so.cache,
+	ld.so.conf and default directories in this order.
+*/
+static void CZTestLdSoDriver(void) {
+	CZLdSoPath paths[CZ_LD_SO_FIND_MAX];
+	int num;
+	int i = 0;
+
+	setenv("LD_LIBRARY_PATH", "/nonexistent:/home/user/cuda", 1);
+	CZLdSoSetRoot(CZ_TEST_LD_SO_ROOT);
+	num = CZLdSoFind("libcuda.so.1", paths, CZ_LD_SO_FIND_MAX);
+
+	CZ_TEST_EQUAL(CZTestLdSoIndex(paths, num, "/home/user/cuda/libcuda.so.1"), i++);
+#ifdef CZ_TEST_CACHE_DIR
+	CZ_TEST_EQUAL(CZTestLdSoIndex(paths, num, CZ_TEST_CACHE_DIR "/libcuda.so.1"), i++);
+#endif
+	CZ_TEST_EQUAL(CZTestLdSoIndex(paths, num, "/usr/lib/nvidia-390/libcuda.so.1"), i++);
+	CZ_TEST_EQUAL(CZTestLdSoIndex(paths, num, "/usr/lib64/libcuda.so.1"), i++);
+	CZ_TEST_EQUAL(num, i);
+
+	/* Entries of other architectures are skipped. */
+#if defined(__x86_64__) && !defined(__ILP32__)
+	CZ_TEST_EQUAL(CZTestLdSoIndex(paths, num, "/usr/lib/i386-linux-gnu/libcuda.so.1"), -1);
+	CZ_TEST_EQUAL(CZTestLdSoIndex(paths, num, "/usr/lib/aarch64-linux-gnu/libcuda.so.1"), -1);
+#endif
+
+	/* Only requested number of paths is returned. */
+	CZ_TEST_EQUAL(CZLdSoFind("libcuda.so.1", paths, 2), 2);
+	CZ_TEST_EQUAL(CZTestLdSoIndex(paths, 2, "/home/user/cuda/libcuda.so.1"), 0);
+
+	unsetenv("LD_LIBRARY_PATH");
+	num = CZLdSoFind("libcuda.so.1", paths, CZ_LD_SO_FIND_MAX);
+	CZ_TEST_EQUAL(CZTestLdSoIndex(paths, num, "/home/user/cuda/libcuda.so.1"), -1);
+	CZ_TEST_EQUAL(num, i - 1);
+}
+
+/*!	\brief Runtime library is found in ld.so.cache and in directories
+	of old style comma separated configuration.
+*/
+static void CZTestLdSoRuntime(void) {
+	CZLdSoPath paths[CZ_LD_SO_FIND_MAX];
+	int num;
+	int i = 0;
+
+	CZLdSoSetRoot(CZ_TEST_LD_SO_ROOT);
+	num = CZLdSoFind("libcudart.so.9.0", paths, CZ_LD_SO_FIND_MAX);
+
+#if defined(__x86_64__) && !defined(__ILP32__)
+	CZ_TEST_EQUAL(CZTestLdSoIndex(paths, num, "/usr/lib/x86_64-linux-gnu/libcudart.so.9.0"), i++);
+#endif
+	CZ_TEST_EQUAL(CZTestLdSoIndex(paths, num, "/opt/cuda/lib64/libcudart.so.9.0"), i++);
+	CZ_TEST_EQUAL(num, i);
+
+	CZ_TEST_EQUAL(CZLdSoFind("libnvidia-ml.so.1", paths, CZ_LD_SO_FIND_MAX), 0);
+}
+
+/*!	\brief Missing fixture files give no paths.
+*/
+static void CZTestLdSoMissing(void) {
+	CZLdSoPath paths[CZ_LD_SO_FIND_MAX];
+
+	CZLdSoSetRoot(CZ_TEST_LD_SO_ROOT "/nonexistent");
+	CZ_TEST_EQUAL(CZLdSoFind("libcuda.so.1", paths, CZ_LD_SO_FIND_MAX), 0);
+}
+
+int main(void) {
+	CZLogSetVerbosityLevel(CZLogLevelError);
+
+	CZTestLdSoRoot();
+	CZTestLdSoDriver();
+	CZTestLdSoRuntime();
+	CZTestLdSoMissing();
+
+	return CZ_TEST_RESULT("tst_ldso");
+}
@@ -0,0 +1,10 @@
+#	\file tst_ldso.pro
+#	\brief Linux shared library resolver test project file.
+#	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+#	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+#	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+
+TARGET = tst_ldso
+include(../test.pri)
+
+SOURCES += tst_ldso.cpp
@@ -0,0 +1,166 @@
+/*!	\file tst_merge.cpp
+	\brief Merge of reports of many nodes test.
+	Reports are read from fixture folder \a data/merge. GeForce GTX 1080
+	with driver 390.48 is tested on node01 to node05, where node03 has
+	slow host to device copies, node04 also has Tesla V100 and node05
+	report has no host name. node06 runs driver 384.111. Folder also
+	has a report of other schema and a file which is not a report.
+	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+*/
+
+#include <stdlib.h>
+#include <math.h>
+
+#include "cztest.h"
+#include "log.h"
+#include "czreport.h"
+#include "czmerge.h"
+
+#define CZ_TEST_MERGE_DIR	CZ_TEST_DATA_DIR "/merge"	/*!< Fixture folder. */
+
+/*!	\brief Check if two values are equal within relative \a 1e-6.
+*/
+static bool CZTestMergeNear(
+	double actual,			/*!<[in] Actual value. */
+	double expected			/*!<[in] Expected value. */
+) {
+	return fabs(actual - expected) <= 1e-6 * fabs(expected);
+}
+
+/*!	\brief Whole folder is merged into groups of model and driver
+	and slow device is found.
+*/
+static void CZTestMergeDir(void) {
+	struct CZFleetConfig config;
+	struct CZMerge merge;
+	struct CZReportText text;
+
+	CZFleetConfigDefault(&config);
+	CZMergeInit(&merge, &config);
+
+	CZ_TEST_EQUAL(CZMergeAddDir(&merge, CZ_TEST_MERGE_DIR), 7);
+	CZ_TEST_EQUAL(merge.filesNum, 6);
+	CZ_TEST_EQUAL(merge.reportsNum, 7);
+	CZ_TEST_EQUAL(CZMergeAnalyze(&merge), 0);
+
+	CZ_TEST_EQUAL(merge.groupsNum, 3);
+	if(merge.groupsNum != 3) {
+		CZMergeFree(&merge);
+		return;
+	}
+
+	const struct CZMergeGroup *old = &merge.groups[0];
+	CZ_TEST_STRING(old->deviceName, "GeForce GTX 1080");
+	CZ_TEST_STRING(old->drvVersion, "384.111");
+	CZ_TEST_EQUAL(old->nodesNum, 1);
+	CZ_TEST_STRING(old->nodes[0].node, "node06");
+	CZ_TEST_EQUAL(old->summary[CZMetricCopyHDPin].num, 1);
+	CZ_TEST_EQUAL(old->summary[CZMetricCopyHDPin].outliersNum, 0);
+
+	const struct CZMergeGroup *group = &merge.groups[1];
+	CZ_TEST_STRING(group->deviceName, "GeForce GTX 1080");
+	CZ_TEST_STRING(group->drvVersion, "390.48");
+	CZ_TEST_EQUAL(group->nodesNum, 5);
+	if(group->nodesNum == 5) {
+		CZ_TEST_STRING(group->nodes[0].node, "node01");
+		CZ_TEST_STRING(group->nodes[1].node, "node02");
+		CZ_TEST_STRING(group->nodes[2].node, "node03");
+		CZ_TEST_STRING(group->nodes[3].node, "node04");
+		CZ_TEST_STRING(group->nodes[4].node, "node05");
+		CZ_TEST_EQUAL(group->nodes[3].device, 0);
+
+		/* Values are kept in units of CZDeviceInfo. */
+		CZ_TEST_CHECK(CZTestMergeNear(group->nodes[2].value[CZMetricCopyHDPin] * CZReportMetricScale(CZMetricCopyHDPin), 6.0e9));
+		CZ_TEST_CHECK(CZTestMergeNear(group->summary[CZMetricCopyHDPin].median * CZReportMetricScale(CZMetricCopyHDPin), 12.8e9));
+		CZ_TEST_EQUAL(group->nodes[0].value[CZMetricCalcDouble], 0);
+		CZ_TEST_EQUAL(group->summary[CZMetricCalcDouble].num, 0);
+
+		CZ_TEST_EQUAL(group->summary[CZMetricCopyHDPin].num, 5);
+		CZ_TEST_EQUAL(group->summary[CZMetricCopyHDPin].outliersNum, 1);
+		CZ_TEST_EQUAL(group->entries[CZMetricCopyHDPin][2].outlier, 1);
+		CZ_TEST_EQUAL(group->entries[CZMetricCopyHDPin][2].rank, 5);
+		CZ_TEST_CHECK(group->entries[CZMetricCopyHDPin][2].deviationPct < -50);
+		CZ_TEST_EQUAL(group->entries[CZMetricCopyHDPin][0].outlier, 0);
+		CZ_TEST_EQUAL(group->entries[CZMetricCopyHDPin][0].rank, 1);
+
+		/* Slower device to device copies of node02 are within threshold. */
+		CZ_TEST_EQUAL(group->summary[CZMetricCopyDD].outliersNum, 0);
+		CZ_TEST_EQUAL(group->summary[CZMetricCalcFloat].outliersNum, 0);
+	}
+
+	const struct CZMergeGroup *tesla = &merge.groups[2];
+	CZ_TEST_STRING(tesla->deviceName, "Tesla V100-PCIE-16GB");
+	CZ_TEST_EQUAL(tesla->nodesNum, 1);
+	CZ_TEST_STRING(tesla->nodes[0].node, "node04");
+	CZ_TEST_EQUAL(tesla->nodes[0].device, 1);
+
+	CZReportTextInit(&text);
+	CZ_TEST_EQUAL(CZReportWriteMergeCSV(&text, &merge), 0);
+	CZ_TEST_CHECK(text.text != NULL);
+	if(text.text != NULL) {
+		int lines = 0;
+		for(const char *p = text.text; *p != 0; p++)
+			lines += (*p == '\n');
+		CZ_TEST_EQUAL(lines, 1 + 7 * 3);
+		CZ_TEST_CHECK(strncmp(text.text, "device_name,driver_version,node,device,file,metric,", 51) == 0);
+		CZ_TEST_CHECK(strstr(text.text, "GeForce GTX 1080,390.48,node03,0,") != NULL);
+	}
+	CZReportTextFree(&text);
+
+	CZMergeFree(&merge);
+	CZ_TEST_EQUAL(merge.groupsNum, 0);
+}
+
+/*!	\brief Two devices of one model are not outliers of each other.
+*/
+static void CZTestMergePair(void) {
+	struct CZFleetConfig config;
+	struct CZMerge merge;
+
+	CZFleetConfigDefault(&config);
+	CZMergeInit(&merge, &config);
+
+	CZ_TEST_EQUAL(CZMergeAddFile(&merge, CZ_TEST_MERGE_DIR "/node01.json"), 1);
+	CZ_TEST_EQUAL(CZMergeAddFile(&merge, CZ_TEST_MERGE_DIR "/node03.csv"), 1);
+	CZ_TEST_EQUAL(CZMergeAnalyze(&merge), 0);
+
+	CZ_TEST_EQUAL(merge.groupsNum, 1);
+	if(merge.groupsNum == 1) {
+		CZ_TEST_EQUAL(merge.groups[0].nodesNum, 2);
+		CZ_TEST_EQUAL(merge.groups[0].summary[CZMetricCopyHDPin].num, 2);
+		CZ_TEST_EQUAL(merge.groups[0].summary[CZMetricCopyHDPin].outliersNum, 0);
+	}
+
+	CZMergeFree(&merge);
+}
+
+/*!	\brief Files which are not reports are skipped.
+*/
+static void CZTestMergeBad(void) {
+	struct CZFleetConfig config;
+	struct CZMerge merge;
+
+	CZFleetConfigDefault(&config);
+	CZMergeInit(&merge, &config);
+
+	CZ_TEST_EQUAL(CZMergeAddFile(&merge, CZ_TEST_MERGE_DIR "/broken.json"), -1);
+	CZ_TEST_EQUAL(CZMergeAddFile(&merge, CZ_TEST_MERGE_DIR "/notes.txt"), -1);
+	CZ_TEST_EQUAL(CZMergeAddFile(&merge, CZ_TEST_MERGE_DIR "/missing.json"), -1);
+	CZ_TEST_EQUAL(CZMergeAddDir(&merge, CZ_TEST_MERGE_DIR "/missing"), -1);
+	CZ_TEST_EQUAL(merge.filesNum, 0);
+	CZ_TEST_EQUAL(merge.groupsNum, 0);
+
+	CZMergeFree(&merge);
+}
+
+int main(void) {
+	CZLogSetVerbosityLevel(CZLogLevelFatal);
+
+	CZTestMergeDir();
+	CZTestMergePair();
+	CZTestMergeBad();
+
+	return CZ_TEST_RESULT("tst_merge");
+}
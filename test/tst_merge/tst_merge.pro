@@ -0,0 +1,10 @@
+#	\file tst_merge.pro
+#	\brief Merge of reports test project file.
+#	\author Andriy Golovnya <andriy.golovnya@gmail.com> http://redscorp.net/
+#	\url http://cuda-z.sf.net/ http://sf.net/projects/cuda-z/
+#	\license GPLv3 http://www.gnu.org/licenses/gpl-3.0.html
+
+TARGET = tst_merge
+include(../test.pri)
+
+SOURCES += tst_merge.cpp